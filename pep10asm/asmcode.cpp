@@ -26,6 +26,7 @@
 #include <utility>
 
 #include "asmcode.h"
+#include "asmcodearena.h"
 #include "asmargument.h"
 #include "isaasm.h"
 #include "macromodules.h"
@@ -290,74 +291,74 @@ void AsmCode::setListingLineNumber(quint32 lineNumber)
     this->listingCodeLine = lineNumber;
 }
 
-AsmCode *UnaryInstruction::cloneAsmCode() const
+AsmCode *UnaryInstruction::cloneAsmCode(AsmCodeArena& arena) const
 {
-    return new UnaryInstruction(*this);
+    return arena.create<UnaryInstruction>(*this);
 }
 
-AsmCode *NonUnaryInstruction::cloneAsmCode() const
+AsmCode *NonUnaryInstruction::cloneAsmCode(AsmCodeArena& arena) const
 {
-    return new NonUnaryInstruction(*this);
+    return arena.create<NonUnaryInstruction>(*this);
 }
 
-AsmCode *DotAddrss::cloneAsmCode() const
+AsmCode *DotAddrss::cloneAsmCode(AsmCodeArena& arena) const
 {
-    return new DotAddrss(*this);
+    return arena.create<DotAddrss>(*this);
 }
 
-AsmCode *DotAlign::cloneAsmCode() const
+AsmCode *DotAlign::cloneAsmCode(AsmCodeArena& arena) const
 {
-    return new DotAlign(*this);
+    return arena.create<DotAlign>(*this);
 }
 
-AsmCode *DotAscii::cloneAsmCode() const
+AsmCode *DotAscii::cloneAsmCode(AsmCodeArena& arena) const
 {
-    return new DotAscii(*this);
+    return arena.create<DotAscii>(*this);
 }
 
-AsmCode *DotBlock::cloneAsmCode() const
+AsmCode *DotBlock::cloneAsmCode(AsmCodeArena& arena) const
 {
-    return new DotBlock(*this);
+    return arena.create<DotBlock>(*this);
 }
 
-AsmCode *DotBurn::cloneAsmCode() const
+AsmCode *DotBurn::cloneAsmCode(AsmCodeArena& arena) const
 {
-    return new DotBurn(*this);
+    return arena.create<DotBurn>(*this);
 }
 
-AsmCode *DotByte::cloneAsmCode() const
+AsmCode *DotByte::cloneAsmCode(AsmCodeArena& arena) const
 {
-    return new DotByte(*this);
+    return arena.create<DotByte>(*this);
 }
 
-AsmCode *DotEnd::cloneAsmCode() const
+AsmCode *DotEnd::cloneAsmCode(AsmCodeArena& arena) const
 {
-    return new DotEnd(*this);
+    return arena.create<DotEnd>(*this);
 }
 
-AsmCode *DotEquate::cloneAsmCode() const
+AsmCode *DotEquate::cloneAsmCode(AsmCodeArena& arena) const
 {
-    return new DotEquate(*this);
+    return arena.create<DotEquate>(*this);
 }
 
-AsmCode *DotWord::cloneAsmCode() const
+AsmCode *DotWord::cloneAsmCode(AsmCodeArena& arena) const
 {
-    return new DotWord(*this);
+    return arena.create<DotWord>(*this);
 }
 
-AsmCode *CommentOnly::cloneAsmCode() const
+AsmCode *CommentOnly::cloneAsmCode(AsmCodeArena& arena) const
 {
-    return new CommentOnly(*this);
+    return arena.create<CommentOnly>(*this);
 }
 
-AsmCode *BlankLine::cloneAsmCode() const
+AsmCode *BlankLine::cloneAsmCode(AsmCodeArena& arena) const
 {
-    return new BlankLine(*this);
+    return arena.create<BlankLine>(*this);
 }
 
-AsmCode *MacroInvoke::cloneAsmCode() const
+AsmCode *MacroInvoke::cloneAsmCode(AsmCodeArena& arena) const
 {
-    return new MacroInvoke(*this);
+    return arena.create<MacroInvoke>(*this);
 }
 
 void UnaryInstruction::appendObjectCode(QList<int> &objectCode) const
@@ -1188,7 +1189,7 @@ void MacroInvoke::appendObjectCode(QList<int> &objectCode) const
 {
     for(const auto& code : this->macroInstance->codeList) {
         // Don't generate listing for anything after and including .END
-        if(dynamic_cast<DotEnd*>(code.get()) != nullptr) break;
+        if(dynamic_cast<DotEnd*>(code) != nullptr) break;
         code->appendObjectCode(objectCode);
     }
 }
@@ -1218,7 +1219,7 @@ QString MacroInvoke::getAssemblerListing() const
     list.append(lineStr);
     for(const auto& code : this->macroInstance->codeList) {
         // Don't generate listing for anything after and including .END
-        if(dynamic_cast<DotEnd*>(code.get()) != nullptr) break;
+        if(dynamic_cast<DotEnd*>(code) != nullptr) break;
         list << code->getAssemblerListing();
     }
     list.append(QString("             ;end macro"));
@@ -1283,9 +1284,9 @@ DotExport &DotExport::operator=(DotExport other)
     return *this;
 }
 
-AsmCode *DotExport::cloneAsmCode() const
+AsmCode *DotExport::cloneAsmCode(AsmCodeArena& arena) const
 {
-    return new DotExport(*this);
+    return arena.create<DotExport>(*this);
 }
 
 void DotExport::appendObjectCode(QList<int> &) const
@@ -1347,9 +1348,9 @@ DotSycall &DotSycall::operator=(DotSycall other)
     return *this;
 }
 
-AsmCode *DotSycall::cloneAsmCode() const
+AsmCode *DotSycall::cloneAsmCode(AsmCodeArena& arena) const
 {
-    return new DotSycall(*this);
+    return arena.create<DotSycall>(*this);
 }
 
 void DotSycall::appendObjectCode(QList<int> &) const
@@ -1411,9 +1412,9 @@ DotUSycall &DotUSycall::operator=(DotUSycall other)
     return *this;
 }
 
-AsmCode *DotUSycall::cloneAsmCode() const
+AsmCode *DotUSycall::cloneAsmCode(AsmCodeArena& arena) const
 {
-    return new DotUSycall(*this);
+    return arena.create<DotUSycall>(*this);
 }
 
 void DotUSycall::appendObjectCode(QList<int> &) const
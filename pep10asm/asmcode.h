@@ -31,6 +31,7 @@ class SymbolRefArgument; // Forward declare identifier argument.
 class AsmArgumentList; //Forward declare a list of arguments.
 class SymbolEntry;
 struct ModuleInstance;
+class AsmCodeArena;
 /*
  * Abstract Code class that represents a single line of assembly code.
  * It contains methods for generating object code, & pretty-printing source code.
@@ -45,7 +46,8 @@ public:
     AsmCode(const AsmCode& other);
     virtual ~AsmCode() = 0;
     // Cannot support operator= in AsmCode, it is pure virtual.
-    virtual AsmCode* cloneAsmCode() const = 0;
+    // Copy this line into arena, which owns the copy.
+    virtual AsmCode* cloneAsmCode(AsmCodeArena& arena) const = 0;
 
     bool hasSymbolEntry() const {return !symbolEntry.isNull();}
     // Before attempting to use the value return by this function, check if the symbol is null.
@@ -131,7 +133,7 @@ public:
     ~UnaryInstruction() override = default;
     UnaryInstruction(const UnaryInstruction& other);
     UnaryInstruction& operator=(UnaryInstruction other);
-    AsmCode *cloneAsmCode() const override;
+    AsmCode *cloneAsmCode(AsmCodeArena& arena) const override;
 
 
     void appendObjectCode(QList<int> &objectCode) const override;
@@ -173,7 +175,7 @@ public:
      ~NonUnaryInstruction() override = default;
     NonUnaryInstruction(const NonUnaryInstruction& other);
     NonUnaryInstruction& operator=(NonUnaryInstruction other);
-    AsmCode *cloneAsmCode() const override;
+    AsmCode *cloneAsmCode(AsmCodeArena& arena) const override;
     // ~NonUnaryInstruction() { delete argument; }
     void appendObjectCode(QList<int> &objectCode) const override;
 
@@ -219,7 +221,7 @@ public:
     ~DotAddrss() override = default;
     DotAddrss(const DotAddrss& other);
     DotAddrss& operator=(DotAddrss other);
-    AsmCode *cloneAsmCode() const override;
+    AsmCode *cloneAsmCode(AsmCodeArena& arena) const override;
      void appendObjectCode(QList<int> &objectCode) const override;
 
     // AsmCode interface
@@ -251,7 +253,7 @@ public:
     virtual ~DotAlign() override = default;
     DotAlign(const DotAlign& other);
     DotAlign& operator=(DotAlign other);
-    AsmCode *cloneAsmCode() const override;
+    AsmCode *cloneAsmCode(AsmCodeArena& arena) const override;
     void appendObjectCode(QList<int> &objectCode) const override;
 
     // AsmCode interface
@@ -285,7 +287,7 @@ public:
     ~DotAscii() override = default;
     DotAscii(const DotAscii& other);
     DotAscii& operator=(DotAscii other);
-    AsmCode *cloneAsmCode() const override;
+    AsmCode *cloneAsmCode(AsmCodeArena& arena) const override;
     void appendObjectCode(QList<int> &objectCode) const override;
 
     // AsmCode interface
@@ -314,7 +316,7 @@ public:
     ~DotBlock() override = default;
     DotBlock(const DotBlock& other);
     DotBlock& operator=(DotBlock other);
-    AsmCode *cloneAsmCode() const override;
+    AsmCode *cloneAsmCode(AsmCodeArena& arena) const override;
 
     void appendObjectCode(QList<int> &objectCode) const override;
     // AsmCode interface
@@ -346,7 +348,7 @@ public:
     virtual ~DotBurn() override = default;
     DotBurn(const DotBurn& other);
     DotBurn& operator=(DotBurn other);
-    AsmCode *cloneAsmCode() const override;
+    AsmCode *cloneAsmCode(AsmCodeArena& arena) const override;
 
     // AsmCode interface
     QString getAssemblerListing() const override;
@@ -374,7 +376,7 @@ public:
     ~DotByte() override = default;
     DotByte(const DotByte& other);
     DotByte& operator=(DotByte other);
-    AsmCode *cloneAsmCode() const override;
+    AsmCode *cloneAsmCode(AsmCodeArena& arena) const override;
     void appendObjectCode(QList<int> &objectCode) const override;
 
     // AsmCode interface
@@ -403,7 +405,7 @@ public:
     ~DotEnd() override = default;
     DotEnd(const DotEnd& other);
     DotEnd& operator=(DotEnd other);
-    AsmCode *cloneAsmCode() const override;
+    AsmCode *cloneAsmCode(AsmCodeArena& arena) const override;
     // AsmCode interface
     QString getAssemblerListing() const override;
     QString getAssemblerSource() const override;
@@ -425,7 +427,7 @@ public:
     ~DotEquate() override = default;
     DotEquate(const DotEquate& other);
     DotEquate& operator=(DotEquate other);
-    AsmCode *cloneAsmCode() const override;
+    AsmCode *cloneAsmCode(AsmCodeArena& arena) const override;
 
     // AsmCode interface
     QString getAssemblerListing() const override;
@@ -452,7 +454,7 @@ public:
     ~DotExport() override = default;
     DotExport(const DotExport& other);
     DotExport& operator=(DotExport other);
-    AsmCode *cloneAsmCode() const override;
+    AsmCode *cloneAsmCode(AsmCodeArena& arena) const override;
     void appendObjectCode(QList<int> &objectCode) const override;
 
     // AsmCode interface
@@ -481,7 +483,7 @@ public:
     ~DotSycall() override = default;
     DotSycall(const DotSycall& other);
     DotSycall& operator=(DotSycall other);
-    AsmCode *cloneAsmCode() const override;
+    AsmCode *cloneAsmCode(AsmCodeArena& arena) const override;
     void appendObjectCode(QList<int> &objectCode) const override;
 
     // AsmCode interface
@@ -510,7 +512,7 @@ public:
     ~DotUSycall() override = default;
     DotUSycall(const DotUSycall& other);
     DotUSycall& operator=(DotUSycall other);
-    AsmCode *cloneAsmCode() const override;
+    AsmCode *cloneAsmCode(AsmCodeArena& arena) const override;
     void appendObjectCode(QList<int> &objectCode) const override;
 
     // AsmCode interface
@@ -541,7 +543,7 @@ public:
     virtual ~DotWord() override = default;
     DotWord(const DotWord& other);
     DotWord& operator=(DotWord other);
-    AsmCode *cloneAsmCode() const override;
+    AsmCode *cloneAsmCode(AsmCodeArena& arena) const override;
 
     void appendObjectCode(QList<int> &objectCode) const override;
 
@@ -571,7 +573,7 @@ public:
     ~CommentOnly() override = default;
     CommentOnly(const CommentOnly& other);
     CommentOnly& operator=(CommentOnly other);
-    AsmCode *cloneAsmCode() const override;
+    AsmCode *cloneAsmCode(AsmCodeArena& arena) const override;
 
     // AsmCode interface
     QString getAssemblerListing() const override;
@@ -592,7 +594,7 @@ public:
     ~BlankLine() override = default;
     BlankLine(const BlankLine& other);
     BlankLine& operator=(BlankLine other);
-    AsmCode *cloneAsmCode() const override;
+    AsmCode *cloneAsmCode(AsmCodeArena& arena) const override;
 
     // AsmCode interface
     QString getAssemblerListing() const override;
@@ -615,7 +617,7 @@ public:
     ~MacroInvoke() override = default;
     MacroInvoke(const MacroInvoke& other);
     MacroInvoke& operator=(MacroInvoke other);
-    AsmCode *cloneAsmCode() const override;
+    AsmCode *cloneAsmCode(AsmCodeArena& arena) const override;
     void appendObjectCode(QList<int> &objectCode) const override;
     void adjustMemAddress(int addressDelta) override;
 
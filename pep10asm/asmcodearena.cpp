@@ -0,0 +1,49 @@
+#include "asmcodearena.h"
+#include "asmcode.h"
+
+AsmCodeArena::AsmCodeArena(size_t chunkSize): chunkSize(chunkSize)
+{
+
+}
+
+AsmCodeArena::~AsmCodeArena()
+{
+    // Lines may refer to lines constructed before them (e.g. a macro invocation
+    // and its instance), so destroy lines in the reverse order of construction.
+    for(auto it = lines.rbegin(); it != lines.rend(); ++it) {
+        (*it)->~AsmCode();
+    }
+    for(char* chunk : chunks) {
+        delete[] chunk;
+    }
+}
+
+int AsmCodeArena::lineCount() const
+{
+    return lines.size();
+}
+
+size_t AsmCodeArena::bytesReserved() const
+{
+    return reserved;
+}
+
+void *AsmCodeArena::allocate(size_t size, size_t alignment)
+{
+    // Number of bytes needed to align the cursor.
+    size_t padding = (alignment - reinterpret_cast<quintptr>(cursor) % alignment) % alignment;
+    if(cursor == nullptr || padding + size > remaining) {
+        // Freshly allocated chunks are suitably aligned for any line.
+        size_t newSize = std::max(chunkSize, size);
+        char* chunk = new char[newSize];
+        chunks.append(chunk);
+        reserved += newSize;
+        cursor = chunk;
+        remaining = newSize;
+        padding = 0;
+    }
+    void* storage = cursor + padding;
+    cursor += padding + size;
+    remaining -= padding + size;
+    return storage;
+}
@@ -0,0 +1,69 @@
+#ifndef ASMCODEARENA_H
+#define ASMCODEARENA_H
+
+#include <QtCore>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+class AsmCode;
+
+/*
+ * Owns every AsmCode line produced while assembling a program.
+ *
+ * Lines are placement-constructed into large chunks instead of being individually
+ * heap allocated and reference counted. Assembling, instancing, and linking a program
+ * therefore costs a handful of chunk allocations, and destroying the arena tears down
+ * every line at once.
+ *
+ * Code lists (ModuleInstance::codeList, AsmProgram::program) hold non-owning pointers
+ * into an arena. Whoever holds those lists must keep the arena alive, which is why
+ * both ModuleAssemblyGraph and AsmProgram hold a shared pointer to theirs.
+ *
+ * Lines are never freed individually. A line that is discarded (e.g. because of
+ * an assembly error) lives until the arena is destroyed.
+ */
+class AsmCodeArena
+{
+public:
+    // Size of each chunk of line storage. Objects larger than this get their own chunk.
+    static constexpr size_t defaultChunkSize = 64 * 1024;
+
+    explicit AsmCodeArena(size_t chunkSize = defaultChunkSize);
+    ~AsmCodeArena();
+    AsmCodeArena(const AsmCodeArena&) = delete;
+    AsmCodeArena& operator=(const AsmCodeArena&) = delete;
+
+    // Construct a line of type T in the arena. The arena owns the result,
+    // so the caller must never delete it.
+    template <typename T, typename... Args>
+    T* create(Args&&... args);
+
+    // Number of lines constructed in the arena.
+    int lineCount() const;
+    // Number of bytes reserved from the heap for line storage.
+    size_t bytesReserved() const;
+
+private:
+    void* allocate(size_t size, size_t alignment);
+
+    size_t chunkSize;
+    QVector<char*> chunks;
+    char* cursor = nullptr;
+    size_t remaining = 0;
+    size_t reserved = 0;
+    // Lines in construction order, so that they may be destroyed in reverse order.
+    QVector<AsmCode*> lines;
+};
+
+template <typename T, typename... Args>
+T* AsmCodeArena::create(Args&&... args)
+{
+    static_assert(std::is_base_of<AsmCode, T>::value, "Only lines of code may be placed in an AsmCodeArena.");
+    void* storage = allocate(sizeof(T), alignof(T));
+    T* line = new (storage) T(std::forward<Args>(args)...);
+    lines.append(line);
+    return line;
+}
+
+#endif // ASMCODEARENA_H
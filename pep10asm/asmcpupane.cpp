@@ -88,21 +88,28 @@ void AsmCpuPane::init(QSharedPointer<ACPUModel> cpu, QSharedPointer<InterfaceISA
 }
 
 void AsmCpuPane::updateCpu() {
-    Enu::EAddrMode addrMode = Pep::decodeAddrMode[acpu->getCPURegByteCurrent(Enu::CPURegisters::IS)];
+    SimulationSnapshot snapshot = acpu->captureSnapshot();
+    snapshot.operandValue = isacpu->getOperandValue();
+    updateCpu(snapshot);
+}
+
+void AsmCpuPane::updateCpu(const SimulationSnapshot &snapshot)
+{
+    Enu::EAddrMode addrMode = Pep::decodeAddrMode[snapshot.registerByte(Enu::CPURegisters::IS)];
 
-    ui->nLabel->setText(acpu->getStatusBitCurrent(Enu::EStatusBit::STATUS_N) ? "1" : "0");
-    ui->zLabel->setText(acpu->getStatusBitCurrent(Enu::EStatusBit::STATUS_Z) ? "1" : "0");
-    ui->vLabel->setText(acpu->getStatusBitCurrent(Enu::EStatusBit::STATUS_V) ? "1" : "0");
-    ui->cLabel->setText(acpu->getStatusBitCurrent(Enu::EStatusBit::STATUS_C) ? "1" : "0");
+    ui->nLabel->setText(snapshot.statusBit(Enu::EStatusBit::STATUS_N) ? "1" : "0");
+    ui->zLabel->setText(snapshot.statusBit(Enu::EStatusBit::STATUS_Z) ? "1" : "0");
+    ui->vLabel->setText(snapshot.statusBit(Enu::EStatusBit::STATUS_V) ? "1" : "0");
+    ui->cLabel->setText(snapshot.statusBit(Enu::EStatusBit::STATUS_C) ? "1" : "0");
 
     quint16 acc, idx, sp, pc, opsc;
     quint8 is;
-    acc = acpu->getCPURegWordCurrent(Enu::CPURegisters::A);
-    idx = acpu->getCPURegWordCurrent(Enu::CPURegisters::X);
-    sp = acpu->getCPURegWordCurrent(Enu::CPURegisters::SP);
-    pc = acpu->getCPURegWordCurrent(Enu::CPURegisters::PC);
-    opsc = acpu->getCPURegWordCurrent(Enu::CPURegisters::OS);
-    is = acpu->getCPURegByteCurrent(Enu::CPURegisters::IS);
+    acc = snapshot.registerWord(Enu::CPURegisters::A);
+    idx = snapshot.registerWord(Enu::CPURegisters::X);
+    sp = snapshot.registerWord(Enu::CPURegisters::SP);
+    pc = snapshot.registerWord(Enu::CPURegisters::PC);
+    opsc = snapshot.registerWord(Enu::CPURegisters::OS);
+    is = snapshot.registerByte(Enu::CPURegisters::IS);
     ui->accHexLabel->setText(QString("0x") + QString("%1").arg(acc, 4, 16, QLatin1Char('0')).toUpper());
     ui->accDecLabel->setText(QString("%1").arg(static_cast<qint16>(acc)));
 
@@ -138,7 +145,7 @@ void AsmCpuPane::updateCpu() {
                                                                          16, QLatin1Char('0')).toUpper());
         ui->oprndSpecDecLabel->setText(QString("%1").arg(static_cast<qint16>(opsc)));
 
-        quint16 opVal = isacpu->getOperandValue();
+        quint16 opVal = snapshot.operandValue;
 
         if(Pep::operandDisplayFieldWidth(Pep::decodeMnemonic[is]) == 2) {
             opVal &= 0xff;
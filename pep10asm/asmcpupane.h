@@ -30,6 +30,7 @@ namespace Ui {
 }
 class ACPUModel;
 class InterfaceISACPU;
+struct SimulationSnapshot;
 class AsmCpuPane : public QWidget {
     Q_OBJECT
     Q_DISABLE_COPY(AsmCpuPane)
@@ -44,6 +45,9 @@ public:
     void updateCpu();
     // Post: Updates CPU pane labels
 
+    void updateCpu(const SimulationSnapshot& snapshot);
+    // Post: Updates CPU pane labels from snapshot, without accessing the CPU
+
     void clearCpu();
     // Post: The CPU pane labels are blanked and the CPU registers are cleared
 
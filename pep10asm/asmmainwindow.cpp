@@ -47,6 +47,7 @@
 #include "asmprogram.h"
 #include "asmprogrammanager.h"
 #include "asmsourcecodepane.h"
+#include "isaprofiler.h"
 #include "asmprogramlistingpane.h"
 #include "byteconverterbin.h"
 #include "byteconverterchar.h"
@@ -63,6 +64,8 @@
 #include "memorydumppane.h"
 #include "updatechecker.h"
 #include "registerfile.h"
+#include "simulationsnapshot.h"
+#include "simulationthread.h"
 #include "symboltable.h"
 
 AsmMainWindow::AsmMainWindow(QWidget *parent) :
@@ -91,6 +94,14 @@ AsmMainWindow::AsmMainWindow(QWidget *parent) :
     ui->assemblerPane->init(programManager);
     ui->asmProgramTracePane->init(controlSection, programManager);
     ui->asmCpuPane->init(controlSection, controlSection);
+    snapshotPublisher = QSharedPointer<SnapshotPublisher>::create();
+    controlSection->setSnapshotPublisher(snapshotPublisher);
+    profiler = QSharedPointer<IsaProfiler>::create();
+    controlSection->setProfiler(profiler);
+    // Run the CPU on its own thread, so that long simulations never block the UI.
+    simulation = new SimulationThread(controlSection, memDevice, this);
+    stopRequested = false;
+    simulation->start();
 
     programManager->setMacroRegistry(macroRegistry);
 
@@ -126,8 +137,13 @@ AsmMainWindow::AsmMainWindow(QWidget *parent) :
 
     // Connect IOWidget to memory
     ui->ioWidget->bindToMemorySection(memDevice.get());
-    // Connect IO events
-    connect(memDevice.get(), &MainMemory::inputRequested, this, &AsmMainWindow::onInputRequested, Qt::QueuedConnection);
+    // Memory belongs to the simulation thread while running, so route typed input through it.
+    disconnect(ui->ioWidget, &IOWidget::inputReady, memDevice.get(), nullptr);
+    connect(ui->ioWidget, &IOWidget::inputReady, simulation, &SimulationThread::postInput);
+    // Connect IO events. The simulation waits for input on its own thread, so the request is handled while it is parked.
+    connect(memDevice.get(), &MainMemory::inputRequested, this, [this](quint16 address) {
+        simulation->invokeBlocking(this, [this, address]() { onInputRequested(address); });
+    }, Qt::DirectConnection);
     connect(memDevice.get(), &MainMemory::outputWritten, this, &AsmMainWindow::onOutputReceived, Qt::QueuedConnection);
 
     // Connect Undo / Redo events
@@ -137,6 +153,7 @@ AsmMainWindow::AsmMainWindow(QWidget *parent) :
     connect(ui->ioWidget, &IOWidget::redoAvailable, this, &AsmMainWindow::setRedoability);
 
     // Connect simulation events.
+    connect(snapshotPublisher.get(), &SnapshotPublisher::frameReady, this, &AsmMainWindow::onSimulationFrame, Qt::QueuedConnection);
     // Events that fire on simulationUpdate should be UniqueConnections, as they will be repeatedly connected and disconnected
     // via connectMicroDraw() and disconnectMicroDraw().
     connect(this, &AsmMainWindow::simulationUpdate, ui->asmCpuPane, &AsmCpuPane::onSimulationUpdate, Qt::UniqueConnection);
@@ -145,19 +162,26 @@ AsmMainWindow::AsmMainWindow(QWidget *parent) :
     connect(this, &AsmMainWindow::simulationStarted, ui->memoryTracePane, &NewMemoryTracePane::onSimulationStarted);
 
     connect(this, &AsmMainWindow::simulationStarted, ui->asmCpuPane, &AsmCpuPane::onSimulationUpdate, Qt::UniqueConnection);
-    connect(controlSection.get(), &IsaCpu::hitBreakpoint, this, &AsmMainWindow::onBreakpointHit);
+    // Views inspect the CPU when it stops, so park the simulation until they have.
+    connect(controlSection.get(), &IsaCpu::hitBreakpoint, this, [this](Enu::BreakpointTypes type) {
+        simulation->invokeBlocking(this, [this, type]() { onBreakpointHit(type); });
+    }, Qt::DirectConnection);
 
     // Clear IOWidget every time a simulation is started.
     connect(this, &AsmMainWindow::simulationStarted, ui->ioWidget, &IOWidget::onClear);
     connect(this, &AsmMainWindow::simulationStarted, ui->ioWidget, &IOWidget::onSimulationStart);
 
     // Post finished events to the event queue so that they are processed after simulation updates.
-    connect(this, &AsmMainWindow::simulationFinished, controlSection.get(), &IsaCpu::onSimulationFinished, Qt::QueuedConnection);
+    connect(this, &AsmMainWindow::simulationFinished, simulation, [this]() {
+        simulation->step([this]() { controlSection->onSimulationFinished(); });
+    }, Qt::QueuedConnection);
     connect(this, &AsmMainWindow::simulationFinished, ui->memoryWidget, &MemoryDumpPane::onSimulationFinished, Qt::QueuedConnection);
     connect(this, &AsmMainWindow::simulationFinished, ui->memoryTracePane, &NewMemoryTracePane::onSimulationFinished, Qt::QueuedConnection);
     connect(this, &AsmMainWindow::simulationFinished, ui->asmCpuPane, &AsmCpuPane::onSimulationUpdate, Qt::UniqueConnection);
     // Connect MainWindow so that it can propogate simulationFinished event and clean up when execution is finished.
-    connect(controlSection.get(), &IsaCpu::simulationFinished, this, &AsmMainWindow::onSimulationFinished);
+    connect(controlSection.get(), &IsaCpu::simulationFinished, this, [this]() {
+        simulation->invokeBlocking(this, [this]() { onSimulationFinished(); });
+    }, Qt::DirectConnection);
 
 
     // Connect simulation events that are internal to the class.
@@ -227,6 +251,7 @@ AsmMainWindow::AsmMainWindow(QWidget *parent) :
 
 AsmMainWindow::~AsmMainWindow()
 {
+    simulation->shutdown();
     delete ui;
     delete helpDialog;
     delete aboutPepDialog;
@@ -253,6 +278,8 @@ void AsmMainWindow::closeEvent(QCloseEvent *event)
         // the entire application alive.
         helpDialog->close();
         writeSettings();
+        // Stop the simulation while the views it reports to still exist.
+        simulation->shutdown();
         event->accept();
     }
     else {
@@ -317,6 +344,8 @@ void AsmMainWindow::connectViewUpdate()
     connect(this, &AsmMainWindow::simulationUpdate, this, static_cast<void(AsmMainWindow::*)()>(&AsmMainWindow::highlightActiveLines), Qt::UniqueConnection);
     // If application is running, active lines shouldn't be highlighted at the begin of the instruction, as this would be misleading.
     connect(this, &AsmMainWindow::simulationStarted, this, static_cast<void(AsmMainWindow::*)()>(&AsmMainWindow::highlightActiveLines), Qt::UniqueConnection);
+    // Views are refreshed directly again, so a frame that was not yet displayed would only show stale state.
+    snapshotPublisher->clear();
 }
 
 void AsmMainWindow::disconnectViewUpdate()
@@ -1104,6 +1133,20 @@ void AsmMainWindow::on_actionBuild_Load_Object_triggered()
 
 void AsmMainWindow::on_actionBuild_Execute_triggered()
 {
+    auto finish = [this]() {
+        // If the simulator finished, then propogate that information to connect components.
+        if(controlSection->getExecutionFinished()) {
+            debugState = DebugState::DISABLED;
+            onSimulationFinished();
+            emit simulationFinished();
+        }
+        // Otherwise, the simulator paused execution, so don't explicitly terminate
+        // the simulator.
+        else {
+            handleDebugButtons();
+            emit simulationUpdate();
+        }
+    };
     loadOperatingSystem();
     debugState = DebugState::RUN;
     if (initializeSimulation()) {
@@ -1112,28 +1155,32 @@ void AsmMainWindow::on_actionBuild_Execute_triggered()
         ui->memoryWidget->clearHighlight();
         ui->memoryWidget->refreshMemory();
         controlSection->onSimulationStarted();
-        controlSection->onRun();
-        connectViewUpdate();
+        simulation->runSimulation([this, finish]() {
+            connectViewUpdate();
+            finish();
+        });
     }
     else {
         debugState = DebugState::DISABLED;
-    }
-    // If the simulator finished, then propogate that information to connect components.
-    if(controlSection->getExecutionFinished()) {
-        debugState = DebugState::DISABLED;
-        onSimulationFinished();
-        emit simulationFinished();
-    }
-    // Otherwise, the simulator paused execution, so don't explicitly terminate
-    // the simulator.
-    else {
-        handleDebugButtons();
-        emit simulationUpdate();
+        finish();
     }
 }
 
 void AsmMainWindow::on_actionBuild_Run_triggered()
 {
+    auto finish = [this]() {
+        // If the simulator finished, then propogate that information to connect components.
+        if(controlSection->getExecutionFinished()) {
+            debugState = DebugState::DISABLED;
+            onSimulationFinished();
+        }
+        // Otherwise, the simulator paused execution, so don't explicitly terminate
+        // the simulator.
+        else {
+            handleDebugButtons();
+            emit simulationUpdate();
+        }
+    };
     if(!on_actionBuild_Assemble_triggered()) return;
     loadOperatingSystem();
     loadObjectCodeProgram();
@@ -1147,23 +1194,14 @@ void AsmMainWindow::on_actionBuild_Run_triggered()
         ui->memoryWidget->updateMemory();
         ui->memoryTracePane->updateTrace();
         controlSection->onSimulationStarted();
-        controlSection->onRun();
-        connectViewUpdate();
-
+        simulation->runSimulation([this, finish]() {
+            connectViewUpdate();
+            finish();
+        });
     }
     else {
         debugState = DebugState::DISABLED;
-    }
-    // If the simulator finished, then propogate that information to connect components.
-    if(controlSection->getExecutionFinished()) {
-        debugState = DebugState::DISABLED;
-        onSimulationFinished();
-    }
-    // Otherwise, the simulator paused execution, so don't explicitly terminate
-    // the simulator.
-    else {
-        handleDebugButtons();
-        emit simulationUpdate();
+        finish();
     }
 }
 
@@ -1292,6 +1330,18 @@ bool AsmMainWindow::on_actionDebug_Start_Debugging_Loader_triggered()
 
 void AsmMainWindow::on_actionDebug_Stop_Debugging_triggered()
 {
+    // A running simulation must first unwind on its own thread, so reset the views once it has.
+    if(simulation->isBusy()) {
+        if(!stopRequested) {
+            stopRequested = true;
+            simulation->cancel();
+            simulation->step({}, [this]() {
+                stopRequested = false;
+                on_actionDebug_Stop_Debugging_triggered();
+            });
+        }
+        return;
+    }
     connectViewUpdate();
     highlightActiveLines();
     debugState = DebugState::DISABLED;
@@ -1324,14 +1374,18 @@ void AsmMainWindow::on_actionDebug_Single_Step_Assembler_triggered()
 void AsmMainWindow::on_actionDebug_Interupt_Execution_triggered()
 {
     // Enable debugging in CPU and then temporarily pause execution.
-    controlSection->enableDebugging();
-    controlSection->forceBreakpoint(Enu::BreakpointTypes::ASSEMBLER);
-    connectViewUpdate();
-    debugState = DebugState::DEBUG_ISA;
-    highlightActiveLines();
-    handleDebugButtons();
-    // Switch to debugger tab if it is not already visibile.
-    ui->tabWidget->setCurrentIndex(ui->tabWidget->indexOf(ui->debuggerTab));
+    simulation->interrupt();
+    // Execution pauses on the simulation thread, so only update the views once it has.
+    simulation->step({}, [this]() {
+        // The program may have finished before the interrupt was handled.
+        if(debugState == DebugState::DISABLED) return;
+        connectViewUpdate();
+        debugState = DebugState::DEBUG_ISA;
+        highlightActiveLines();
+        handleDebugButtons();
+        // Switch to debugger tab if it is not already visibile.
+        ui->tabWidget->setCurrentIndex(ui->tabWidget->indexOf(ui->debuggerTab));
+    });
 }
 
 void AsmMainWindow::on_actionDebug_Continue_triggered()
@@ -1339,16 +1393,16 @@ void AsmMainWindow::on_actionDebug_Continue_triggered()
     debugState = DebugState::DEBUG_RESUMED;
     handleDebugButtons();
     disconnectViewUpdate();
-    controlSection->onRun();
-    if(controlSection->hadErrorOnStep()) {
-        return; // we'll just return here instead of letting it fail and go to the bottom
-    }
-    connectViewUpdate();
-    if(controlSection->stoppedForBreakpoint()) {
-        emit simulationUpdate();
-        QApplication::processEvents();
-        highlightActiveLines();
-    }
+    simulation->runSimulation([this]() {
+        if(controlSection->hadErrorOnStep()) {
+            return; // we'll just return here instead of letting it fail and go to the bottom
+        }
+        connectViewUpdate();
+        if(controlSection->stoppedForBreakpoint()) {
+            emit simulationUpdate();
+            highlightActiveLines();
+        }
+    });
 }
 
 void AsmMainWindow::on_actionDebug_Step_Over_Assembler_triggered()
@@ -1360,24 +1414,24 @@ void AsmMainWindow::on_actionDebug_Step_Over_Assembler_triggered()
     // until this step finishes.
     debugState = DebugState::DEBUG_RESUMED;
     handleDebugButtons();
-    controlSection->stepOver();
-    // The step has finished. The program may have been canceled
-    // during the execution of that step, so only transition to
-    // debugging at the ISA level if the simulation is still ongoing.
-    if(debugState != DebugState::DISABLED) {
-            // Actions will be refreshed on simulationUpdate.
-            debugState = DebugState::DEBUG_ISA;
-    }
-    connectViewUpdate();
-    emit simulationUpdate();
+    simulation->step([this]() { controlSection->stepOver(); }, [this]() {
+        // The step has finished. The program may have been canceled
+        // during the execution of that step, so only transition to
+        // debugging at the ISA level if the simulation is still ongoing.
+        if(debugState != DebugState::DISABLED) {
+                // Actions will be refreshed on simulationUpdate.
+                debugState = DebugState::DEBUG_ISA;
+        }
+        connectViewUpdate();
+        emit simulationUpdate();
+    });
 }
 
 void AsmMainWindow::on_actionDebug_Step_Into_Assembler_triggered()
 {
     debugState = DebugState::DEBUG_ISA;
     ui->tabWidget->setCurrentIndex(ui->tabWidget->indexOf(ui->debuggerTab));
-    controlSection->stepInto();
-    emit simulationUpdate();
+    simulation->step([this]() { controlSection->stepInto(); }, [this]() { emit simulationUpdate(); });
 }
 
 void AsmMainWindow::on_actionDebug_Step_Out_Assembler_triggered()
@@ -1390,16 +1444,17 @@ void AsmMainWindow::on_actionDebug_Step_Out_Assembler_triggered()
     // until this step finishes.
     debugState = DebugState::DEBUG_RESUMED;
     handleDebugButtons();
-    controlSection->stepOut();
-    // The step has finished. The program may have been canceled
-    // during the execution of that step, so only transition to
-    // debugging at the ISA level if the simulation is still ongoing.
-    if(debugState != DebugState::DISABLED) {
-            // Actions will be refreshed on simulationUpdate.
-            debugState = DebugState::DEBUG_ISA;
-    }
-    connectViewUpdate();
-    emit simulationUpdate();
+    simulation->step([this]() { controlSection->stepOut(); }, [this]() {
+        // The step has finished. The program may have been canceled
+        // during the execution of that step, so only transition to
+        // debugging at the ISA level if the simulation is still ongoing.
+        if(debugState != DebugState::DISABLED) {
+                // Actions will be refreshed on simulationUpdate.
+                debugState = DebugState::DEBUG_ISA;
+        }
+        connectViewUpdate();
+        emit simulationUpdate();
+    });
 }
 
 void AsmMainWindow::onASMBreakpointHit()
@@ -1457,6 +1512,33 @@ void AsmMainWindow::on_actionSystem_Reinstall_Default_OS_triggered()
     ui->memoryWidget->refreshMemory();
 }
 
+void AsmMainWindow::on_actionSystem_Export_Profile_triggered()
+{
+    // The profile is written by the simulation thread while a program runs.
+    if(simulation->isBusy()) {
+        ui->statusBar->showMessage("Stop execution before exporting the profile", 4000);
+        return;
+    }
+    QString fileName = QFileDialog::getSaveFileName(
+                this,
+                "Export Profile",
+                QDir(curPath).absoluteFilePath("profile.folded"),
+                "Folded stacks (*.folded *.txt)");
+    if (fileName.isEmpty()) return;
+    QFile file(fileName);
+    if (!file.open(QFile::WriteOnly | QFile::Text)) {
+        QMessageBox::warning(this, tr("Pep/9 Micro"),
+                             tr("Cannot write file %1:\n%2.")
+                             .arg(fileName)
+                             .arg(file.errorString()));
+        return;
+    }
+    // Name functions by the labels of the loaded programs, like the listing does.
+    QTextStream(&file) << profiler->getFoldedStacks(IsaProfiler::symbolNamer(programManager));
+    curPath = QFileInfo(fileName).absolutePath();
+    ui->statusBar->showMessage("Profile exported", 4000);
+}
+
 void AsmMainWindow::onSimulationFinished()
 {
     QString errorString;
@@ -1473,6 +1555,14 @@ void AsmMainWindow::onSimulationFinished()
 
 }
 
+void AsmMainWindow::onSimulationFrame()
+{
+    QSharedPointer<const SimulationSnapshot> snapshot = snapshotPublisher->takeLatest();
+    if(snapshot.isNull()) return;
+    ui->memoryWidget->refreshPages(*snapshot);
+    ui->asmCpuPane->updateCpu(*snapshot);
+}
+
 void AsmMainWindow::onDarkModeChanged()
 {
     isInDarkMode = inDarkMode();
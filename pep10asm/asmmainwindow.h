@@ -41,6 +41,7 @@ class ByteConverterHex;
 class ByteConverterInstr;
 class CpuPane;
 class AsmHelpDialog;
+class IsaProfiler;
 class MicrocodePane;
 class MicroObjectCodePane;
 class UpdateChecker;
@@ -48,6 +49,8 @@ class UpdateChecker;
 //WIP classes
 class IsaCpu;
 class MainMemory;
+class SimulationThread;
+class SnapshotPublisher;
 
 /*
  * The set of possible states for the debugger.
@@ -88,6 +91,14 @@ private:
     // Main Memory
     QSharedPointer<MainMemory> memDevice;
     QSharedPointer<IsaCpu> controlSection;
+    // Snapshots the CPU publishes while running, so that views refresh once per frame.
+    QSharedPointer<SnapshotPublisher> snapshotPublisher;
+    // Profile of the most recent run, which may be exported as folded stacks.
+    QSharedPointer<IsaProfiler> profiler;
+    // Thread running the CPU. Only touch the CPU or memory from the UI while it is not busy.
+    SimulationThread* simulation;
+    // Set while waiting for a canceled simulation to unwind, so that the views are only reset once.
+    bool stopRequested;
 
     // Dialogues
     AsmHelpDialog *helpDialog;
@@ -210,6 +221,7 @@ private slots:
     void on_actionSystem_Clear_Memory_triggered();
     void on_actionSystem_Assemble_Install_New_OS_triggered();
     void on_actionSystem_Reinstall_Default_OS_triggered();
+    void on_actionSystem_Export_Profile_triggered();
 
     // Help
     void on_actionHelp_triggered();
@@ -234,6 +246,8 @@ private slots:
 
     //Run events
     void onSimulationFinished();
+    // Refresh views from the latest snapshot published by a running simulation.
+    void onSimulationFrame();
 
     // Byte converter
     void slotByteConverterDecEdited(const QString &);
@@ -21,23 +21,66 @@
 
 #include "asmprogram.h"
 #include "asmcode.h"
+#include "asmcodearena.h"
 #include "symboltable.h"
 #include "symbolentry.h"
+#include "typetags.h"
 
 StaticTraceInfo::StaticTraceInfo(): staticTraceError(false), hadTraceTags(false), dynamicAllocSymbolTypes(), staticAllocSymbolTypes(),
-    instrToSymlist(), hasHeapMalloc(), heapPtr(), mallocPtr()
+    instrToSymlist(), hasHeapMalloc(), heapPtr(), mallocPtr(), types(), instrToTypes(), staticAllocSymbolRanges()
 {
 
 }
 
-AsmProgram::AsmProgram(): program(), indexToMemAddress(), memAddressToIndex(), symTable(QSharedPointer<SymbolTable>(new SymbolTable())),
+void StaticTraceInfo::flattenTypes()
+{
+    types.clear();
+    instrToTypes.clear();
+    staticAllocSymbolRanges.clear();
+    // Appending to types may move its elements, so remember each range by index until it is complete.
+    auto flatten = [this](const QList<QSharedPointer<AType>>& tags) {
+        int begin = types.size();
+        for(const auto& tag : tags) {
+            for(const auto& primitive : tag->toPrimitives()) {
+                types.append(TraceType{primitive.first, primitive.second});
+            }
+        }
+        return QPair<int, int>(begin, types.size());
+    };
+    QList<QPair<quint16, QPair<int, int>>> instrIndices;
+    for(auto it = instrToSymlist.cbegin(); it != instrToSymlist.cend(); ++it) {
+        instrIndices.append({it.key(), flatten(it.value())});
+    }
+    QList<QPair<QSharedPointer<const SymbolEntry>, QPair<int, int>>> staticIndices;
+    for(auto it = staticAllocSymbolTypes.cbegin(); it != staticAllocSymbolTypes.cend(); ++it) {
+        staticIndices.append({it.key(), flatten({it.value()})});
+    }
+
+    auto toRange = [this](QPair<int, int> indices) {
+        TraceTypeRange range;
+        range.begin = types.constData() + indices.first;
+        range.end = types.constData() + indices.second;
+        for(auto type = range.begin; type != range.end; ++type) {
+            range.size += Enu::tagNumBytes(type->format);
+        }
+        return range;
+    };
+    for(const auto& instr : instrIndices) {
+        instrToTypes.insert(instr.first, toRange(instr.second));
+    }
+    for(const auto& symbol : staticIndices) {
+        staticAllocSymbolRanges.insert(symbol.first, toRange(symbol.second));
+    }
+}
+
+AsmProgram::AsmProgram(): codeArena(), program(), indexToMemAddress(), memAddressToIndex(), symTable(QSharedPointer<SymbolTable>(new SymbolTable())),
     traceInfo(), burn(false), burnAddress(0), burnValue(0)
 {
 
 }
 
-AsmProgram::AsmProgram(QList<QSharedPointer<AsmCode> > programList, QSharedPointer<SymbolTable> symbolTable,
-                       QSharedPointer<const StaticTraceInfo> traceInfo): program(programList),
+AsmProgram::AsmProgram(QList<AsmCode *> programList, QSharedPointer<AsmCodeArena> codeArena, QSharedPointer<SymbolTable> symbolTable,
+                       QSharedPointer<const StaticTraceInfo> traceInfo): codeArena(codeArena), program(programList),
     indexToMemAddress(), memAddressToIndex(), symTable(symbolTable), traceInfo(traceInfo), burn(false), burnAddress(0), burnValue(0)
 {
     programByteLength = 0;
@@ -51,8 +94,8 @@ AsmProgram::AsmProgram(QList<QSharedPointer<AsmCode> > programList, QSharedPoint
     programBounds = {static_cast<quint16>(start), static_cast<quint16>(start-1+programByteLength)};
 }
 
-AsmProgram::AsmProgram(QList<QSharedPointer<AsmCode> > programList, QSharedPointer<SymbolTable> symbolTable,
-                       QSharedPointer<const StaticTraceInfo> traceInfo, quint16 burnAddress, quint16 burnValue) : program(programList),
+AsmProgram::AsmProgram(QList<AsmCode *> programList, QSharedPointer<AsmCodeArena> codeArena, QSharedPointer<SymbolTable> symbolTable,
+                       QSharedPointer<const StaticTraceInfo> traceInfo, quint16 burnAddress, quint16 burnValue) : codeArena(codeArena), program(programList),
     indexToMemAddress(), memAddressToIndex(), symTable(symbolTable), traceInfo(traceInfo),
     burn(true), burnAddress(burnAddress), burnValue(burnValue)
 {
@@ -82,7 +125,7 @@ const QVector<quint8> AsmProgram::getObjectCode() const
 {
     QVector<quint8> vect;
     QList<int> objCode;
-    for(QSharedPointer<AsmCode> line : program) {
+    for(const AsmCode* line : program) {
         // If a line of code occurs before a burn, it can't emit object code
         if(hasBurn() && line->getMemoryAddress()<getBurnAddress()) continue;
         line->appendObjectCode(objCode);
@@ -94,7 +137,7 @@ const QVector<quint8> AsmProgram::getObjectCode() const
     return vect;
 }
 
-const QList<QSharedPointer<AsmCode> > AsmProgram::getProgram() const
+const QList<AsmCode *> AsmProgram::getProgram() const
 {
     return program;
 }
@@ -127,18 +170,19 @@ quint16 AsmProgram::getBurnValue() const
 AsmCode *AsmProgram::getCodeAtIndex(quint32 line)
 {
     if(line >= static_cast<quint32>(program.length())) return nullptr;
-    else return program[static_cast<int>(line)].data();
+    else return program[static_cast<int>(line)];
 }
 
 const AsmCode *AsmProgram::getCodeAtIndex(quint32 line) const
 {
     if(line >= static_cast<quint32>(program.length())) return nullptr;
-    else return program[static_cast<int>(line)].data();
+    else return program[static_cast<int>(line)];
 }
 
 const AsmCode *AsmProgram::memAddressToCode(quint16 memAddress) const
 {
-    if(memAddressToIndex.contains(memAddress)) return program[memAddressToIndex[memAddress]].data();
+    auto index = memAddressToIndex.constFind(memAddress);
+    if(index != memAddressToIndex.constEnd()) return program[*index];
     else return nullptr;
 }
 
@@ -29,9 +29,26 @@
 #include "enu.h"
 class AType;
 class AsmCode;
+class AsmCodeArena;
 class SymbolEntry;
 class SymbolTable;
 
+// A primitive field of a trace tag, such as one member of a struct.
+struct TraceType
+{
+    Enu::ESymbolFormat format;
+    QString name;
+};
+
+// The primitive fields of a list of trace tags, which are contiguous in StaticTraceInfo::types.
+struct TraceTypeRange
+{
+    const TraceType* begin = nullptr;
+    const TraceType* end = nullptr;
+    // Number of bytes spanned by the fields.
+    quint16 size = 0;
+};
+
 // Contains meta-info about the formats and types of symbols in a program
 struct StaticTraceInfo
 {
@@ -48,6 +65,15 @@ struct StaticTraceInfo
     bool hasHeapMalloc;
     // If they exist, store the pointer to their values
     QSharedPointer<const SymbolEntry> heapPtr, mallocPtr;
+
+    // The primitive fields of every type above, flattened so that the memory trace can refer to
+    // them by pointer instead of building lists of names on every instruction.
+    QVector<TraceType> types;
+    // Same as instrToSymlist and staticAllocSymbolTypes, but as ranges of types.
+    QMap<quint16, TraceTypeRange> instrToTypes;
+    QMap<QSharedPointer<const SymbolEntry>, TraceTypeRange> staticAllocSymbolRanges;
+    // Rebuild types and the ranges into it. Must be called after the other fields are complete.
+    void flattenTypes();
 };
 
 
@@ -55,14 +81,15 @@ class AsmProgram
 {
 public:
     explicit AsmProgram();
-    explicit AsmProgram(QList<QSharedPointer<AsmCode>> programList, QSharedPointer<SymbolTable> symbolTable, QSharedPointer<const StaticTraceInfo> traceInfo);
-    explicit AsmProgram(QList<QSharedPointer<AsmCode>> programList, QSharedPointer<SymbolTable> symbolTable, QSharedPointer<const StaticTraceInfo> traceInfo, quint16 burnAddress, quint16 burnValue);
+    // The lines of programList must be owned by codeArena, which the program keeps alive.
+    explicit AsmProgram(QList<AsmCode*> programList, QSharedPointer<AsmCodeArena> codeArena, QSharedPointer<SymbolTable> symbolTable, QSharedPointer<const StaticTraceInfo> traceInfo);
+    explicit AsmProgram(QList<AsmCode*> programList, QSharedPointer<AsmCodeArena> codeArena, QSharedPointer<SymbolTable> symbolTable, QSharedPointer<const StaticTraceInfo> traceInfo, quint16 burnAddress, quint16 burnValue);
     ~AsmProgram();
 
     // Getters and setters for program features
     quint16 getProgramLength() const;
     const QVector<quint8> getObjectCode() const;
-    const QList<QSharedPointer<AsmCode>> getProgram() const;
+    const QList<AsmCode*> getProgram() const;
     QSharedPointer<SymbolTable> getSymbolTable();
     const QSharedPointer<SymbolTable> getSymbolTable() const;
 
@@ -90,7 +117,8 @@ public:
 
 private:
     QPair<quint16, quint16> programBounds;
-    QList<QSharedPointer<AsmCode>> program;
+    QSharedPointer<AsmCodeArena> codeArena;
+    QList<AsmCode*> program;
     QMap<int, quint16> indexToMemAddress;
     QMap<quint16, int> memAddressToIndex;
     quint16 programByteLength;
@@ -54,7 +54,7 @@ AsmProgramListingPane::~AsmProgramListingPane()
 void AsmProgramListingPane::setAssemblerListing(QSharedPointer<AsmProgram> program, QSharedPointer<SymbolTable> symTable) {
     clearAssemblerListing();
     ui->plainTextEdit->appendPlainText(program->getProgramListing());
-    if(!symTable->getSymbolMap().isEmpty()) {
+    if(!symTable->isEmpty()) {
         ui->plainTextEdit->appendPlainText(symTable->getSymbolTableListing());
     }
     ui->plainTextEdit->verticalScrollBar()->setValue(ui->plainTextEdit->verticalScrollBar()->minimum());
@@ -9,7 +9,8 @@
 #include "symbolentry.h"
 
 AsmProgramManager* AsmProgramManager::instance = nullptr;
-AsmProgramManager::AsmProgramManager(QObject *parent): QObject(parent), operatingSystem(nullptr), userProgram(nullptr)
+AsmProgramManager::AsmProgramManager(QObject *parent): QObject(parent), operatingSystem(nullptr), userProgram(nullptr),
+    addressTable(1 << 16)
 {
     userProgram.clear();
     operatingSystem.clear();
@@ -44,6 +45,7 @@ QSharedPointer<const AsmProgram> AsmProgramManager::getUserProgram() const
 void AsmProgramManager::setOperatingSystem(QSharedPointer<AsmProgram> prog)
 {
     operatingSystem = prog;
+    rebuildAddressTable();
 }
 
 quint16 AsmProgramManager::getMemoryVectorValue(MemoryVectors vector) const
@@ -65,23 +67,12 @@ quint16 AsmProgramManager::getMemoryVectorValue(MemoryVectors vector) const
 void AsmProgramManager::setUserProgram(QSharedPointer<AsmProgram>prog)
 {
     userProgram = prog;
+    rebuildAddressTable();
 }
 
 AsmProgram *AsmProgramManager::getProgramAt(quint16 address)
 {
-    if(!userProgram.isNull()) {
-
-        if(userProgram->getProgramBounds().first <= address && userProgram->getProgramBounds().second >= address){
-            return userProgram.data();
-        }
-    }
-    else if(!operatingSystem.isNull()) {
-
-        if(operatingSystem->getProgramBounds().first <= address && operatingSystem->getProgramBounds().second >= address){
-            return operatingSystem.data();
-        }
-    }
-    return nullptr;
+    return addressTable[address].program;
 }
 
 QSet<quint16> AsmProgramManager::getBreakpoints() const
@@ -91,7 +82,7 @@ QSet<quint16> AsmProgramManager::getBreakpoints() const
     if(!userProgram.isNull()) progsList.append(userProgram);
     if(!operatingSystem.isNull()) progsList.append(operatingSystem);
     for(QSharedPointer<AsmProgram> prog : progsList) {
-        for(QSharedPointer<AsmCode> code : prog->getProgram())
+        for(const AsmCode* code : prog->getProgram())
         {
             if(code->hasBreakpoint()) {
                 quint16 addr = static_cast<quint16>(code->getMemoryAddress());
@@ -114,19 +105,39 @@ void AsmProgramManager::setMacroRegistry(QSharedPointer<MacroRegistry> macroRegi
 
 const AsmProgram *AsmProgramManager::getProgramAt(quint16 address) const
 {
-    if(!userProgram.isNull()) {
+    return addressTable[address].program;
+}
 
-        if(userProgram->getProgramBounds().first <= address && userProgram->getProgramBounds().second >= address){
-            return userProgram.data();
-        }
-    }
-    else if(!operatingSystem.isNull()) {
+const AsmProgramManager::AddressInfo &AsmProgramManager::getAddressInfo(quint16 address) const
+{
+    return addressTable[address];
+}
 
-        if(operatingSystem->getProgramBounds().first <= address && operatingSystem->getProgramBounds().second >= address){
-            return operatingSystem.data();
+void AsmProgramManager::rebuildAddressTable()
+{
+    addressTable.fill(AddressInfo());
+    // The operating system is only searched when there is no user program.
+    AsmProgram* prog = !userProgram.isNull() ? userProgram.data() : operatingSystem.data();
+    if(prog == nullptr) return;
+    QSharedPointer<const StaticTraceInfo> traceInfo = prog->getTraceInfo();
+    auto bounds = prog->getProgramBounds();
+    for(quint32 address = bounds.first; address <= bounds.second; address++) {
+        AddressInfo& info = addressTable[static_cast<int>(address)];
+        info.program = prog;
+        if(prog == userProgram.data()) info.flags |= AddressInfo::InUserProgram;
+        info.code = prog->memAddressToCode(static_cast<quint16>(address));
+        if(!traceInfo.isNull()) {
+            auto types = traceInfo->instrToTypes.constFind(static_cast<quint16>(address));
+            if(types != traceInfo->instrToTypes.constEnd()) info.traceTypes = &types.value();
+        }
+        auto instr = dynamic_cast<const NonUnaryInstruction*>(info.code);
+        if(instr == nullptr) continue;
+        info.flags |= AddressInfo::NonUnary;
+        if(instr->getMnemonic() == Enu::EMnemonic::CALL) info.flags |= AddressInfo::Call;
+        if(instr->hasSymbolicOperand() && instr->getSymbolicOperand()->getName() == "malloc") {
+            info.flags |= AddressInfo::CallsMalloc;
         }
     }
-    return nullptr;
 }
 
 void AsmProgramManager::onBreakpointAdded(quint16 address)
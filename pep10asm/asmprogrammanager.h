@@ -25,9 +25,12 @@
 #include <QObject>
 #include <QSharedPointer>
 #include <QSet>
+#include <QVector>
 #include "isaasm.h"
+class AsmCode;
 class AsmProgram;
 class SymbolTable;
+struct TraceTypeRange;
 class MacroRegistry;
 /*
  * A class to manage the lifetime of user programs & the operating system.
@@ -44,6 +47,29 @@ public:
         QList<QPair<int, QString>> errors;
         bool success;
     };
+    /*
+     * Everything the simulator needs to know about the code at an address, precomputed whenever a
+     * program is loaded so that per-instruction bookkeeping needs no map lookups or string comparisons.
+     */
+    struct AddressInfo {
+        enum Flags : quint8 {
+            // The address is inside of the user program.
+            InUserProgram = 1 << 0,
+            // The line starting at the address is an instruction with an operand specifier.
+            NonUnary = 1 << 1,
+            // ... whose mnemonic is CALL.
+            Call = 1 << 2,
+            // ... whose operand specifier is the symbol malloc.
+            CallsMalloc = 1 << 3,
+        };
+        // Same as getProgramAt(address).
+        AsmProgram* program = nullptr;
+        // Same as program->memAddressToCode(address).
+        const AsmCode* code = nullptr;
+        // Types of the trace tags of the instruction at the address, or nullptr if it has none.
+        const TraceTypeRange* traceTypes = nullptr;
+        quint8 flags = 0;
+    };
     QSharedPointer<AsmOutput> assembleOS(QString sourceCode, bool forceBurnAt0xFFFF);
     QSharedPointer<AsmOutput> assembleProgram(QString sourceCode);
     /*
@@ -73,6 +99,7 @@ public:
     // Return the program that contains the address
     const AsmProgram* getProgramAt(quint16 address) const;
     AsmProgram* getProgramAt(quint16 address);
+    const AddressInfo& getAddressInfo(quint16 address) const;
 
     // Return all breakpoints for the program counter
     QSet<quint16> getBreakpoints() const;
@@ -96,7 +123,9 @@ private:
     QSharedPointer<AsmProgram> operatingSystem;
     QSharedPointer<AsmProgram> userProgram;
     QSharedPointer<MacroRegistry> macroRegistry;
-
+    // For each of the 2^16 addresses, information about the code at that address.
+    QVector<AddressInfo> addressTable;
+    void rebuildAddressTable();
 };
 
 #endif // ASMPROGRAMMANAGER_H
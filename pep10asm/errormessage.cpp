@@ -88,21 +88,21 @@ int FrontEndError::getListingLineNumber() const
     return -1;
 }
 
-BackEndError::BackEndError(quint32 instanceIndex, Severity severity, QString message, QSharedPointer<AsmCode> line):
+BackEndError::BackEndError(quint32 instanceIndex, Severity severity, QString message, const AsmCode *line):
     AErrorMessage(instanceIndex, severity, Stage::BACKEND, message),
-    line(std::move(line))
+    sourceLineNumber(line->getSourceLineNumber()), listingLineNumber(line->getListingLineNumber())
 {
 
 }
 
 BackEndError::BackEndError(const BackEndError &other): AErrorMessage(other),
-    line(other.line)
+    sourceLineNumber(other.sourceLineNumber), listingLineNumber(other.listingLineNumber)
 {
 
 }
 
 BackEndError::BackEndError(BackEndError &&other): AErrorMessage(other),
-    line(std::move(other.line))
+    sourceLineNumber(other.sourceLineNumber), listingLineNumber(other.listingLineNumber)
 {
 
 }
@@ -117,7 +117,7 @@ BackEndError::~BackEndError() = default;
 
 int BackEndError::getSourceLineNumber() const
 {
-    return line->getSourceLineNumber();
+    return sourceLineNumber;
 }
 
 bool BackEndError::presentInListing() const
@@ -127,7 +127,7 @@ bool BackEndError::presentInListing() const
 
 int BackEndError::getListingLineNumber() const
 {
-    return line->getListingLineNumber();
+    return listingLineNumber;
 }
 
 void ErrorDictionary::addError(QSharedPointer<AErrorMessage> error)
@@ -114,7 +114,9 @@ private:
 class BackEndError : public AErrorMessage
 {
 public:
-    BackEndError(quint32 instanceIndex, Severity severity, QString message, QSharedPointer<AsmCode> line);
+    // Line numbers are captured from line when the error is created, so the error
+    // may outlive the arena that owns line.
+    BackEndError(quint32 instanceIndex, Severity severity, QString message, const AsmCode* line);
     BackEndError(const BackEndError& other);
     BackEndError(BackEndError&& other);
     BackEndError& operator=(BackEndError rhs);
@@ -128,10 +130,11 @@ public:
     {
         using std::swap;
         swap(static_cast<AErrorMessage&>(first), static_cast<AErrorMessage&>(second));
-        swap(first.line, second.line);
+        swap(first.sourceLineNumber, second.sourceLineNumber);
+        swap(first.listingLineNumber, second.listingLineNumber);
     }
 private:
-    QSharedPointer<AsmCode> line;
+    int sourceLineNumber, listingLineNumber;
 };
 
 class ErrorDictionary
@@ -1,22 +1,34 @@
 #include "executionstatisticswidget.h"
 #include "ui_executionstatisticswidget.h"
+#include "asmprogrammanager.h"
+#include "isaprofiler.h"
 #include "pep.h"
 ExecutionStatisticsWidget::ExecutionStatisticsWidget(QWidget *parent) :
     QWidget(parent),
-    ui(new Ui::ExecutionStatisticsWidget), model(new QStandardItemModel(this))
+    ui(new Ui::ExecutionStatisticsWidget), model(new QStandardItemModel(this)),
+    hotSpotModel(new QStandardItemModel(this)), showCycles(false)
 {
     ui->setupUi(this);
     ui->treeView->setModel(model);
     model->setHorizontalHeaderLabels({"Instruction", "Frequency"});
+    ui->treeView_HotSpots->setModel(hotSpotModel);
 }
 
 void ExecutionStatisticsWidget::init(QSharedPointer<InterfaceISACPU> cpu, bool showCycles)
 {
     this->cpu = cpu;
+    this->showCycles = showCycles;
     if(!showCycles) {
         ui->label->hide();
         ui->lineEdit_Cycles->hide();
     }
+    // Inclusive and exclusive totals are in the same unit as the counts above them.
+    QString unit = showCycles ? "Cycles" : "Instructions";
+    hotSpotModel->setHorizontalHeaderLabels({"Function", "Calls", "Inclusive " + unit, "Exclusive " + unit});
+    if(cpu->getProfiler().isNull()) {
+        ui->label_HotSpots->hide();
+        ui->treeView_HotSpots->hide();
+    }
 }
 
 ExecutionStatisticsWidget::~ExecutionStatisticsWidget()
@@ -29,9 +41,11 @@ void ExecutionStatisticsWidget::onClear()
     ui->lineEdit_Cycles->clear();
     ui->lineEdit_Instructions->clear();
     model->removeRows(0, model->rowCount());
+    hotSpotModel->removeRows(0, hotSpotModel->rowCount());
     // Sort by a non-existent column to prevent the "sorting arrow"
     // from appearing over unsorted data.
     ui->treeView->sortByColumn(-1, Qt::SortOrder::AscendingOrder);
+    ui->treeView_HotSpots->sortByColumn(-1, Qt::SortOrder::AscendingOrder);
 }
 
 void ExecutionStatisticsWidget::onSimulationStarted()
@@ -46,6 +60,7 @@ void ExecutionStatisticsWidget::onSimulationFinished()
     ui->lineEdit_Cycles->setText(QLocale::system().toString(cpu->getCycleCount()));
     ui->lineEdit_Instructions->setText(QLocale::system().toString(cpu->getInstructionCount()));
     fillModel(cpu->getInstructionHistogram());
+    if(!cpu->getProfiler().isNull()) fillHotSpots(*cpu->getProfiler());
 }
 
 // POD class to help aggregate statistics.
@@ -131,3 +146,21 @@ void ExecutionStatisticsWidget::fillModel(const QVector<quint32> histogram)
     }
 
 }
+
+void ExecutionStatisticsWidget::fillHotSpots(const IsaProfiler &profiler)
+{
+    hotSpotModel->removeRows(0, hotSpotModel->rowCount());
+    auto stats = profiler.getFunctionStats(IsaProfiler::symbolNamer(AsmProgramManager::getInstance()));
+    // Functions arrive hottest first, which is also the order to show them in.
+    for(const IsaProfiler::FunctionStats& function : stats) {
+        QStandardItem* name = new QStandardItem(function.name);
+        QStandardItem* calls = new QStandardItem();
+        QStandardItem* inclusive = new QStandardItem();
+        QStandardItem* exclusive = new QStandardItem();
+        // Make a variant from an int type to ensure that sorting works correctly.
+        calls->setData(QVariant(function.calls), Qt::DisplayRole);
+        inclusive->setData(QVariant(showCycles ? function.inclusiveCycles : function.inclusiveInstructions), Qt::DisplayRole);
+        exclusive->setData(QVariant(showCycles ? function.exclusiveCycles : function.exclusiveInstructions), Qt::DisplayRole);
+        hotSpotModel->appendRow({name, calls, inclusive, exclusive});
+    }
+}
@@ -4,6 +4,7 @@
 #include <QWidget>
 #include "interfaceisacpu.h"
 #include <QStandardItemModel>
+class IsaProfiler;
 namespace Ui {
 class ExecutionStatisticsWidget;
 }
@@ -26,7 +27,11 @@ private:
     Ui::ExecutionStatisticsWidget *ui;
     QSharedPointer<InterfaceISACPU> cpu;
     QStandardItemModel* model;
+    // Functions of the program, from the CPU's profiler if it has one.
+    QStandardItemModel* hotSpotModel;
+    bool showCycles;
     void fillModel(const QVector<quint32> histogram);
+    void fillHotSpots(const IsaProfiler& profiler);
 };
 
 #endif // EXECUTIONSTATISTICSWIDGET_H
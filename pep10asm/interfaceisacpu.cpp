@@ -7,11 +7,12 @@
 #include "typetags.h"
 #include "symbolentry.h"
 #include "asmcode.h"
+#include "isaprofiler.h"
 InterfaceISACPU::InterfaceISACPU(const AMemoryDevice* /*dev*/, const AsmProgramManager* manager) noexcept:
     manager(manager), opValCache(0),
     breakpointsISA(), asmInstructionCounter(0), asmBreakpointHit(false), doDebug(false),
     firstLineAfterCall(false), isTrapped(false), memTrace(QSharedPointer<MemoryTrace>::create()),
-    userActions(), osActions(), activeActions(&userActions)
+    userActions(), osActions(), activeActions(&userActions), profiler()
 {
     memTrace->activeStack = &memTrace->userStack;
 }
@@ -55,11 +56,26 @@ QSharedPointer<const MemoryTrace> InterfaceISACPU::getMemoryTrace() const
     return memTrace;
 }
 
+QSharedPointer<MemoryTrace> InterfaceISACPU::getMemoryTrace()
+{
+    return memTrace;
+}
+
 quint16 InterfaceISACPU::getOperandValue() const
 {
     return opValCache;
 }
 
+void InterfaceISACPU::setProfiler(QSharedPointer<IsaProfiler> profiler) noexcept
+{
+    this->profiler = profiler;
+}
+
+QSharedPointer<const IsaProfiler> InterfaceISACPU::getProfiler() const noexcept
+{
+    return profiler;
+}
+
 void InterfaceISACPU::setDebugBreakpoints(bool doDebug) noexcept
 {
     this->doDebug = doDebug;
@@ -103,9 +119,10 @@ void InterfaceISACPU::calculateStackChangeEnd(quint8 instr, quint16 opspec, quin
      *  x - If CallStack is ever exhausted before size is hit, return false.
      */
 
-    if(!memTrace->activeStack->isStackIntact() || this->manager->getProgramAt(pc) == nullptr
+    const AsmProgramManager::AddressInfo& info = manager->getAddressInfo(pc);
+    if(!memTrace->activeStack->isStackIntact()
             // For now, only allow tracing of user programs
-            || this->manager->getUserProgram() != this->manager->getProgramAt(pc)) return;
+            || !(info.flags & AsmProgramManager::AddressInfo::InUserProgram)) return;
     Enu::EMnemonic mnemon = Pep::decodeMnemonic[instr];
     quint16 size = 0;
     bool mallocPreError = false;
@@ -114,19 +131,16 @@ void InterfaceISACPU::calculateStackChangeEnd(quint8 instr, quint16 opspec, quin
         firstLineAfterCall = true;
         memTrace->activeStack->call(sp - 2);
         activeActions->push(stackAction::call);
-        if(dynamic_cast<const NonUnaryInstruction*>(manager->getUserProgram()->memAddressToCode(pc)) != nullptr){
-            const NonUnaryInstruction* instr = dynamic_cast<const NonUnaryInstruction*>(manager->getUserProgram()->memAddressToCode(pc));
+        if(info.flags & AsmProgramManager::AddressInfo::NonUnary) {
             // If a previous call to malloc has corrupted the heap,
             // don't attempt any further processing.
             if(memTrace->heapTrace.canAddNew() == false) return;
             // A call to things other than malloc don't trigger heap changes.
-            else if(instr->getSymbolicOperand()->getName() != "malloc") return;
+            // Calls to malloc via a literal address aren't tracked either.
+            else if(!(info.flags & AsmProgramManager::AddressInfo::CallsMalloc)) return;
             // In case a user wrote a self modifying program, and
             // give up on tracking futue heap changes.
-            else if(instr->getMnemonic() != Enu::EMnemonic::CALL) mallocPreError = true;
-            // Don't try to track calls to malloc via a literal address, and give up
-            // on tracking future heap changes.
-            else if(!instr->hasSymbolicOperand()) mallocPreError = true;
+            else if(!(info.flags & AsmProgramManager::AddressInfo::Call)) mallocPreError = true;
 
             // If there was an error, prevent any new heap adjustments from being made.
             if(mallocPreError == true) {
@@ -136,13 +150,9 @@ void InterfaceISACPU::calculateStackChangeEnd(quint8 instr, quint16 opspec, quin
                 return;
             }
             // A call with no symbol traces listed is ignored.
-            else if(manager->getUserProgram()->getTraceInfo()->instrToSymlist.contains(pc)) {
+            else if(info.traceTypes != nullptr) {
                 memTrace->heapTrace.setInMalloc(true);
-                QList<QPair<Enu::ESymbolFormat, QString>> primList;
-                for(auto item : manager->getProgramAt(pc)->getTraceInfo()->instrToSymlist[pc]) {
-                    primList.append(item->toPrimitives());
-                }
-                memTrace->heapTrace.pushHeap(heapPtr, primList);
+                memTrace->heapTrace.pushHeap(heapPtr, *info.traceTypes);
                 heapPtr += acc;
             }
             else {
@@ -179,35 +189,23 @@ void InterfaceISACPU::calculateStackChangeEnd(quint8 instr, quint16 opspec, quin
         break;
 
     case Enu::EMnemonic::SUBSP:
-        if(manager->getProgramAt(pc)->getTraceInfo()->instrToSymlist.contains(pc)) {
-            quint16 size = 0;
-            for(auto pair : manager->getProgramAt(pc)->getTraceInfo()->instrToSymlist[pc]) {
-                size += pair->size();
-            }
-            if(size != opspec) {
+        if(info.traceTypes != nullptr) {
+            if(info.traceTypes->size != opspec) {
                 memTrace->activeStack->setStackIntact(false);
                 memTrace->activeStack->setErrorMessage("ERROR: Operand of SUBSP does not match size of trace tags.");
                 break;
             }
         }
         if(firstLineAfterCall) {
-            if(manager->getProgramAt(pc)->getTraceInfo()->instrToSymlist.contains(pc)) {
-                QList<QPair<Enu::ESymbolFormat,QString>> primList;
-                for(auto item : manager->getProgramAt(pc)->getTraceInfo()->instrToSymlist[pc]) {
-                    primList.append(item->toPrimitives());
-                }
-                memTrace->activeStack->pushLocals(sp, primList);
+            if(info.traceTypes != nullptr) {
+                memTrace->activeStack->pushLocals(sp, *info.traceTypes);
             }
             activeActions->push(stackAction::locals);
             //qDebug() << "Alloc'ed Locals!" ;
         }
         else {
-            if(manager->getProgramAt(pc)->getTraceInfo()->instrToSymlist.contains(pc)) {
-                QList<QPair<Enu::ESymbolFormat,QString>> primList;
-                for(auto item : manager->getProgramAt(pc)->getTraceInfo()->instrToSymlist[pc]) {
-                    primList.append(item->toPrimitives());
-                }
-                memTrace->activeStack->pushParams(sp, primList);
+            if(info.traceTypes != nullptr) {
+                memTrace->activeStack->pushParams(sp, *info.traceTypes);
             }
             activeActions->push(stackAction::params);
             //qDebug() << "Alloc'ed params! " ;//<< activeStack->top();
@@ -216,10 +214,8 @@ void InterfaceISACPU::calculateStackChangeEnd(quint8 instr, quint16 opspec, quin
         break;
 
     case Enu::EMnemonic::ADDSP:
-        if(manager->getProgramAt(pc)->getTraceInfo()->instrToSymlist.contains(pc)) {
-            for(auto pair : manager->getProgramAt(pc)->getTraceInfo()->instrToSymlist[pc]) {
-                size += pair->size();
-            }
+        if(info.traceTypes != nullptr) {
+            size = info.traceTypes->size;
             if(size != opspec) {
                 memTrace->activeStack->setStackIntact(false);
                 memTrace->activeStack->setErrorMessage("ERROR: Operand of ADDSP does not match size of trace tags.");
@@ -311,6 +307,7 @@ void InterfaceISACPU::reset() noexcept
     asmInstructionCounter = 0;
     asmBreakpointHit = false;
     memTrace->clear();
+    if(profiler) profiler->clear();
     // Only trace the stack if trace tags are present, and no assembly time
     // errors occured.
     bool hadWarnings =  false;
@@ -328,15 +325,15 @@ void InterfaceISACPU::reset() noexcept
 
     // Store globals, if there were no trace tag errors
     if(!memTrace->hasTraceWarnings()) {
-        QList<QPair<quint16,QPair<Enu::ESymbolFormat,QString>>> lst;
-        QMap<QSharedPointer<const SymbolEntry>, QSharedPointer<AType>> map =
-                manager->getUserProgram()->getTraceInfo()->staticAllocSymbolTypes;
-        for(auto global : map.keys()) {
-            QList<QPair<Enu::ESymbolFormat,QString>> innerPairs = map[global]->toPrimitives();
-            quint16 addr = global->getValue();
-            for(auto primitive : innerPairs) {
-                lst.append({addr,{primitive}});
-                addr += Enu::tagNumBytes(primitive.first);
+        QSharedPointer<const StaticTraceInfo> traceInfo = manager->getUserProgram()->getTraceInfo();
+        memTrace->setTraceInfo(traceInfo);
+        QVector<MemTag> lst;
+        const auto& map = traceInfo->staticAllocSymbolRanges;
+        for(auto global = map.cbegin(); global != map.cend(); ++global) {
+            quint16 addr = global.key()->getValue();
+            for(auto type = global.value().begin; type != global.value().end; ++type) {
+                lst.append(MemTag{addr, type});
+                addr += Enu::tagNumBytes(type->format);
             }
 
         }
@@ -27,6 +27,7 @@
 #include "stacktrace.h"
 class AMemoryDevice;
 class AsmProgramManager;
+class IsaProfiler;
 enum class stackAction {
     locals, params, call
 };
@@ -59,8 +60,15 @@ public:
     void breakpointRemoved(quint16 address) noexcept;
     void breakpointAdded(quint16 address) noexcept;
     QSharedPointer<const MemoryTrace> getMemoryTrace() const;
+    // The view drawing the trace takes the changes from its stack, which resets them.
+    QSharedPointer<MemoryTrace> getMemoryTrace();
     // Return the decoded value of the last executed
     quint16 getOperandValue() const;
+    // Record every instruction executed from now on in profiler, or stop profiling if it is null.
+    // The profile is cleared on reset and once the user program is loaded, and instructions undone
+    // by stepping back remain in the profile.
+    void setProfiler(QSharedPointer<IsaProfiler> profiler) noexcept;
+    QSharedPointer<const IsaProfiler> getProfiler() const noexcept;
 
     // Clear program counters & breakpoint status
     void reset() noexcept;
@@ -124,6 +132,9 @@ protected:
     QSharedPointer<MemoryTrace> memTrace;
     QStack<stackAction> userActions, osActions, *activeActions;
     quint16 heapPtr;
+
+    // Optional, so that unprofiled execution only pays for a null check.
+    QSharedPointer<IsaProfiler> profiler;
 };
 
 #endif // AISACPU_H
@@ -21,6 +21,7 @@
 #include "isaasm.h"
 #include "asmargument.h"
 #include "asmcode.h"
+#include "asmcodearena.h"
 #include "asmprogram.h"
 #include "asmprogrammanager.h"
 #include "mainmemory.h"
@@ -71,7 +72,8 @@ bool IsaAsm::assembleUserProgram(const QString &progText, QSharedPointer<AsmProg
     QStringList sourceCodeList = progText.split("\n");
     AsmCode *code;
     int lineNum = 0;
-    QList<QSharedPointer<AsmCode>> programList;
+    QList<AsmCode*> programList;
+    QSharedPointer<AsmCodeArena> codeArena = QSharedPointer<AsmCodeArena>::create();
 
     QSharedPointer<SymbolTable> symTable = QSharedPointer<SymbolTable>::create();
 
@@ -82,7 +84,7 @@ bool IsaAsm::assembleUserProgram(const QString &progText, QSharedPointer<AsmProg
     while (lineNum < sourceCodeList.size() && !dotEndDetected) {
         sourceLine = sourceCodeList[lineNum];
         if (!IsaAsm::processSourceLine(symTable.data(), info, *traceInfo, byteCount,
-                                       sourceLine, lineNum, code,
+                                       sourceLine, lineNum, *codeArena, code,
                                        errorString, dotEndDetected)) {
             errList.append(QPair<int,QString>{lineNum, errorString});
             return false;
@@ -92,7 +94,7 @@ bool IsaAsm::assembleUserProgram(const QString &progText, QSharedPointer<AsmProg
             errList.append(QPair<int,QString>{lineNum, errorString});
             errorString.clear();
         }
-        programList.append(QSharedPointer<AsmCode>(code));
+        programList.append(code);
         lineNum++;
     }
 
@@ -155,7 +157,7 @@ bool IsaAsm::assembleUserProgram(const QString &progText, QSharedPointer<AsmProg
     }
     // Finds remaining trace tags (structs, add/subsp) and handles malloc/heap allocation.
     handleTraceTags(*symTable.get(), *traceInfo.get(), programList, errList);
-    progOut = QSharedPointer<AsmProgram>::create(programList, symTable, traceInfo);
+    progOut = QSharedPointer<AsmProgram>::create(programList, codeArena, symTable, traceInfo);
 
     return success;
 }
@@ -171,7 +173,8 @@ bool IsaAsm::assembleOperatingSystem(const QString &progText, bool forceBurnAt0x
     bool dotEndDetected = false, success = true;
 
     QSharedPointer<SymbolTable> symTable = QSharedPointer<SymbolTable>::create();
-    QList<QSharedPointer<AsmCode>> programList;
+    QList<AsmCode*> programList;
+    QSharedPointer<AsmCodeArena> codeArena = QSharedPointer<AsmCodeArena>::create();
     int byteCount = 0;
     BURNInfo info;
     QSharedPointer<StaticTraceInfo> traceInfo = QSharedPointer<StaticTraceInfo>::create();
@@ -179,7 +182,7 @@ bool IsaAsm::assembleOperatingSystem(const QString &progText, bool forceBurnAt0x
         sourceLine = fileLines[lineNum];
         if (!IsaAsm::processSourceLine(symTable.data(), info, *traceInfo.get(),
                                        byteCount, sourceLine, lineNum,
-                                       code, errorString, dotEndDetected)) {
+                                       *codeArena, code, errorString, dotEndDetected)) {
             return false;
         }
         // If a non-fatal error occured, log it to the error list.
@@ -187,7 +190,7 @@ bool IsaAsm::assembleOperatingSystem(const QString &progText, bool forceBurnAt0x
             errList.append(QPair<int,QString>{lineNum, errorString});
             errorString.clear();
         }
-        programList.append(QSharedPointer<AsmCode>(code));
+        programList.append(code);
         lineNum++;
     }
 
@@ -255,7 +258,7 @@ bool IsaAsm::assembleOperatingSystem(const QString &progText, bool forceBurnAt0x
     // Find the .BURN directive
     int indexOfBurn = 0;
     for(int it = 0; it < programList.size(); it++) {
-        if(dynamic_cast<DotBurn*>(programList[it].get()) != nullptr) {
+        if(dynamic_cast<DotBurn*>(programList[it]) != nullptr) {
             indexOfBurn = it;
             break;
         }
@@ -279,9 +282,9 @@ bool IsaAsm::assembleOperatingSystem(const QString &progText, bool forceBurnAt0x
         }
 
         // If the instruction is a .ALIGN, then we must re-calculate the rolling offset.
-        if(dynamic_cast<DotAlign*>(programList[it].get()) != nullptr) {
+        if(dynamic_cast<DotAlign*>(programList[it]) != nullptr) {
             // The instruction is known to be an ALIGN directive, so just cast it.
-            DotAlign* asAlign = static_cast<DotAlign*>(programList[it].get());
+            DotAlign* asAlign = static_cast<DotAlign*>(programList[it]);
             // The address of the .ALIGN.
             int startAddr = asAlign->memAddress;
             // The address of the last byte of the .ALIGN.
@@ -300,7 +303,7 @@ bool IsaAsm::assembleOperatingSystem(const QString &progText, bool forceBurnAt0x
     // the operating system is not a translation of a C program.
     // handleTraceTags(*symTable.get(), *traceInfo, codeList, errList);
     traceInfo->hadTraceTags = false;
-    progOut = QSharedPointer<AsmProgram>::create(programList, symTable, traceInfo, info.startROMAddress, info.burnValue);
+    progOut = QSharedPointer<AsmProgram>::create(programList, codeArena, symTable, traceInfo, info.startROMAddress, info.burnValue);
     return true;
 }
 
@@ -337,15 +340,15 @@ bool instanceof (AsmCode* inst) {
 
 }
 void IsaAsm::handleTraceTags(const SymbolTable& symTable, StaticTraceInfo& traceInfo,
-                             QList<QSharedPointer<AsmCode>>& programList, QList<QPair<int, QString>> &errList)
+                             QList<AsmCode*>& programList, QList<QPair<int, QString>> &errList)
 {
     // Extract the list of lines that have remaing trace tags.
-    QList<QPair<int,QSharedPointer<AsmCode>>> structs, allocs;
+    QList<QPair<int,AsmCode*>> structs, allocs;
     int lineIt = 0;
     for(auto line : programList) {
         // If a line is a non-unary instruction & the program has trace tags.
-        if(traceInfo.hadTraceTags && dynamic_cast<NonUnaryInstruction*>(line.get()) != nullptr) {
-            NonUnaryInstruction* instr = dynamic_cast<NonUnaryInstruction*>(line.get());
+        if(traceInfo.hadTraceTags && dynamic_cast<NonUnaryInstruction*>(line) != nullptr) {
+            NonUnaryInstruction* instr = dynamic_cast<NonUnaryInstruction*>(line);
             switch(instr->mnemonic) {
             case Enu::EMnemonic::CALL:
                 [[fallthrough]];
@@ -364,10 +367,10 @@ void IsaAsm::handleTraceTags(const SymbolTable& symTable, StaticTraceInfo& trace
             // If a line has symbol tags and allocates storage
             // (local or global) for a struct.
             if(hasSymbolTag(line->getComment())
-                    && (instanceof<DotBlock>(line.get()) ||
-                        instanceof<DotEquate>(line.get()) ||
-                        instanceof<DotByte>(line.get()) ||
-                        instanceof<DotWord>(line.get())
+                    && (instanceof<DotBlock>(line) ||
+                        instanceof<DotEquate>(line) ||
+                        instanceof<DotByte>(line) ||
+                        instanceof<DotWord>(line)
                         )
                     ) {
                 structs.append({lineIt, line});
@@ -392,7 +395,7 @@ void IsaAsm::handleTraceTags(const SymbolTable& symTable, StaticTraceInfo& trace
     int lastLen;
     do {
         lastLen = structs.length();
-        for(QMutableListIterator<QPair<int,QSharedPointer<AsmCode>>> it(structs); it.hasNext();) {
+        for(QMutableListIterator<QPair<int,AsmCode*>> it(structs); it.hasNext();) {
             auto line = it.next();
             // If a line with symbol tags listed does not contain a symbol definition, there is an error.
             if(!line.second->hasSymbolEntry()) {
@@ -416,8 +419,8 @@ void IsaAsm::handleTraceTags(const SymbolTable& symTable, StaticTraceInfo& trace
                 continue;
             }
             // Global structs - static allocated.
-            if(dynamic_cast<DotBlock*>(line.second.get()) != nullptr) {
-                DotBlock* instr = dynamic_cast<DotBlock*>(line.second.get());
+            if(dynamic_cast<DotBlock*>(line.second) != nullptr) {
+                DotBlock* instr = dynamic_cast<DotBlock*>(line.second);
                 // Check that the allocated size of a global struct is the same size as the type tag.
                 if(instr->argument->getArgumentValue() != rVal.first->size()) {
                     traceInfo.staticTraceError = true;
@@ -458,8 +461,8 @@ void IsaAsm::handleTraceTags(const SymbolTable& symTable, StaticTraceInfo& trace
     for(auto line: allocs) {
         // Used to force a continue on the outer loop from an inner loop.
         bool forceContinue = false;
-        if(dynamic_cast<NonUnaryInstruction*>(line.second.get()) != nullptr) {
-            NonUnaryInstruction *instr = static_cast<NonUnaryInstruction*>(line.second.get());
+        if(dynamic_cast<NonUnaryInstruction*>(line.second) != nullptr) {
+            NonUnaryInstruction *instr = static_cast<NonUnaryInstruction*>(line.second);
             QList<QSharedPointer<AType>> lineTypes;
             if(hasSymbolTag(line.second->getComment())) {
                 QStringList texts = extractTagList(line.second->getComment());
@@ -557,6 +560,9 @@ void IsaAsm::handleTraceTags(const SymbolTable& symTable, StaticTraceInfo& trace
         traceInfo.mallocPtr = symTable.getValue("malloc");
     }
 
+    // Types may only be flattened once every trace tag has been parsed.
+    traceInfo.flattenTypes();
+
     // Since model works, no need to print debug info, but retain code for future debugging.
     /*qDebug().noquote().nospace() << "Stack / Heap allocated types:";
     for(auto sym : traceInfo.dynamicAllocSymbolTypes) {
@@ -575,7 +581,7 @@ void IsaAsm::handleTraceTags(const SymbolTable& symTable, StaticTraceInfo& trace
 
 }
 
-void IsaAsm::relocateCode(QList<QSharedPointer<AsmCode> > &codeList, quint16 addressDelta)
+void IsaAsm::relocateCode(QList<AsmCode *> &codeList, quint16 addressDelta)
 {
     for (int i = 0; i < codeList.length(); i++) {
         codeList[i]->adjustMemAddress(addressDelta);
@@ -583,7 +589,7 @@ void IsaAsm::relocateCode(QList<QSharedPointer<AsmCode> > &codeList, quint16 add
 }
 
 bool IsaAsm::processSourceLine(SymbolTable* symTable, BURNInfo& info, StaticTraceInfo& traceInfo,
-                               int& byteCount, QString sourceLine, int lineNum, AsmCode *&code,
+                               int& byteCount, QString sourceLine, int lineNum, AsmCodeArena &arena, AsmCode *&code,
                                QString &errorString, bool &dotEndDetected, bool hasBreakpoint)
 {
     IsaParserHelper::ELexicalToken token; // Passed to getToken.
@@ -618,7 +624,7 @@ bool IsaAsm::processSourceLine(SymbolTable* symTable, BURNInfo& info, StaticTrac
                 if (Pep::mnemonToEnumMap.contains(tokenString.toUpper())) {
                     localEnumMnemonic = Pep::mnemonToEnumMap.value(tokenString.toUpper());
                     if (Pep::isUnaryMap.value(localEnumMnemonic)) {
-                        unaryInstruction = new UnaryInstruction;
+                        unaryInstruction = arena.create<UnaryInstruction>();
                         unaryInstruction->mnemonic = localEnumMnemonic;
                         unaryInstruction->breakpoint = hasBreakpoint;
                         code = unaryInstruction;
@@ -627,7 +633,7 @@ bool IsaAsm::processSourceLine(SymbolTable* symTable, BURNInfo& info, StaticTrac
                         state = IsaParserHelper::PS_CLOSE;
                     }
                     else {
-                        nonUnaryInstruction = new NonUnaryInstruction;
+                        nonUnaryInstruction = arena.create<NonUnaryInstruction>();
                         nonUnaryInstruction->mnemonic = localEnumMnemonic;
                         nonUnaryInstruction->breakpoint = hasBreakpoint;
                         code = nonUnaryInstruction;
@@ -645,43 +651,43 @@ bool IsaAsm::processSourceLine(SymbolTable* symTable, BURNInfo& info, StaticTrac
                 tokenString.remove(0, 1); // Remove the period
                 tokenString = tokenString.toUpper();
                 if (tokenString == "ADDRSS") {
-                    dotAddrss = new DotAddrss;
+                    dotAddrss = arena.create<DotAddrss>();
                     code = dotAddrss;
                     code->memAddress = byteCount;
                     state = IsaParserHelper::PS_DOT_ADDRSS;
                 }
                 else if (tokenString == "ALIGN") {
-                    dotAlign = new DotAlign;
+                    dotAlign = arena.create<DotAlign>();
                     code = dotAlign;
                     code->memAddress = byteCount;
                     state = IsaParserHelper::PS_DOT_ALIGN;
                 }
                 else if (tokenString == "ASCII") {
-                    dotAscii = new DotAscii;
+                    dotAscii = arena.create<DotAscii>();
                     code = dotAscii;
                     code->memAddress = byteCount;
                     state = IsaParserHelper::PS_DOT_ASCII;
                 }
                 else if (tokenString == "BLOCK") {
-                    dotBlock = new DotBlock;
+                    dotBlock = arena.create<DotBlock>();
                     code = dotBlock;
                     code->memAddress = byteCount;
                     state = IsaParserHelper::PS_DOT_BLOCK;
                 }
                 else if (tokenString == "BURN") {
-                    dotBurn = new DotBurn;
+                    dotBurn = arena.create<DotBurn>();
                     code = dotBurn;
                     code->memAddress = byteCount;
                     state = IsaParserHelper::PS_DOT_BURN;
                 }
                 else if (tokenString == "BYTE") {
-                    dotByte = new DotByte;
+                    dotByte = arena.create<DotByte>();
                     code = dotByte;
                     code->memAddress = byteCount;
                     state = IsaParserHelper::PS_DOT_BYTE;
                 }
                 else if (tokenString == "END") {
-                    dotEnd = new DotEnd;
+                    dotEnd = arena.create<DotEnd>();
                     code = dotEnd;
                     // End symbol does not have a memory address
                     code->memAddress = byteCount;
@@ -689,13 +695,13 @@ bool IsaAsm::processSourceLine(SymbolTable* symTable, BURNInfo& info, StaticTrac
                     state = IsaParserHelper::PS_DOT_END;
                 }
                 else if (tokenString == "EQUATE") {
-                    dotEquate = new DotEquate;
+                    dotEquate = arena.create<DotEquate>();
                     code = dotEquate;
                     code->memAddress = byteCount;
                     state = IsaParserHelper::PS_DOT_EQUATE;
                 }
                 else if (tokenString == "WORD") {
-                    dotWord = new DotWord;
+                    dotWord = arena.create<DotWord>();
                     code = dotWord;
                     code->memAddress = byteCount;
                     state = IsaParserHelper::PS_DOT_WORD;
@@ -723,7 +729,7 @@ bool IsaAsm::processSourceLine(SymbolTable* symTable, BURNInfo& info, StaticTrac
                 state = IsaParserHelper::PS_SYMBOL_DEF;
             }
             else if (token == IsaParserHelper::LT_COMMENT) {
-                commentOnly = new CommentOnly;
+                commentOnly = arena.create<CommentOnly>();
                 commentOnly->hasCom = true;
                 commentOnly->comment = tokenString;
                 code = commentOnly;
@@ -732,7 +738,7 @@ bool IsaAsm::processSourceLine(SymbolTable* symTable, BURNInfo& info, StaticTrac
                 state = IsaParserHelper::PS_COMMENT;
             }
             else if (token == IsaParserHelper::LT_EMPTY) {
-                blankLine = new BlankLine;
+                blankLine = arena.create<BlankLine>();
                 code = blankLine;
                 // Neither do empty lines
                 code->memAddress = -1;
@@ -750,7 +756,7 @@ bool IsaAsm::processSourceLine(SymbolTable* symTable, BURNInfo& info, StaticTrac
                 if (Pep::mnemonToEnumMap.contains(tokenString.toUpper())) {
                     localEnumMnemonic = Pep::mnemonToEnumMap.value(tokenString.toUpper());
                     if (Pep::isUnaryMap.value(localEnumMnemonic)) {
-                        unaryInstruction = new UnaryInstruction;
+                        unaryInstruction = arena.create<UnaryInstruction>();
                         unaryInstruction->symbolEntry = symTable->getValue(localSymbolDef);
                         unaryInstruction->mnemonic = localEnumMnemonic;
                         unaryInstruction->breakpoint = hasBreakpoint;
@@ -760,7 +766,7 @@ bool IsaAsm::processSourceLine(SymbolTable* symTable, BURNInfo& info, StaticTrac
                         state = IsaParserHelper::PS_CLOSE;
                     }
                     else {
-                        nonUnaryInstruction = new NonUnaryInstruction;
+                        nonUnaryInstruction = arena.create<NonUnaryInstruction>();
                         nonUnaryInstruction->symbolEntry = symTable->getValue(localSymbolDef);
                         nonUnaryInstruction->mnemonic = localEnumMnemonic;
                         nonUnaryInstruction->breakpoint = hasBreakpoint;
@@ -779,42 +785,42 @@ bool IsaAsm::processSourceLine(SymbolTable* symTable, BURNInfo& info, StaticTrac
                 tokenString.remove(0, 1); // Remove the period
                 tokenString = tokenString.toUpper();
                 if (tokenString == "ADDRSS") {
-                    dotAddrss = new DotAddrss;
+                    dotAddrss = arena.create<DotAddrss>();
                     dotAddrss->symbolEntry = symTable->getValue(localSymbolDef);
                     code = dotAddrss;
                     code->memAddress = byteCount;
                     state = IsaParserHelper::PS_DOT_ADDRSS;
                 }
                 else if (tokenString == "ASCII") {
-                    dotAscii = new DotAscii;
+                    dotAscii = arena.create<DotAscii>();
                     dotAscii->symbolEntry = symTable->getValue(localSymbolDef);
                     code = dotAscii;
                     code->memAddress = byteCount;
                     state = IsaParserHelper::PS_DOT_ASCII;
                 }
                 else if (tokenString == "BLOCK") {
-                    dotBlock = new DotBlock;
+                    dotBlock = arena.create<DotBlock>();
                     dotBlock->symbolEntry = symTable->getValue(localSymbolDef);
                     code = dotBlock;
                     code->memAddress = byteCount;
                     state = IsaParserHelper::PS_DOT_BLOCK;
                 }
                 else if (tokenString == "BURN") {
-                    dotBurn = new DotBurn;
+                    dotBurn = arena.create<DotBurn>();
                     dotBurn->symbolEntry = symTable->getValue(localSymbolDef);
                     code = dotBurn;
                     code->memAddress = byteCount;
                     state = IsaParserHelper::PS_DOT_BURN;
                 }
                 else if (tokenString == "BYTE") {
-                    dotByte = new DotByte;
+                    dotByte = arena.create<DotByte>();
                     dotByte->symbolEntry = symTable->getValue(localSymbolDef);
                     code = dotByte;
                     code->memAddress = byteCount;
                     state = IsaParserHelper::PS_DOT_BYTE;
                 }
                 else if (tokenString == "END") {
-                    dotEnd = new DotEnd;
+                    dotEnd = arena.create<DotEnd>();
                     dotEnd->symbolEntry = symTable->getValue(localSymbolDef);
                     code = dotEnd;
                     code->memAddress = byteCount;
@@ -822,14 +828,14 @@ bool IsaAsm::processSourceLine(SymbolTable* symTable, BURNInfo& info, StaticTrac
                     state = IsaParserHelper::PS_DOT_END;
                 }
                 else if (tokenString == "EQUATE") {
-                    dotEquate = new DotEquate;
+                    dotEquate = arena.create<DotEquate>();
                     dotEquate->symbolEntry = symTable->getValue(localSymbolDef);
                     code = dotEquate;
                     code->memAddress = byteCount;
                     state = IsaParserHelper::PS_DOT_EQUATE;
                 }
                 else if (tokenString == "WORD") {
-                    dotWord = new DotWord;
+                    dotWord = arena.create<DotWord>();
                     dotWord->symbolEntry = symTable->getValue(localSymbolDef);
                     code = dotWord;
                     code->memAddress = byteCount;
@@ -26,6 +26,7 @@
 #include "enu.h"
 
 class AsmCode; // Forward declaration for argument of processSourceLine.
+class AsmCodeArena;
 class AsmProgram;
 class AsmProgramManager;
 class MainMemory;
@@ -139,8 +140,8 @@ private:
     // In the case of successful parsing, the pointer will be non-non, and the string will be empty.
     // If the pointer is null, then there exists an error message.
 
-    void handleTraceTags(const SymbolTable& symTable, StaticTraceInfo& traceInfo, QList<QSharedPointer<AsmCode>>& progList, QList<QPair<int, QString>> &errList);
-    void relocateCode(QList<QSharedPointer<AsmCode>>& codeList, quint16 addressDelta);
+    void handleTraceTags(const SymbolTable& symTable, StaticTraceInfo& traceInfo, QList<AsmCode*>& progList, QList<QPair<int, QString>> &errList);
+    void relocateCode(QList<AsmCode*>& codeList, quint16 addressDelta);
     // Pre: codeList contains a valid program
     // Post: The address of every line of code in codeList is increase by addressDelta
 
@@ -150,10 +151,11 @@ private:
     // beginning of sourceLine and returned in tokenString, true is returned, and token is set to the token type.
     // Post: If false is returned, then tokenString is set to the lexical error message.
 
-    bool processSourceLine(SymbolTable* symTable, BURNInfo& info, StaticTraceInfo& traceInfo, int& byteCount, QString sourceLine, int lineNum, AsmCode *&code, QString &errorString, bool &dotEndDetected, bool hasBreakpoint = false);
+    bool processSourceLine(SymbolTable* symTable, BURNInfo& info, StaticTraceInfo& traceInfo, int& byteCount, QString sourceLine, int lineNum, AsmCodeArena& arena, AsmCode *&code, QString &errorString, bool &dotEndDetected, bool hasBreakpoint = false);
     // Pre: sourceLine has one line of source code.
     // Pre: lineNum is the line number of the source code.
     // Post: If the source line is valid, true is returned and code is set to the source code for the line.
+    // Post: Any code object created for the line is owned by arena.
     // Post: dotEndDetected is set to true if .END is processed. Otherwise it is set to false.
     // Post: Pep::byteCount is incremented by the number of bytes generated.
     // Post: If the source line is not valid, false is returned and errorString is set to the error message.
@@ -1,6 +1,5 @@
 #include "isacpu.h"
 #include <functional>
-#include <QApplication>
 
 #include "acpumodel.h"
 #include "amemorydevice.h"
@@ -8,7 +7,10 @@
 #include "asmprogram.h"
 #include "interrupthandler.h"
 #include "isacpumemoizer.h"
+#include "isaprofiler.h"
+#include "memoryaccessstats.h"
 #include "pep.h"
+#include "simulationsnapshot.h"
 IsaCpu::IsaCpu(const AsmProgramManager *manager, QSharedPointer<AMemoryDevice> memDevice, QObject *parent):
     ACPUModel(memDevice, parent), InterfaceISACPU(memDevice.get(), manager), memoizer(new IsaCpuMemoizer(*this))
 {
@@ -75,6 +77,9 @@ void IsaCpu::runUntilLoaded()
     doISAStepWhile(cond);
     // Clear memory at end to hide the fact that the user program was loaded.
     memory->clearBytesWritten();
+    // Likewise, only profile the user program and the OS code it calls.
+    if(profiler) profiler->clear();
+    memory->clearStatistics();
 }
 
 quint64 IsaCpu::getCycleCount()
@@ -102,6 +107,82 @@ const RegisterFile &IsaCpu::getRegisterBank() const
     return registerBank;
 }
 
+void IsaCpu::loadArchitecturalState(const RegisterFile &registers, int callDepth)
+{
+    registerBank.copyArchitecturalState(registers);
+    this->callDepth = callDepth;
+    controlError = false;
+    errorMessage = "";
+    executionFinished = false;
+    asmBreakpointHit = false;
+    // Earlier instructions were executed elsewhere, so they can't be undone here.
+    undoLog.clear();
+}
+
+quint64 IsaCpu::getUndoBudget() const noexcept
+{
+    return undoLog.getBudget();
+}
+
+void IsaCpu::setUndoBudget(quint64 bytes)
+{
+    undoLog.setBudget(bytes);
+}
+
+quint64 IsaCpu::getUndoDepth() const noexcept
+{
+    return undoLog.getDepth();
+}
+
+quint64 IsaCpu::stepBack(quint64 count)
+{
+    // Clear at start, so as to preserve highlighting AFTER finishing the restore.
+    memory->clearBytesSet();
+    quint64 undone = 0;
+    while(undone < count && undoInstruction()) undone++;
+    return undone;
+}
+
+bool IsaCpu::runBackToBreakpoint()
+{
+    memory->clearBytesSet();
+    if(!undoInstruction()) return false;
+    while(!breakpointsISA.contains(registerBank.readRegisterWordCurrent(Enu::CPURegisters::PC))) {
+        if(!undoInstruction()) return false;
+    }
+    return true;
+}
+
+bool IsaCpu::undoInstruction()
+{
+    IsaUndoLog::Frame frame;
+    if(!undoLog.undoInstruction(memory.get(), frame)) return false;
+    for(quint8 reg = 0; reg < frame.registers.size(); reg++) {
+        registerBank.writeRegisterByte(reg, frame.registers[reg]);
+    }
+    registerBank.writeStatusBits(frame.statusBits);
+    registerBank.flattenFile();
+    callDepth = frame.callDepth;
+    opValCache = frame.operandValue;
+    asmInstructionCounter--;
+    quint8 instr = 0;
+    memory->getByte(registerBank.readRegisterWordCurrent(Enu::CPURegisters::PC), instr);
+    memoizer->onInstructionUndone(instr);
+
+    // Whatever stopped execution happened after this point.
+    controlError = false;
+    errorMessage = "";
+    executionFinished = false;
+    asmBreakpointHit = false;
+    memory->clearErrors();
+    // Stack annotations are only ever appended to, so they no longer describe memory.
+    if(memTrace->activeStack->isStackIntact()) {
+        memTrace->activeStack->setStackIntact(false);
+        memTrace->activeStack->setErrorMessage("Stack trace unavailable after stepping back.");
+    }
+    return true;
+}
+
 void IsaCpu::onISAStep()
 {
     asmBreakpointHit = false;
@@ -109,6 +190,16 @@ void IsaCpu::onISAStep()
     // Also store any other values needed for detailed statistics
     memoizer->storeStateInstrStart();
     memory->onCycleStarted();
+    if(undoLog.isEnabled()) {
+        IsaUndoLog::Frame frame;
+        for(quint8 reg = 0; reg < frame.registers.size(); reg++) {
+            frame.registers[reg] = registerBank.readRegisterByteCurrent(reg);
+        }
+        frame.statusBits = registerBank.readStatusBitsCurrent();
+        frame.operandValue = opValCache;
+        frame.callDepth = callDepth;
+        memory->setWriteJournal(undoLog.beginInstruction(frame));
+    }
     InterfaceISACPU::calculateStackChangeStart(this->getCPURegByteStart(Enu::CPURegisters::IS));
 
     // Load PC from register bank, allocate space for operand if it exists.
@@ -150,20 +241,31 @@ void IsaCpu::onISAStep()
                                              this->getCPURegWordStart(Enu::CPURegisters::SP),
                                              this->getCPURegWordStart(Enu::CPURegisters::PC),
                                              this->getCPURegWordCurrent(Enu::CPURegisters::A));
+    // The ISA level has no clock, so like getCycleCount(), count each instruction as one cycle.
+    if(profiler) profiler->recordInstruction(startPC, is, registerBank.readRegisterWordCurrent(Enu::CPURegisters::PC), 1);
+    if(MemoryAccessStats* stats = memory->getAccessStats()) {
+        stats->recordExecute(startPC, Pep::isUnaryMap[mnemon] ? 1 : 3);
+    }
     memoizer->storeStateInstrEnd();
+    // Writes made outside of an instruction, such as from the UI, are not undoable.
+    if(undoLog.isEnabled()) memory->setWriteJournal(nullptr);
     updateAtInstructionEnd();
     emit asmInstructionFinished();
     asmInstructionCounter++;
 
-    qDebug().noquote().nospace() << memoizer->memoize();
-
     registerBank.flattenFile();
 
     // Modulus must be greater than 1, or there will be no gaurentee of forward progress.
     // If modulus were 1, then debug debug breakpoints that were signaled externally
     // during process events would never be cleared by branch handler.
-    if(asmInstructionCounter % 500 == 0) {
-        QApplication::processEvents();
+    if(snapshotPublisher.isNull()) {
+        if(asmInstructionCounter % 500 == 0) processEvents();
+    }
+    // Only refresh the UI once per frame, so that running is not slowed by redrawing.
+    // Reading the clock is cheap, but not free, so only check it every few instructions.
+    else if(asmInstructionCounter % 64 == 0 && snapshotPublisher->isFrameDue()) {
+        publishSnapshot(asmInstructionCounter, 0, getOperandValue());
+        processEvents();
     }
 
     // If execution finished on this instruction, then restore original starting program counter,
@@ -328,6 +430,7 @@ void IsaCpu::onSimulationStarted()
     asmBreakpointHit = false;
     memoizer->clear();
     memory->clearErrors();
+    undoLog.clear();
     ACPUModel::handler->clearQueuedInterrupts();
 }
 
@@ -388,6 +491,7 @@ void IsaCpu::onResetCPU()
 {
     // Reset all internal state, but keep loaded micropgoram & breakpoints
     ACPUModel::memory->clearErrors();
+    ACPUModel::memory->clearStatistics();
     ACPUModel::handler->clearQueuedInterrupts();
     memoizer->clear();
     InterfaceISACPU::reset();
@@ -400,6 +504,7 @@ void IsaCpu::onResetCPU()
     asmBreakpointHit = false;
     registerBank.clearRegisters();
     registerBank.clearStatusBits();
+    undoLog.clear();
 
 }
 
@@ -2,6 +2,7 @@
 #define ISACPU_H
 #include "interfaceisacpu.h"
 #include <QElapsedTimer>
+#include "isaundolog.h"
 #include "registerfile.h"
 
 /* Though not part of the specification, the trap mechanism  must
@@ -37,6 +38,24 @@ public:
 
     RegisterFile& getRegisterBank();
     const RegisterFile& getRegisterBank() const;
+    // Adopt the ISA visible registers, status bits, and call depth of another CPU that is
+    // between instructions, so that execution continues from the same state at this level.
+    // Must be called after onSimulationStarted(). Memory is not copied.
+    void loadArchitecturalState(const RegisterFile& registers, int callDepth);
+
+    // Reverse execution. While the undo budget is nonzero, every instruction is journaled so that
+    // it may be undone, and the oldest history is discarded to stay within the budget.
+    // Memory mapped input that was consumed is not returned, and the stack trace is marked as
+    // corrupted after stepping back, since it can't be rewound.
+    quint64 getUndoBudget() const noexcept;
+    void setUndoBudget(quint64 bytes);
+    // Number of instructions that may currently be undone.
+    quint64 getUndoDepth() const noexcept;
+    // Undo up to count instructions, returning how many were undone.
+    quint64 stepBack(quint64 count = 1);
+    // Undo at least one instruction, and then continue undoing until the next
+    // instruction to execute is at a breakpoint. Returns true if a breakpoint was reached.
+    bool runBackToBreakpoint();
 
 protected:
     void onISAStep() override;
@@ -72,6 +91,9 @@ private:
     RegisterFile registerBank;
     QElapsedTimer timer;
     IsaCpuMemoizer* memoizer;
+    IsaUndoLog undoLog;
+    // Restore the state from before the most recent instruction, returning false if there was none.
+    bool undoInstruction();
     bool operandWordValueHelper(quint16 operand, Enu::EAddrMode addrMode,
                            bool (AMemoryDevice::*readFunc)(quint16, quint16&) const, quint16& opVal);
     bool operandByteValueHelper(quint16 operand, Enu::EAddrMode addrMode,
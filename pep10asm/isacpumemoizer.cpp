@@ -40,6 +40,12 @@ void IsaCpuMemoizer::storeStateInstrStart()
     cpu.registerBank.setIRCache(instr);
 }
 
+void IsaCpuMemoizer::onInstructionUndone(quint8 instr)
+{
+    if(state.instructionsCalled[instr] > 0) state.instructionsCalled[instr]--;
+    cpu.registerBank.setIRCache(instr);
+}
+
 QString IsaCpuMemoizer::memoize()
 {
     const RegisterFile& file = cpu.registerBank;
@@ -13,6 +13,8 @@ public:
     void clear();
     void storeStateInstrEnd();
     void storeStateInstrStart();
+    // Remove an instruction that was undone from the statistics.
+    void onInstructionUndone(quint8 instr);
     QString memoize();
     QString finalStatistics();
     quint64 getCycleCount();
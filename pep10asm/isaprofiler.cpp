@@ -0,0 +1,191 @@
+#include "isaprofiler.h"
+
+#include <algorithm>
+#include <QStringBuilder>
+#include <QStringList>
+
+#include "asmcode.h"
+#include "asmprogrammanager.h"
+#include "pep.h"
+#include "symbolentry.h"
+
+IsaProfiler::IsaProfiler(): kinds(), executions(1 << 16, 0), cyclesAt(1 << 16, 0),
+    instructionCount(0), cycleCount(0), callSites(), nodes(), children(), current(0), started(false)
+{
+    // Classify instructions the same way the CPU tracks its call depth.
+    for(int it = 0; it < 256; it++) {
+        Enu::EMnemonic mnemon = Pep::decodeMnemonic[it];
+        if(mnemon == Enu::EMnemonic::CALL || Pep::isTrapMap[mnemon]) kinds[it] = Kind::Call;
+        else if(mnemon == Enu::EMnemonic::RET || mnemon == Enu::EMnemonic::SRET) kinds[it] = Kind::Return;
+        else kinds[it] = Kind::Other;
+    }
+    clear();
+}
+
+IsaProfiler::~IsaProfiler() = default;
+
+void IsaProfiler::clear()
+{
+    executions.fill(0);
+    cyclesAt.fill(0);
+    instructionCount = 0;
+    cycleCount = 0;
+    callSites.clear();
+    nodes.clear();
+    nodes.append(Node{-1, 0, 0, 0, 0});
+    children.clear();
+    current = 0;
+    started = false;
+}
+
+void IsaProfiler::recordInstruction(quint16 pc, quint8 is, quint16 nextPC, quint32 cycles)
+{
+    if(!started) {
+        nodes[0].function = pc;
+        started = true;
+    }
+    executions[pc]++;
+    cyclesAt[pc] += cycles;
+    instructionCount++;
+    cycleCount += cycles;
+    // The instruction belongs to the caller, even if it transfers control.
+    nodes[current].instructions++;
+    nodes[current].cycles += cycles;
+
+    switch(kinds[is]) {
+    case Kind::Call:
+    {
+        callSites[static_cast<quint32>(pc) << 16 | nextPC]++;
+        quint64 key = static_cast<quint64>(current) << 16 | nextPC;
+        auto child = children.constFind(key);
+        if(child != children.cend()) current = *child;
+        else {
+            nodes.append(Node{current, nextPC, 0, 0, 0});
+            current = nodes.size() - 1;
+            children.insert(key, current);
+        }
+        nodes[current].calls++;
+        break;
+    }
+    case Kind::Return:
+        // Returning more times than calling, as an OS does when it starts the user program, stays at the root.
+        if(current != 0) current = nodes[current].parent;
+        break;
+    case Kind::Other:
+        break;
+    }
+}
+
+quint64 IsaProfiler::getInstructionCount() const noexcept
+{
+    return instructionCount;
+}
+
+quint64 IsaProfiler::getCycleCount() const noexcept
+{
+    return cycleCount;
+}
+
+quint64 IsaProfiler::getExecutionCount(quint16 pc) const noexcept
+{
+    return executions[pc];
+}
+
+quint64 IsaProfiler::getCycleCount(quint16 pc) const noexcept
+{
+    return cyclesAt[pc];
+}
+
+quint64 IsaProfiler::getCallCount(quint16 site, quint16 target) const
+{
+    return callSites.value(static_cast<quint32>(site) << 16 | target, 0);
+}
+
+QVector<IsaProfiler::FunctionStats> IsaProfiler::getFunctionStats(const SymbolNamer &namer) const
+{
+    QVector<quint64> inclusiveInstructions, inclusiveCycles;
+    subtreeTotals(inclusiveInstructions, inclusiveCycles);
+
+    QHash<quint16, FunctionStats> functions;
+    for(int it = 0; it < nodes.size(); it++) {
+        const Node& node = nodes[it];
+        FunctionStats& stats = functions[node.function];
+        stats.address = node.function;
+        stats.calls += node.calls;
+        stats.exclusiveInstructions += node.instructions;
+        stats.exclusiveCycles += node.cycles;
+        // Only count the outermost call of a recursive function as inclusive,
+        // since the inner calls are already part of its total.
+        bool outermost = true;
+        for(int parent = node.parent; parent != -1 && outermost; parent = nodes[parent].parent) {
+            outermost = nodes[parent].function != node.function;
+        }
+        if(outermost) {
+            stats.inclusiveInstructions += inclusiveInstructions[it];
+            stats.inclusiveCycles += inclusiveCycles[it];
+        }
+    }
+
+    QVector<FunctionStats> ret;
+    ret.reserve(functions.size());
+    for(FunctionStats& stats : functions) {
+        if(stats.inclusiveInstructions == 0) continue;
+        stats.name = namer(stats.address);
+        ret.append(stats);
+    }
+    std::sort(ret.begin(), ret.end(), [](const FunctionStats& lhs, const FunctionStats& rhs) {
+        if(lhs.exclusiveCycles != rhs.exclusiveCycles) return lhs.exclusiveCycles > rhs.exclusiveCycles;
+        return lhs.address < rhs.address;
+    });
+    return ret;
+}
+
+QString IsaProfiler::getFoldedStacks(const SymbolNamer &namer) const
+{
+    // Every node comes after its parent, so each stack is its parent's stack plus one function.
+    QHash<quint16, QString> names;
+    QVector<QString> stacks(nodes.size());
+    QStringList lines;
+    for(int it = 0; it < nodes.size(); it++) {
+        const Node& node = nodes[it];
+        auto name = names.constFind(node.function);
+        if(name == names.cend()) name = names.insert(node.function, namer(node.function));
+        if(node.parent == -1) stacks[it] = *name;
+        else stacks[it] = stacks[node.parent] % ";" % *name;
+        if(node.cycles != 0) lines.append(QString(stacks[it] % " " % QString::number(node.cycles)));
+    }
+    lines.sort();
+    if(lines.isEmpty()) return QString();
+    return lines.join("\n") % "\n";
+}
+
+QString IsaProfiler::hexNamer(quint16 address)
+{
+    return "0x" % QString("%1").arg(address, 4, 16, QLatin1Char('0')).toUpper();
+}
+
+IsaProfiler::SymbolNamer IsaProfiler::symbolNamer(const AsmProgramManager *manager)
+{
+    return [manager](quint16 address) -> QString {
+        const AsmCode* code = manager->getAddressInfo(address).code;
+        if(code != nullptr && code->getMemoryAddress() == address && code->hasSymbolEntry()) {
+            return code->getSymbolEntry()->getName();
+        }
+        return hexNamer(address);
+    };
+}
+
+void IsaProfiler::subtreeTotals(QVector<quint64> &instructions, QVector<quint64> &cycles) const
+{
+    instructions.fill(0, nodes.size());
+    cycles.fill(0, nodes.size());
+    // Visiting children before their parents lets each node add its total to its parent's.
+    for(int it = nodes.size() - 1; it >= 0; it--) {
+        instructions[it] += nodes[it].instructions;
+        cycles[it] += nodes[it].cycles;
+        if(nodes[it].parent != -1) {
+            instructions[nodes[it].parent] += instructions[it];
+            cycles[nodes[it].parent] += cycles[it];
+        }
+    }
+}
@@ -0,0 +1,101 @@
+#ifndef ISAPROFILER_H
+#define ISAPROFILER_H
+
+#include <array>
+#include <functional>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+class AsmProgramManager;
+
+/*
+ * Exact instruction level profiler for ISA programs.
+ *
+ * The CPU reports every instruction it finishes. The profiler counts executions and cycles for each
+ * of the 2^16 program counters, and how often each call site transferred control to each target.
+ * It also follows CALL / trap and RET / SRET to maintain a calling context tree, where each node is
+ * one distinct chain of calls from the root. Recording an instruction only increments counters,
+ * and a hash lookup is only needed when a call happens, so a profiled program runs at nearly
+ * full speed.
+ *
+ * Functions are identified by the address that was called, and names are resolved from symbols
+ * only when a report is generated. Execution outside of any call is attributed to the function
+ * containing the first profiled instruction.
+ */
+class IsaProfiler
+{
+public:
+    // Totals for every call of one function (i.e. the target of a CALL or trap).
+    struct FunctionStats
+    {
+        quint16 address = 0;
+        QString name;
+        quint64 calls = 0;
+        // Inclusive counts include every function called by the function, and are not
+        // double counted for recursive calls. Exclusive counts are only the function's own instructions.
+        quint64 inclusiveInstructions = 0, exclusiveInstructions = 0;
+        quint64 inclusiveCycles = 0, exclusiveCycles = 0;
+    };
+    // Names the function at an address.
+    using SymbolNamer = std::function<QString(quint16)>;
+
+    explicit IsaProfiler();
+    ~IsaProfiler();
+
+    void clear();
+    // Record an instruction, whose instruction specifier was is, that started at pc,
+    // took cycles to execute, and left the program counter at nextPC.
+    void recordInstruction(quint16 pc, quint8 is, quint16 nextPC, quint32 cycles);
+
+    quint64 getInstructionCount() const noexcept;
+    quint64 getCycleCount() const noexcept;
+    quint64 getExecutionCount(quint16 pc) const noexcept;
+    quint64 getCycleCount(quint16 pc) const noexcept;
+    // Number of times the call or trap at site transferred control to target.
+    quint64 getCallCount(quint16 site, quint16 target) const;
+
+    // Statistics for every function that executed an instruction, hottest (by exclusive cycles) first.
+    QVector<FunctionStats> getFunctionStats(const SymbolNamer& namer = hexNamer) const;
+    // One line per distinct call stack, such as "main;fib;fib 42", where the count is the number of
+    // cycles spent in the last function of the stack. This is the folded format of flamegraph.pl.
+    QString getFoldedStacks(const SymbolNamer& namer = hexNamer) const;
+
+    // Names functions by their address in hexadecimal.
+    static QString hexNamer(quint16 address);
+    // Names functions by the symbol labeling the code at their address, or by hexNamer(...)
+    // if no program loaded by the manager labels that address.
+    static SymbolNamer symbolNamer(const AsmProgramManager* manager);
+
+private:
+    enum class Kind : quint8 {
+        Other, Call, Return
+    };
+    // One distinct chain of calls from the root.
+    struct Node
+    {
+        int parent;
+        quint16 function;
+        // Number of times the chain was entered.
+        quint64 calls;
+        // Instructions and cycles executed by the last function of the chain itself.
+        quint64 instructions, cycles;
+    };
+
+    std::array<Kind, 256> kinds;
+    QVector<quint64> executions, cyclesAt;
+    quint64 instructionCount, cycleCount;
+    // Keyed by site << 16 | target.
+    QHash<quint32, quint64> callSites;
+    // nodes[0] is the root, and every node comes after its parent.
+    QVector<Node> nodes;
+    // Keyed by parent << 16 | function.
+    QHash<quint64, int> children;
+    int current;
+    bool started;
+
+    // Inclusive instructions and cycles of each node.
+    void subtreeTotals(QVector<quint64>& instructions, QVector<quint64>& cycles) const;
+};
+
+#endif // ISAPROFILER_H
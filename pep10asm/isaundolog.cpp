@@ -0,0 +1,100 @@
+#include "isaundolog.h"
+
+#include <algorithm>
+
+IsaUndoLog::IsaUndoLog(quint64 budgetBytes, int checkpointInterval):
+    budget(budgetBytes), checkpointInterval(std::max(checkpointInterval, 1))
+{
+
+}
+
+IsaUndoLog::~IsaUndoLog() = default;
+
+quint64 IsaUndoLog::getBudget() const noexcept
+{
+    return budget;
+}
+
+void IsaUndoLog::setBudget(quint64 budgetBytes)
+{
+    budget = budgetBytes;
+    if(budget == 0) clear();
+    else evict();
+}
+
+bool IsaUndoLog::isEnabled() const noexcept
+{
+    return budget != 0;
+}
+
+void IsaUndoLog::clear()
+{
+    segments.clear();
+    depth = 0;
+    sealedBytes = 0;
+}
+
+quint64 IsaUndoLog::getDepth() const noexcept
+{
+    return depth;
+}
+
+quint64 IsaUndoLog::getBytesUsed() const noexcept
+{
+    return sealedBytes + (segments.empty() ? 0 : segments.back().bytes());
+}
+
+QVector<MemoryWriteRecord> *IsaUndoLog::beginInstruction(const Frame &before)
+{
+    // Start a new segment at each checkpoint.
+    if(segments.empty() || segments.back().frames.size() >= checkpointInterval) {
+        if(!segments.empty()) sealedBytes += segments.back().bytes();
+        segments.emplace_back();
+        Segment& segment = segments.back();
+        segment.frames.reserve(checkpointInterval);
+        segment.firstWrite.reserve(checkpointInterval);
+    }
+    Segment& segment = segments.back();
+    segment.frames.append(before);
+    segment.firstWrite.append(segment.writes.size());
+    depth++;
+    evict();
+    return &segment.writes;
+}
+
+bool IsaUndoLog::undoInstruction(AMemoryDevice *memory, Frame &before)
+{
+    if(segments.empty()) return false;
+    Segment& segment = segments.back();
+    int first = segment.firstWrite.last();
+    // Undo writes newest first, so a byte written twice ends with its original value.
+    for(int it = segment.writes.size() - 1; it >= first; it--) {
+        memory->setByte(segment.writes[it].address, segment.writes[it].oldValue);
+    }
+    segment.writes.resize(first);
+    before = segment.frames.last();
+    segment.frames.removeLast();
+    segment.firstWrite.removeLast();
+    depth--;
+    // Once back at its checkpoint, the previous segment resumes growing.
+    if(segment.frames.isEmpty()) {
+        segments.pop_back();
+        if(!segments.empty()) sealedBytes -= segments.back().bytes();
+    }
+    return true;
+}
+
+quint64 IsaUndoLog::Segment::bytes() const noexcept
+{
+    return static_cast<quint64>(frames.size()) * (sizeof(Frame) + sizeof(int))
+            + static_cast<quint64>(writes.size()) * sizeof(MemoryWriteRecord);
+}
+
+void IsaUndoLog::evict()
+{
+    while(segments.size() > 1 && getBytesUsed() > budget) {
+        sealedBytes -= segments.front().bytes();
+        depth -= static_cast<quint64>(segments.front().frames.size());
+        segments.pop_front();
+    }
+}
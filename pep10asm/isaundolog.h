@@ -0,0 +1,78 @@
+#ifndef ISAUNDOLOG_H
+#define ISAUNDOLOG_H
+
+#include <array>
+#include <deque>
+#include <QVector>
+#include "amemorydevice.h"
+
+/*
+ * Journal of executed ISA instructions, which allows an IsaCpu to step backwards.
+ *
+ * Before an instruction executes, the CPU records a frame holding the ISA visible registers,
+ * status bits, and call depth. While it executes, the memory device appends the prior value of
+ * every byte it writes. Undoing an instruction restores those bytes in reverse order and returns
+ * its frame, so stepping back n instructions costs time proportional to n and the number of
+ * bytes they wrote, independent of how long the program has been running.
+ *
+ * Frames are grouped into segments of checkpointInterval instructions, each starting at a
+ * checkpoint. When the journal outgrows its memory budget, whole segments are evicted starting
+ * with the oldest, so the earliest reachable instruction is always a checkpoint and eviction
+ * never has to shift the remaining history. The segment being recorded is never evicted.
+ */
+class IsaUndoLog
+{
+public:
+    // State of the CPU before an instruction executed.
+    struct Frame
+    {
+        // Registers A through OS, which are the only registers ISA level instructions change.
+        std::array<quint8, 13> registers {};
+        quint8 statusBits = 0;
+        quint16 operandValue = 0;
+        int callDepth = 0;
+    };
+
+    // A budget of 0 disables journaling.
+    explicit IsaUndoLog(quint64 budgetBytes = 0, int checkpointInterval = 1024);
+    ~IsaUndoLog();
+
+    quint64 getBudget() const noexcept;
+    // Evicts history until the journal fits within the new budget.
+    void setBudget(quint64 budgetBytes);
+    bool isEnabled() const noexcept;
+
+    void clear();
+    // Number of instructions which may be undone.
+    quint64 getDepth() const noexcept;
+    quint64 getBytesUsed() const noexcept;
+
+    // Start journaling an instruction, which will execute from the state in before. Returns the
+    // journal into which the memory device must write until the next instruction begins.
+    QVector<MemoryWriteRecord>* beginInstruction(const Frame& before);
+    // Restore the bytes written by the most recent instruction through memory->setByte(...), and
+    // remove the instruction from the journal. Returns false if there is nothing to undo.
+    bool undoInstruction(AMemoryDevice* memory, Frame& before);
+
+private:
+    struct Segment
+    {
+        QVector<Frame> frames;
+        // Index of the first write of each frame, so that writes[firstWrite[i]...] belong to frames[i].
+        QVector<int> firstWrite;
+        QVector<MemoryWriteRecord> writes;
+        quint64 bytes() const noexcept;
+    };
+    void evict();
+
+    quint64 budget;
+    int checkpointInterval;
+    // Segments are only added at the back and removed at either end,
+    // so the journal handed to the memory device is never moved.
+    std::deque<Segment> segments;
+    quint64 depth = 0;
+    // Bytes used by every segment except the last, which is still growing.
+    quint64 sealedBytes = 0;
+};
+
+#endif // ISAUNDOLOG_H
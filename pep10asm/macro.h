@@ -29,6 +29,9 @@ struct Macro
     QString macroName;
     quint8 argCount;
     QString macroText;
+    // Core macros are indexed at build time, and their text is read lazily by the
+    // MacroRegistry. If non-empty, macroText has not yet been read from this resource.
+    QString resourcePath;
 };
 
 
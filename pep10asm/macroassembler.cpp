@@ -1,6 +1,7 @@
 #include "macroassembler.h"
 #include "macrotokenizer.h"
 #include <list>
+#include <QtConcurrent>
 #include "pep.h"
 #include "asmcode.h"
 #include "symboltable.h"
@@ -26,43 +27,88 @@ static QList<MacroTokenizerHelper::ELexicalToken> macroArgumentsTypes = nonunary
         << MacroTokenizerHelper::ELexicalToken::LT_DOT_COMMAND
         << MacroTokenizerHelper::ELexicalToken::LT_SYMBOL_DEF;
 MacroAssembler::MacroAssembler(MacroRegistry* registry): registry(registry),
-    tokenBuffer(new TokenizerBuffer())
+    osSymbolTable(nullptr), tokenBuffer(nullptr)
 {
 
 }
 
 MacroAssembler::~MacroAssembler()
 {
-    delete tokenBuffer;
+
+}
+
+void MacroAssembler::setOSSymbolTable(QSharedPointer<const SymbolTable> OSSymbolTable)
+{
+    osSymbolTable = OSSymbolTable;
+}
+
+void MacroAssembler::clearOSSymbolTable()
+{
+    osSymbolTable.reset();
 }
 
 AssemblerResult MacroAssembler::assemble(ModuleAssemblyGraph &graph)
 {
     AssemblerResult retVal;
     retVal.success = true;
-    std::list<ModuleInstance*> toAssemble;
-    toAssemble.emplace_back(graph.getRootInstance().get());
-
-
-    // All modules in a single compilation will share the same symbol table
-    QSharedPointer<SymbolTable> symbolTable = QSharedPointer<SymbolTable>::create();
 
-    while(!toAssemble.empty()) {
-        auto currentModule = toAssemble.front();
-        toAssemble.pop_front();
+    // A module instance paired with the tokens of its (macro substituted) text.
+    struct PendingModule
+    {
+        ModuleInstance* instance;
+        QSharedPointer<TokenizerBuffer> tokens;
+    };
+    // Discover all modules that need to be assembled, in breadth first order from the root.
+    QVector<PendingModule> toAssemble;
+    QSet<ModuleInstance*> discovered;
+    std::list<ModuleInstance*> toVisit;
+    toVisit.emplace_back(graph.getRootInstance().get());
+    while(!toVisit.empty()) {
+        auto currentModule = toVisit.front();
+        toVisit.pop_front();
 
         // If an item has already been assembled, no need to assemble it or
         // discover its dependencies again.
-        if(currentModule->alreadyAssembled == true) continue;
+        if(currentModule->alreadyAssembled == true || discovered.contains(currentModule)) continue;
+        discovered.insert(currentModule);
+        toAssemble.append({currentModule, nullptr});
 
-        currentModule->symbolTable = symbolTable;
         for(auto childInstance : currentModule->prototype->lineToInstance) {
             if(childInstance->alreadyAssembled == false) {
-                toAssemble.emplace_back(childInstance);
+                toVisit.emplace_back(childInstance);
             }
         }
+    }
+
+    // Tokenizing a module depends only on its text and macro arguments, so every
+    // module is tokenized concurrently. Parsing the tokens into code lines must remain
+    // sequential, because all modules define symbols in the same symbol table,
+    // and system call declarations add macros to the registry.
+    QtConcurrent::blockingMap(toAssemble, [](PendingModule& module) {
+        module.tokens = QSharedPointer<TokenizerBuffer>::create();
+        module.tokens->setMacroSubstitutions(module.instance->macroArgs);
+        module.tokens->setTokenizerInput(module.instance->prototype->textLines);
+        module.tokens->tokenizeInput();
+    });
+
+    // All modules in a single compilation will share the same symbol table
+    QSharedPointer<SymbolTable> symbolTable = QSharedPointer<SymbolTable>::create();
+    if(!osSymbolTable.isNull()
+            && graph.getRootInstance()->prototype->moduleType != ModuleType::OPERATING_SYSTEM) {
+        symbolTable->setImportTable(osSymbolTable);
+    }
+
+    // Assemble modules in discovery order, so that the reported error does not
+    // depend on how tokenizing was scheduled.
+    for(auto& module : toAssemble) {
+        auto currentModule = module.instance;
+        currentModule->symbolTable = symbolTable;
+        tokenBuffer = module.tokens;
+        // Release the tokens as soon as the module is assembled.
+        module.tokens.reset();
         qDebug().noquote() << "Assembling module: " << currentModule->prototype->name;
         auto result = assembleModule(graph, *currentModule);
+        tokenBuffer.reset();
         //qDebug().noquote() << "";
         if(!result.success) {
             retVal.success = false;
@@ -83,13 +129,11 @@ MacroAssembler::ModuleResult MacroAssembler::assembleModule(ModuleAssemblyGraph
     ModuleResult result;
     result.success = true;
     quint16 lineNumber = 0;
-    // Make sure tokenizer is prepared to handle this modules macro arguments.
-    tokenBuffer->setMacroSubstitutions(instance.macroArgs);
-    tokenBuffer->setTokenizerInput(instance.prototype->textLines);
-
-    QList<QSharedPointer<AsmCode>> codeList;
+    QList<AsmCode*> codeList;
     QString errorMessage;
     bool dotEndDetected = false;
+    // Lines parsed for the instance are owned by the graph.
+    instance.codeArena = graph.codeArena.data();
     while(tokenBuffer->inputRemains()) {
         auto retVal = assembleLine(graph, instance, errorMessage, dotEndDetected);
 
@@ -158,7 +202,7 @@ MacroAssembler::LineResult MacroAssembler::assembleLine(ModuleAssemblyGraph &gra
             return retVal;
         }
         // Match a comment only line.
-        auto commentLine =  QSharedPointer<CommentOnly>::create();
+        auto commentLine =  instance.codeArena->create<CommentOnly>();
         commentLine->setComment(tokenBuffer->takeLastMatch().second.toString());
         retVal.success = true;
         retVal.codeLine = commentLine;
@@ -170,7 +214,7 @@ MacroAssembler::LineResult MacroAssembler::assembleLine(ModuleAssemblyGraph &gra
         // Take the \n so that it does not clog token buffer.
         tokenBuffer->takeLastMatch();
         retVal.success = true;
-        retVal.codeLine =  QSharedPointer<BlankLine>::create();
+        retVal.codeLine =  instance.codeArena->create<BlankLine>();
         return retVal;
     }
     // Check for the presence of an (optional) symbol.
@@ -214,7 +258,7 @@ MacroAssembler::LineResult MacroAssembler::assembleLine(ModuleAssemblyGraph &gra
 
         // Process a unary instruction
         if(Pep::isUnaryMap.value(mnemonic)) {
-            auto unaryInstruction =  QSharedPointer<UnaryInstruction>::create();
+            auto unaryInstruction =  instance.codeArena->create<UnaryInstruction>();
             unaryInstruction->setMnemonic(mnemonic);
             if(symbolPointer.has_value()) {
                 unaryInstruction->setSymbolEntry(optional_helper(symbolPointer));
@@ -390,13 +434,13 @@ bool MacroAssembler::validateSymbolName(const QStringRef &name, QString &errorMe
     return true;
 }
 
-QSharedPointer<NonUnaryInstruction>
+NonUnaryInstruction*
         MacroAssembler::parseNonUnaryInstruction(Enu::EMnemonic mnemonic,
                                                  std::optional<QSharedPointer<SymbolEntry>> symbol,
                                                  ModuleInstance &instance,QString &errorMessage)
 {
     Enu::EAddrMode addrMode;
-    auto nonUnaryInstruction = QSharedPointer<NonUnaryInstruction>::create();
+    auto nonUnaryInstruction = instance.codeArena->create<NonUnaryInstruction>();
     nonUnaryInstruction->setMnemonic(mnemonic);
     if(symbol.has_value()) {
         nonUnaryInstruction->setSymbolEntry(optional_helper(symbol));
@@ -433,11 +477,11 @@ QSharedPointer<NonUnaryInstruction>
     return nonUnaryInstruction;
 }
 
-QSharedPointer<MacroInvoke>
+MacroInvoke*
         MacroAssembler::parseMacroInstruction(const ModuleAssemblyGraph& graph,
                                               const QString &macroName,
                                               std::optional<QSharedPointer<SymbolEntry> > symbol,
-                                              ModuleInstance &/*instance*/, QString &errorMessage)
+                                              ModuleInstance &instance, QString &errorMessage)
 {
     // Require that the registry already contains a definition for the passed macro.
     if(!registry->hasMacro(macroName)) {
@@ -473,7 +517,7 @@ QSharedPointer<MacroInvoke>
         errorMessage = macroDoesNotExist.arg(macroName);
         return nullptr;
     }
-    QSharedPointer<MacroInvoke> macroInstruction = QSharedPointer<MacroInvoke>::create();
+    MacroInvoke* macroInstruction = instance.codeArena->create<MacroInvoke>();
     if(symbol.has_value()) {
         macroInstruction->setSymbolEntry(optional_helper(symbol));
     }
@@ -568,7 +612,7 @@ Enu::EAddrMode MacroAssembler::stringToAddrMode(QString str) const
     return Enu::EAddrMode::NONE;
 }
 
-QSharedPointer<DotAddrss>
+DotAddrss*
         MacroAssembler::parseADDRSS(std::optional<QSharedPointer<SymbolEntry> > symbol,
                                     ModuleInstance &instance, QString &errorMessage)
 {
@@ -579,7 +623,7 @@ QSharedPointer<DotAddrss>
             errorMessage = longSymbol.arg(tokenString);
             return nullptr;
         }
-        QSharedPointer<DotAddrss> dotAddrss = QSharedPointer<DotAddrss>::create();
+        DotAddrss* dotAddrss = instance.codeArena->create<DotAddrss>();
         if(symbol.has_value()) {
             dotAddrss->setSymbolEntry(optional_helper(symbol));
         }
@@ -592,14 +636,14 @@ QSharedPointer<DotAddrss>
     }
 }
 
-QSharedPointer<DotAscii>
+DotAscii*
         MacroAssembler::parseASCII(std::optional<QSharedPointer<SymbolEntry> > symbol,
                                    ModuleInstance&, QString &errorMessage)
 {
 
     if (tokenBuffer->match(MacroTokenizerHelper::ELexicalToken::LT_STRING_CONSTANT)) {
         QString tokenString = tokenBuffer->takeLastMatch().second.toString();
-        QSharedPointer<DotAscii> dotAscii = QSharedPointer<DotAscii>::create();
+        DotAscii* dotAscii = instance.codeArena->create<DotAscii>();
         if(symbol.has_value()) {
             dotAscii->setSymbolEntry(optional_helper(symbol));
         }
@@ -612,14 +656,14 @@ QSharedPointer<DotAscii>
     }
 }
 
-QSharedPointer<DotAlign>
+DotAlign*
         MacroAssembler::parseALIGN(std::optional<QSharedPointer<SymbolEntry> > symbol,
                                    ModuleInstance&, QString &errorMessage)
 {
     // ALIGN directives may only take integer arguments in (2, 4, 8).
     if (tokenBuffer->match(MacroTokenizerHelper::ELexicalToken::LT_DEC_CONSTANT)) {
         QString tokenString = tokenBuffer->takeLastMatch().second.toString();
-        QSharedPointer<DotAlign> dotAlign = QSharedPointer<DotAlign>::create();
+        DotAlign* dotAlign = instance.codeArena->create<DotAlign>();
         if(symbol.has_value()) {
             dotAlign->setSymbolEntry(optional_helper(symbol));
         }
@@ -641,7 +685,7 @@ QSharedPointer<DotAlign>
     }
 }
 
-QSharedPointer<DotBlock>
+DotBlock*
         MacroAssembler::parseBLOCK(std::optional<QSharedPointer<SymbolEntry> > symbol,
                                    ModuleInstance&, QString &errorMessage)
 {
@@ -650,7 +694,7 @@ QSharedPointer<DotBlock>
         bool ok = false;
         int value = tokenString.toInt(&ok, 10);
         if (ok && (0 <= value) && (value <= 65535)) {
-            QSharedPointer<DotBlock> dotBlock = QSharedPointer<DotBlock>::create();
+            DotBlock* dotBlock = instance.codeArena->create<DotBlock>();
             if(symbol.has_value()) {
                 dotBlock->setSymbolEntry(optional_helper(symbol));
             }
@@ -669,7 +713,7 @@ QSharedPointer<DotBlock>
         bool ok = false;
         int value = tokenString.toInt(&ok, 16);
         if (ok && value < 65536) {
-            QSharedPointer<DotBlock> dotBlock = QSharedPointer<DotBlock>::create();
+            DotBlock* dotBlock = instance.codeArena->create<DotBlock>();
             if(symbol.has_value()) {
                 dotBlock->setSymbolEntry(optional_helper(symbol));
             }
@@ -687,7 +731,7 @@ QSharedPointer<DotBlock>
     }
 }
 
-QSharedPointer<DotBurn>
+DotBurn*
         MacroAssembler::parseBURN(std::optional<QSharedPointer<SymbolEntry> > symbol,
                                   ModuleInstance &instance, QString &errorMessage)
 {
@@ -697,7 +741,7 @@ QSharedPointer<DotBurn>
         bool ok = false;
         int value = tokenString.toInt(&ok, 16);
         if (ok && value < 65536) {
-            QSharedPointer<DotBurn> dotBurn = QSharedPointer<DotBurn>::create();
+            DotBurn* dotBurn = instance.codeArena->create<DotBurn>();
             if(symbol.has_value()) {
                 dotBurn->setSymbolEntry(optional_helper(symbol));
             }
@@ -718,12 +762,12 @@ QSharedPointer<DotBurn>
     }
 }
 
-QSharedPointer<DotByte>
+DotByte*
         MacroAssembler::parseBYTE(std::optional<QSharedPointer<SymbolEntry> > symbol,
                                   ModuleInstance&, QString &errorMessage)
 {
     bool ok;
-    QSharedPointer<DotByte> dotByte = QSharedPointer<DotByte>::create();
+    DotByte* dotByte = instance.codeArena->create<DotByte>();
     if(symbol.has_value()) {
         dotByte->setSymbolEntry(optional_helper(symbol));
     }
@@ -773,7 +817,7 @@ QSharedPointer<DotByte>
     return dotByte;
 }
 
-QSharedPointer<DotEnd>
+DotEnd*
         MacroAssembler::parseEND(std::optional<QSharedPointer<SymbolEntry> > symbol,
                                  ModuleInstance&, QString &errorMessage)
 {
@@ -787,10 +831,10 @@ QSharedPointer<DotEnd>
         return nullptr;
     }
 
-    return QSharedPointer<DotEnd>::create();
+    return instance.codeArena->create<DotEnd>();
 }
 
-QSharedPointer<DotEquate>
+DotEquate*
         MacroAssembler::parseEQUATE(std::optional<QSharedPointer<SymbolEntry> > symbol,
                                     ModuleInstance&, QString &errorMessage)
 {
@@ -800,7 +844,7 @@ QSharedPointer<DotEquate>
     }
 
     bool ok = false;
-    QSharedPointer<DotEquate> dotEquate = QSharedPointer<DotEquate>::create();
+    DotEquate* dotEquate = instance.codeArena->create<DotEquate>();
     if(symbol.has_value()) {
         dotEquate->setSymbolEntry(optional_helper(symbol));
     }
@@ -857,7 +901,7 @@ QSharedPointer<DotEquate>
     return dotEquate;
 }
 
-QSharedPointer<DotExport>
+DotExport*
         MacroAssembler::parseEXPORT(std::optional<QSharedPointer<SymbolEntry> > symbol,
                                  ModuleInstance &instance, QString &errorMessage)
 {
@@ -872,7 +916,7 @@ QSharedPointer<DotExport>
             errorMessage = longSymbol.arg(tokenString);
             return nullptr;
         }
-        QSharedPointer<DotExport> dotExport = QSharedPointer<DotExport>::create();
+        DotExport* dotExport = instance.codeArena->create<DotExport>();
         dotExport->setArgument(QSharedPointer<SymbolRefArgument>::create(instance.symbolTable->reference(tokenString)));
         // Export declares a symbol from the operating system to be visible in user code.
         instance.symbolTable->declareExternal(tokenString);
@@ -884,7 +928,7 @@ QSharedPointer<DotExport>
     }
 }
 
-QSharedPointer<DotSycall> MacroAssembler::parseSCALL(std::optional<QSharedPointer<SymbolEntry> > symbol, ModuleInstance &instance, QString &errorMessage)
+DotSycall* MacroAssembler::parseSCALL(std::optional<QSharedPointer<SymbolEntry> > symbol, ModuleInstance &instance, QString &errorMessage)
 {
     if (symbol.has_value()) {
         errorMessage = scallForbidsSymbol;
@@ -896,7 +940,7 @@ QSharedPointer<DotSycall> MacroAssembler::parseSCALL(std::optional<QSharedPointe
             errorMessage = longSymbol.arg(tokenString);
             return nullptr;
         }
-        QSharedPointer<DotSycall> dotSycall = QSharedPointer<DotSycall>::create();
+        DotSycall* dotSycall = instance.codeArena->create<DotSycall>();
         dotSycall->setArgument(QSharedPointer<SymbolRefArgument>::create(instance.symbolTable->reference(tokenString)));
         // Export declares a symbol from the operating system to be visible in user code.
         bool success = registry->registerNonunarySystemCall(tokenString);
@@ -912,7 +956,7 @@ QSharedPointer<DotSycall> MacroAssembler::parseSCALL(std::optional<QSharedPointe
     }
 }
 
-QSharedPointer<DotUSycall> MacroAssembler::parseUSCALL(std::optional<QSharedPointer<SymbolEntry> > symbol, ModuleInstance &instance, QString &errorMessage)
+DotUSycall* MacroAssembler::parseUSCALL(std::optional<QSharedPointer<SymbolEntry> > symbol, ModuleInstance &instance, QString &errorMessage)
 {
     if (symbol.has_value()) {
         errorMessage = uscallForbidsSymbol;
@@ -924,7 +968,7 @@ QSharedPointer<DotUSycall> MacroAssembler::parseUSCALL(std::optional<QSharedPoin
             errorMessage = longSymbol.arg(tokenString);
             return nullptr;
         }
-        QSharedPointer<DotUSycall> dotUSycall = QSharedPointer<DotUSycall>::create();
+        DotUSycall* dotUSycall = instance.codeArena->create<DotUSycall>();
         dotUSycall->setArgument(QSharedPointer<SymbolRefArgument>::create(instance.symbolTable->reference(tokenString)));
         // Export declares a symbol from the operating system to be visible in user code.
         bool success = registry->registerUnarySystemCall(tokenString);
@@ -940,12 +984,12 @@ QSharedPointer<DotUSycall> MacroAssembler::parseUSCALL(std::optional<QSharedPoin
     }
 }
 
-QSharedPointer<DotWord>
+DotWord*
         MacroAssembler::parseWORD(std::optional<QSharedPointer<SymbolEntry> > symbol,
                                   ModuleInstance&, QString &errorMessage)
 {
     bool ok = false;
-    QSharedPointer<DotWord> dotWord = QSharedPointer<DotWord>::create();
+    DotWord* dotWord = instance.codeArena->create<DotWord>();
     if(symbol.has_value()) {
         dotWord->setSymbolEntry(optional_helper(symbol));
     }
@@ -21,6 +21,10 @@ public:
 
 
     AssemblerResult assemble(ModuleAssemblyGraph& graph);
+    // When assembling a user program, resolve references to symbols exported by the
+    // operating system through the operating system's own table. The table is shared, not copied.
+    void setOSSymbolTable(QSharedPointer<const SymbolTable> OSSymbolTable);
+    void clearOSSymbolTable();
 private:
     struct ModuleResult
     {
@@ -30,8 +34,9 @@ private:
     struct LineResult
     {
         bool success = false;
-        QSharedPointer<AsmCode> codeLine = nullptr;
+        AsmCode* codeLine = nullptr;
     };
+    // Pre: tokenBuffer contains the tokens of instance.
     ModuleResult assembleModule(ModuleAssemblyGraph &graph, ModuleInstance& instance);
     // Pre: errorMessage is an empty string.
     LineResult assembleLine(ModuleAssemblyGraph &graph, ModuleInstance& instance,
@@ -39,56 +44,58 @@ private:
     // Check if the name fits our requirements / length.
     bool validateSymbolName(const QStringRef& name, QString& errorMessage);
 
-    QSharedPointer<NonUnaryInstruction> parseNonUnaryInstruction(Enu::EMnemonic mnemonic,
-                                                                 std::optional<QSharedPointer<SymbolEntry>> symbol,
-                                                                 ModuleInstance& instance,
-                                                                 QString& errorMessage);
+    NonUnaryInstruction* parseNonUnaryInstruction(Enu::EMnemonic mnemonic,
+                                                  std::optional<QSharedPointer<SymbolEntry>> symbol,
+                                                  ModuleInstance& instance,
+                                                  QString& errorMessage);
     QSharedPointer<AsmArgument> parseOperandSpecifier(ModuleInstance &instance, QString& errorMessage);
     Enu::EAddrMode stringToAddrMode(QString str) const;
 
-    QSharedPointer<DotAddrss> parseADDRSS(std::optional<QSharedPointer<SymbolEntry>> symbol,
-                                          ModuleInstance& instance,
-                                          QString& errorMessage);
-    QSharedPointer<DotAscii> parseASCII(std::optional<QSharedPointer<SymbolEntry>> symbol,
-                                        ModuleInstance& instance,
-                                        QString& errorMessage);
-    QSharedPointer<DotAlign> parseALIGN(std::optional<QSharedPointer<SymbolEntry>> symbol,
-                                        ModuleInstance& instance,
-                                        QString& errorMessage);
-    QSharedPointer<DotBlock> parseBLOCK(std::optional<QSharedPointer<SymbolEntry>> symbol,
-                                        ModuleInstance& instance,
-                                        QString& errorMessage);
-    QSharedPointer<DotBurn> parseBURN(std::optional<QSharedPointer<SymbolEntry>> symbol,
-                                      ModuleInstance& instance,
-                                      QString& errorMessage);
-    QSharedPointer<DotByte> parseBYTE(std::optional<QSharedPointer<SymbolEntry>> symbol,
-                                      ModuleInstance& instance,
-                                      QString& errorMessage);
-    QSharedPointer<DotEnd> parseEND(std::optional<QSharedPointer<SymbolEntry>> symbol,
-                                    ModuleInstance& instance,
-                                    QString& errorMessage);
-    QSharedPointer<DotEquate> parseEQUATE(std::optional<QSharedPointer<SymbolEntry>> symbol,
-                                          ModuleInstance& instance,
-                                          QString& errorMessage);
-    QSharedPointer<DotExport> parseEXPORT(std::optional<QSharedPointer<SymbolEntry> > symbol,
-                                          ModuleInstance &instance,
-                                          QString &errorMessage);
-    QSharedPointer<DotSycall> parseSCALL(std::optional<QSharedPointer<SymbolEntry> > symbol,
-                                          ModuleInstance &instance,
-                                          QString &errorMessage);
-    QSharedPointer<DotUSycall> parseUSCALL(std::optional<QSharedPointer<SymbolEntry> > symbol,
-                                            ModuleInstance &instance,
-                                            QString &errorMessage);
-    QSharedPointer<DotWord> parseWORD(std::optional<QSharedPointer<SymbolEntry>> symbol,
+    DotAddrss* parseADDRSS(std::optional<QSharedPointer<SymbolEntry>> symbol,
+                           ModuleInstance& instance,
+                           QString& errorMessage);
+    DotAscii* parseASCII(std::optional<QSharedPointer<SymbolEntry>> symbol,
+                         ModuleInstance& instance,
+                         QString& errorMessage);
+    DotAlign* parseALIGN(std::optional<QSharedPointer<SymbolEntry>> symbol,
+                         ModuleInstance& instance,
+                         QString& errorMessage);
+    DotBlock* parseBLOCK(std::optional<QSharedPointer<SymbolEntry>> symbol,
+                         ModuleInstance& instance,
+                         QString& errorMessage);
+    DotBurn* parseBURN(std::optional<QSharedPointer<SymbolEntry>> symbol,
+                       ModuleInstance& instance,
+                       QString& errorMessage);
+    DotByte* parseBYTE(std::optional<QSharedPointer<SymbolEntry>> symbol,
+                       ModuleInstance& instance,
+                       QString& errorMessage);
+    DotEnd* parseEND(std::optional<QSharedPointer<SymbolEntry>> symbol,
+                     ModuleInstance& instance,
+                     QString& errorMessage);
+    DotEquate* parseEQUATE(std::optional<QSharedPointer<SymbolEntry>> symbol,
+                           ModuleInstance& instance,
+                           QString& errorMessage);
+    DotExport* parseEXPORT(std::optional<QSharedPointer<SymbolEntry> > symbol,
+                           ModuleInstance &instance,
+                           QString &errorMessage);
+    DotSycall* parseSCALL(std::optional<QSharedPointer<SymbolEntry> > symbol,
+                          ModuleInstance &instance,
+                          QString &errorMessage);
+    DotUSycall* parseUSCALL(std::optional<QSharedPointer<SymbolEntry> > symbol,
+                            ModuleInstance &instance,
+                            QString &errorMessage);
+    DotWord* parseWORD(std::optional<QSharedPointer<SymbolEntry>> symbol,
                        ModuleInstance& instance, QString& errorMessage);
 
-    QSharedPointer<MacroInvoke> parseMacroInstruction(const ModuleAssemblyGraph& graph,
-                                                      const QString& macroName,
-                                                      std::optional<QSharedPointer<SymbolEntry>> symbol,
-                                                      ModuleInstance& instance, QString& errorMessage);
+    MacroInvoke* parseMacroInstruction(const ModuleAssemblyGraph& graph,
+                                       const QString& macroName,
+                                       std::optional<QSharedPointer<SymbolEntry>> symbol,
+                                       ModuleInstance& instance, QString& errorMessage);
 
     MacroRegistry* registry;
-    TokenizerBuffer* tokenBuffer;
+    QSharedPointer<const SymbolTable> osSymbolTable;
+    // Tokens of the module currently being assembled.
+    QSharedPointer<TokenizerBuffer> tokenBuffer;
 public:
     static const inline QString unexpectedToken = ";ERROR: Unexpected token %1 encountered.";
     static const inline QString unxpectedEOL = ";ERROR: Found unexpected end of line.";
@@ -41,6 +41,8 @@ ProgramOutput MacroAssemblerDriver::assembleUserProgram(QString input,
         return output;
     }
     // Handle any preprocessor errors.
+    // Exported operating system symbols are resolved through the (shared) OS symbol table.
+    this->assembler->setOSSymbolTable(osSymbol);
     if(!assembleProgram()) {
         output.success = false;
         output.errors = graph.errors;
@@ -67,6 +69,7 @@ ProgramOutput MacroAssemblerDriver::assembleUserProgram(QString input,
     validate(*rootInstance.get());
 
     output.program = QSharedPointer<AsmProgram>::create(rootInstance->codeList,
+                                                        graph.codeArena,
                                                         rootInstance->symbolTable,
                                                         nullptr);
     output.success = true;
@@ -89,6 +92,7 @@ ProgramOutput MacroAssemblerDriver::assembleOperatingSystem(QString input)
         return output;
     }
     // Handle any preprocessor errors.
+    this->assembler->clearOSSymbolTable();
     if(!assembleProgram()) {
         output.success = false;
         output.errors = graph.errors;
@@ -115,6 +119,7 @@ ProgramOutput MacroAssemblerDriver::assembleOperatingSystem(QString input)
 
     validate(*rootInstance.get());
     output.program = QSharedPointer<AsmProgram>::create(rootInstance->codeList,
+                                                        graph.codeArena,
                                                         rootInstance->symbolTable,
                                                         nullptr,
                                                         rootInstance->burnInfo.startROMAddress,
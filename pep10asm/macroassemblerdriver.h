@@ -44,6 +44,10 @@ class MacroStackAnnotater;
  *  The resulting AssemblyGraph is converted into a list of codelines.
  *  Just as in Pep9, we use a tokenizer to assemble our programs.
  *  The assembler adapts which methods are available based on the type of the module being parsed.
+ *  Module instances are tokenized concurrently, but are parsed one at a time in breadth first
+ *  order, since all instances share a symbol table. Errors are therefore reported deterministically.
+ *  Code lines are allocated from the graph's AsmCodeArena rather than individually on the heap.
+ *  The arena is handed to the final AsmProgram, which keeps every line alive.
  *
  * Instancing:
  *  (Copying module instances)
@@ -67,7 +71,9 @@ class MacroStackAnnotater;
  *  a base address, but this failed to correct for the strange behavior of ALIGN.
  * Link:
  *  External symbols (e.g. symbols in the operating system that had a .EXPORT) are pulled into
- *  all modules symbol tables.
+ *  all modules symbol tables. When assembling through assembleUserProgram(...), the user
+ *  program's symbol table imports the operating system's table during the build step instead,
+ *  so exported symbols are shared rather than copied into each user program.
  *  Checks for multiply defined / undefined symbols in module table.
  *  The address of each code line is calculated.
  *
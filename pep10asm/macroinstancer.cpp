@@ -30,8 +30,8 @@ InstanceResult MacroInstancer::instanceModule(ModuleAssemblyGraph graph, ModuleA
 
     for(int lineNum = 0 ; lineNum < instance.codeList.size(); lineNum++) {
         auto line = instance.codeList[lineNum];
-        if(dynamic_cast<MacroInvoke*>(line.get()) != nullptr) {
-            auto macroLine = static_cast<MacroInvoke*>(line.get());
+        if(dynamic_cast<MacroInvoke*>(line) != nullptr) {
+            auto macroLine = static_cast<MacroInvoke*>(line);
             // Copy and swap the moduleInstance. Now we can adjust the code list for the
             // child module without affecting every instance of the macro in the application.
             auto copiedInstance = QSharedPointer<ModuleInstance>::create(*macroLine->getMacroInstance());
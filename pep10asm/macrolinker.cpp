@@ -85,8 +85,13 @@ LinkResult MacroLinker::pullInExports(ModuleAssemblyGraph &graph)
     }
     auto symList = optional_helper(osSymbolTable)->getExternalSymbols();
     auto rootInstance = graph.getRootInstance();
+    // If the program was assembled against the operating system's symbol table,
+    // references to exported symbols already resolve to the operating system's entries,
+    // and only local definitions of those symbols remain. Marking them as redefinitions
+    // of an exported symbol lets linkModule(...) report them.
+    // Otherwise, every local reference to an exported symbol must be pointed at the export.
     for(auto symbol : symList) {
-        if(rootInstance->symbolTable->exists(symbol->getName())) {
+        if(rootInstance->symbolTable->existsLocally(symbol->getName())) {
             rootInstance->symbolTable->define(symbol->getName());
             auto value = QSharedPointer<SymbolValueExternal>::create(symbol);
             rootInstance->symbolTable->setValue(symbol->getName(), value);
@@ -110,14 +115,14 @@ LinkResult MacroLinker::linkModule(ModuleAssemblyGraph graph,
         line->setListingLineNumber(nextSourceLine++);
         // Now that we are assigning addresses, we can properly deduce the number
         // of padding bytes that need to be generated.
-        if(auto asAlign = dynamic_cast<DotAlign*>(line.get()); asAlign != nullptr) {
+        if(auto asAlign = dynamic_cast<DotAlign*>(line); asAlign != nullptr) {
             int alignment = asAlign->getArgument()->getArgumentValue();
             int padding =  (alignment - nextAddress % alignment) % alignment;
             asAlign->setNumBytesGenerated(padding);
         }
         // Must detect object code "address" of .BURN to prevent code generation above
         // the .BURN statement.
-        else if(auto asBurn = dynamic_cast<DotBurn*>(line.get()); asBurn != nullptr) {
+        else if(auto asBurn = dynamic_cast<DotBurn*>(line); asBurn != nullptr) {
             instance.burnInfo.burnAddress = nextAddress;
 
         }
@@ -141,7 +146,7 @@ LinkResult MacroLinker::linkModule(ModuleAssemblyGraph graph,
                 }
 
             }
-            else if(dynamic_cast<DotEquate*>(line.get()) != nullptr)
+            else if(dynamic_cast<DotEquate*>(line) != nullptr)
             {
                 // The value of a .EQUATE is handled in the assembler,
                 // as it is not tied the address of a the current line of code.
@@ -164,13 +169,13 @@ LinkResult MacroLinker::linkModule(ModuleAssemblyGraph graph,
         }
 
         // Handle macro invocations in a depth-first manner.
-        if(dynamic_cast<MacroInvoke*>(line.get()) != nullptr) {
+        if(dynamic_cast<MacroInvoke*>(line) != nullptr) {
             // While a macro line does not have a logical address,
             // storing the current address may help diagnose problems
             // in future steps of the macro assembler.
             line->setMemoryAddress(nextAddress);
             // We don't increment the address, this will be done by children of module.
-            auto macroLine = static_cast<MacroInvoke*>(line.get());
+            auto macroLine = static_cast<MacroInvoke*>(line);
             // Copy and swap the moduleInstance. Now we can adjust the code list for the
             // child module without affecting every instance of the macro in the application.
             auto child = *macroLine->getMacroInstance();
@@ -265,7 +270,7 @@ bool MacroLinker::shiftForBURN(ModuleAssemblyGraph& graph)
     // Find the .BURN directive
     int indexOfBurn = 0;
     for(int it = 0; it < codeList.size(); it++) {
-        if(dynamic_cast<DotBurn*>(codeList[it].get()) != nullptr) {
+        if(dynamic_cast<DotBurn*>(codeList[it]) != nullptr) {
             indexOfBurn = it;
             break;
         }
@@ -289,9 +294,9 @@ bool MacroLinker::shiftForBURN(ModuleAssemblyGraph& graph)
         }
 
         // If the instruction is a .ALIGN, then we must re-calculate the rolling offset.
-        if(dynamic_cast<DotAlign*>(codeList[it].get()) != nullptr) {
+        if(dynamic_cast<DotAlign*>(codeList[it]) != nullptr) {
             // The instruction is known to be an ALIGN directive, so just cast it.
-            DotAlign* asAlign = static_cast<DotAlign*>(codeList[it].get());
+            DotAlign* asAlign = static_cast<DotAlign*>(codeList[it]);
             // The address of the .ALIGN.
             int startAddr = asAlign->getMemoryAddress();
             // The address of the last byte of the .ALIGN.
@@ -124,9 +124,11 @@ QSharedPointer<ModuleInstance> ModuleAssemblyGraph::getRootInstance()
 ModuleInstance::ModuleInstance(const ModuleInstance &other)
 {
     this->burnInfo = other.burnInfo;
-    // Must duplicate entire code list
+    // Must duplicate entire code list. Copies are placed in the same arena as the originals.
+    this->codeArena = other.codeArena;
+    this->codeList.reserve(other.codeList.size());
     for(auto line : other.codeList) {
-        this->codeList.append(QSharedPointer<AsmCode>(line->cloneAsmCode()));
+        this->codeList.append(line->cloneAsmCode(*codeArena));
     }
     // WARNING: Multiple instances now have the same instance index. This is very bad.
     this->instanceIndex = other.instanceIndex;
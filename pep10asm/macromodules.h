@@ -6,6 +6,7 @@
 #include "ngraph.h"
 #include "symboltable.h"
 #include "asmcode.h"
+#include "asmcodearena.h"
 #include "errormessage.h"
 
 // Track the line number an contents of an error message.
@@ -129,7 +130,10 @@ struct ModuleInstance {
      * Information filled in during assembly.
      */
     bool alreadyAssembled;
-    QList<QSharedPointer<AsmCode>> codeList;
+    // Lines are owned by codeArena, which is kept alive by the ModuleAssemblyGraph
+    // (or AsmProgram) that produced them. Copies of the instance clone into the same arena.
+    QList<AsmCode*> codeList;
+    AsmCodeArena* codeArena = nullptr;
     // Information about the presence & value of a .BURN directive.
     MacroBurnInfo burnInfo;
     // All module instances share the same symbol table.
@@ -153,6 +157,7 @@ struct ModuleInstance {
         swap(first.instanceIndex, second.instanceIndex);
         swap(first.burnInfo, second.burnInfo);
         swap(first.codeList, second.codeList);
+        swap(first.codeArena, second.codeArena);
         swap(first.macroArgs, second.macroArgs);
         swap(first.prototype, second.prototype);
         swap(first.traceInfo, second.traceInfo);
@@ -168,6 +173,9 @@ struct ModuleInstance {
  */
 struct ModuleAssemblyGraph
 {
+    // Owns every line of code in every module instance of the graph.
+    // Declared first so that it is destroyed after all instances are released.
+    QSharedPointer<AsmCodeArena> codeArena = QSharedPointer<AsmCodeArena>::create();
     // Map which macros use other macros.
     NGraph::tGraph<quint16> moduleGraph;
     // Map the ID of a vertex to its prototype.
@@ -1,10 +1,25 @@
 #include "macroregistry.h"
 #include "pep.h"
 
-MacroRegistry::MacroRegistry(QString registryName) : macroList()
+namespace {
+struct CoreMacroIndexEntry
 {
-    QString builtinDir = ":/help-asm/macros/builtin";
-    registerCoreMacros(QDir(builtinDir));
+    const char* macroName;
+    quint8 argCount;
+    const char* resourcePath;
+};
+
+// The index is generated by qmake from the contents of help-asm/macros/builtin.
+#define PEP_CORE_MACRO(name, argc, path) {#name, argc, ":/" #path},
+const CoreMacroIndexEntry coreMacroIndex[] = {
+#include "coremacroindex.h"
+};
+#undef PEP_CORE_MACRO
+}
+
+MacroRegistry::MacroRegistry(QString registryName) : macroList(), bodyMutex()
+{
+    registerCoreMacros();
     nonunaryMacroTemplate = Pep::resToString(":/help-asm/macros/systemcall/SCALL.txt", false);
     unaryMacroTemplate = Pep::resToString(":/help-asm/macros/systemcall/USCALL.txt", false);
 }
@@ -28,8 +43,14 @@ QSharedPointer<const Macro> MacroRegistry::getMacro(QString macroName) const
     auto equalIg = [&macroName](const QSharedPointer<Macro>& other){
         return other->macroName.compare(macroName, Qt::CaseInsensitive) == 0;
     };
-    auto item = std::find_if(macroList.cbegin(), macroList.cend(), equalIg);
-    if(item != macroList.end()) {
+    // Macros are usually requested using the same case they were registered with,
+    // so try an exact lookup before falling back to a case insensitive search.
+    auto item = macroList.constFind(macroName);
+    if(item == macroList.cend()) {
+        item = std::find_if(macroList.cbegin(), macroList.cend(), equalIg);
+    }
+    if(item != macroList.cend()) {
+        loadMacroBody(*item.value());
         return item.value();
     }
     return nullptr;
@@ -52,9 +73,20 @@ bool MacroRegistry::registerNonunarySystemCall(QString macroName)
     return registerMacro(macroName, macroText, MacroType::SystemMacro);
 }
 
-bool MacroRegistry::registerCoreMacro(QString macroName, QString macroText)
+bool MacroRegistry::registerCoreMacro(QString macroName, quint8 argCount, QString resourcePath)
 {
-    return registerMacro(macroName, macroText, MacroType::CoreMacro);
+    if(macroList.contains(macroName)) {
+        return false;
+    }
+    // The build time index has already validated the macro's declaration line,
+    // so the macro text need not be read here.
+    QSharedPointer<Macro> newMacro = QSharedPointer<Macro>::create();
+    newMacro->macroName = macroName;
+    newMacro->argCount = argCount;
+    newMacro->type = MacroType::CoreMacro;
+    newMacro->resourcePath = resourcePath;
+    macroList.insert(macroName, newMacro);
+    return true;
 }
 
 QList<QSharedPointer<const Macro> > MacroRegistry::getSytemCalls() const
@@ -141,23 +173,26 @@ std::tuple<bool, QString, quint16> MacroRegistry::macroDefinition(QString macroT
     return {true, name, argCount};
 }
 
-bool MacroRegistry::registerCoreMacros(QDir dir)
+bool MacroRegistry::registerCoreMacros()
 {
     bool retVal = true;
-    for(auto item : dir.entryInfoList()) {
-        if(item.isDir()) {
-            retVal &= registerCoreMacros(QDir(item.filePath()));
-        }
-        else {
-            // Must use macro assembler to validate contents of macros.
-            QString macroName = item.baseName();
-            QString macroText = Pep::resToString(item.filePath(), false);
-            retVal &= registerCoreMacro(macroName, macroText);
-        }
+    for(const auto& entry : coreMacroIndex) {
+        retVal &= registerCoreMacro(QString::fromLatin1(entry.macroName), entry.argCount,
+                                    QString::fromLatin1(entry.resourcePath));
     }
     return retVal;
 }
 
+void MacroRegistry::loadMacroBody(Macro &macro) const
+{
+    QMutexLocker locker(&bodyMutex);
+    if(macro.resourcePath.isEmpty()) {
+        return;
+    }
+    macro.macroText = Pep::resToString(macro.resourcePath, false);
+    macro.resourcePath.clear();
+}
+
 bool MacroRegistry::registerMacro(QString macroName, QString macroText, MacroType type)
 {
     if(macroList.contains(macroName)) {
@@ -182,10 +217,12 @@ bool MacroRegistry::registerMacro(QString macroName, QString macroText, MacroTyp
 QList<QSharedPointer<const Macro> > MacroRegistry::getMacros(MacroType which) const
 {
     QList<QSharedPointer<const Macro>> output;
-    auto filter = [which](const QSharedPointer<Macro>& other){
-        return other->type == which;
-    };
-    std::copy_if(macroList.cbegin(), macroList.cend(),
-                 std::inserter(output, output.end()), filter);
+    for(const auto& macro : macroList) {
+        if(macro->type == which) {
+            // Callers may inspect the text of any returned macro.
+            loadMacroBody(*macro);
+            output.append(macro);
+        }
+    }
     return output;
 }
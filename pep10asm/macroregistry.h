@@ -6,6 +6,7 @@
 #include <QString>
 #include <tuple>
 #include <QFile>
+#include <QMutex>
 #include "macro.h"
 
 /*
@@ -14,6 +15,10 @@
  *
  * Only one macro may exist with the same name - there cannot be multiple macros with the same name
  * and different levels and/or different argument counts.
+ *
+ * Core macros are registered from an index generated at build time (see pep10asm-macroindex.pri),
+ * so constructing a registry reads no files. The text of a core macro is loaded from resources
+ * the first time the macro is requested.
  */
 class MacroRegistry
 {
@@ -39,17 +44,22 @@ public:
     static std::tuple<bool, QString, quint16> macroDefinition(QString macroText);
 private:
     QMap<QString, QSharedPointer<Macro>> macroList;
+    // Guards lazy loading of core macro bodies, which may happen through const accessors.
+    mutable QMutex bodyMutex;
     // "Template" text for macros. Still contains QString::arg() format specifiers,
     // so must be formatted before use. These texts shall have at most 1 format
     // specifier argument.
     QString unaryMacroTemplate;
     QString nonunaryMacroTemplate;
-    // Helper function that discovers all builtin macros.
-    bool registerCoreMacros(QDir dir);
+    // Helper function that registers all builtin macros from the build time index.
+    bool registerCoreMacros();
+    // Read the text of a core macro from resources if it has not yet been loaded.
+    void loadMacroBody(Macro& macro) const;
     bool registerMacro(QString macroName, QString macroText, MacroType type);
     QList<QSharedPointer<const Macro>> getMacros(MacroType which) const;
     // Core macros are auto-deteced, not added by users.
-    bool registerCoreMacro(QString macroName, QString macroText);
+    // Their text is not read until the macro is first requested.
+    bool registerCoreMacro(QString macroName, quint8 argCount, QString resourcePath);
 
 };
 
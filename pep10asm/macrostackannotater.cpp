@@ -148,14 +148,14 @@ void MacroStackAnnotater::discoverLines(ModuleInstance &instance)
     for(auto line : instance.codeList) {
 
         // Recursively discover submodules.
-        if(MacroInvoke* asMacro = dynamic_cast<MacroInvoke*>(line.get());
+        if(MacroInvoke* asMacro = dynamic_cast<MacroInvoke*>(line);
            asMacro != nullptr) {
             discoverLines(*asMacro->getMacroInstance());
         }
 
         // .BLOCK may be a(n) 1) integral type, 2) array of integral types, or 3) a struct, or 4) nothing.
         // Tags are always optional.
-        else if(DotBlock* asBlock = dynamic_cast<DotBlock*>(line.get());
+        else if(DotBlock* asBlock = dynamic_cast<DotBlock*>(line);
                 asBlock != nullptr) {
             if(containsFormatTag(asBlock->getComment()) ||
                containsSymbolTag(asBlock->getComment()) ||
@@ -167,7 +167,7 @@ void MacroStackAnnotater::discoverLines(ModuleInstance &instance)
         }
         // .BYTE may be a(n) 1) integral type.
         // Tags are always optional.
-        else if(DotByte* asByte = dynamic_cast<DotByte*>(line.get());
+        else if(DotByte* asByte = dynamic_cast<DotByte*>(line);
                 asByte != nullptr) {
             if(containsFormatTag(asByte->getComment()) ||
                containsSymbolTag(asByte->getComment()) ||
@@ -179,7 +179,7 @@ void MacroStackAnnotater::discoverLines(ModuleInstance &instance)
         }
         // .EQUATE may be a(n) 1) integral type 2) array of integral types, 3) a struct, or 4) nothing.
         // Tags are always optional.
-        else if(DotEquate* asEquate = dynamic_cast<DotEquate*>(line.get());
+        else if(DotEquate* asEquate = dynamic_cast<DotEquate*>(line);
                 asEquate != nullptr) {
             if(containsFormatTag(asEquate->getComment()) ||
                containsSymbolTag(asEquate->getComment()) ||
@@ -190,7 +190,7 @@ void MacroStackAnnotater::discoverLines(ModuleInstance &instance)
         }
         // .WORD may be a(n) 1) integral type, 2) array of 2 characters.
         // Tags are always optional.
-        else if(DotWord* asWord = dynamic_cast<DotWord*>(line.get());
+        else if(DotWord* asWord = dynamic_cast<DotWord*>(line);
                 asWord != nullptr) {
             if(containsFormatTag(asWord->getComment()) ||
                containsSymbolTag(asWord->getComment()) ||
@@ -201,7 +201,7 @@ void MacroStackAnnotater::discoverLines(ModuleInstance &instance)
             }
         }
         // Unary instructions do not require tags.
-        else if(UnaryInstruction* asUnary = dynamic_cast<UnaryInstruction*>(line.get());
+        else if(UnaryInstruction* asUnary = dynamic_cast<UnaryInstruction*>(line);
                 asUnary != nullptr) {
             if(asUnary->getMnemonic() == Enu::EMnemonic::RET ||
                asUnary->getMnemonic() == Enu::EMnemonic::SRET ||
@@ -217,7 +217,7 @@ void MacroStackAnnotater::discoverLines(ModuleInstance &instance)
         // Non-unary instructions may require tags.
         // If any ADDSP and SUBSP has a tag, then all must have tags.
         // CALL may have a tag if it is calling MALLOC.
-        else if(NonUnaryInstruction* asNonunary = dynamic_cast<NonUnaryInstruction*>(line.get());
+        else if(NonUnaryInstruction* asNonunary = dynamic_cast<NonUnaryInstruction*>(line);
                 asNonunary != nullptr) {
 
             if(asNonunary->getMnemonic() == Enu::EMnemonic::ADDSP ||
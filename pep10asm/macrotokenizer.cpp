@@ -359,6 +359,16 @@ void TokenizerBuffer::setTokenizerInput(QStringList lines)
     matches.clear();
 }
 
+void TokenizerBuffer::tokenizeInput()
+{
+    while(inputIterator < tokenizerInput.size()) {
+        // Error tokens reference errorMessage, which would be overwritten by
+        // an error on a later line. An error ends assembly of a module anyway,
+        // so there is no need to look any further.
+        if(!fetchNextLine()) break;
+    }
+}
+
 bool TokenizerBuffer::inputRemains()
 {
     return (inputIterator < tokenizerInput.size()) || !backedUpInput.isEmpty();
@@ -437,7 +447,7 @@ void TokenizerBuffer::clearMatchBuffer()
     matches.clear();
 }
 
-void TokenizerBuffer::fetchNextLine()
+bool TokenizerBuffer::fetchNextLine()
 {
     // Compiler believes this variable to always be unitialized. This is incorrect,
     // since it is initialized within the getToekn(...) method.
@@ -445,7 +455,7 @@ void TokenizerBuffer::fetchNextLine()
     QStringRef tokenString;
     QList<QPair<MacroTokenizerHelper::ELexicalToken, QStringRef>> newTokens;
     int offset = 0;
-    bool hadMacroInvoke = false;
+    bool hadMacroInvoke = false, hadError = false;
     // Only need to perform macro substitutions once per line.
     tokenizer->performMacroSubstitutions(tokenizerInput[inputIterator]);
     while(token != MacroTokenizerHelper::ELexicalToken::LT_EMPTY) {
@@ -457,6 +467,7 @@ void TokenizerBuffer::fetchNextLine()
             tokenString = QStringRef(&this->errorMessage);
             qDebug().noquote() << token << tokenString;
             backedUpInput.append({token, tokenString});
+            hadError = true;
             break;
         }
 
@@ -473,4 +484,5 @@ void TokenizerBuffer::fetchNextLine()
     }
     backedUpInput.append(newTokens);
     ++inputIterator;
+    return !hadError;
 }
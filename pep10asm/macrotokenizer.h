@@ -113,6 +113,10 @@ public:
     void setMacroSubstitutions(QStringList args);
     void clearMacroSubstitutions();
     void setTokenizerInput(QStringList lines);
+    // Eagerly tokenize all remaining input lines, stopping after the first line
+    // that contains an error. Does not depend on any state outside of this buffer,
+    // so distinct buffers may be tokenized concurrently.
+    void tokenizeInput();
     bool inputRemains();
 
     bool match(MacroTokenizerHelper::ELexicalToken);
@@ -125,7 +129,8 @@ public:
     void clearMatchBuffer();
 private:
     // Grab the next token and place it in backed up input.
-    void fetchNextLine();
+    // Returns false if the line had an error, whose token precedes the line's other tokens.
+    bool fetchNextLine();
 
 };
 
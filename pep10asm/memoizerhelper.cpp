@@ -97,7 +97,8 @@ QString attemptOperSpecReplace(SymbolTable *symTable, quint16 number)
     if(symTable == nullptr) return formatNum(number);
     int count = 0;
     QString name;
-    for(auto it : symTable->getSymbolMap()) {
+    // Operating system symbols are imported rather than copied into the program's table.
+    for(const auto& it : symTable->getSymbolEntries() + symTable->getImportedSymbols()) {
         if(it->getRawValue()->getSymbolType() == SymbolType::ADDRESS) continue;
         if(it->getValue() == number) {
             count++;
@@ -113,7 +114,7 @@ QString attemptAddrReplace(SymbolTable *symTable, quint16 number)
     if(symTable == nullptr) return formatNum(number);
     int count = 0;
     QString name;
-    for(auto it : symTable->getSymbolMap()) {
+    for(const auto& it : symTable->getSymbolEntries() + symTable->getImportedSymbols()) {
         if(it->getRawValue()->getSymbolType() == SymbolType::NUMERIC_CONSTANT) continue;
         if(it->getValue() == number) {
             count++;
@@ -48,6 +48,11 @@ MemoryCellGraphicsItem::~MemoryCellGraphicsItem()
 }
 
 QRectF MemoryCellGraphicsItem::boundingRect() const
+{
+    return cellBounds(x, y);
+}
+
+QRectF MemoryCellGraphicsItem::cellBounds(int x, int y)
 {
     const int Margin = 4;
     return QRectF(QPointF(x - addressWidth - Margin, y - Margin),
@@ -56,6 +61,9 @@ QRectF MemoryCellGraphicsItem::boundingRect() const
 
 void MemoryCellGraphicsItem::updateContents(int newAddr, QString newSymbol, Enu::ESymbolFormat newFmt, int newY)
 {
+    // Moving the cell changes its bounding rectangle, which the scene must be told about before it happens.
+    if(newY != y) prepareGeometryChange();
+    else update();
     this->address = quint16(newAddr);
     if (newSymbol.length() > 0 && newSymbol.at(0).isDigit()) {
         newSymbol = "";
@@ -93,18 +101,23 @@ void MemoryCellGraphicsItem::paint(QPainter *painter, const QStyleOptionGraphics
 
 void MemoryCellGraphicsItem::setModified(bool value)
 {
+    if(isModified == value) return;
     isModified = value;
+    update();
 }
 
 void MemoryCellGraphicsItem::setColorTheme(const PepColors::Colors &newColors)
 {
     this->colors = &newColors;
     backgroundColor = colors->backgroundFill;
+    update();
 }
 
 void MemoryCellGraphicsItem::setBackgroundColor(QColor color)
 {
+    if(backgroundColor == color) return;
     backgroundColor = color;
+    update();
 }
 
 quint16 MemoryCellGraphicsItem::getValue() const
@@ -114,6 +127,7 @@ quint16 MemoryCellGraphicsItem::getValue() const
 
 void MemoryCellGraphicsItem::updateValue()
 {
+    QString oldValue = value;
     quint8 byte;
     quint16 word;
     switch (eSymbolFormat) {
@@ -150,6 +164,8 @@ void MemoryCellGraphicsItem::updateValue()
         iValue = 0;
         break;
     }
+    // Only repaint cells whose text changed, rather than invalidating the whole scene.
+    if(value != oldValue) update();
 
 }
 
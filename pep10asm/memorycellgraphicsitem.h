@@ -37,6 +37,8 @@ public:
     ~MemoryCellGraphicsItem() override;
 
     QRectF boundingRect() const override;
+    // Bounding rectangle of a cell whose box is drawn at (x, y).
+    static QRectF cellBounds(int x, int y);
 
     void updateContents(int newAddr, QString newSymbol, Enu::ESymbolFormat newFmt, int newY);
     void paint(QPainter *painter, const QStyleOptionGraphicsItem *, QWidget *) override;
@@ -18,6 +18,7 @@
     You should have received a copy of the GNU General Public License
     along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
+#include <algorithm>
 #include <QFontDialog>
 #include <QRgb>
 #include "memorytracepane.h"
@@ -37,7 +38,8 @@
 
 NewMemoryTracePane::NewMemoryTracePane(QWidget *parent): QWidget (parent), ui(new Ui::MemoryTracePane),
     colors(&PepColors::lightMode), globalVars(), runtimeStack(), heap(), extraItems(),
-    graphicItemsInStackFrame(), heapFrameItemStack(),
+    graphicItemsInStackFrame(), heapFrameItemStack(), heapFramesShown(0), heapCellsHighlighted(0),
+    modifiedAddresses(), staticsRect(),
     globalLocation(QPointF(0, 0)), stackLocation(QPointF(175, 0)),
     heapLocation (QPointF(350, 0/* - MemoryCellGraphicsItem::boxHeight*/)),
     addressToItems()
@@ -57,7 +59,7 @@ NewMemoryTracePane::NewMemoryTracePane(QWidget *parent): QWidget (parent), ui(ne
 }
 
 void NewMemoryTracePane::init(const AsmProgramManager *manager, QSharedPointer<const ACPUModel> CPU,
-                              QSharedPointer<const MainMemory> memorySection, QSharedPointer<const MemoryTrace> trace)
+                              QSharedPointer<const MainMemory> memorySection, QSharedPointer<MemoryTrace> trace)
 {
     this->manager = manager;
     this->cpu = CPU;
@@ -77,7 +79,6 @@ void NewMemoryTracePane::updateTrace()
     // If the pane is hidden (disabled & no way for the user to ever see it),
     // then updates may be skipped.
     if(trace == nullptr || trace->hasTraceWarnings() || isHidden()) return;
-    updateGlobals();
     // Only render stack / heap if they are still intact.
     if(trace->activeStack->isStackIntact()) updateStack();
     else {
@@ -87,30 +88,13 @@ void NewMemoryTracePane::updateTrace()
     else {
         ui->warningLabel->setText(trace->heapTrace.getErrorMessage());
     }
-    // Using main memory device, update
-    for(quint16 address : memorySection->getBytesWritten()) {
-        if(addressToItems.contains(address)) {
-            addressToItems[address]->setModified(true);
-            addressToItems[address]->updateValue();
-        }
-    }
+    updateValues();
+    updateSceneRect();
 
     // Scroll to the top item if we have a scrollbar:
     if (!runtimeStack.isEmpty() && ui->graphicsView->viewport()->height() < scene->height()) {
         ui->graphicsView->centerOn(runtimeStack.top());
     }
-
-    // This is time-consuming, but worthwhile to ensure scrollbars aren't going off into
-    // oblivion after items are removed.
-    // From the documentation for the 'itemsBoundingRect()' function:
-    // Calculates and returns the bounding rect of all items on the scene.
-    // This function works by iterating over all items, and because if this,
-    // it can be slow for large scenes. It is unlikely that this scene become very large
-    // (as in the 30,000 chips example), so this should remain performant.
-    scene->setSceneRect(scene->itemsBoundingRect());
-
-    scene->invalidate();
-
 }
 
 void NewMemoryTracePane::highlightOnFocus()
@@ -146,6 +130,10 @@ void NewMemoryTracePane::onSimulationStarted()
     addressToItems.clear();
     graphicItemsInStackFrame.clear();
     heapFrameItemStack.clear();
+    heapFramesShown = 0;
+    heapCellsHighlighted = 0;
+    modifiedAddresses.clear();
+    staticsRect = QRectF();
     scene->clear();
     MemoryCellGraphicsItem* ptr = nullptr;
     qreal globaly = globalLocation.y();
@@ -169,23 +157,19 @@ void NewMemoryTracePane::onSimulationStarted()
     globaly -= num * MemoryCellGraphicsItem::boxHeight;
     for(auto tag : trace->globalTrace.getMemTags()) {
         ptr = new MemoryCellGraphicsItem(memorySection.get(),
-                                         tag.addr, tag.type.second,
-                                         tag.type.first,
+                                         tag.addr, tag.type->name,
+                                         tag.type->format,
                                          static_cast<int>(globalLocation.x()),
                                          static_cast<int>(globaly));
         ptr->updateValue();
         scene->addItem(ptr);
         globalVars.push(ptr);
-        addressToItems.insert(tag.addr, ptr);
-        if(ptr->getNumBytes() == 2) {
-            addressToItems.insert((tag.addr + 1) % memorySection->maxAddress(), ptr);
-        }
+        mapCell(ptr);
         globaly += MemoryCellGraphicsItem::boxHeight;
     }
 
     updateStatics();
     updateTrace();
-    scene->invalidate(); // redraw the scene!
 
 }
 
@@ -210,7 +194,7 @@ void NewMemoryTracePane::onDarkModeChanged(bool darkMode)
     QPen pen(colors->textColor);
     pen.setWidth(4);
     for(auto item : this->graphicItemsInStackFrame) {
-        item->setPen(pen);
+        if(item != nullptr) item->setPen(pen);
     }
     for(auto item : this->heapFrameItemStack) {
         item->setPen(pen);
@@ -224,15 +208,6 @@ void NewMemoryTracePane::onMemoryChanged()
     updateTrace();
 }
 
-void NewMemoryTracePane::updateGlobals()
-{
-    // Update the value of all global items
-    for(MemoryCellGraphicsItem* item : globalVars) {
-        item->setModified(false);
-        item->updateValue();
-    }
-}
-
 void NewMemoryTracePane::updateHeap()
 {
     // Pen to draw dark border
@@ -240,74 +215,75 @@ void NewMemoryTracePane::updateHeap()
     pen.setWidth(4);
     // Y location where bold outline should be drawn.
     int frameBase = static_cast<int>(heapLocation.y());
-    // Number of bytes allocated by the current call to malloc, or 0 otherwise.
-    quint16 frameItemCount = 0;
+    const HeapTrace& heapTrace = trace->heapTrace;
+    // Frames are only appended to the heap trace, so fewer frames than were drawn means it was cleared.
+    if(heapTrace.numFrames() < heapFramesShown) {
+        for(auto item : heap) {
+            unmapCell(item);
+            scene->removeItem(item);
+            delete item;
+        }
+        for(auto frame : heapFrameItemStack) {
+            scene->removeItem(frame);
+            delete frame;
+        }
+        heap.clear();
+        heapFrameItemStack.clear();
+        heapFramesShown = 0;
+        heapCellsHighlighted = 0;
+    }
     // Since we want to allocate any previously missed frames,
-    // iterate from the oldest frame to the newest frame,
+    // iterate from the oldest undrawn frame to the newest frame,
     // and shift up any old frame to make room for new ones.
-    for(auto stackFrame = trace->heapTrace.begin();
-        stackFrame != trace->heapTrace.end(); ++stackFrame) {
+    // If the heap can't be added to, leave the remaining frames until it can.
+    for(; heapFramesShown < heapTrace.numFrames() && heapTrace.canAddNew(); heapFramesShown++) {
+        StackFrame stackFrame = heapTrace.getFrame(heapFramesShown);
         // Reset starting y location for each iteration, or multiple frames may be allocated on top of each other
         int yLoc = static_cast<int>(heapLocation.y()) - MemoryCellGraphicsItem::boxHeight;
         // Number of cells in current frame.
-        frameItemCount = stackFrame->numItems();
-        // If a frame has 0 items, it is already allocated (or doesn't matter), otherwise, it might not be allocated.
-        bool frameAdded = frameItemCount == 0;
-        for(auto graphicsItem : heap){
-            // If the first address of any arbitrary item in the current frame is found on the
-            // heap, assume the entire frame has already been sucessfully placed on the heap.
-            if(graphicsItem->getAddress() == stackFrame->begin()->addr) {
-                frameAdded = true;
-                break;
-            }
+        quint16 frameItemCount = stackFrame.numItems();
+        // If a frame has 0 items, there is nothing to draw.
+        if(frameItemCount == 0) continue;
+        // First, shift up all existing heap entries by the size of this frame.
+        for(auto item : heap) {
+            item->moveBy(0, 0 - frameItemCount * MemoryCellGraphicsItem::boxHeight);
         }
-        // If the frame hasn't been added yet and the heap is still
-        // able to be added to (i.e. it is intact), there's work to do.
-        if(!frameAdded && trace->heapTrace.canAddNew()){
-            // First, shift up all existing stack entries by the size of this stack frame.
-            for(auto item : heap) {
-                item->moveBy(0, 0 - frameItemCount * MemoryCellGraphicsItem::boxHeight);
-            }
-            // Shift up the frame outlines by the size of this stack frame
-            for(auto frame: heapFrameItemStack) {
-                frame->moveBy(0, 0 - frameItemCount * MemoryCellGraphicsItem::boxHeight);
-            }
-            // Add the cells from this frame to the heap
-            for(auto memTag = stackFrame->begin();
-                memTag != stackFrame->end(); ++memTag) {
-                MemoryCellGraphicsItem* item = new MemoryCellGraphicsItem(memorySection.get(), memTag->addr,
-                                                  memTag->type.second, memTag->type.first,
-                                                  static_cast<int>(heapLocation.x()),
-                                                                          yLoc);
-                item->setColorTheme(*colors);
-                addressToItems.insert(item->getAddress(), item);
-                if(item->getNumBytes() == 2) addressToItems.insert(item->getAddress() + 1, item);
-                heap.append(item);
-                scene->addItem(item);
-                yLoc -= MemoryCellGraphicsItem::boxHeight;
-            }
-            // Add the bolded frame
-            QGraphicsRectItem * rectItem = new QGraphicsRectItem(heapLocation.x() - 2, frameBase,
-                              static_cast<qreal>(MemoryCellGraphicsItem::boxWidth + 4),
-                              - static_cast<qreal>(MemoryCellGraphicsItem::boxHeight * stackFrame->numItems()), nullptr);
-            scene->addItem(rectItem);
-            rectItem->setPen(pen);
-            rectItem->setZValue(1.0); // This moves the frame to the front
-            heapFrameItemStack.push(rectItem);
+        // Shift up the frame outlines by the size of this frame
+        for(auto frame: heapFrameItemStack) {
+            frame->moveBy(0, 0 - frameItemCount * MemoryCellGraphicsItem::boxHeight);
         }
-
+        // Add the cells from this frame to the heap
+        for(const MemTag& memTag : stackFrame) {
+            MemoryCellGraphicsItem* item = new MemoryCellGraphicsItem(memorySection.get(), memTag.addr,
+                                                                      memTag.type->name, memTag.type->format,
+                                                                      static_cast<int>(heapLocation.x()), yLoc);
+            item->setColorTheme(*colors);
+            item->updateValue();
+            mapCell(item);
+            heap.append(item);
+            scene->addItem(item);
+            yLoc -= MemoryCellGraphicsItem::boxHeight;
+        }
+        // Add the bolded frame
+        QGraphicsRectItem * rectItem = new QGraphicsRectItem(heapLocation.x() - 2, frameBase,
+                          static_cast<qreal>(MemoryCellGraphicsItem::boxWidth + 4),
+                          - static_cast<qreal>(MemoryCellGraphicsItem::boxHeight * frameItemCount), nullptr);
+        scene->addItem(rectItem);
+        rectItem->setPen(pen);
+        rectItem->setZValue(1.0); // This moves the frame to the front
+        heapFrameItemStack.push(rectItem);
     }
-    // Update the contents of every cell in the memory view
-    for (auto item : heap) {
-        item->setModified(false);
-        item->updateValue();
-        item->setBackgroundColor(colors->backgroundFill);
+
+    // Only the cells of the newest frame are ever highlighted, so only they need to be reset.
+    for(int it = heap.size() - heapCellsHighlighted; it < heap.size(); it++) {
+        heap[it]->setBackgroundColor(colors->backgroundFill);
     }
+    heapCellsHighlighted = 0;
     // If currently in malloc, and there are items to highlight, highlight (in green) the last added frame.
-    if(trace->heapTrace.inMalloc()
-            && trace->heapTrace.crbegin() != trace->heapTrace.crend()) {
-        for(int it = 0; it < trace->heapTrace.crbegin()->numItems(); it++) {
-            heap[heap.size() - 1 - it]->setBackgroundColor(Qt::green);
+    if(heapTrace.inMalloc() && heapFramesShown > 0 && heapFramesShown == heapTrace.numFrames()) {
+        heapCellsHighlighted = heapTrace.getFrame(heapFramesShown - 1).numItems();
+        for(int it = heap.size() - heapCellsHighlighted; it < heap.size(); it++) {
+            heap[it]->setBackgroundColor(Qt::green);
         }
     }
 }
@@ -317,144 +293,163 @@ void NewMemoryTracePane::updateStack()
     // Pen to draw dark border
     QPen pen(colors->textColor);
     pen.setWidth(4);
+    StackTrace* stack = trace->activeStack;
+    const QVector<MemTag>& tags = stack->getMemTags();
+    // Tags and frames below the first change are still drawn correctly, so only the top of the
+    // stack needs to be redrawn. Cells that aren't on the runtime stack yet are always drawn.
+    StackTrace::Changes changes = stack->takeChanges();
+
+    // Point the cells whose tags may have changed at their new tags.
+    int firstTag = std::min(changes.firstTag, runtimeStack.size());
+    int keptTags = std::min(tags.size(), runtimeStack.size());
+    for(int it = firstTag; it < keptTags; it++) {
+        bindCell(runtimeStack[it], tags[it], stackCellY(it));
+    }
 
-    // Pointer to item being rendered.
-    MemoryCellGraphicsItem * item = nullptr;
-    // Items that are being added to the runtime stack this cycle.
-    QList<MemoryCellGraphicsItem *> newItems = {};
-    // Mantain cache of usable rectangle to avoid useless memory allocations
-    QStack<QGraphicsRectItem *> itemCache = graphicItemsInStackFrame;
-    graphicItemsInStackFrame.clear();
-    // Iterator to traverse the items already on the runtime stack.
-    QStack<MemoryCellGraphicsItem *>::iterator rtit = runtimeStack.begin();
-    // Iterator to traverse the unused graphics items that are lying around.
-    QList<MemoryCellGraphicsItem *>::iterator exit = extraItems.begin();
-    int yLoc = static_cast<int>(stackLocation.y()) - MemoryCellGraphicsItem::boxHeight;
-    int frameBase;
-    for(auto stackFrame = trace->activeStack->cbegin();
-        stackFrame != trace->activeStack->cend(); ++stackFrame) {
-        // Store the bottom Y value of this stack frame,
-        // so that a bold outline might be drawn around it.
-        frameBase = yLoc + MemoryCellGraphicsItem::boxHeight;
-        for(auto memTag = stackFrame->begin();
-            memTag != stackFrame->end(); ++memTag) {
-
-            // Exhaust items on the runtime stack.
-            if(rtit != runtimeStack.cend()) {
-                // If the current tag does not match the item at the current
-                // position on the runtime stack, extra cleanup work todo
-                if((*rtit)->getAddress() != memTag->addr) {
-                    // Remove old entry's address from the lookup map,
-                    // else a modifcation to that address might effect this one.
-                    addressToItems.remove((*rtit)->getAddress());
-                    if((*rtit)->getNumBytes() == 2) addressToItems.remove((*rtit)->getAddress() + 1);
-                    (*rtit)->updateContents(memTag->addr, memTag->type.second, memTag->type.first, yLoc);
-                    // Add updated cell to address lookup map.
-                    addressToItems.insert((*rtit)->getAddress(), (*rtit));
-                    if((*rtit)->getNumBytes() == 2) addressToItems.insert((*rtit)->getAddress() + 1, (*rtit));
-                }
-                // Set the item whose contents are to be updated.
-                item = *rtit;
-                ++rtit;
-            }
-
-            // Then exhaust extra cached items.
-            else if(exit != extraItems.end()) {
-                // Take an item from the extra list and update its contents.
-                item = *exit;
-                item->updateContents(memTag->addr, memTag->type.second, memTag->type.first, yLoc);
-                item->setColorTheme(*colors);
-                // Add updated cell to address lookup map.
-                addressToItems.insert(item->getAddress(), item);
-                if(item->getNumBytes() == 2) addressToItems.insert(item->getAddress() + 1, item);
-                ++exit;
-                // Remove item from extra list, and append it to the list of newly added items this update pass.
-                extraItems.pop_front();
-                newItems.append(item);
-                scene->addItem(item);
-
-            }
-
-            // Then start creating new items
-            else {
-                // No cached items, so must allocate some via new.
-                item = new MemoryCellGraphicsItem(memorySection.get(), memTag->addr,
-                                                  memTag->type.second, memTag->type.first,
-                                                  static_cast<int>(stackLocation.x()), yLoc);
-                item->setColorTheme(*colors);
-                // Add updated cell to address lookup map.
-                addressToItems.insert(item->getAddress(), item);
-                if(item->getNumBytes() == 2) addressToItems.insert(item->getAddress() + 1, item);
-                newItems.append(item);
-                scene->addItem(item);
-            }
+    // Remove items from rendering on runtime stack if they have been popped.
+    // Cache the items, to save calls to new.
+    while(runtimeStack.size() > tags.size()) {
+        MemoryCellGraphicsItem* item = runtimeStack.pop();
+        unmapCell(item);
+        scene->removeItem(item);
+        extraItems.append(item);
+    }
 
-            // Adjust location of next stack item to account for the most recently processed item
-            yLoc -= MemoryCellGraphicsItem::boxHeight;
-            item->setModified(false);
+    // Draw the pushed tags, preferring cached items to creating new ones.
+    for(int it = runtimeStack.size(); it < tags.size(); it++) {
+        MemoryCellGraphicsItem* item;
+        if(!extraItems.isEmpty()) {
+            item = extraItems.takeLast();
+            bindCell(item, tags[it], stackCellY(it));
+        }
+        else {
+            item = new MemoryCellGraphicsItem(memorySection.get(), tags[it].addr,
+                                              tags[it].type->name, tags[it].type->format,
+                                              static_cast<int>(stackLocation.x()), stackCellY(it));
             item->updateValue();
+            mapCell(item);
         }
+        item->setColorTheme(*colors);
+        scene->addItem(item);
+        runtimeStack.push(item);
+    }
 
+    // Redraw the outlines of changed frames, reusing the outlines that are already in the scene.
+    int firstFrame = std::min(changes.firstFrame, graphicItemsInStackFrame.size());
+    for(int it = firstFrame; it < stack->numFrames(); it++) {
+        StackFrame stackFrame = stack->getFrame(it);
+        if(it == graphicItemsInStackFrame.size()) graphicItemsInStackFrame.push(nullptr);
+        QGraphicsRectItem *&outline = graphicItemsInStackFrame[it];
         // If a frame is orphaned or incomplete, it should not be outlined.
-        if(stackFrame->isOrphaned == false) {
-            QGraphicsRectItem * item;
-            // If there are no leftover frame outlines, start creating new ones
-            if(itemCache.isEmpty()) {
-            item = new QGraphicsRectItem(stackLocation.x() - 2, frameBase,
-                              static_cast<qreal>(MemoryCellGraphicsItem::boxWidth + 4),
-                              - static_cast<qreal>(MemoryCellGraphicsItem::boxHeight * stackFrame->numItems()), nullptr);
-                scene->addItem(item);
+        if(stackFrame.isOrphaned) {
+            if(outline != nullptr) {
+                scene->removeItem(outline);
+                delete outline;
+                outline = nullptr;
             }
-            // Otherwise reuse an old outline.
-            else {
-                item = itemCache.takeFirst();
-                item->setRect(stackLocation.x() - 2, frameBase,
-                              static_cast<qreal>(MemoryCellGraphicsItem::boxWidth + 4),
-                              - static_cast<qreal>(MemoryCellGraphicsItem::boxHeight * stackFrame->numItems()));
-            }
-            item->setPen(pen);
-            graphicItemsInStackFrame.push(item);
-            item->setZValue(1.0); // This moves the stack frame to the front
+            continue;
         }
+        // The bottom Y value of this stack frame, around which the bold outline is drawn.
+        int frameBase = stackCellY(static_cast<int>(stackFrame.begin() - tags.constData()))
+                + MemoryCellGraphicsItem::boxHeight;
+        QRectF rect(stackLocation.x() - 2, frameBase,
+                    static_cast<qreal>(MemoryCellGraphicsItem::boxWidth + 4),
+                    - static_cast<qreal>(MemoryCellGraphicsItem::boxHeight * stackFrame.numItems()));
+        if(outline == nullptr) {
+            outline = new QGraphicsRectItem(rect, nullptr);
+            outline->setPen(pen);
+            outline->setZValue(1.0); // This moves the stack frame to the front
+            scene->addItem(outline);
+        }
+        else outline->setRect(rect);
     }
 
-    // Remove items from rendering on runtime stack if they have been popped.
-    // Cache the items, to save calls to new.
-    while(rtit != runtimeStack.cend()) {
-        addressToItems.remove((*rtit)->getAddress());
-        if((*rtit)->getNumBytes() == 2) addressToItems.remove((*rtit)->getAddress() + 1);
-        scene->removeItem(*rtit);
-        extraItems.append(*rtit);
-        // Don't need to delete items, as they have been sucessfully appended to extraItems.
-        rtit = runtimeStack.erase(rtit);
-    }
-
-    // Delete additional frame outlines. These should be cached, but the performance gain should be minimal
-    while(!itemCache.isEmpty()) {
-        QGraphicsRectItem * item = itemCache.takeFirst();
+    // Delete the outlines of frames that have been popped.
+    while(graphicItemsInStackFrame.size() > stack->numFrames()) {
+        QGraphicsRectItem * item = graphicItemsInStackFrame.pop();
+        if(item == nullptr) continue;
         scene->removeItem(item);
         delete item;
     }
+}
 
-    // Move newItems to runtime stack.
-    // Don't move them until after updating stack,
-    // since adding items would confuse our non-mutable iterators.
-    for(auto item : newItems) {
-        runtimeStack.push(item);
+void NewMemoryTracePane::updateValues()
+{
+    for(quint16 address : modifiedAddresses) {
+        MemoryCellGraphicsItem* item = addressToItems.value(address, nullptr);
+        if(item != nullptr) item->setModified(false);
+    }
+    modifiedAddresses.clear();
+    // Memory only changes through writes by the program, or by the user setting bytes,
+    // so every other cell still shows the right value.
+    for(quint16 address : memorySection->getBytesSet()) {
+        MemoryCellGraphicsItem* item = addressToItems.value(address, nullptr);
+        if(item != nullptr) item->updateValue();
+    }
+    for(quint16 address : memorySection->getBytesWritten()) {
+        MemoryCellGraphicsItem* item = addressToItems.value(address, nullptr);
+        if(item == nullptr) continue;
+        item->setModified(true);
+        item->updateValue();
+        modifiedAddresses.append(address);
+    }
+}
+
+void NewMemoryTracePane::updateSceneRect()
+{
+    // Every column grows up from y = 0, so the scene spans the tallest column, and the lines under the stack.
+    // Computing this is much cheaper than scene->itemsBoundingRect(), which visits every item in the scene.
+    int cells = std::max({globalVars.size(), runtimeStack.size(), heap.size()});
+    QRectF rect = MemoryCellGraphicsItem::cellBounds(static_cast<int>(globalLocation.x()),
+                                                     -cells * MemoryCellGraphicsItem::boxHeight)
+            | MemoryCellGraphicsItem::cellBounds(static_cast<int>(heapLocation.x()),
+                                                 -MemoryCellGraphicsItem::boxHeight)
+            | staticsRect;
+    // Ensure scrollbars aren't going off into oblivion after items are removed.
+    if(rect != scene->sceneRect()) scene->setSceneRect(rect);
+}
+
+int NewMemoryTracePane::stackCellY(int tag) const
+{
+    return static_cast<int>(stackLocation.y()) - MemoryCellGraphicsItem::boxHeight * (tag + 1);
+}
+
+void NewMemoryTracePane::bindCell(MemoryCellGraphicsItem *item, const MemTag &tag, int y)
+{
+    unmapCell(item);
+    item->updateContents(tag.addr, tag.type->name, tag.type->format, y);
+    item->setModified(false);
+    item->updateValue();
+    mapCell(item);
+}
+
+void NewMemoryTracePane::mapCell(MemoryCellGraphicsItem *item)
+{
+    addressToItems.insert(item->getAddress(), item);
+    if(item->getNumBytes() == 2) addressToItems.insert(static_cast<quint16>(item->getAddress() + 1), item);
+}
+
+void NewMemoryTracePane::unmapCell(MemoryCellGraphicsItem *item)
+{
+    // Only remove the entries that still refer to this item, since another cell may have taken its address.
+    quint16 address = item->getAddress();
+    if(addressToItems.value(address, nullptr) == item) addressToItems.remove(address);
+    if(item->getNumBytes() == 2 && addressToItems.value(static_cast<quint16>(address + 1), nullptr) == item) {
+        addressToItems.remove(static_cast<quint16>(address + 1));
     }
 }
 
 void NewMemoryTracePane::updateStatics()
 {
     // Add lines under stack
-    scene->addLine(stackLocation.x() - MemoryCellGraphicsItem::boxWidth * 0.2, stackLocation.y(),
+    staticsRect |= scene->addLine(stackLocation.x() - MemoryCellGraphicsItem::boxWidth * 0.2, stackLocation.y(),
                    stackLocation.x() + MemoryCellGraphicsItem::boxWidth * 1.2, stackLocation.y(),
-                   QPen(QBrush(colors->textColor, Qt::SolidPattern), 2, Qt::SolidLine));
+                   QPen(QBrush(colors->textColor, Qt::SolidPattern), 2, Qt::SolidLine))->boundingRect();
     int dist = static_cast<int>(MemoryCellGraphicsItem::boxWidth * 1.2 - MemoryCellGraphicsItem::boxWidth * 1.4);
     for (int i = static_cast<int>(MemoryCellGraphicsItem::boxWidth * 1.2); i > dist; i = i - 10) {
-        scene->addLine(stackLocation.x() + i - 10, stackLocation.y() + 10,
+        staticsRect |= scene->addLine(stackLocation.x() + i - 10, stackLocation.y() + 10,
                        stackLocation.x() + i, stackLocation.y() + 1,
-                       QPen(QBrush(colors->textColor, Qt::SolidPattern), 1, Qt::SolidLine));
+                       QPen(QBrush(colors->textColor, Qt::SolidPattern), 1, Qt::SolidLine))->boundingRect();
     }
 
 }
@@ -36,6 +36,7 @@ class MainMemory;
 class MemoryTrace;
 class AsmProgramManager;
 class ACPUModel;
+struct MemTag;
 class NewMemoryTracePane : public QWidget {
     Q_OBJECT
     Q_DISABLE_COPY(NewMemoryTracePane)
@@ -43,7 +44,7 @@ public:
     explicit NewMemoryTracePane(QWidget *parent = nullptr);
     // Must be called after construction but before the component is used.
     void init(const AsmProgramManager *manager, QSharedPointer<const ACPUModel> CPU,
-              QSharedPointer<const MainMemory> memorySection, QSharedPointer<const MemoryTrace> trace);
+              QSharedPointer<const MainMemory> memorySection, QSharedPointer<MemoryTrace> trace);
     virtual ~NewMemoryTracePane() override;
     void updateTrace();
 
@@ -64,17 +65,26 @@ public slots:
     void onDarkModeChanged(bool darkMode);
     void onMemoryChanged();
 private:
-    void updateGlobals();
     void updateHeap();
     void updateStack();
+    // Refresh the cells whose memory was written, and un-highlight the cells modified last update.
+    void updateValues();
     void updateStatics();
+    void updateSceneRect();
+    // Y location of the cell for the tag-th tag on the stack, counting from the bottom.
+    int stackCellY(int tag) const;
+    // Point an existing cell at tag, drawn at y, and refresh its value.
+    void bindCell(MemoryCellGraphicsItem *item, const MemTag &tag, int y);
+    void mapCell(MemoryCellGraphicsItem *item);
+    void unmapCell(MemoryCellGraphicsItem *item);
 
     Ui::MemoryTracePane *ui;
     const PepColors::Colors *colors;
     const AsmProgramManager *manager;
     QSharedPointer<const ACPUModel> cpu;
     QSharedPointer<const MainMemory> memorySection;
-    QSharedPointer<const MemoryTrace> trace;
+    // Not const, since the pane takes the changes of the stack trace each time it is drawn.
+    QSharedPointer<MemoryTrace> trace;
     QGraphicsScene *scene;
     // Stack of the global variables
     QStack<MemoryCellGraphicsItem *> globalVars;
@@ -85,10 +95,19 @@ private:
     // Cached items from the memory view that can be re-used to reduce # of calls to new.
     QList<MemoryCellGraphicsItem *> extraItems;
 
-    // Stack of *items used to access the stack frames.
+    // Outline of each frame on the stack, indexed like the frames of the stack trace.
+    // Orphaned frames are not outlined, so their entries are nullptr.
     QStack<QGraphicsRectItem *> graphicItemsInStackFrame;
     // Stack of *items for the heap graphic frames.
     QStack<QGraphicsRectItem *> heapFrameItemStack;
+    // Number of frames of the heap trace that have been drawn.
+    int heapFramesShown;
+    // Number of cells at the end of heap that are highlighted as being allocated by malloc.
+    int heapCellsHighlighted;
+    // Addresses whose cells were highlighted as modified by the last update.
+    QList<quint16> modifiedAddresses;
+    // Bounds of the lines drawn by updateStatics().
+    QRectF staticsRect;
 
     // This is the location where global items start.
     const QPointF globalLocation;
@@ -19,6 +19,7 @@ FORMS += \
 HEADERS += \
     asmargument.h \
     asmcode.h \
+    asmcodearena.h \
     asmobjectcodepane.h \
     asmprogram.h \
     asmprogrammanager.h \
@@ -52,6 +53,8 @@ HEADERS += \
     asmcpupane.h \
     isacpu.h \
     isacpumemoizer.h \
+    isaprofiler.h \
+    isaundolog.h \
     memoizerhelper.h \
     asmprogramtracepane.h \
     asmprogramlistingpane.h \
@@ -60,6 +63,7 @@ HEADERS += \
 SOURCES += \
     asmargument.cpp \
     asmcode.cpp \
+    asmcodearena.cpp \
     asmobjectcodepane.cpp \
     asmprogram.cpp \
     asmprogrammanager.cpp \
@@ -89,7 +93,12 @@ SOURCES += \
     asmcpupane.cpp \
     isacpu.cpp \
     isacpumemoizer.cpp \
+    isaprofiler.cpp \
+    isaundolog.cpp \
     memoizerhelper.cpp \
     asmprogramtracepane.cpp \
     asmprogramlistingpane.cpp \
     assemblerpane.cpp
+
+# Index of builtin macros, used by MacroRegistry.
+include($$PWD/pep10asm-macroindex.pri)
@@ -0,0 +1,41 @@
+# -------------------------------------------------
+# Builtin macro index generation.
+# -------------------------------------------------
+# Walk the builtin macro directory when qmake runs, and record each macro's name,
+# argument count, and resource path in coremacroindex.h. MacroRegistry compiles
+# this index in, so it does not need to walk the resource tree at startup, and
+# macro bodies are only read from resources when a macro is first requested.
+#
+# Re-run qmake after adding, removing, or renaming a builtin macro.
+CORE_MACRO_ROOT = $$PWD/help-asm/macros/builtin
+CORE_MACRO_FILES = $$files($$CORE_MACRO_ROOT/*.pepm, true)
+CORE_MACRO_INDEX = $$OUT_PWD/coremacroindex.h
+
+CORE_MACRO_LINES = "// Generated by pep10asm-macroindex.pri. Do not edit."
+CORE_MACRO_LINES += "// Each entry is PEP_CORE_MACRO(name, argument count, resource path)."
+for(macroFile, CORE_MACRO_FILES) {
+    # A macro file must begin with a line of the form "@NAME argc".
+    macroLines = $$cat($$macroFile, lines)
+    macroDecl = $$first(macroLines)
+    macroDecl = $$replace(macroDecl, "@", "")
+    macroParts = $$split(macroDecl, " ")
+    macroName = $$member(macroParts, 0)
+    macroArgs = $$member(macroParts, 1)
+    isEmpty(macroName)|isEmpty(macroArgs) {
+        warning("Skipping builtin macro $$macroFile: malformed macro declaration.")
+        next()
+    }
+    # The declared name must match the file name, ignoring case.
+    macroFileName = $$basename(macroFile)
+    macroFileName = $$section(macroFileName, ".", 0, 0)
+    macroNameLower = $$lower($$macroName)
+    !equals(macroNameLower, $$lower($$macroFileName)) {
+        warning("Skipping builtin macro $$macroFile: declared name does not match file name.")
+        next()
+    }
+    macroPath = $$relative_path($$macroFile, $$PWD)
+    CORE_MACRO_LINES += "PEP_CORE_MACRO($$macroName, $$macroArgs, $$macroPath)"
+}
+write_file($$CORE_MACRO_INDEX, CORE_MACRO_LINES)|error("Could not write $$CORE_MACRO_INDEX.")
+
+INCLUDEPATH += $$OUT_PWD
@@ -1,21 +1,8 @@
 #include "stacktrace.h"
-#include "typetags.h"
-#include "symbolentry.h"
+#include <algorithm>
+#include <limits>
+#include "asmprogram.h"
 #include "enu.h"
-#include <QTextStream>
-#include "amemorydevice.h"
-
-StackTrace::iterator StackTrace::begin()
-{
-    return iterator(*this);
-}
-
-StackTrace::iterator StackTrace::end()
-{
-    int size = callStack.size();
-    if(!nextFrame.isNull()) ++size;
-    return iterator(*this, size);
-}
 
 StackTrace::const_iterator StackTrace::begin() const
 {
@@ -29,24 +16,12 @@ StackTrace::const_iterator StackTrace::end() const
 
 StackTrace::const_iterator StackTrace::cbegin() const
 {
-    return const_iterator(*this);
+    return const_iterator(tags, frames, 0, false);
 }
 
 StackTrace::const_iterator StackTrace::cend() const
 {
-    int size = callStack.size();
-    if(!nextFrame.isNull()) ++size;
-    return const_iterator(*this, size);
-}
-
-StackTrace::reverse_iterator StackTrace::rbegin()
-{
-    return reverse_iterator(*this);
-}
-
-StackTrace::reverse_iterator StackTrace::rend()
-{
-    return reverse_iterator(*this, -1);
+    return const_iterator(tags, frames, frames.size(), false);
 }
 
 StackTrace::const_reverse_iterator StackTrace::rbegin() const
@@ -61,105 +36,171 @@ StackTrace::const_reverse_iterator StackTrace::rend() const
 
 StackTrace::const_reverse_iterator StackTrace::crbegin() const
 {
-    return const_reverse_iterator(*this);
+    return const_reverse_iterator(tags, frames, frames.size() - 1, true);
 }
 
 StackTrace::const_reverse_iterator StackTrace::crend() const
 {
-    return const_reverse_iterator(*this, -1);
+    return const_reverse_iterator(tags, frames, -1, true);
+}
+
+StackTrace::StackTrace(): tags(), frames(), stackIntact(true),
+    changedTag(0), changedFrame(0)
+{
+    frames.append(FrameBounds{0, 0, 0, false});
+    frames.append(FrameBounds{0, 0, 0, true});
+}
+
+int StackTrace::nextFrame() const
+{
+    return frames.size() - 1;
+}
+
+int StackTrace::topFrame() const
+{
+    return frames.size() - 2;
+}
+
+void StackTrace::markChanged(int frame, int tag)
+{
+    changedFrame = std::min(changedFrame, frame);
+    changedTag = std::min(changedTag, tag);
 }
 
-StackTrace::StackTrace(): callStack(), nextFrame(QSharedPointer<StackFrame>::create()), stackIntact(true)
+StackFrame StackTrace::getFrame(int frame) const
 {
-    callStack.push(QSharedPointer<StackFrame>::create());
-    nextFrame->isOrphaned = true;
+    const FrameBounds& bounds = frames[frame];
+    return StackFrame(tags.constData() + bounds.begin, tags.constData() + bounds.end,
+                      bounds.bytes, bounds.isOrphaned);
+}
+
+void StackTrace::push(int frame, quint16 addr, const TraceType *type)
+{
+    markChanged(frame, frames[frame].end);
+    FrameBounds& bounds = frames[frame];
+    // Frames are only ever pushed at the top of the stack, or just below the next frame,
+    // so this rarely moves any tags.
+    tags.insert(bounds.end, MemTag{addr, type});
+    bounds.end++;
+    bounds.bytes += Enu::tagNumBytes(type->format);
+    for(int it = frame + 1; it < frames.size(); it++) {
+        frames[it].begin++;
+        frames[it].end++;
+    }
+}
+
+quint16 StackTrace::pop(int frame, quint16 size)
+{
+    FrameBounds& bounds = frames[frame];
+    quint16 popped = 0;
+    int end = bounds.end;
+    while(popped < size && end > bounds.begin) {
+        --end;
+        popped += Enu::tagNumBytes(tags[end].type->format);
+    }
+    int count = bounds.end - end;
+    markChanged(frame, end);
+    // Removing elements never shrinks the vector, so that pushing them again is free.
+    tags.remove(end, count);
+    bounds.end = end;
+    bounds.bytes -= popped;
+    for(int it = frame + 1; it < frames.size(); it++) {
+        frames[it].begin -= count;
+        frames[it].end -= count;
+    }
+    if(bounds.begin == bounds.end) bounds.isOrphaned = true;
+    return popped;
 }
 
 void StackTrace::call(quint16 sp)
 {
-    static const QPair<Enu::ESymbolFormat,QString> retType{Enu::ESymbolFormat::F_2H, "retAddr"};
+    static const TraceType retType{Enu::ESymbolFormat::F_2H, "retAddr"};
     // WHen a frame is being moved from the "next up" to the actual call stack, it is no longer orphaned
-    nextFrame->push({sp, retType});
-    nextFrame->isOrphaned = false;
-    callStack.push(nextFrame);
-    nextFrame = QSharedPointer<StackFrame>::create();
-    nextFrame->isOrphaned = true;
+    push(nextFrame(), sp, &retType);
+    frames[nextFrame()].isOrphaned = false;
+    markChanged(nextFrame(), tags.size());
+    frames.append(FrameBounds{tags.size(), tags.size(), 0, true});
 }
 
 void StackTrace::clear()
 {
-    callStack.clear();
-    nextFrame = QSharedPointer<StackFrame>::create();
-    nextFrame->isOrphaned = true;
+    tags.clear();
+    frames.clear();
+    frames.append(FrameBounds{0, 0, 0, true});
+    markChanged(0, 0);
     stackIntact = true;
     errMessage = "";
 }
 
 bool StackTrace::ret()
 {
-    if(callStack.isEmpty()) return false;
-    nextFrame = callStack.pop();
-    nextFrame->isOrphaned = true;
-    return nextFrame->pop(2);
+    if(callDepth() == 0) return false;
+    // The top of the call stack replaces the next frame.
+    markChanged(topFrame(), frames[nextFrame()].begin);
+    tags.resize(frames[nextFrame()].begin);
+    frames.removeLast();
+    frames[nextFrame()].isOrphaned = true;
+    return pop(nextFrame(), 2) == 2;
 }
 
-void StackTrace::pushLocals(quint16 start, QList<QPair<Enu::ESymbolFormat, QString> > items)
+void StackTrace::pushLocals(quint16 start, const TraceTypeRange& items)
 {
-    if(callStack.isEmpty()) {
-        auto stack = QSharedPointer<StackFrame>::create();
-        stack->isOrphaned = false;
-        callStack.push(stack);
+    if(callDepth() == 0) {
+        int base = frames[nextFrame()].begin;
+        markChanged(nextFrame(), base);
+        frames.insert(nextFrame(), FrameBounds{base, base, 0, false});
     }
-    for(auto pair : items) {
-        start -= Enu::tagNumBytes(pair.first);
-        callStack.top()->push({start, pair});
+    for(auto type = items.begin; type != items.end; ++type) {
+        start -= Enu::tagNumBytes(type->format);
+        push(topFrame(), start, type);
     }
 }
 
-void StackTrace::pushParams(quint16 start, QList<QPair<Enu::ESymbolFormat, QString> > items)
+void StackTrace::pushParams(quint16 start, const TraceTypeRange& items)
 {
-    for(auto pair :items) {
-        start -= Enu::tagNumBytes(pair.first);
-        nextFrame->push({start, pair});
+    for(auto type = items.begin; type != items.end; ++type) {
+        start -= Enu::tagNumBytes(type->format);
+        push(nextFrame(), start, type);
     }
 }
 
 bool StackTrace::popLocals(quint16 size)
 {
-    if(callStack.isEmpty()) return false;
-    return callStack.top()->pop(size);
+    if(callDepth() == 0) return false;
+    return pop(topFrame(), size) == size;
 }
 
 bool StackTrace::popParams(quint16 size)
 {
-    // Handle recursive case when next frame has no contents
-    if(nextFrame->size() == 0) {
-        // If stack is entirely empty, return false
-        if(callStack.isEmpty()) return false;
-        // Otherwise take the next call stack and start popping from it
-        nextFrame = callStack.pop();
-        nextFrame->isOrphaned = true;
-        return popParams(size);
-    }
-    else if(size > nextFrame->size()) {
-        quint16 popped = nextFrame->pop(nextFrame->size());
-        return popParams(size-popped);
-    }
-    else {
-        return nextFrame->pop(size);
+    while(true) {
+        quint16 frameSize = frames[nextFrame()].bytes;
+        // Handle recursive case when next frame has no contents
+        if(frameSize == 0) {
+            // If stack is entirely empty, return false
+            if(callDepth() == 0) return false;
+            // Otherwise take the next call stack and start popping from it
+            markChanged(topFrame(), frames[nextFrame()].begin);
+            frames.removeLast();
+            frames[nextFrame()].isOrphaned = true;
+        }
+        else if(size > frameSize) {
+            size -= pop(nextFrame(), frameSize);
+        }
+        else {
+            return pop(nextFrame(), size) == size;
+        }
     }
 }
 
 bool StackTrace::popAndOrphan(quint16 size)
 {
-    if(size >= nextFrame->size()) {
+    if(size >= frames[nextFrame()].bytes) {
         return false;
     }
     else {
-        nextFrame->isOrphaned = true;
-        callStack.push(nextFrame);
-        nextFrame = QSharedPointer<StackFrame>::create();
-        nextFrame->isOrphaned = true;
+        frames[nextFrame()].isOrphaned = true;
+        markChanged(nextFrame(), tags.size());
+        frames.append(FrameBounds{tags.size(), tags.size(), 0, true});
         // Orphaned frame can now be removed from call stack
         return popLocals(size);
     }
@@ -167,19 +208,37 @@ bool StackTrace::popAndOrphan(quint16 size)
 
 quint16 StackTrace::callDepth() const
 {
-    return static_cast<quint16>(callStack.length());
+    return static_cast<quint16>(frames.size() - 1);
 }
 
-const StackFrame &StackTrace::getTOS()
+StackFrame StackTrace::getTOS() const
 {
-    if(nextFrame->size() == 0 && callStack.size() > 0) {
-        return *callStack.top().get();
+    if(frames[nextFrame()].bytes == 0 && callDepth() > 0) {
+        return getFrame(topFrame());
     }
     else {
-        return *nextFrame.get();
+        return getFrame(nextFrame());
     }
 }
 
+const QVector<MemTag> &StackTrace::getMemTags() const
+{
+    return tags;
+}
+
+int StackTrace::numFrames() const
+{
+    return frames.size();
+}
+
+StackTrace::Changes StackTrace::takeChanges()
+{
+    Changes changes{changedTag, changedFrame};
+    changedTag = std::numeric_limits<int>::max();
+    changedFrame = std::numeric_limits<int>::max();
+    return changes;
+}
+
 bool StackTrace::isStackIntact() const
 {
     return stackIntact;
@@ -204,14 +263,16 @@ StackTrace::operator QString() const
 {
     QList<QString> ts;
     QString tmp = "";
-    if(nextFrame->size()>0) {
-        tmp = QString(*nextFrame);
+    StackFrame next = getFrame(nextFrame());
+    if(next.size()>0) {
+        tmp = QString(next);
     } else {
         tmp="{}";
     }
-    for(auto pair : callStack) {
-        if (pair->size() == 0) continue;
-        ts << QString("{%1}").arg(QString(*pair));
+    for(int it = 0; it < callDepth(); it++) {
+        StackFrame frame = getFrame(it);
+        if (frame.size() == 0) continue;
+        ts << QString("{%1}").arg(QString(frame));
     }
     QStringList out;
     std::reverse(ts.begin(),ts.end());
@@ -219,7 +280,7 @@ StackTrace::operator QString() const
     return out.join("||");
 }
 
-MemoryTrace::MemoryTrace(): traceWarnings(false), userStack(StackTrace()),
+MemoryTrace::MemoryTrace(): traceWarnings(false), traceInfo(), userStack(StackTrace()),
     heapTrace(HeapTrace()), globalTrace(GlobalTrace())
 {
 
@@ -231,6 +292,7 @@ void MemoryTrace::clear()
     globalTrace.clear();
     heapTrace.clear();
     traceWarnings = false;
+    traceInfo.clear();
 }
 
 bool MemoryTrace::hasTraceWarnings() const
@@ -243,15 +305,20 @@ void MemoryTrace::setHasTraceWarnings(bool value)
     traceWarnings = value;
 }
 
-StackFrame::iterator StackFrame::begin()
+void MemoryTrace::setTraceInfo(QSharedPointer<const StaticTraceInfo> traceInfo)
 {
-    return iterator(*this);
+    this->traceInfo = traceInfo;
 }
 
-StackFrame::iterator StackFrame::end()
+StackFrame::StackFrame(): first(nullptr), last(nullptr), bytes(0), isOrphaned(true)
 {
-    int size = this->stack.size();
-    return iterator(*this, size);
+
+}
+
+StackFrame::StackFrame(const MemTag *first, const MemTag *last, quint16 bytes, bool isOrphaned):
+    first(first), last(last), bytes(bytes), isOrphaned(isOrphaned)
+{
+
 }
 
 StackFrame::const_iterator StackFrame::begin() const
@@ -266,23 +333,12 @@ StackFrame::const_iterator StackFrame::end() const
 
 StackFrame::const_iterator StackFrame::cbegin() const
 {
-    return const_iterator(*this);
+    return first;
 }
 
 StackFrame::const_iterator StackFrame::cend() const
 {
-    int size = this->stack.size();
-    return const_iterator(*this, size);
-}
-
-StackFrame::reverse_iterator StackFrame::rbegin()
-{
-    return reverse_iterator(*this);
-}
-
-StackFrame::reverse_iterator StackFrame::rend()
-{
-    return reverse_iterator(*this, -1);
+    return last;
 }
 
 StackFrame::const_reverse_iterator StackFrame::rbegin() const
@@ -297,51 +353,83 @@ StackFrame::const_reverse_iterator StackFrame::rend() const
 
 StackFrame::const_reverse_iterator StackFrame::crbegin() const
 {
-    return const_reverse_iterator(*this);
+    return const_reverse_iterator(last);
 }
 
 StackFrame::const_reverse_iterator StackFrame::crend() const
 {
-    return const_reverse_iterator(*this, -1);
+    return const_reverse_iterator(first);
 }
 
-void StackFrame::push(MemTag tag)
+quint16 StackFrame::size() const
 {
-    stack.push(tag);
+    return bytes;
 }
 
-bool StackFrame::pop(quint16 size)
+quint16 StackFrame::numItems() const
 {
-    quint16 popped = 0;
-    while(popped<size && !stack.isEmpty()) {
-        auto next = stack.pop();
-        popped += Enu::tagNumBytes(next.type.first);
-    }
-    if(this->size() == 0) isOrphaned = true;
-    return popped == size;
+    return static_cast<quint16>(last - first);
 }
 
-quint16 StackFrame::size() const
+StackFrame::operator QString() const
 {
-    quint16 size = 0;
-    for(auto x : stack) {
-        size += Enu::tagNumBytes(x.type.first);
+    QList<QString> items;
+    for(auto tag = crbegin(); tag!=crend(); tag++) {
+        items << *tag;
     }
-    return size;
+    return items.join(", ");
 }
 
-quint16 StackFrame::numItems() const
+TraceFrameIterator::TraceFrameIterator(const QVector<MemTag> &tags, const QVector<FrameBounds> &frames,
+                                       int idx, bool reversed):
+    tags(&tags), frames(&frames), idx(idx), step(reversed ? -1 : 1), frame()
 {
-    return static_cast<quint16>(stack.size());
+    load();
 }
 
-StackFrame::operator QString() const
+void TraceFrameIterator::load()
 {
-    QList<QString> items;
-    for(auto tag = stack.rbegin(); tag!=stack.rend(); tag++) {
-        items << *tag;
+    if(idx < 0 || idx >= frames->size()) {
+        frame = StackFrame();
+        return;
     }
-    return items.join(", ");
+    const FrameBounds& bounds = (*frames)[idx];
+    frame = StackFrame(tags->constData() + bounds.begin, tags->constData() + bounds.end,
+                       bounds.bytes, bounds.isOrphaned);
+}
+
+bool TraceFrameIterator::operator==(const TraceFrameIterator &rhs) const
+{
+    return frames == rhs.frames && idx == rhs.idx;
+}
+
+bool TraceFrameIterator::operator!=(const TraceFrameIterator &rhs) const
+{
+    return !(*this == rhs);
+}
+
+TraceFrameIterator &TraceFrameIterator::operator++()
+{
+    idx += step;
+    load();
+    return *this;
+}
+
+TraceFrameIterator &TraceFrameIterator::operator--()
+{
+    idx -= step;
+    load();
+    return *this;
+}
+
+TraceFrameIterator::reference TraceFrameIterator::operator*() const
+{
+    return frame;
+}
+
+TraceFrameIterator::pointer TraceFrameIterator::operator->() const
+{
+    return &frame;
 }
 
 GlobalTrace::GlobalTrace(): tags()
@@ -349,12 +437,11 @@ GlobalTrace::GlobalTrace(): tags()
 
 }
 
-void GlobalTrace::setTags(QList<QPair<quint16, QPair<Enu::ESymbolFormat, QString> > > items)
+void GlobalTrace::setTags(QVector<MemTag> items)
 {
     tags.clear();
     for(auto entry : items) {
-        quint16 addr = entry.first;
-        tags.insert(entry.first, {addr, entry.second});
+        tags.insert(entry.addr, entry);
     }
 }
 
@@ -363,7 +450,7 @@ void GlobalTrace::clear()
     tags.clear();
 }
 
-const QMap<quint16, MemTag> GlobalTrace::getMemTags() const
+const QMap<quint16, MemTag> &GlobalTrace::getMemTags() const
 {
     return tags;
 }
@@ -372,21 +459,10 @@ MemTag::operator QString() const
 {
 
     return QString("(%1:[%2])")
-            .arg(type.second)
+            .arg(type->name)
             .arg(addr,4,16,QChar('0'));
 }
 
-HeapTrace::iterator HeapTrace::begin()
-{
-    return iterator(*this);
-}
-
-HeapTrace::iterator HeapTrace::end()
-{
-    int size = heap.size();
-    return iterator(*this, size);
-}
-
 HeapTrace::const_iterator HeapTrace::begin() const
 {
     return cbegin();
@@ -399,23 +475,12 @@ HeapTrace::const_iterator HeapTrace::end() const
 
 HeapTrace::const_iterator HeapTrace::cbegin() const
 {
-    return const_iterator(*this);
+    return const_iterator(tags, frames, 0, false);
 }
 
 HeapTrace::const_iterator HeapTrace::cend() const
 {
-    int size = heap.size();
-    return const_iterator(*this, size);
-}
-
-HeapTrace::reverse_iterator HeapTrace::rbegin()
-{
-    return reverse_iterator(*this);
-}
-
-HeapTrace::reverse_iterator HeapTrace::rend()
-{
-    return reverse_iterator(*this, -1);
+    return const_iterator(tags, frames, frames.size(), false);
 }
 
 HeapTrace::const_reverse_iterator HeapTrace::rbegin() const
@@ -430,36 +495,48 @@ HeapTrace::const_reverse_iterator HeapTrace::rend() const
 
 HeapTrace::const_reverse_iterator HeapTrace::crbegin() const
 {
-    return const_reverse_iterator(*this);
+    return const_reverse_iterator(tags, frames, frames.size() - 1, true);
 }
 
 HeapTrace::const_reverse_iterator HeapTrace::crend() const
 {
-    return const_reverse_iterator(*this, -1);
+    return const_reverse_iterator(tags, frames, -1, true);
 }
 
-HeapTrace::HeapTrace():  itToAddresses(), heap(), intact(true), addNew(true), isInMalloc(false)
+HeapTrace::HeapTrace(): tags(), frames(), intact(true), addNew(true), isInMalloc(false)
 {
 
 }
 
-void HeapTrace::pushHeap(quint16 start, QList<QPair<Enu::ESymbolFormat, QString> > items)
+void HeapTrace::pushHeap(quint16 start, const TraceTypeRange& items)
 {
-    QSharedPointer<StackFrame> frm = QSharedPointer<StackFrame>::create();
+    FrameBounds bounds{tags.size(), tags.size(), 0, false};
     quint16 addr = start;
-    for(auto pair : items) {
-        frm->push({addr, pair});
-        addr += Enu::tagNumBytes(pair.first);
+    for(auto type = items.begin; type != items.end; ++type) {
+        tags.append(MemTag{addr, type});
+        addr += Enu::tagNumBytes(type->format);
     }
-    itToAddresses.append(start);
-    heap.insert(start, frm);
+    bounds.end = tags.size();
+    bounds.bytes = static_cast<quint16>(addr - start);
+    frames.append(bounds);
+}
+
+int HeapTrace::numFrames() const
+{
+    return frames.size();
+}
 
+StackFrame HeapTrace::getFrame(int frame) const
+{
+    const FrameBounds& bounds = frames[frame];
+    return StackFrame(tags.constData() + bounds.begin, tags.constData() + bounds.end,
+                      bounds.bytes, bounds.isOrphaned);
 }
 
 void HeapTrace::clear()
 {
-    heap.clear();
-    itToAddresses.clear();
+    tags.clear();
+    frames.clear();
     intact = true;
     addNew = true;
     isInMalloc = false;
@@ -509,1122 +586,8 @@ void HeapTrace::setErrorMessage(QString message)
 HeapTrace::operator QString() const
 {
     QList<QString> items;
-    for(auto frame = heap.keyBegin(); frame!=heap.keyEnd(); frame++) {
-        items << QString("%1").arg(heap[(*frame)]->operator QString());
+    for(auto frame = cbegin(); frame != cend(); ++frame) {
+        items << QString("%1").arg(frame->operator QString());
     }
     return items.join(", ");
 }
-
-/*
- * Stack trace iterators
- */
-StackTrace::iterator::iterator(StackTrace & trace): trace(&trace), idx(0)
-{
-
-}
-
-StackTrace::iterator::iterator(StackTrace & trace, int offset): trace(&trace), idx(offset)
-{
-
-}
-
-StackTrace::iterator::iterator(const StackTrace::iterator & rhs): trace(rhs.trace),
-    idx(rhs.idx)
-{
-
-}
-
-StackTrace::iterator::~iterator()
-{
-    // Nothing to clean up with this iterator
-}
-
-StackTrace::iterator &StackTrace::iterator::operator=(const StackTrace::iterator & rhs)
-{
-    if(*this != rhs){
-        this->trace = rhs.trace;
-        this->idx = rhs.idx;
-    }
-    return *this;
-}
-
-bool StackTrace::iterator::operator==(const StackTrace::iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx == rhs.idx;
-}
-
-bool StackTrace::iterator::operator!=(const StackTrace::iterator &rhs) const
-{
-    return !(*this == rhs);
-}
-
-bool StackTrace::iterator::operator<(const StackTrace::iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx < rhs.idx;
-}
-
-bool StackTrace::iterator::operator>(const StackTrace::iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx > rhs.idx;
-}
-
-bool StackTrace::iterator::operator<=(const StackTrace::iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx <= rhs.idx;
-}
-
-bool StackTrace::iterator::operator>=(const StackTrace::iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx >= rhs.idx;
-}
-
-StackTrace::iterator &StackTrace::iterator::operator++()
-{
-    idx++;
-    return *this;
-}
-
-StackTrace::iterator &StackTrace::iterator::operator--()
-{
-    idx--;
-    return *this;
-}
-
-StackTrace::iterator::reference StackTrace::iterator::operator*()
-{
-    if(idx < trace->callStack.size()) {
-        return *trace->callStack[idx].get();
-    }
-    else {
-        return *trace->nextFrame.get();
-    }
-}
-
-StackTrace::iterator::pointer StackTrace::iterator::operator->()
-{
-    if(idx < trace->callStack.size()) {
-        return trace->callStack[idx].get();
-    }
-    else {
-        return trace->nextFrame.get();
-    }
-}
-
-StackTrace::reverse_iterator::reverse_iterator(StackTrace & trace): trace(&trace)
-{
-    int size = trace.callStack.size() - 1;
-    if(!trace.nextFrame.isNull()) size++;
-    idx = size;
-}
-
-StackTrace::reverse_iterator::reverse_iterator(StackTrace & trace, int offset):
-    trace(&trace), idx(offset)
-{
-
-}
-
-StackTrace::reverse_iterator::reverse_iterator(const StackTrace::reverse_iterator & rhs):
-    trace(rhs.trace), idx(rhs.idx)
-{
-
-}
-
-StackTrace::reverse_iterator::~reverse_iterator()
-{
-    // Nothing to clean up with this reverse_iterator
-}
-
-StackTrace::reverse_iterator &StackTrace::reverse_iterator::operator=(const StackTrace::reverse_iterator & rhs)
-{
-    if(*this != rhs){
-        this->trace = rhs.trace;
-        this->idx = rhs.idx;
-    }
-    return *this;
-}
-
-bool StackTrace::reverse_iterator::operator==(const StackTrace::reverse_iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx == rhs.idx;
-}
-
-bool StackTrace::reverse_iterator::operator!=(const StackTrace::reverse_iterator &rhs) const
-{
-    return !(*this == rhs);
-}
-
-bool StackTrace::reverse_iterator::operator<(const StackTrace::reverse_iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx > rhs.idx;
-}
-
-bool StackTrace::reverse_iterator::operator>(const StackTrace::reverse_iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx < rhs.idx;
-}
-
-bool StackTrace::reverse_iterator::operator<=(const StackTrace::reverse_iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx >= rhs.idx;
-}
-
-bool StackTrace::reverse_iterator::operator>=(const StackTrace::reverse_iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx <= rhs.idx;
-}
-
-StackTrace::reverse_iterator &StackTrace::reverse_iterator::operator++()
-{
-    idx--;
-    return *this;
-}
-
-StackTrace::reverse_iterator &StackTrace::reverse_iterator::operator--()
-{
-    idx++;
-    return *this;
-}
-
-StackTrace::reverse_iterator::reference StackTrace::reverse_iterator::operator*()
-{
-    if(idx < trace->callStack.size()) {
-        return *trace->callStack[idx].get();
-    }
-    else {
-        return *trace->nextFrame.get();
-    }
-}
-
-StackTrace::reverse_iterator::pointer StackTrace::reverse_iterator::operator->()
-{
-    if(idx < trace->callStack.size()) {
-        return trace->callStack[idx].get();
-    }
-    else {
-        return trace->nextFrame.get();
-    }
-}
-
-StackTrace::const_iterator::const_iterator(const StackTrace & trace): trace(&trace), idx(0)
-{
-
-}
-
-StackTrace::const_iterator::const_iterator(const StackTrace & trace, int offset):
-    trace(&trace), idx(offset)
-{
-
-}
-
-StackTrace::const_iterator::const_iterator(const StackTrace::const_iterator & rhs):
-    trace(rhs.trace), idx(rhs.idx)
-{
-
-}
-
-StackTrace::const_iterator::~const_iterator()
-{
-    // Nothing to clean up with this iterator
-}
-
-StackTrace::const_iterator &StackTrace::const_iterator::operator=(const StackTrace::const_iterator & rhs)
-{
-    if(*this != rhs){
-        this->trace = rhs.trace;
-        this->idx = rhs.idx;
-    }
-    return *this;
-}
-
-bool StackTrace::const_iterator::operator==(const StackTrace::const_iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx == rhs.idx;
-}
-
-bool StackTrace::const_iterator::operator!=(const StackTrace::const_iterator &rhs) const
-{
-    return !(*this == rhs);
-}
-
-bool StackTrace::const_iterator::operator<(const StackTrace::const_iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx < rhs.idx;
-}
-
-bool StackTrace::const_iterator::operator>(const StackTrace::const_iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx > rhs.idx;
-}
-
-bool StackTrace::const_iterator::operator<=(const StackTrace::const_iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx <= rhs.idx;
-}
-
-bool StackTrace::const_iterator::operator>=(const StackTrace::const_iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx >= rhs.idx;
-}
-
-StackTrace::const_iterator &StackTrace::const_iterator::operator++()
-{
-    idx++;
-    return *this;
-}
-
-StackTrace::const_iterator &StackTrace::const_iterator::operator--()
-{
-    idx--;
-    return *this;
-}
-
-StackTrace::const_iterator::reference StackTrace::const_iterator::operator*() const
-{
-    if(idx < trace->callStack.size()) {
-        return *trace->callStack[idx].get();
-    }
-    else {
-        return *trace->nextFrame.get();
-    }
-}
-
-StackTrace::const_iterator::pointer StackTrace::const_iterator::operator->() const
-{
-    if(idx < trace->callStack.size()) {
-        return trace->callStack[idx].get();
-    }
-    else {
-        return trace->nextFrame.get();
-    }
-}
-
-StackTrace::const_reverse_iterator::const_reverse_iterator(const StackTrace & trace):
-    trace(&trace)
-{
-    int size = trace.callStack.size() - 1;
-    if(!trace.nextFrame.isNull()) size++;
-    idx = size;
-}
-
-StackTrace::const_reverse_iterator::const_reverse_iterator(const StackTrace & trace, int offset):
-    trace(&trace), idx(offset)
-{
-
-}
-
-StackTrace::const_reverse_iterator::const_reverse_iterator(const StackTrace::const_reverse_iterator & rhs):
-    trace(rhs.trace), idx(rhs.idx)
-{
-
-}
-
-StackTrace::const_reverse_iterator::~const_reverse_iterator()
-{
-    // Nothing to clean up with this iterator
-}
-
-StackTrace::const_reverse_iterator &StackTrace::const_reverse_iterator::operator=(const StackTrace::const_reverse_iterator & rhs)
-{
-    if(*this != rhs){
-        this->trace = rhs.trace;
-        this->idx = rhs.idx;
-    }
-    return *this;
-}
-
-bool StackTrace::const_reverse_iterator::operator==(const StackTrace::const_reverse_iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx == rhs.idx;
-}
-
-bool StackTrace::const_reverse_iterator::operator!=(const StackTrace::const_reverse_iterator &rhs) const
-{
-    return !(*this == rhs);
-}
-
-bool StackTrace::const_reverse_iterator::operator<(const StackTrace::const_reverse_iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx > rhs.idx;
-}
-
-bool StackTrace::const_reverse_iterator::operator>(const StackTrace::const_reverse_iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx < rhs.idx;
-}
-
-bool StackTrace::const_reverse_iterator::operator<=(const StackTrace::const_reverse_iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx >= rhs.idx;
-}
-
-bool StackTrace::const_reverse_iterator::operator>=(const StackTrace::const_reverse_iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx <= rhs.idx;
-}
-
-StackTrace::const_reverse_iterator &StackTrace::const_reverse_iterator::operator++()
-{
-    idx--;
-    return *this;
-}
-
-StackTrace::const_reverse_iterator &StackTrace::const_reverse_iterator::operator--()
-{
-    idx++;
-    return *this;
-}
-
-StackTrace::const_reverse_iterator::reference StackTrace::const_reverse_iterator::operator*() const
-{
-    if(idx < trace->callStack.size()) {
-        return *trace->callStack[idx].get();
-    }
-    else {
-        return *trace->nextFrame.get();
-    }
-}
-
-StackTrace::const_reverse_iterator::pointer StackTrace::const_reverse_iterator::operator->() const
-{
-    if(idx < trace->callStack.size()) {
-        return trace->callStack[idx].get();
-    }
-    else {
-        return trace->nextFrame.get();
-    }
-}
-
-
-/*
- * Iterators for a stack frame
- */
-StackFrame::iterator::iterator(StackFrame & frame): frame(&frame),
-    idx(0)
-{
-
-}
-
-StackFrame::iterator::iterator(StackFrame & frame, int offset):
-    frame(&frame), idx(offset)
-{
-
-}
-
-StackFrame::iterator::iterator(const StackFrame::iterator & other):
-    frame(other.frame), idx(other.idx)
-{
-
-}
-
-StackFrame::iterator::~iterator()
-{
-    // No cleanup to do, this doesn't own any memory
-}
-
-StackFrame::iterator &StackFrame::iterator::operator=(const StackFrame::iterator & rhs)
-{
-    if(*this != rhs) {
-        this->frame = rhs.frame;
-        this->idx = rhs.idx;
-    }
-    return *this;
-}
-
-bool StackFrame::iterator::operator==(const StackFrame::iterator & rhs) const
-{
-    return this->frame == rhs.frame
-            && this->idx == rhs.idx;
-}
-
-bool StackFrame::iterator::operator!=(const StackFrame::iterator & rhs) const
-{
-    return !(*this == rhs);
-}
-
-bool StackFrame::iterator::operator<(const StackFrame::iterator & rhs) const
-{
-    return this->frame == rhs.frame
-            && this->idx < rhs.idx;
-}
-
-bool StackFrame::iterator::operator>(const StackFrame::iterator & rhs) const
-{
-    return this->frame == rhs.frame
-            && this->idx > rhs.idx;
-}
-
-bool StackFrame::iterator::operator<=(const StackFrame::iterator & rhs) const
-{
-    return this->frame == rhs.frame
-            && this->idx <= rhs.idx;
-}
-
-bool StackFrame::iterator::operator>=(const StackFrame::iterator & rhs) const
-{
-    return this->frame == rhs.frame
-            && this->idx >= rhs.idx;
-}
-
-StackFrame::iterator &StackFrame::iterator::operator++()
-{
-    idx++;
-    return *this;
-}
-
-StackFrame::iterator &StackFrame::iterator::operator--()
-{
-    idx--;
-    return *this;
-}
-
-StackFrame::iterator::reference StackFrame::iterator::operator*()
-{
-    return frame->stack[idx];
-}
-
-StackFrame::iterator::pointer StackFrame::iterator::operator->()
-{
-    return &frame->stack[idx];
-}
-
-StackFrame::reverse_iterator::reverse_iterator(StackFrame & frame): frame(&frame)
-{
-    int size = frame.stack.size() - 1;
-    idx = size;
-}
-
-StackFrame::reverse_iterator::reverse_iterator(StackFrame & frame, int offset):
-    frame(&frame), idx(offset)
-{
-
-}
-
-StackFrame::reverse_iterator::reverse_iterator(const StackFrame::reverse_iterator & other):
-    frame(other.frame), idx(other.idx)
-{
-
-}
-
-StackFrame::reverse_iterator::~reverse_iterator()
-{
-    // No cleanup to do, this doesn't own any memory
-}
-
-StackFrame::reverse_iterator &StackFrame::reverse_iterator::operator=(const StackFrame::reverse_iterator & rhs)
-{
-    if(*this != rhs) {
-        this->frame = rhs.frame;
-        this->idx = rhs.idx;
-    }
-    return *this;
-}
-
-bool StackFrame::reverse_iterator::operator==(const StackFrame::reverse_iterator & rhs) const
-{
-    return this->frame == rhs.frame
-            && this->idx == rhs.idx;
-}
-
-bool StackFrame::reverse_iterator::operator!=(const StackFrame::reverse_iterator & rhs) const
-{
-    return !(*this == rhs);
-}
-
-bool StackFrame::reverse_iterator::operator<(const StackFrame::reverse_iterator & rhs) const
-{
-    return this->frame == rhs.frame
-            && this->idx > rhs.idx;
-}
-
-bool StackFrame::reverse_iterator::operator>(const StackFrame::reverse_iterator & rhs) const
-{
-    return this->frame == rhs.frame
-            && this->idx < rhs.idx;
-}
-
-bool StackFrame::reverse_iterator::operator<=(const StackFrame::reverse_iterator & rhs) const
-{
-    return this->frame == rhs.frame
-            && this->idx >= rhs.idx;
-}
-
-bool StackFrame::reverse_iterator::operator>=(const StackFrame::reverse_iterator & rhs) const
-{
-    return this->frame == rhs.frame
-            && this->idx <= rhs.idx;
-}
-
-StackFrame::reverse_iterator &StackFrame::reverse_iterator::operator++()
-{
-    idx--;
-    return *this;
-}
-
-StackFrame::reverse_iterator &StackFrame::reverse_iterator::operator--()
-{
-    idx++;
-    return *this;
-}
-
-StackFrame::reverse_iterator::reference StackFrame::reverse_iterator::operator*()
-{
-    return frame->stack[idx];
-}
-
-StackFrame::reverse_iterator::pointer StackFrame::reverse_iterator::operator->()
-{
-    return &frame->stack[idx];
-}
-
-StackFrame::const_iterator::const_iterator(const StackFrame & frame): frame(&frame),
-    idx(0)
-{
-
-}
-
-StackFrame::const_iterator::const_iterator(const StackFrame & frame, int offset):
-    frame(&frame), idx(offset)
-{
-
-}
-
-StackFrame::const_iterator::const_iterator(const StackFrame::const_iterator & other):
-    frame(other.frame), idx(other.idx)
-{
-
-}
-
-StackFrame::const_iterator::~const_iterator()
-{
-    // No cleanup to do, this doesn't own any memory
-}
-
-StackFrame::const_iterator &StackFrame::const_iterator::operator=(const StackFrame::const_iterator & rhs)
-{
-    if(*this != rhs) {
-        this->frame = rhs.frame;
-        this->idx = rhs.idx;
-    }
-    return *this;
-}
-
-bool StackFrame::const_iterator::operator==(const StackFrame::const_iterator & rhs) const
-{
-    return this->frame == rhs.frame
-            && this->idx == rhs.idx;
-}
-
-bool StackFrame::const_iterator::operator!=(const StackFrame::const_iterator & rhs) const
-{
-    return !(*this == rhs);
-}
-
-bool StackFrame::const_iterator::operator<(const StackFrame::const_iterator & rhs) const
-{
-    return this->frame == rhs.frame
-            && this->idx < rhs.idx;
-}
-
-bool StackFrame::const_iterator::operator>(const StackFrame::const_iterator & rhs) const
-{
-    return this->frame == rhs.frame
-            && this->idx > rhs.idx;
-}
-
-bool StackFrame::const_iterator::operator<=(const StackFrame::const_iterator & rhs) const
-{
-    return this->frame == rhs.frame
-            && this->idx <= rhs.idx;
-}
-
-bool StackFrame::const_iterator::operator>=(const StackFrame::const_iterator & rhs) const
-{
-    return this->frame == rhs.frame
-            && this->idx >= rhs.idx;
-}
-
-StackFrame::const_iterator &StackFrame::const_iterator::operator++()
-{
-    idx++;
-    return *this;
-}
-
-StackFrame::const_iterator &StackFrame::const_iterator::operator--()
-{
-    idx--;
-    return *this;
-}
-
-StackFrame::const_iterator::reference StackFrame::const_iterator::operator*() const
-{
-    return frame->stack.at(idx);
-}
-
-StackFrame::const_iterator::pointer StackFrame::const_iterator::operator->() const
-{
-    return &frame->stack.at(idx);
-}
-
-StackFrame::const_reverse_iterator::const_reverse_iterator(const StackFrame & frame):
-    frame(&frame)
-{
-    int size = frame.stack.size() - 1;
-    idx = size;
-}
-
-StackFrame::const_reverse_iterator::const_reverse_iterator(const StackFrame & frame, int offset):
-    frame(&frame), idx(offset)
-{
-
-}
-
-StackFrame::const_reverse_iterator::const_reverse_iterator(const StackFrame::const_reverse_iterator & other):
-    frame(other.frame), idx(other.idx)
-{
-
-}
-
-StackFrame::const_reverse_iterator::~const_reverse_iterator()
-{
-    // No cleanup to do, this doesn't own any memory
-}
-
-StackFrame::const_reverse_iterator &StackFrame::const_reverse_iterator::operator=(const StackFrame::const_reverse_iterator & rhs)
-{
-    if(*this != rhs) {
-        this->frame = rhs.frame;
-        this->idx = rhs.idx;
-    }
-    return *this;
-}
-
-bool StackFrame::const_reverse_iterator::operator==(const StackFrame::const_reverse_iterator & rhs) const
-{
-    return this->frame == rhs.frame
-            && this->idx == rhs.idx;
-}
-
-bool StackFrame::const_reverse_iterator::operator!=(const StackFrame::const_reverse_iterator & rhs) const
-{
-    return !(*this == rhs);
-}
-
-bool StackFrame::const_reverse_iterator::operator<(const StackFrame::const_reverse_iterator & rhs) const
-{
-    return this->frame == rhs.frame
-            && this->idx > rhs.idx;
-}
-
-bool StackFrame::const_reverse_iterator::operator>(const StackFrame::const_reverse_iterator & rhs) const
-{
-    return this->frame == rhs.frame
-            && this->idx < rhs.idx;
-}
-
-bool StackFrame::const_reverse_iterator::operator<=(const StackFrame::const_reverse_iterator & rhs) const
-{
-    return this->frame == rhs.frame
-            && this->idx >= rhs.idx;
-}
-
-bool StackFrame::const_reverse_iterator::operator>=(const StackFrame::const_reverse_iterator & rhs) const
-{
-    return this->frame == rhs.frame
-            && this->idx <= rhs.idx;
-}
-
-StackFrame::const_reverse_iterator &StackFrame::const_reverse_iterator::operator++()
-{
-    idx--;
-    return *this;
-}
-
-StackFrame::const_reverse_iterator &StackFrame::const_reverse_iterator::operator--()
-{
-    idx++;
-    return *this;
-}
-
-StackFrame::const_reverse_iterator::reference StackFrame::const_reverse_iterator::operator*() const
-{
-    return frame->stack.at(idx);
-}
-
-StackFrame::const_reverse_iterator::pointer StackFrame::const_reverse_iterator::operator->() const
-{
-    return &frame->stack.at(idx);
-}
-
-HeapTrace::iterator::iterator(HeapTrace & trace): trace(&trace), idx(0)
-{
-
-}
-
-HeapTrace::iterator::iterator(HeapTrace & trace, int offset): trace(&trace), idx(offset)
-{
-
-}
-
-HeapTrace::iterator::iterator(const HeapTrace::iterator & rhs): trace(rhs.trace),
-    idx(rhs.idx)
-{
-
-}
-
-HeapTrace::iterator::~iterator()
-{
-    // Nothing to clean up with this iterator
-}
-
-HeapTrace::iterator &HeapTrace::iterator::operator=(const HeapTrace::iterator & rhs)
-{
-    if(*this != rhs){
-        this->trace = rhs.trace;
-        this->idx = rhs.idx;
-    }
-    return *this;
-}
-
-bool HeapTrace::iterator::operator==(const HeapTrace::iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx == rhs.idx;
-}
-
-bool HeapTrace::iterator::operator!=(const HeapTrace::iterator &rhs) const
-{
-    return !(*this == rhs);
-}
-
-bool HeapTrace::iterator::operator<(const HeapTrace::iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx < rhs.idx;
-}
-
-bool HeapTrace::iterator::operator>(const HeapTrace::iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx > rhs.idx;
-}
-
-bool HeapTrace::iterator::operator<=(const HeapTrace::iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx <= rhs.idx;
-}
-
-bool HeapTrace::iterator::operator>=(const HeapTrace::iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx >= rhs.idx;
-}
-
-HeapTrace::iterator &HeapTrace::iterator::operator++()
-{
-    idx++;
-    return *this;
-}
-
-HeapTrace::iterator &HeapTrace::iterator::operator--()
-{
-    idx--;
-    return *this;
-}
-
-HeapTrace::iterator::reference HeapTrace::iterator::operator*()
-{
-    return *trace->heap[trace->itToAddresses[idx]].get();
-}
-
-HeapTrace::iterator::pointer HeapTrace::iterator::operator->()
-{
-    return trace->heap[trace->itToAddresses[idx]].get();
-}
-
-HeapTrace::reverse_iterator::reverse_iterator(HeapTrace & trace): trace(&trace)
-{
-    int size = trace.itToAddresses.size() - 1;
-    idx = size;
-}
-
-HeapTrace::reverse_iterator::reverse_iterator(HeapTrace & trace, int offset):
-    trace(&trace), idx(offset)
-{
-
-}
-
-HeapTrace::reverse_iterator::reverse_iterator(const HeapTrace::reverse_iterator & rhs):
-    trace(rhs.trace), idx(rhs.idx)
-{
-
-}
-
-HeapTrace::reverse_iterator::~reverse_iterator()
-{
-    // Nothing to clean up with this reverse_iterator
-}
-
-HeapTrace::reverse_iterator &HeapTrace::reverse_iterator::operator=(const HeapTrace::reverse_iterator & rhs)
-{
-    if(*this != rhs){
-        this->trace = rhs.trace;
-        this->idx = rhs.idx;
-    }
-    return *this;
-}
-
-bool HeapTrace::reverse_iterator::operator==(const HeapTrace::reverse_iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx == rhs.idx;
-}
-
-bool HeapTrace::reverse_iterator::operator!=(const HeapTrace::reverse_iterator &rhs) const
-{
-    return !(*this == rhs);
-}
-
-bool HeapTrace::reverse_iterator::operator<(const HeapTrace::reverse_iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx > rhs.idx;
-}
-
-bool HeapTrace::reverse_iterator::operator>(const HeapTrace::reverse_iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx < rhs.idx;
-}
-
-bool HeapTrace::reverse_iterator::operator<=(const HeapTrace::reverse_iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx >= rhs.idx;
-}
-
-bool HeapTrace::reverse_iterator::operator>=(const HeapTrace::reverse_iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx <= rhs.idx;
-}
-
-HeapTrace::reverse_iterator &HeapTrace::reverse_iterator::operator++()
-{
-    --idx;
-    return *this;
-}
-
-HeapTrace::reverse_iterator &HeapTrace::reverse_iterator::operator--()
-{
-    ++idx;
-    return *this;
-}
-
-HeapTrace::reverse_iterator::reference HeapTrace::reverse_iterator::operator*()
-{
-    return *trace->heap[trace->itToAddresses[idx]].get();
-}
-
-HeapTrace::reverse_iterator::pointer HeapTrace::reverse_iterator::operator->()
-{
-    return trace->heap[trace->itToAddresses[idx]].get();
-}
-
-HeapTrace::const_iterator::const_iterator(const HeapTrace & trace): trace(&trace), idx(0)
-{
-
-}
-
-HeapTrace::const_iterator::const_iterator(const HeapTrace & trace, int offset):
-    trace(&trace), idx(offset)
-{
-
-}
-
-HeapTrace::const_iterator::const_iterator(const HeapTrace::const_iterator & rhs):
-    trace(rhs.trace), idx(rhs.idx)
-{
-
-}
-
-HeapTrace::const_iterator::~const_iterator()
-{
-    // Nothing to clean up with this iterator
-}
-
-HeapTrace::const_iterator &HeapTrace::const_iterator::operator=(const HeapTrace::const_iterator & rhs)
-{
-    if(*this != rhs){
-        this->trace = rhs.trace;
-        this->idx = rhs.idx;
-    }
-    return *this;
-}
-
-bool HeapTrace::const_iterator::operator==(const HeapTrace::const_iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx == rhs.idx;
-}
-
-bool HeapTrace::const_iterator::operator!=(const HeapTrace::const_iterator &rhs) const
-{
-    return !(*this == rhs);
-}
-
-bool HeapTrace::const_iterator::operator<(const HeapTrace::const_iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx < rhs.idx;
-}
-
-bool HeapTrace::const_iterator::operator>(const HeapTrace::const_iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx > rhs.idx;
-}
-
-bool HeapTrace::const_iterator::operator<=(const HeapTrace::const_iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx <= rhs.idx;
-}
-
-bool HeapTrace::const_iterator::operator>=(const HeapTrace::const_iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx >= rhs.idx;
-}
-
-HeapTrace::const_iterator &HeapTrace::const_iterator::operator++()
-{
-    ++idx;
-    return *this;
-}
-
-HeapTrace::const_iterator &HeapTrace::const_iterator::operator--()
-{
-    --idx;
-    return *this;
-}
-
-HeapTrace::const_iterator::reference HeapTrace::const_iterator::operator*() const
-{
-    return *trace->heap[trace->itToAddresses[idx]].get();
-}
-
-HeapTrace::const_iterator::pointer HeapTrace::const_iterator::operator->() const
-{
-    return trace->heap[trace->itToAddresses[idx]].get();
-}
-
-HeapTrace::const_reverse_iterator::const_reverse_iterator(const HeapTrace & trace):
-    trace(&trace)
-{
-    int size = trace.heap.size() - 1;
-    idx = size;
-}
-
-HeapTrace::const_reverse_iterator::const_reverse_iterator(const HeapTrace & trace, int offset):
-    trace(&trace), idx(offset)
-{
-
-}
-
-HeapTrace::const_reverse_iterator::const_reverse_iterator(const HeapTrace::const_reverse_iterator & rhs):
-    trace(rhs.trace), idx(rhs.idx)
-{
-
-}
-
-HeapTrace::const_reverse_iterator::~const_reverse_iterator()
-{
-    // Nothing to clean up with this iterator
-}
-
-HeapTrace::const_reverse_iterator &HeapTrace::const_reverse_iterator::operator=(const HeapTrace::const_reverse_iterator & rhs)
-{
-    if(*this != rhs){
-        this->trace = rhs.trace;
-        this->idx = rhs.idx;
-    }
-    return *this;
-}
-
-bool HeapTrace::const_reverse_iterator::operator==(const HeapTrace::const_reverse_iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx == rhs.idx;
-}
-
-bool HeapTrace::const_reverse_iterator::operator!=(const HeapTrace::const_reverse_iterator &rhs) const
-{
-    return !(*this == rhs);
-}
-
-bool HeapTrace::const_reverse_iterator::operator<(const HeapTrace::const_reverse_iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx > rhs.idx;
-}
-
-bool HeapTrace::const_reverse_iterator::operator>(const HeapTrace::const_reverse_iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx < rhs.idx;
-}
-
-bool HeapTrace::const_reverse_iterator::operator<=(const HeapTrace::const_reverse_iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx >= rhs.idx;
-}
-
-bool HeapTrace::const_reverse_iterator::operator>=(const HeapTrace::const_reverse_iterator & rhs) const
-{
-    return this->trace == rhs.trace
-            && this->idx <= rhs.idx;
-}
-
-HeapTrace::const_reverse_iterator &HeapTrace::const_reverse_iterator::operator++()
-{
-    --idx;
-    return *this;
-}
-
-HeapTrace::const_reverse_iterator &HeapTrace::const_reverse_iterator::operator--()
-{
-    ++idx;
-    return *this;
-}
-
-HeapTrace::const_reverse_iterator::reference HeapTrace::const_reverse_iterator::operator*() const
-{
-    return *trace->heap[trace->itToAddresses[idx]].get();
-}
-
-HeapTrace::const_reverse_iterator::pointer HeapTrace::const_reverse_iterator::operator->() const
-{
-    return trace->heap[trace->itToAddresses[idx]].get();
-}
@@ -1,91 +1,163 @@
 #ifndef STACKTRACE_H
 #define STACKTRACE_H
 
-#include <QObject>
-#include <QStack>
+#include <iterator>
+#include <QMap>
 #include <QSharedPointer>
+#include <QString>
+#include <QVector>
 #include "enu.h"
-class AType;
-class AMemoryDevice;
-
+struct StaticTraceInfo;
+struct TraceType;
+struct TraceTypeRange;
+
+/*
+ * A primitive value in memory. The type is owned by the program's StaticTraceInfo,
+ * so that pushing a tag never copies its name.
+ */
 struct MemTag
 {
     quint16 addr;
-    QPair<Enu::ESymbolFormat, QString> type;
+    const TraceType* type;
     operator QString() const;
 };
 
+/*
+ * Bounds of a frame in the tag vector of a StackTrace or HeapTrace.
+ */
+struct FrameBounds
+{
+    int begin, end;
+    // Number of bytes spanned by the tags in the frame.
+    quint16 bytes;
+    bool isOrphaned;
+};
+
+/*
+ * A read-only view of the tags in one frame of a StackTrace or HeapTrace.
+ * Views are invalidated by any change to the trace they came from.
+ */
 class StackFrame
 {
-private:
-    QStack<MemTag> stack;
+    const MemTag* first;
+    const MemTag* last;
+    quint16 bytes;
 public:
+    using const_iterator = const MemTag*;
+    using const_reverse_iterator = std::reverse_iterator<const MemTag*>;
 
-    class iterator;
-    class reverse_iterator;
-    class const_iterator;
-    class const_reverse_iterator;
+    explicit StackFrame();
+    explicit StackFrame(const MemTag* first, const MemTag* last, quint16 bytes, bool isOrphaned);
 
-    iterator begin();
-    iterator end();
     const_iterator begin() const;
     const_iterator end() const;
     const_iterator cbegin() const;
     const_iterator cend() const;
 
-    reverse_iterator rbegin();
-    reverse_iterator rend();
     const_reverse_iterator rbegin() const;
     const_reverse_iterator rend() const;
     const_reverse_iterator crbegin() const;
     const_reverse_iterator crend() const;
 
-    bool isOrphaned = false;
-    void push(MemTag tag);
-    bool pop(quint16 size);
+    bool isOrphaned;
     quint16 size() const;
     quint16 numItems() const;
     operator QString() const;
 };
 
+/*
+ * Iterates over the frames of a StackTrace or HeapTrace,
+ * from oldest to newest, or from newest to oldest if reversed.
+ */
+class TraceFrameIterator
+{
+    const QVector<MemTag>* tags;
+    const QVector<FrameBounds>* frames;
+    int idx, step;
+    StackFrame frame;
+    void load();
+public:
+    using difference_type = int;
+    using value_type = StackFrame;
+    using reference = const StackFrame&;
+    using pointer = const StackFrame*;
+    using iterator_category = std::bidirectional_iterator_tag;
+
+    TraceFrameIterator(const QVector<MemTag>& tags, const QVector<FrameBounds>& frames, int idx, bool reversed);
+
+    bool operator==(const TraceFrameIterator&) const;
+    bool operator!=(const TraceFrameIterator&) const;
+
+    TraceFrameIterator& operator++();
+    TraceFrameIterator& operator--();
+
+    reference operator*() const;
+    pointer operator->() const;
+};
+
+/*
+ * Every tag on the stack is kept in one vector, from the bottom of the stack to the top,
+ * and frames are ranges of that vector. Since the vector keeps its capacity when tags are
+ * popped, a program that calls and returns repeatedly stops allocating once it reaches its
+ * deepest call.
+ */
 class StackTrace
 {
-    QStack<QSharedPointer<StackFrame>> callStack;
-    QSharedPointer<StackFrame> nextFrame;
+    QVector<MemTag> tags;
+    // The frames on the call stack, followed by the next frame (i.e. the arguments
+    // that have been pushed for a call that has not happened yet).
+    QVector<FrameBounds> frames;
     QString errMessage;
     bool stackIntact;
-public:
+    // Lowest tag and frame index changed since the last call to takeChanges().
+    int changedTag, changedFrame;
 
-    class iterator;
-    class reverse_iterator;
-    class const_iterator;
-    class const_reverse_iterator;
+    int nextFrame() const;
+    int topFrame() const;
+    void markChanged(int frame, int tag);
+    void push(int frame, quint16 addr, const TraceType* type);
+    // Returns the number of bytes popped, which may exceed size if a tag was split.
+    quint16 pop(int frame, quint16 size);
+public:
+    using const_iterator = TraceFrameIterator;
+    using const_reverse_iterator = TraceFrameIterator;
 
-    iterator begin();
-    iterator end();
     const_iterator begin() const;
     const_iterator end() const;
     const_iterator cbegin() const;
     const_iterator cend() const;
 
-    reverse_iterator rbegin();
-    reverse_iterator rend();
     const_reverse_iterator rbegin() const;
     const_reverse_iterator rend() const;
     const_reverse_iterator crbegin() const;
     const_reverse_iterator crend() const;
 
+    // Frames and tags below these indices are unchanged since the last call to takeChanges().
+    struct Changes
+    {
+        int firstTag, firstFrame;
+    };
+
     explicit StackTrace();
     void call(quint16 sp);
     void clear();
     bool ret();
-    void pushLocals(quint16 start, QList<QPair<Enu::ESymbolFormat, QString> > items);
-    void pushParams(quint16 start, QList<QPair<Enu::ESymbolFormat, QString> > items);
+    void pushLocals(quint16 start, const TraceTypeRange& items);
+    void pushParams(quint16 start, const TraceTypeRange& items);
     bool popLocals(quint16 size);
     bool popParams(quint16 size);
     bool popAndOrphan(quint16 size);
     quint16 callDepth() const;
-    const StackFrame& getTOS();
+    StackFrame getTOS() const;
+    // Every tag on the stack, from the bottom up.
+    const QVector<MemTag>& getMemTags() const;
+    // Number of frames, including the next frame.
+    int numFrames() const;
+    StackFrame getFrame(int frame) const;
+    // Report which frames and tags were pushed, popped, or replaced since the previous call,
+    // so that a view only needs to redraw the top of the stack. Taking the changes resets them,
+    // so only one view may take changes.
+    Changes takeChanges();
     operator QString() const;
 
     bool isStackIntact() const;
@@ -95,36 +167,34 @@ public:
 
 };
 
+/*
+ * Like StackTrace, every tag on the heap is kept in one vector, in the order it was allocated.
+ */
 class HeapTrace
 {
-    QVector<quint16> itToAddresses;
-    QMap<quint16, QSharedPointer<StackFrame>> heap;
+    QVector<MemTag> tags;
+    QVector<FrameBounds> frames;
     QString errMessage;
     bool intact, addNew, isInMalloc;
 public:
+    using const_iterator = TraceFrameIterator;
+    using const_reverse_iterator = TraceFrameIterator;
 
-    class iterator;
-    class reverse_iterator;
-    class const_iterator;
-    class const_reverse_iterator;
-
-
-    iterator begin();
-    iterator end();
     const_iterator begin() const;
     const_iterator end() const;
     const_iterator cbegin() const;
     const_iterator cend() const;
 
-    reverse_iterator rbegin();
-    reverse_iterator rend();
     const_reverse_iterator rbegin() const;
     const_reverse_iterator rend() const;
     const_reverse_iterator crbegin() const;
     const_reverse_iterator crend() const;
 
     explicit HeapTrace();
-    void pushHeap(quint16 start, QList<QPair<Enu::ESymbolFormat, QString> > items);
+    void pushHeap(quint16 start, const TraceTypeRange& items);
+    // Frames are only ever appended, until the heap is cleared.
+    int numFrames() const;
+    StackFrame getFrame(int frame) const;
     void clear();
     void setCanAddNew(bool val);
     void setHeapIntact(bool val);
@@ -143,15 +213,16 @@ class GlobalTrace
     QMap<quint16, MemTag> tags;
 public:
     explicit GlobalTrace();
-    void setTags(QList<QPair<quint16 /*address*/,
-                  QPair<Enu::ESymbolFormat, QString> /*tag*/ > > items);
+    void setTags(QVector<MemTag> items);
     void clear();
-    const QMap<quint16, MemTag> getMemTags() const;
+    const QMap<quint16, MemTag>& getMemTags() const;
 };
 
 class MemoryTrace
 {
     bool traceWarnings;
+    // Owns the types of every tag in the trace.
+    QSharedPointer<const StaticTraceInfo> traceInfo;
 public:
     explicit MemoryTrace();
     void clear();
@@ -160,378 +231,8 @@ public:
     GlobalTrace globalTrace;
     bool hasTraceWarnings() const;
     void setHasTraceWarnings(bool value);
-};
-
-class StackFrame::iterator {
-    StackFrame * frame;
-    int idx;
-public:
-    using difference_type = typename std::allocator<MemTag>::difference_type;
-    using value_type = typename std::allocator<MemTag>::value_type;
-    using reference = typename std::allocator<MemTag>::reference;
-    using pointer = typename std::allocator<MemTag>::pointer;
-    //typedef std::random_access_iterator_tag iterator_category; //or another tag
-
-    iterator(StackFrame&);
-    iterator(StackFrame&, int offset);
-    iterator (const iterator&);
-    ~iterator();
-
-    iterator& operator=(const iterator&);
-    bool operator==(const iterator&) const;
-    bool operator!=(const iterator&) const;
-    bool operator<(const iterator&) const; //optional
-    bool operator>(const iterator&) const; //optional
-    bool operator<=(const iterator&) const; //optional
-    bool operator>=(const iterator&) const; //optional
-
-    iterator& operator++();
-    iterator& operator--(); //optional
-
-    reference operator*();
-    pointer operator->();
-    //reference operator[](size_type) const; //optional
-};
-
-class StackFrame::reverse_iterator{
-    StackFrame * frame;
-    int idx;
-public:
-    using difference_type = typename std::allocator<MemTag>::difference_type;
-    using value_type = typename std::allocator<MemTag>::value_type;
-    using reference = typename std::allocator<MemTag>::reference;
-    using pointer = typename std::allocator<MemTag>::pointer;
-    //typedef std::random_access_iterator_tag iterator_category; //or another tag
-
-    reverse_iterator(StackFrame&);
-    reverse_iterator(StackFrame&, int offset);
-    reverse_iterator (const reverse_iterator&);
-    ~reverse_iterator();
-
-    reverse_iterator& operator=(const reverse_iterator&);
-    bool operator==(const reverse_iterator&) const;
-    bool operator!=(const reverse_iterator&) const;
-    bool operator<(const reverse_iterator&) const; //optional
-    bool operator>(const reverse_iterator&) const; //optional
-    bool operator<=(const reverse_iterator&) const; //optional
-    bool operator>=(const reverse_iterator&) const; //optional
-
-    reverse_iterator& operator++();
-    reverse_iterator& operator--(); //optional
-
-    reference operator*();
-    pointer operator->();
-
-};
-
-class StackFrame::const_iterator {
-    const StackFrame * frame;
-    int idx;
-public:
-    using difference_type = const typename std::allocator<MemTag>::difference_type;
-    using value_type = const typename std::allocator<MemTag>::value_type;
-    using reference = typename std::allocator<MemTag>::const_reference;
-    using pointer = typename std::allocator<MemTag>::const_pointer;
-    //typedef std::random_access_iterator_tag iterator_category; //or another tag
-
-    const_iterator(const StackFrame&);
-    const_iterator(const StackFrame&, int offset);
-    const_iterator (const const_iterator&);
-    ~const_iterator();
-
-    const_iterator& operator=(const const_iterator&);
-    bool operator==(const const_iterator&) const;
-    bool operator!=(const const_iterator&) const;
-    bool operator<(const const_iterator&) const; //optional
-    bool operator>(const const_iterator&) const; //optional
-    bool operator<=(const const_iterator&) const; //optional
-    bool operator>=(const const_iterator&) const; //optional
-
-    const_iterator& operator++();
-    const_iterator& operator--(); //optional
-
-    reference operator*() const;
-    pointer operator->() const;
-    //reference operator[](size_type) const; //optional
-};
-
-class StackFrame::const_reverse_iterator {
-    const StackFrame * frame;
-    int idx;
-public:
-    using difference_type = const typename std::allocator<MemTag>::difference_type;
-    using value_type = const typename std::allocator<MemTag>::value_type;
-    using reference = typename std::allocator<MemTag>::const_reference;
-    using pointer = typename std::allocator<MemTag>::const_pointer;
-    //typedef std::random_access_iterator_tag iterator_category; //or another tag
-
-    const_reverse_iterator(const StackFrame&);
-    const_reverse_iterator(const StackFrame&, int offset);
-    const_reverse_iterator (const const_reverse_iterator&);
-    ~const_reverse_iterator();
-
-    const_reverse_iterator& operator=(const const_reverse_iterator&);
-    bool operator==(const const_reverse_iterator&) const;
-    bool operator!=(const const_reverse_iterator&) const;
-    bool operator<(const const_reverse_iterator&) const; //optional
-    bool operator>(const const_reverse_iterator&) const; //optional
-    bool operator<=(const const_reverse_iterator&) const; //optional
-    bool operator>=(const const_reverse_iterator&) const; //optional
-
-    const_reverse_iterator& operator++();
-    const_reverse_iterator& operator--(); //optional
-
-    reference operator*() const;
-    pointer operator->() const;
-    //reference operator[](size_type) const; //optional
-};
-
-class StackTrace::iterator {
-    StackTrace * trace;
-    int idx;
-public:
-    using difference_type = typename std::allocator<StackFrame>::difference_type;
-    using value_type = typename std::allocator<StackFrame>::value_type;
-    using reference = typename std::allocator<StackFrame>::reference;
-    using pointer = typename std::allocator<StackFrame>::pointer;
-    //typedef std::random_access_iterator_tag iterator_category; //or another tag
-
-    iterator(StackTrace&);
-    iterator(StackTrace&, int offset);
-    iterator (const iterator&);
-    ~iterator();
-
-    iterator& operator=(const iterator&);
-    bool operator==(const iterator&) const;
-    bool operator!=(const iterator&) const;
-    bool operator<(const iterator&) const; //optional
-    bool operator>(const iterator&) const; //optional
-    bool operator<=(const iterator&) const; //optional
-    bool operator>=(const iterator&) const; //optional
-
-    iterator& operator++();
-    iterator& operator--(); //optional
-
-    reference operator*();
-    pointer operator->();
-    //reference operator[](size_type) const; //optional
-};
-
-class StackTrace::reverse_iterator {
-    StackTrace * trace;
-    int idx;
-public:
-    using difference_type = typename std::allocator<StackFrame>::difference_type;
-    using value_type = typename std::allocator<StackFrame>::value_type;
-    using reference = typename std::allocator<StackFrame>::reference;
-    using pointer = typename std::allocator<StackFrame>::pointer;
-    //typedef std::random_access_iterator_tag iterator_category; //or another tag
-
-    reverse_iterator(StackTrace&);
-    reverse_iterator(StackTrace&, int offset);
-    reverse_iterator (const reverse_iterator&);
-    ~reverse_iterator();
-
-    reverse_iterator& operator=(const reverse_iterator&);
-    bool operator==(const reverse_iterator&) const;
-    bool operator!=(const reverse_iterator&) const;
-    bool operator<(const reverse_iterator&) const; //optional
-    bool operator>(const reverse_iterator&) const; //optional
-    bool operator<=(const reverse_iterator&) const; //optional
-    bool operator>=(const reverse_iterator&) const; //optional
-
-    reverse_iterator& operator++();
-    reverse_iterator& operator--(); //optional
-
-    reference operator*();
-    pointer operator->();
-    //reference operator[](size_type) const; //optional
-};
-
-class StackTrace::const_iterator {
-    const StackTrace * trace;
-    int idx;
-public:
-    using difference_type = const typename std::allocator<StackFrame>::difference_type;
-    using value_type = const typename std::allocator<StackFrame>::value_type;
-    using reference = typename std::allocator<StackFrame>::const_reference;
-    using pointer = typename std::allocator<StackFrame>::const_pointer;
-    //typedef std::random_access_iterator_tag iterator_category; //or another tag
-
-    const_iterator(const StackTrace&);
-    const_iterator(const StackTrace&, int offset);
-    const_iterator (const const_iterator&);
-    ~const_iterator();
-
-    const_iterator& operator=(const const_iterator&);
-    bool operator==(const const_iterator&) const;
-    bool operator!=(const const_iterator&) const;
-    bool operator<(const const_iterator&) const; //optional
-    bool operator>(const const_iterator&) const; //optional
-    bool operator<=(const const_iterator&) const; //optional
-    bool operator>=(const const_iterator&) const; //optional
-
-    const_iterator& operator++();
-    const_iterator& operator--(); //optional
-
-    reference operator*() const;
-    pointer operator->() const;
-    //reference operator[](size_type) const; //optional
-};
-
-class StackTrace::const_reverse_iterator {
-    const StackTrace * trace;
-    int idx;
-public:
-    using difference_type = const typename std::allocator<StackFrame>::difference_type;
-    using value_type = const typename std::allocator<StackFrame>::value_type;
-    using reference = typename std::allocator<StackFrame>::const_reference;
-    using pointer = typename std::allocator<StackFrame>::const_pointer;
-    //typedef std::random_access_iterator_tag iterator_category; //or another tag
-
-    const_reverse_iterator(const StackTrace&);
-    const_reverse_iterator(const StackTrace&, int offset);
-    const_reverse_iterator (const const_reverse_iterator&);
-    ~const_reverse_iterator();
-
-    const_reverse_iterator& operator=(const const_reverse_iterator&);
-    bool operator==(const const_reverse_iterator&) const;
-    bool operator!=(const const_reverse_iterator&) const;
-    bool operator<(const const_reverse_iterator&) const; //optional
-    bool operator>(const const_reverse_iterator&) const; //optional
-    bool operator<=(const const_reverse_iterator&) const; //optional
-    bool operator>=(const const_reverse_iterator&) const; //optional
-
-    const_reverse_iterator& operator++();
-    const_reverse_iterator& operator--(); //optional
-
-    reference operator*() const;
-    pointer operator->() const;
-    //reference operator[](size_type) const; //optional
-};
-
-class HeapTrace::iterator {
-    HeapTrace * trace;
-    int idx;
-public:
-    using difference_type = typename std::allocator<StackFrame>::difference_type;
-    using value_type = typename std::allocator<StackFrame>::value_type;
-    using reference = typename std::allocator<StackFrame>::reference;
-    using pointer = typename std::allocator<StackFrame>::pointer;
-    //typedef std::random_access_iterator_tag iterator_category; //or another tag
-
-    iterator(HeapTrace&);
-    iterator(HeapTrace&, int offset);
-    iterator (const iterator&);
-    ~iterator();
-
-    iterator& operator=(const iterator&);
-    bool operator==(const iterator&) const;
-    bool operator!=(const iterator&) const;
-    bool operator<(const iterator&) const; //optional
-    bool operator>(const iterator&) const; //optional
-    bool operator<=(const iterator&) const; //optional
-    bool operator>=(const iterator&) const; //optional
-
-    iterator& operator++();
-    iterator& operator--(); //optional
-
-    reference operator*();
-    pointer operator->();
-    //reference operator[](size_type) const; //optional
-};
-
-class HeapTrace::reverse_iterator {
-    HeapTrace * trace;
-    int idx;
-public:
-    using difference_type = typename std::allocator<StackFrame>::difference_type;
-    using value_type = typename std::allocator<StackFrame>::value_type;
-    using reference = typename std::allocator<StackFrame>::reference;
-    using pointer = typename std::allocator<StackFrame>::pointer;
-    //typedef std::random_access_iterator_tag iterator_category; //or another tag
-
-    reverse_iterator(HeapTrace&);
-    reverse_iterator(HeapTrace&, int offset);
-    reverse_iterator (const reverse_iterator&);
-    ~reverse_iterator();
-
-    reverse_iterator& operator=(const reverse_iterator&);
-    bool operator==(const reverse_iterator&) const;
-    bool operator!=(const reverse_iterator&) const;
-    bool operator<(const reverse_iterator&) const; //optional
-    bool operator>(const reverse_iterator&) const; //optional
-    bool operator<=(const reverse_iterator&) const; //optional
-    bool operator>=(const reverse_iterator&) const; //optional
-
-    reverse_iterator& operator++();
-    reverse_iterator& operator--(); //optional
-
-    reference operator*();
-    pointer operator->();
-    //reference operator[](size_type) const; //optional
-};
-
-class HeapTrace::const_iterator {
-    const HeapTrace * trace;
-    int idx;
-public:
-    using difference_type = const typename std::allocator<StackFrame>::difference_type;
-    using value_type = const typename std::allocator<StackFrame>::value_type;
-    using reference = typename std::allocator<StackFrame>::const_reference;
-    using pointer = typename std::allocator<StackFrame>::const_pointer;
-    //typedef std::random_access_iterator_tag iterator_category; //or another tag
-
-    const_iterator(const HeapTrace&);
-    const_iterator(const HeapTrace&, int offset);
-    const_iterator (const const_iterator&);
-    ~const_iterator();
-
-    const_iterator& operator=(const const_iterator&);
-    bool operator==(const const_iterator&) const;
-    bool operator!=(const const_iterator&) const;
-    bool operator<(const const_iterator&) const; //optional
-    bool operator>(const const_iterator&) const; //optional
-    bool operator<=(const const_iterator&) const; //optional
-    bool operator>=(const const_iterator&) const; //optional
-
-    const_iterator& operator++();
-    const_iterator& operator--(); //optional
-
-    reference operator*() const;
-    pointer operator->() const;
-    //reference operator[](size_type) const; //optional
-};
-
-class HeapTrace::const_reverse_iterator {
-    const HeapTrace * trace;
-    int idx;
-public:
-    using difference_type = const typename std::allocator<StackFrame>::difference_type;
-    using value_type = const typename std::allocator<StackFrame>::value_type;
-    using reference = typename std::allocator<StackFrame>::const_reference;
-    using pointer = typename std::allocator<StackFrame>::const_pointer;
-    //typedef std::random_access_iterator_tag iterator_category; //or another tag
-
-    const_reverse_iterator(const HeapTrace&);
-    const_reverse_iterator(const HeapTrace&, int offset);
-    const_reverse_iterator (const const_reverse_iterator&);
-    ~const_reverse_iterator();
-
-    const_reverse_iterator& operator=(const const_reverse_iterator&);
-    bool operator==(const const_reverse_iterator&) const;
-    bool operator!=(const const_reverse_iterator&) const;
-    bool operator<(const const_reverse_iterator&) const; //optional
-    bool operator>(const const_reverse_iterator&) const; //optional
-    bool operator<=(const const_reverse_iterator&) const; //optional
-    bool operator>=(const const_reverse_iterator&) const; //optional
-
-    const_reverse_iterator& operator++();
-    const_reverse_iterator& operator--(); //optional
-
-    reference operator*() const;
-    pointer operator->() const;
-    //reference operator[](size_type) const; //optional
+    // Must be set before pushing any tags whose types belong to traceInfo.
+    void setTraceInfo(QSharedPointer<const StaticTraceInfo> traceInfo);
 };
 
 #endif // STACKTRACE_H
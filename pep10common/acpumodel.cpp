@@ -23,10 +23,11 @@
 #include "acpumodel.h"
 #include "amemorydevice.h"
 #include "interrupthandler.h"
+#include <QCoreApplication>
 #include <QSharedPointer>
 #include <utility>
 ACPUModel::ACPUModel(QSharedPointer<AMemoryDevice> memoryDev, QObject* parent) noexcept: QObject(parent), memory(std::move(memoryDev)),
-    handler(new InterruptHandler()), callDepth(0), inDebug(false), inSimulation(false),
+    handler(new InterruptHandler()), snapshotPublisher(nullptr), eventPump(), callDepth(0), inDebug(false), inSimulation(false),
     executionFinished(false), controlError(false), errorMessage("")
 {
 
@@ -69,6 +70,65 @@ int ACPUModel::getCallDepth() const noexcept
     return callDepth;
 }
 
+void ACPUModel::setSnapshotPublisher(QSharedPointer<SnapshotPublisher> publisher)
+{
+    snapshotPublisher = std::move(publisher);
+}
+
+QSharedPointer<SnapshotPublisher> ACPUModel::getSnapshotPublisher() const noexcept
+{
+    return snapshotPublisher;
+}
+
+SimulationSnapshot ACPUModel::captureSnapshot() const
+{
+    SimulationSnapshot snapshot;
+    snapshot.callDepth = callDepth;
+    // Only registers A through OS are present at every level of abstraction.
+    for(int reg = 0; reg <= static_cast<int>(Enu::CPURegisters::OS) + 1; reg++) {
+        snapshot.registers[static_cast<std::size_t>(reg)] = getCPURegByteCurrent(static_cast<Enu::CPURegisters>(reg));
+    }
+    if(getStatusBitCurrent(Enu::STATUS_N)) snapshot.statusBits |= Enu::NMask;
+    if(getStatusBitCurrent(Enu::STATUS_Z)) snapshot.statusBits |= Enu::ZMask;
+    if(getStatusBitCurrent(Enu::STATUS_V)) snapshot.statusBits |= Enu::VMask;
+    if(getStatusBitCurrent(Enu::STATUS_C)) snapshot.statusBits |= Enu::CMask;
+    if(getStatusBitCurrent(Enu::STATUS_S)) snapshot.statusBits |= Enu::SMask;
+    return snapshot;
+}
+
+void ACPUModel::setEventPump(std::function<void()> pump)
+{
+    eventPump = std::move(pump);
+}
+
+void ACPUModel::publishSnapshot(quint64 instructionCount, quint64 cycleCount, quint16 operandValue)
+{
+    SimulationSnapshot snapshot = captureSnapshot();
+    snapshot.instructionCount = instructionCount;
+    snapshot.cycleCount = cycleCount;
+    snapshot.operandValue = operandValue;
+    snapshot.dirtyPages = memory->takeDirtyPages();
+    // Copy the pages now, since the views must not read memory while the simulation owns it.
+    // Addresses past the end of memory can't be read without error, so they are left 0.
+    snapshot.pageBytes.fill(0, snapshot.dirtyPages.size() * AMemoryDevice::pageSize);
+    quint32 maxAddress = memory->maxAddress();
+    quint8* bytes = snapshot.pageBytes.data();
+    for(quint8 page : snapshot.dirtyPages) {
+        for(quint32 address = page * AMemoryDevice::pageSize;
+            address < (page + 1u) * AMemoryDevice::pageSize && address <= maxAddress; address++) {
+            memory->getByte(static_cast<quint16>(address), bytes[address % AMemoryDevice::pageSize]);
+        }
+        bytes += AMemoryDevice::pageSize;
+    }
+    snapshotPublisher->publish(std::move(snapshot));
+}
+
+void ACPUModel::processEvents()
+{
+    if(eventPump) eventPump();
+    else QCoreApplication::processEvents();
+}
+
 void ACPUModel::onClearMemory()
 {
     memory->clearErrors();
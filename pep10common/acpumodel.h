@@ -22,8 +22,11 @@
 #ifndef ACPUMODEL_H
 #define ACPUMODEL_H
 
+#include <functional>
 #include <QObject>
+#include <QSharedPointer>
 #include "enu.h"
+#include "simulationsnapshot.h"
 
 class AMemoryDevice;
 class InterruptHandler;
@@ -64,6 +67,17 @@ public:
     // Return the depth of the call stack (#calls+#traps-#ret-#rettr)
     int getCallDepth() const noexcept;
 
+    // While running, publish snapshots of the CPU to publisher once per frame, and only then
+    // let the UI process events. If there is no publisher, events are processed every few hundred instructions.
+    void setSnapshotPublisher(QSharedPointer<SnapshotPublisher> publisher);
+    QSharedPointer<SnapshotPublisher> getSnapshotPublisher() const noexcept;
+    // Copy the current registers, status bits, and call depth. Counters, operand value, and memory are left empty.
+    // Microcoded CPUs also copy their micro-level registers.
+    virtual SimulationSnapshot captureSnapshot() const;
+    // While running, the CPU periodically calls pump so that it may react to outside requests (like interrupting
+    // execution). If there is no pump, the application's event loop is processed instead.
+    void setEventPump(std::function<void()> pump);
+
     // Prepare the CPU for starting simulations / debugging.
     virtual void initCPU() = 0;
     // Fetch values of the status bit reigsters(NZVCS bits).
@@ -113,8 +127,16 @@ signals:
     void asmInstructionFinished();
 
 protected:
+    // Capture the registers, status bits, and the dirty pages of memory with their contents, and publish them.
+    // Only call when the publisher is not null.
+    void publishSnapshot(quint64 instructionCount, quint64 cycleCount, quint16 operandValue);
+    // Call the event pump, or process application events if there is none.
+    void processEvents();
+
     QSharedPointer<AMemoryDevice> memory;
     QSharedPointer<InterruptHandler> handler;
+    QSharedPointer<SnapshotPublisher> snapshotPublisher;
+    std::function<void()> eventPump;
     int callDepth;
     bool inDebug, inSimulation, executionFinished;
     mutable bool controlError;
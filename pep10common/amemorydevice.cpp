@@ -21,6 +21,7 @@
 */
 
 #include "amemorydevice.h"
+#include "memoryaccessstats.h"
 
 AMemoryDevice::AMemoryDevice(QObject *parent) noexcept: QObject(parent),
     errorMessage(""), error(false)
@@ -64,6 +65,42 @@ void AMemoryDevice::clearBytesSet() noexcept
     bytesSet.clear();
 }
 
+void AMemoryDevice::setWriteJournal(QVector<MemoryWriteRecord> *journal) noexcept
+{
+    writeJournal = journal;
+}
+
+QVector<quint8> AMemoryDevice::takeDirtyPages()
+{
+    QVector<quint8> pages;
+    if(dirtyPages.none()) return pages;
+    for(std::size_t page = 0; page < dirtyPages.size(); page++) {
+        if(dirtyPages.test(page)) pages.append(static_cast<quint8>(page));
+    }
+    dirtyPages.reset();
+    return pages;
+}
+
+void AMemoryDevice::setAccessStats(MemoryAccessStats *stats) noexcept
+{
+    accessStats = stats;
+}
+
+MemoryAccessStats *AMemoryDevice::getAccessStats() const noexcept
+{
+    return accessStats;
+}
+
+void AMemoryDevice::clearStatistics()
+{
+    if(accessStats != nullptr) accessStats->clear();
+}
+
+quint64 AMemoryDevice::takeWaitCycles() noexcept
+{
+    return 0;
+}
+
 bool AMemoryDevice::readWord(quint16 offsetFromBase, quint16 &output) const
 {
     quint8 temp = 0;
@@ -22,8 +22,19 @@
 #ifndef AMEMORYDEVICE_H
 #define AMEMORYDEVICE_H
 
+#include <bitset>
 #include <QObject>
 #include <QSet>
+#include <QVector>
+
+class MemoryAccessStats;
+
+// The value a byte held before it was changed by AMemoryDevice::writeByte(...).
+struct MemoryWriteRecord
+{
+    quint16 address;
+    quint8 oldValue;
+};
 
 /*
  * This class provides a unified interface for memory devices (like RAM, or a cache).
@@ -53,7 +64,16 @@ protected:
     QSet<quint16> bytesWritten, bytesSet;
     mutable QString errorMessage;
     mutable bool error;
+    // If not nullptr, writeByte(...) appends the prior value of each byte it writes.
+    QVector<MemoryWriteRecord>* writeJournal = nullptr;
+    // One bit per page of pageSize bytes, set when the page is written / set.
+    std::bitset<256> dirtyPages;
+    // If not nullptr, reads and writes (but not gets and sets) are counted per address.
+    MemoryAccessStats* accessStats = nullptr;
 public:
+    // Granularity at which changes are tracked by takeDirtyPages().
+    static constexpr int pageSize = (1 << 16) / 256;
+    static constexpr int pageCount = (1 << 16) / pageSize;
     explicit AMemoryDevice(QObject *parent = nullptr) noexcept;
 
     // Returns true if a fatal error affected memory.
@@ -77,6 +97,22 @@ public:
     // continue to grow until explicitly reset.
     void clearBytesWritten() noexcept;
     void clearBytesSet() noexcept;
+    // Journal the prior value of every byte written (but not set) into journal, so that
+    // writes may later be undone in reverse order. Pass nullptr to stop journaling.
+    void setWriteJournal(QVector<MemoryWriteRecord>* journal) noexcept;
+    // Returns the pages written / set since the last call, in increasing order, and marks every page clean.
+    // Unlike the written / set byte sets, this is cheap to call frequently while a simulation runs.
+    QVector<quint8> takeDirtyPages();
+    // Count every read and write in stats, or stop counting if stats is nullptr. The CPU counts the
+    // instructions it executes in getAccessStats(). Stats must outlive this device, or be detached first.
+    void setAccessStats(MemoryAccessStats* stats) noexcept;
+    MemoryAccessStats* getAccessStats() const noexcept;
+    // Clear any statistics gathered about accesses, such as the access stats. CPUs call this
+    // when they are reset, and once the user program is loaded, so that statistics cover one run.
+    virtual void clearStatistics();
+    // Return the number of cycles that accesses since the last call waited for, beyond the fixed
+    // wait states of the bus protocol, and reset the count. Memory without latency returns 0.
+    virtual quint64 takeWaitCycles() noexcept;
 
 public slots:
     // Clear the contents of memory. All addresses from 0 to size will be set to 0.
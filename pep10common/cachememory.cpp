@@ -0,0 +1,323 @@
+#include "cachememory.h"
+
+#include <stdexcept>
+#include <QStringList>
+
+#include "amemorychip.h"
+#include "mainmemory.h"
+#include "memoryaccessstats.h"
+
+static bool isPowerOfTwo(quint32 value)
+{
+    return value != 0 && (value & (value - 1)) == 0;
+}
+
+static int bitsOf(quint32 powerOfTwo)
+{
+    int bits = 0;
+    while((1u << bits) < powerOfTwo) bits++;
+    return bits;
+}
+
+QString CacheConfig::validate() const
+{
+    if(!isPowerOfTwo(size) || size > (1 << 16)) {
+        return QString("Cache size must be a power of two no larger than 65536, but was %1.").arg(size);
+    }
+    else if(!isPowerOfTwo(lineSize)) {
+        return QString("Line size must be a power of two, but was %1.").arg(lineSize);
+    }
+    else if(!isPowerOfTwo(associativity)) {
+        return QString("Associativity must be a power of two, but was %1.").arg(associativity);
+    }
+    else if(static_cast<quint32>(lineSize) * associativity > size) {
+        return QString("A cache of %1 bytes cannot hold %2 lines of %3 bytes.").arg(size).arg(associativity).arg(lineSize);
+    }
+    return QString();
+}
+
+QString CacheConfig::parse(const QString &spec, CacheConfig &config)
+{
+    CacheConfig ret = config;
+    for(const QString& pair : spec.split(',', QString::SkipEmptyParts)) {
+        QStringList parts = pair.split('=');
+        if(parts.size() != 2) return QString("Expected key=value, but found \"%1\".").arg(pair.trimmed());
+        QString key = parts[0].trimmed().toLower(), value = parts[1].trimmed().toLower();
+        bool ok = true;
+        if(key == "size") ret.size = value.toUInt(&ok);
+        else if(key == "line") ret.lineSize = value.toUShort(&ok);
+        else if(key == "ways") ret.associativity = value.toUShort(&ok);
+        else if(key == "hit") ret.hitLatency = value.toUInt(&ok);
+        else if(key == "latency") ret.memoryLatency = value.toUInt(&ok);
+        else if(key == "seed") ret.seed = value.toUInt(&ok);
+        else if(key == "replace") {
+            if(value == "lru") ret.replacement = Replacement::LRU;
+            else if(value == "fifo") ret.replacement = Replacement::FIFO;
+            else if(value == "random") ret.replacement = Replacement::Random;
+            else ok = false;
+        }
+        else if(key == "write") {
+            if(value == "back") ret.write = Write::Back;
+            else if(value == "through") ret.write = Write::Through;
+            else ok = false;
+        }
+        else if(key == "allocate") {
+            if(value == "yes") ret.writeAllocate = true;
+            else if(value == "no") ret.writeAllocate = false;
+            else ok = false;
+        }
+        else return QString("Unknown cache option \"%1\".").arg(key);
+        if(!ok) return QString("Invalid value \"%1\" for cache option \"%2\".").arg(value, key);
+    }
+    QString error = ret.validate();
+    if(error.isEmpty()) config = ret;
+    return error;
+}
+
+quint64 CacheStats::hits() const noexcept
+{
+    return readHits + writeHits;
+}
+
+quint64 CacheStats::misses() const noexcept
+{
+    return readMisses + writeMisses;
+}
+
+double CacheStats::hitRate() const noexcept
+{
+    quint64 accesses = hits() + misses();
+    if(accesses == 0) return 0;
+    return static_cast<double>(hits()) / accesses;
+}
+
+QString CacheStats::toString() const
+{
+    return QString("Reads: %1 hits, %2 misses\n"
+                   "Writes: %3 hits, %4 misses\n"
+                   "Hit rate: %5%\n"
+                   "Evictions: %6 (%7 written back)\n"
+                   "Uncached accesses: %8\n"
+                   "Wait cycles: %9\n")
+            .arg(readHits).arg(readMisses).arg(writeHits).arg(writeMisses)
+            .arg(hitRate() * 100, 0, 'f', 2)
+            .arg(evictions).arg(writeBacks).arg(uncached).arg(waitCycles);
+}
+
+CacheMemory::CacheMemory(QSharedPointer<MainMemory> memory, CacheConfig config, QObject *parent):
+    AMemoryDevice(parent), memory(std::move(memory)), config(config), offsetBits(0), setMask(0),
+    tags(), flags(), stamps(), clock(0), randomState(0), stats(), pendingWaitCycles(0)
+{
+    QString error = config.validate();
+    if(!error.isEmpty()) throw std::invalid_argument(error.toStdString());
+    quint32 lines = config.size / config.lineSize;
+    quint32 sets = lines / config.associativity;
+    offsetBits = bitsOf(config.lineSize);
+    setMask = static_cast<quint16>(sets - 1);
+    tags.fill(0, static_cast<int>(lines));
+    flags.fill(0, static_cast<int>(lines));
+    stamps.fill(0, static_cast<int>(lines));
+    // Xorshift gets stuck at 0, so never seed it with 0.
+    randomState = config.seed != 0 ? config.seed : 1;
+}
+
+CacheMemory::~CacheMemory() = default;
+
+QSharedPointer<MainMemory> CacheMemory::getMemory() const noexcept
+{
+    return memory;
+}
+
+const CacheConfig &CacheMemory::getConfig() const noexcept
+{
+    return config;
+}
+
+const CacheStats &CacheMemory::getStats() const noexcept
+{
+    return stats;
+}
+
+bool CacheMemory::contains(quint16 address) const noexcept
+{
+    return find(address) != -1;
+}
+
+void CacheMemory::invalidate() noexcept
+{
+    flags.fill(0);
+    stamps.fill(0);
+    clock = 0;
+}
+
+quint32 CacheMemory::maxAddress() const noexcept
+{
+    return memory->maxAddress();
+}
+
+void CacheMemory::clearStatistics()
+{
+    AMemoryDevice::clearStatistics();
+    memory->clearStatistics();
+    invalidate();
+    stats = CacheStats();
+    pendingWaitCycles = 0;
+    randomState = config.seed != 0 ? config.seed : 1;
+}
+
+quint64 CacheMemory::takeWaitCycles() noexcept
+{
+    quint64 ret = pendingWaitCycles;
+    pendingWaitCycles = 0;
+    return ret;
+}
+
+void CacheMemory::clearMemory()
+{
+    memory->clearMemory();
+    invalidate();
+    bytesSet.clear();
+    bytesWritten.clear();
+    dirtyPages.set();
+    clearErrors();
+}
+
+void CacheMemory::onCycleStarted()
+{
+    memory->onCycleStarted();
+}
+
+void CacheMemory::onCycleFinished()
+{
+    memory->onCycleFinished();
+}
+
+bool CacheMemory::readByte(quint16 address, quint8 &output) const
+{
+    access(address, false);
+    if(accessStats != nullptr) accessStats->recordRead(address);
+    bool retVal = memory->readByte(address, output);
+    if(!retVal) copyError();
+    return retVal;
+}
+
+bool CacheMemory::writeByte(quint16 address, quint8 value)
+{
+    // Journal here rather than in the wrapped memory, since the CPU only knows of this device.
+    if(writeJournal != nullptr) {
+        quint8 oldValue = 0;
+        memory->getByte(address, oldValue);
+        writeJournal->append({address, oldValue});
+    }
+    access(address, true);
+    if(accessStats != nullptr) accessStats->recordWrite(address);
+    bool retVal = memory->writeByte(address, value);
+    if(!retVal) copyError();
+    bytesWritten.insert(address);
+    dirtyPages.set(address / pageSize);
+    return retVal;
+}
+
+bool CacheMemory::getByte(quint16 address, quint8 &output) const
+{
+    return memory->getByte(address, output);
+}
+
+bool CacheMemory::setByte(quint16 address, quint8 value)
+{
+    bool retVal = memory->setByte(address, value);
+    bytesSet.insert(address);
+    dirtyPages.set(address / pageSize);
+    return retVal;
+}
+
+int CacheMemory::find(quint16 address) const noexcept
+{
+    quint16 line = address >> offsetBits;
+    int first = (line & setMask) * config.associativity;
+    for(int it = first; it < first + config.associativity; it++) {
+        if((flags[it] & Valid) && tags[it] == line) return it;
+    }
+    return -1;
+}
+
+int CacheMemory::fill(quint16 address) const noexcept
+{
+    quint16 line = address >> offsetBits;
+    int first = (line & setMask) * config.associativity;
+    int victim = -1;
+    // Prefer an empty line, so that nothing is evicted.
+    for(int it = first; it < first + config.associativity && victim == -1; it++) {
+        if(!(flags[it] & Valid)) victim = it;
+    }
+    if(victim == -1) {
+        if(config.replacement == CacheConfig::Replacement::Random) {
+            randomState ^= randomState << 13;
+            randomState ^= randomState >> 17;
+            randomState ^= randomState << 5;
+            victim = first + static_cast<int>(randomState & (config.associativity - 1u));
+        }
+        else {
+            // LRU and FIFO both evict the oldest stamp. They differ in when the stamp is updated.
+            victim = first;
+            for(int it = first + 1; it < first + config.associativity; it++) {
+                if(stamps[it] < stamps[victim]) victim = it;
+            }
+        }
+        stats.evictions++;
+        if(flags[victim] & Dirty) {
+            stats.writeBacks++;
+            pendingWaitCycles += config.memoryLatency;
+            stats.waitCycles += config.memoryLatency;
+        }
+    }
+    tags[victim] = line;
+    flags[victim] = Valid;
+    stamps[victim] = ++clock;
+    pendingWaitCycles += config.memoryLatency;
+    stats.waitCycles += config.memoryLatency;
+    return victim;
+}
+
+bool CacheMemory::isCachable(quint16 address) const noexcept
+{
+    return memory->chipAt(address)->isCachable();
+}
+
+void CacheMemory::access(quint16 address, bool isWrite) const noexcept
+{
+    if(!isCachable(address)) {
+        stats.uncached++;
+        pendingWaitCycles += config.memoryLatency;
+        stats.waitCycles += config.memoryLatency;
+        return;
+    }
+    quint32 waits = config.hitLatency;
+    int line = find(address);
+    if(line != -1) {
+        if(isWrite) stats.writeHits++;
+        else stats.readHits++;
+        if(config.replacement == CacheConfig::Replacement::LRU) stamps[line] = ++clock;
+    }
+    else if(!isWrite || config.writeAllocate) {
+        if(isWrite) stats.writeMisses++;
+        else stats.readMisses++;
+        line = fill(address);
+    }
+    else stats.writeMisses++;
+
+    if(isWrite && config.write == CacheConfig::Write::Through) waits += config.memoryLatency;
+    // A write that misses without allocating a line goes straight to memory.
+    else if(isWrite && line == -1) waits += config.memoryLatency;
+    else if(isWrite) flags[line] |= Dirty;
+    pendingWaitCycles += waits;
+    stats.waitCycles += waits;
+}
+
+void CacheMemory::copyError() const
+{
+    if(memory->hadError()) {
+        error = true;
+        errorMessage = memory->getErrorMessage();
+    }
+}
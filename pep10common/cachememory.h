@@ -0,0 +1,151 @@
+#ifndef CACHEMEMORY_H
+#define CACHEMEMORY_H
+
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+
+#include "amemorydevice.h"
+class MainMemory;
+
+/*
+ * Shape and policies of a CacheMemory.
+ */
+struct CacheConfig
+{
+    enum class Replacement : quint8 {
+        LRU, FIFO, Random
+    };
+    enum class Write : quint8 {
+        // Written lines are marked dirty, and only copied to memory when they are evicted.
+        Back,
+        // Every write is copied to memory immediately, so lines are never dirty.
+        Through
+    };
+
+    // Total bytes of data held by the cache, bytes per line, and lines per set.
+    // All must be powers of two, and size must be at least lineSize * associativity.
+    quint32 size = 1024;
+    quint16 lineSize = 16;
+    quint16 associativity = 2;
+    Replacement replacement = Replacement::LRU;
+    Write write = Write::Back;
+    // If a write misses, fetch the line into the cache before writing it.
+    bool writeAllocate = true;
+    // Extra cycles, beyond the bus protocol's wait states, that a hit waits for,
+    // and that each transfer between the cache and memory (a line fill, the write back of a
+    // dirty line, a write through, or an access to an uncachable address) waits for.
+    quint32 hitLatency = 0;
+    quint32 memoryLatency = 10;
+    // Seed of the generator that picks victims for Replacement::Random, so that runs can be repeated.
+    quint32 seed = 1;
+
+    // Returns an empty string if the configuration is valid, otherwise a description of the problem.
+    QString validate() const;
+    // Parse a comma separated list of key=value pairs, such as "size=512,ways=4,replace=fifo".
+    // Keys are size, line, ways, replace (lru, fifo, random), write (back, through), allocate (yes, no),
+    // hit, latency, and seed. Keys that are not given keep their default values.
+    // Returns an empty string on success, otherwise a description of the problem.
+    static QString parse(const QString& spec, CacheConfig& config);
+};
+
+/*
+ * Counts of the cache's behavior since the statistics were last cleared.
+ */
+struct CacheStats
+{
+    quint64 readHits = 0, readMisses = 0;
+    quint64 writeHits = 0, writeMisses = 0;
+    // Valid lines replaced to make room for another line, and the dirty lines among them.
+    quint64 evictions = 0, writeBacks = 0;
+    // Accesses to addresses whose chip is not cachable, such as memory-mapped IO.
+    quint64 uncached = 0;
+    quint64 waitCycles = 0;
+
+    quint64 hits() const noexcept;
+    quint64 misses() const noexcept;
+    // Fraction of cachable accesses that hit, or 0 if there were none.
+    double hitRate() const noexcept;
+    // Multi-line, human readable summary.
+    QString toString() const;
+};
+
+/*
+ * A set-associative cache placed in front of a MainMemory, so that a CPU using it
+ * may measure hits, misses, and evictions.
+ *
+ * The cache only keeps the tags and state of its lines, and every access still goes to the
+ * wrapped memory. Values are therefore always consistent with what the UI shows of main memory,
+ * and the cache only changes how long accesses take. Reads and writes (but not gets and sets)
+ * are simulated, and addresses on chips that are not cachable (AMemoryChip::isCachable())
+ * bypass the cache.
+ *
+ * Each access adds the latency of its hit, miss, or memory traffic to the pending wait cycles,
+ * which the CPU collects with takeWaitCycles().
+ */
+class CacheMemory : public AMemoryDevice
+{
+    Q_OBJECT
+public:
+    // Throws std::invalid_argument if config is not valid.
+    explicit CacheMemory(QSharedPointer<MainMemory> memory, CacheConfig config, QObject* parent = nullptr);
+    ~CacheMemory() override;
+
+    QSharedPointer<MainMemory> getMemory() const noexcept;
+    const CacheConfig& getConfig() const noexcept;
+    const CacheStats& getStats() const noexcept;
+    // Whether the line containing address is in the cache, without counting an access.
+    bool contains(quint16 address) const noexcept;
+    // Mark every line invalid. Dirty lines are discarded, since memory already holds their values.
+    void invalidate() noexcept;
+
+    // AMemoryDevice interface
+    quint32 maxAddress() const noexcept override;
+    // Clear the statistics of the cache and of the wrapped memory, and invalidate every line,
+    // so that each run starts with a cold cache.
+    void clearStatistics() override;
+    quint64 takeWaitCycles() noexcept override;
+
+public slots:
+    // Clear the wrapped memory and invalidate every line.
+    void clearMemory() override;
+    void onCycleStarted() override;
+    void onCycleFinished() override;
+
+    bool readByte(quint16 address, quint8 &output) const override;
+    bool writeByte(quint16 address, quint8 value) override;
+    bool getByte(quint16 address, quint8 &output) const override;
+    bool setByte(quint16 address, quint8 value) override;
+
+private:
+    enum LineFlags : quint8 {
+        Valid = 1, Dirty = 2
+    };
+    QSharedPointer<MainMemory> memory;
+    CacheConfig config;
+    // An address' line is address >> offsetBits, and the line's set is line & setMask.
+    int offsetBits;
+    quint16 setMask;
+    // readByte(...) is const, but simulating a read changes the state of the cache.
+    // Line i of set s is at index s * associativity + i.
+    mutable QVector<quint16> tags;
+    mutable QVector<quint8> flags;
+    // When each line was last used (LRU) or filled (FIFO).
+    mutable QVector<quint64> stamps;
+    mutable quint64 clock;
+    mutable quint32 randomState;
+    mutable CacheStats stats;
+    mutable quint64 pendingWaitCycles;
+
+    // Returns the index of the line, or -1 if it is not in the cache.
+    int find(quint16 address) const noexcept;
+    // Pick the line to replace in the set of address, and fill it with the line containing address.
+    int fill(quint16 address) const noexcept;
+    bool isCachable(quint16 address) const noexcept;
+    // Record a read (or write) of address in the cache.
+    void access(quint16 address, bool isWrite) const noexcept;
+    // Copy an error from the wrapped memory, after an access to it failed.
+    void copyError() const;
+};
+
+#endif // CACHEMEMORY_H
@@ -23,6 +23,8 @@
 #define ENU_H
 
 #include <QtCore>
+#include <array>
+#include <bitset>
 
 namespace Enu {
     Q_NAMESPACE
@@ -197,6 +199,15 @@ namespace Enu {
     };
     Q_ENUM_NS(EClockSignals);
 
+    // Compile time counterparts of Pep::numControlSignals() and Pep::numClockSignals().
+    // Must be updated if a signal is added after PValid or PValidCk.
+    static constexpr int controlSignalCount = PValid + 1;
+    static constexpr int clockSignalCount = PValidCk + 1;
+    // Fixed size storage for the signals of one cycle, indexed by EControlSignals and EClockSignals.
+    // Both fit in a few machine words, so loading a line of microcode is a couple of register copies.
+    using ControlSignals = std::array<quint8, controlSignalCount>;
+    using ClockSignals = std::bitset<clockSignalCount>;
+
     enum EMemoryRegisters
     {
         MEM_MARA,MEM_MARB,MEM_MDR,MEM_MDRO,MEM_MDRE
@@ -99,6 +99,12 @@ void IOWidget::setOutputChipAddress(quint16 address)
     charOutAddr = address;
 }
 
+void IOWidget::setScrollbackLimit(int lines)
+{
+    ui->batchOutput->setScrollbackLimit(lines);
+    ui->terminalIO->setScrollbackLimit(lines);
+}
+
 void IOWidget::bindToMemorySection(MainMemory *memory)
 {
     connect(ui->terminalIO, &TerminalPane::inputReady, this, &IOWidget::onInputReady);
@@ -52,6 +52,9 @@ public:
     // and the program will probably crash.
     void setInputChipAddress(quint16 address);
     void setOutputChipAddress(quint16 address);
+    // Limit the batch output and terminal panes to their last lines lines of output.
+    // A limit of 0 keeps every line.
+    void setScrollbackLimit(int lines);
     // Connect to needed signals/slots of passed memory device.
     void bindToMemorySection(MainMemory* memory);
 
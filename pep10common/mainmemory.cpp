@@ -26,6 +26,7 @@
 #include "amemorychip.h"
 #include "memorychips.h"
 #include "mainmemory.h"
+#include "memoryaccessstats.h"
 
 MainMemory::MainMemory(QObject* parent) noexcept: AMemoryDevice (parent),
     endChip(new NilChip(0xffff, 0, this)), addressToChipLookupTable(1 << 16)
@@ -65,10 +66,11 @@ void MainMemory::insertChip(QSharedPointer<AMemoryChip> chip, quint16 address)
     // so make sure to explicitly reset its address to prevent mapping errors.
     chip->setBaseAddress(address);
     if(chip->getChipType() == AMemoryChip::ChipTypes::IDEV) {
-        connect(static_cast<InputChip*>(chip.get()), &InputChip::inputRequested, this,  &MainMemory::onChipInputRequested);
+        // Chips are read from whatever thread runs the simulation, and must be serviced before the read returns.
+        connect(static_cast<InputChip*>(chip.get()), &InputChip::inputRequested, this,  &MainMemory::onChipInputRequested, Qt::DirectConnection);
     }
     else if(chip->getChipType() == AMemoryChip::ChipTypes::ODEV) {
-        connect(static_cast<OutputChip*>(chip.get()), &OutputChip::outputGenerated, this,  &MainMemory::onChipOutputWritten);
+        connect(static_cast<OutputChip*>(chip.get()), &OutputChip::outputGenerated, this,  &MainMemory::onChipOutputWritten, Qt::DirectConnection);
     }
     if(updateMemMap) calculateAddressToChip();
 }
@@ -207,6 +209,11 @@ void MainMemory::loadValues(quint16 address, QVector<quint8> values) noexcept
     blockSignals(block);
 }
 
+void MainMemory::setInputWaiter(std::function<void (quint16)> waiter)
+{
+    inputWaiter = std::move(waiter);
+}
+
 void MainMemory::clearMemory()
 {
     // Inform each chip that it needs to be zero'ed out.
@@ -216,6 +223,7 @@ void MainMemory::clearMemory()
     // Cleared memory has no written or set bytes.
     bytesSet.clear();
     bytesWritten.clear();
+    dirtyPages.set();
     // Remove pending error messages and pending IO.
     clearErrors();
     clearIO();
@@ -234,6 +242,7 @@ void MainMemory::onCycleFinished()
 bool MainMemory::readByte(quint16 address, quint8 &output) const
 {
     const AMemoryChip *chip = chipAt(address);
+    if(accessStats != nullptr) accessStats->recordRead(address);
     // Since IO can fail, wrap it in a try-catch.
     try {
         bool retVal = chip->readByte(address - chip->getBaseAddress(), output);
@@ -264,8 +273,15 @@ bool MainMemory::writeByte(quint16 address, quint8 value)
 {
     AMemoryChip *chip = chipAt(address);
     try {
+        if(writeJournal != nullptr) {
+            quint8 oldValue = 0;
+            chip->getByte(address - chip->getBaseAddress(), oldValue);
+            writeJournal->append({address, oldValue});
+        }
+        if(accessStats != nullptr) accessStats->recordWrite(address);
         bool retVal = chip->writeByte(address - chip->getBaseAddress(), value);
         bytesWritten.insert(address);
+        dirtyPages.set(address / pageSize);
         emit changed(address, value);
         return retVal;
     } catch (std::range_error& e) {
@@ -302,6 +318,7 @@ bool MainMemory::setByte(quint16 address, quint8 value)
     try {
         bool retVal = chip->setByte(address - chip->getBaseAddress(), value);
         bytesSet.insert(address);
+        dirtyPages.set(address / pageSize);
         emit changed(address, value);
         return retVal;
     } catch (std::range_error& e) {
@@ -405,8 +422,9 @@ void MainMemory::onChipInputRequested(quint16 address)
     else {
         waitingOnInput.insert(address);
         emit inputRequested(address);
+        if(inputWaiter) inputWaiter(address);
         // Make sure the signal is handled by the UI immediately
-        QApplication::processEvents();
+        else QApplication::processEvents();
     }
 }
 
@@ -22,6 +22,7 @@
 #ifndef MAINMEMORY_H
 #define MAINMEMORY_H
 
+#include <functional>
 #include <QMap>
 #include <QObject>
 #include <QSharedPointer>
@@ -64,6 +65,8 @@ class MainMemory : public AMemoryDevice
     mutable QSet<quint16> waitingOnInput;
     // Highest accessible address in memory.
     mutable quint32 maxAddr {0};
+    // Called when a read must wait for input that has not been received.
+    std::function<void(quint16)> inputWaiter;
 
 public:
     explicit MainMemory(QObject* parent = nullptr) noexcept;
@@ -102,6 +105,12 @@ public:
     // Copies the bytes from values into main memory starting at address.
     void loadValues(quint16 address, QVector<quint8> values) noexcept;
 
+    // When an input device is read without any buffered input, inputRequested(address) is emitted
+    // and then waiter(address) is called. The read completes once the waiter returns, so the
+    // waiter should not return until input was received, canceled, or aborted for the address.
+    // If there is no waiter, the application's event loop is processed once instead.
+    void setInputWaiter(std::function<void(quint16)> waiter);
+
 public slots:
     // Set the values in all memory chips to 0, clear all outstanding IO operations.
     void clearMemory() override;
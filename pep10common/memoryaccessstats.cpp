@@ -0,0 +1,107 @@
+#include "memoryaccessstats.h"
+
+#include <algorithm>
+#include <numeric>
+#include <QStringList>
+
+MemoryAccessStats::MemoryAccessStats(quint32 sampleInterval): counts(), sampleInterval(std::max(sampleInterval, 1u)),
+    instructionCount(0), samples(), current()
+{
+    for(auto& count : counts) {
+        count.fill(0, 1 << 16);
+    }
+}
+
+MemoryAccessStats::~MemoryAccessStats() = default;
+
+void MemoryAccessStats::clear()
+{
+    for(auto& count : counts) {
+        count.fill(0);
+    }
+    instructionCount = 0;
+    samples.clear();
+    current = WorkingSetSample{0, 0, {}, {}};
+}
+
+quint32 MemoryAccessStats::getSampleInterval() const noexcept
+{
+    return sampleInterval;
+}
+
+void MemoryAccessStats::setSampleInterval(quint32 instructions)
+{
+    sampleInterval = std::max(instructions, 1u);
+    samples.clear();
+    current = WorkingSetSample{instructionCount, 0, {}, {}};
+}
+
+void MemoryAccessStats::recordExecute(quint16 address, quint16 length) noexcept
+{
+    for(quint16 it = 0; it < length; it++) {
+        auto byte = static_cast<quint16>(address + it);
+        increment(counts[static_cast<int>(Access::Execute)][byte]);
+        current.pages[byte / AMemoryDevice::pageSize] = true;
+    }
+    instructionCount++;
+    // The instruction that fills an interval closes it, so that its accesses belong to the interval.
+    if(++current.instructions == sampleInterval) {
+        samples.append(current);
+        current = WorkingSetSample{instructionCount, 0, {}, {}};
+    }
+}
+
+quint32 MemoryAccessStats::getCount(Access access, quint16 address) const noexcept
+{
+    return counts[static_cast<int>(access)][address];
+}
+
+quint64 MemoryAccessStats::getPageCount(Access access, quint8 page) const noexcept
+{
+    const QVector<quint32>& count = counts[static_cast<int>(access)];
+    int first = page * AMemoryDevice::pageSize;
+    return std::accumulate(count.cbegin() + first, count.cbegin() + first + AMemoryDevice::pageSize, quint64{0});
+}
+
+quint32 MemoryAccessStats::getMaxCount(Access access) const noexcept
+{
+    const QVector<quint32>& count = counts[static_cast<int>(access)];
+    return *std::max_element(count.cbegin(), count.cend());
+}
+
+quint64 MemoryAccessStats::getInstructionCount() const noexcept
+{
+    return instructionCount;
+}
+
+QVector<MemoryAccessStats::WorkingSetSample> MemoryAccessStats::getWorkingSet() const
+{
+    QVector<WorkingSetSample> ret = samples;
+    if(current.instructions != 0) ret.append(current);
+    return ret;
+}
+
+QString MemoryAccessStats::getWorkingSetReport() const
+{
+    auto hexPage = [](int page) {
+        return QString("%1").arg(page, 2, 16, QLatin1Char('0')).toUpper();
+    };
+    QStringList lines;
+    for(const WorkingSetSample& sample : getWorkingSet()) {
+        QString lowest, highest;
+        if(sample.writtenPages.any()) {
+            int page = 0;
+            while(!sample.writtenPages.test(static_cast<std::size_t>(page))) page++;
+            lowest = hexPage(page);
+            page = AMemoryDevice::pageCount - 1;
+            while(!sample.writtenPages.test(static_cast<std::size_t>(page))) page--;
+            highest = hexPage(page);
+        }
+        lines.append(QString("%1,%2,%3,%4,%5,%6")
+                     .arg(sample.firstInstruction).arg(sample.instructions)
+                     .arg(sample.pages.count()).arg(sample.writtenPages.count())
+                     .arg(lowest, highest));
+    }
+    if(lines.isEmpty()) return QString();
+    return lines.join("\n") + "\n";
+}
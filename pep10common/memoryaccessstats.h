@@ -0,0 +1,97 @@
+#ifndef MEMORYACCESSSTATS_H
+#define MEMORYACCESSSTATS_H
+
+#include <bitset>
+#include <limits>
+#include <QString>
+#include <QVector>
+
+#include "amemorydevice.h"
+
+/*
+ * Counts how many times each of the 2^16 addresses was read, written, and executed.
+ *
+ * A memory device counts reads and writes as they happen, and the CPU counts the bytes of each
+ * instruction it executes. Since the instruction is fetched through the memory device,
+ * the bytes of an instruction are counted both as read and as executed.
+ *
+ * Every sampleInterval instructions, the pages (of AMemoryDevice::pageSize bytes) accessed since
+ * the last sample are recorded, which gives the size of the working set over time.
+ * A stack that grows without bound shows up as written pages that move ever lower,
+ * and a heap that is misused as pages written far from where the heap starts.
+ *
+ * Counters are 32 bits and saturate rather than wrap around.
+ */
+class MemoryAccessStats
+{
+public:
+    enum class Access : quint8 {
+        Read, Write, Execute
+    };
+    // The pages accessed in one interval of sampleInterval instructions.
+    struct WorkingSetSample
+    {
+        // Number of instructions executed before the interval started.
+        quint64 firstInstruction;
+        quint32 instructions;
+        std::bitset<AMemoryDevice::pageCount> pages, writtenPages;
+    };
+    static constexpr quint32 defaultSampleInterval = 1000;
+
+    explicit MemoryAccessStats(quint32 sampleInterval = defaultSampleInterval);
+    ~MemoryAccessStats();
+
+    void clear();
+    // Number of instructions in each working set sample. Clears the samples taken so far.
+    quint32 getSampleInterval() const noexcept;
+    void setSampleInterval(quint32 instructions);
+
+    inline void recordRead(quint16 address) noexcept;
+    inline void recordWrite(quint16 address) noexcept;
+    // Record that the length bytes of the instruction at address were executed.
+    void recordExecute(quint16 address, quint16 length) noexcept;
+
+    quint32 getCount(Access access, quint16 address) const noexcept;
+    // Sum of the counts of every address in a page.
+    quint64 getPageCount(Access access, quint8 page) const noexcept;
+    // Largest count of any address, which is useful for scaling a heatmap.
+    quint32 getMaxCount(Access access) const noexcept;
+    quint64 getInstructionCount() const noexcept;
+
+    // Every completed sample, followed by the current interval if any instruction was executed in it.
+    QVector<WorkingSetSample> getWorkingSet() const;
+    // One line per sample, as comma separated values: the first instruction of the sample, the
+    // number of instructions in it, the number of pages accessed and written, and the lowest and
+    // highest page written in hexadecimal (or empty if none were written).
+    QString getWorkingSetReport() const;
+
+private:
+    QVector<quint32> counts[3];
+    quint32 sampleInterval;
+    quint64 instructionCount;
+    QVector<WorkingSetSample> samples;
+    WorkingSetSample current;
+
+    static inline void increment(quint32& counter) noexcept;
+};
+
+void MemoryAccessStats::recordRead(quint16 address) noexcept
+{
+    increment(counts[static_cast<int>(Access::Read)][address]);
+    current.pages[address / AMemoryDevice::pageSize] = true;
+}
+
+void MemoryAccessStats::recordWrite(quint16 address) noexcept
+{
+    increment(counts[static_cast<int>(Access::Write)][address]);
+    current.pages[address / AMemoryDevice::pageSize] = true;
+    current.writtenPages[address / AMemoryDevice::pageSize] = true;
+}
+
+void MemoryAccessStats::increment(quint32 &counter) noexcept
+{
+    // Comparing is cheaper than widening every counter to 64 bits.
+    if(counter != std::numeric_limits<quint32>::max()) counter++;
+}
+
+#endif // MEMORYACCESSSTATS_H
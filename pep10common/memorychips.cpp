@@ -1,5 +1,3 @@
-#include <QApplication>
-
 #include "memorychips.h"
 
 ConstChip::ConstChip(quint32 size, quint16 baseAddress, QObject *parent):
@@ -165,9 +163,8 @@ bool InputChip::readByte(quint16 offsetFromBase, quint8 &output) const
     waiting[offsetFromBase] = true;
     requestCanceled[offsetFromBase] = false;
     requestAborted[offsetFromBase] = false;
+    // Memory services the request before the signal returns, either with buffered input or by waiting for it.
     emit inputRequested(baseAddress + offsetFromBase);
-    // Let the UI handle I/O before returning to this device
-    QApplication::processEvents();
     if(requestCanceled[offsetFromBase]) return false;
     else if(requestAborted[offsetFromBase]) {
         memory[offsetFromBase] = errorChar;
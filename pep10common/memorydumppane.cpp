@@ -19,8 +19,11 @@
     You should have received a copy of the GNU General Public License
     along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
+#include <algorithm>
+#include <cmath>
 #include <QAbstractTextDocumentLayout>
 #include <QFontDialog>
+#include <QHeaderView>
 #include <QStyle>
 #include <QTextCharFormat>
 
@@ -30,6 +33,7 @@
 #include "mainmemory.h"
 #include "memorydumppane.h"
 #include "pep.h"
+#include "simulationsnapshot.h"
 #include "ui_memorydumppane.h"
 #include <QtAlgorithms>
 #include <QtCore>
@@ -39,9 +43,10 @@
 static QString space = "   ";
 
 MemoryDumpPane::MemoryDumpPane(QWidget *parent) :
-    QWidget(parent), ui(new Ui::MemoryDumpPane), data(new QStandardItemModel(this)), lineSize(500), memDevice(nullptr),
+    QWidget(parent), ui(new Ui::MemoryDumpPane), data(new MemoryDumpModel(this)), lineSize(500), memDevice(nullptr),
     cpu(nullptr), delegate(nullptr), colors(&PepColors::lightMode), highlightedData(), modifiedBytes(), lastModifiedBytes(),
-    delayLastStepClear(false), inSimulation(false), highlightPC(true)
+    delayLastStepClear(false), inSimulation(false), highlightPC(true), accessStats(nullptr),
+    heatmapAccess(MemoryAccessStats::Access::Read), showHeatmap(false)
 {
     ui->setupUi(this);
     ui->label->setFont(QFont(Pep::labelFont, Pep::labelFontSize));
@@ -53,18 +58,25 @@ MemoryDumpPane::MemoryDumpPane(QWidget *parent) :
     connect(ui->spPushButton, &QAbstractButton::clicked, this, &MemoryDumpPane::scrollToSP);
     connect(ui->scrollToLineEdit, &QLineEdit::textEdited, this, &MemoryDumpPane::scrollToAddress);
     connect(ui->tableView->verticalScrollBar(), &QScrollBar::valueChanged, this, &MemoryDumpPane::scrollToLine);
+    connect(ui->heatmapComboBox, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged),
+            this, &MemoryDumpPane::onHeatmapChanged);
 }
 
 void MemoryDumpPane::init(QSharedPointer<MainMemory> memory, QSharedPointer<ACPUModel> cpu)
 {
     this->memDevice = memory;
     this->cpu = cpu;
+    data->setMemory(memory);
 
+    // Hook the table view into the model. Safe to use new inline, as it will be deleted when this class is destructed.
+    ui->tableView->setModel(data);
+    ui->tableView->setSelectionModel(new DisableEdgeSelectionModel(data, this));
+    // Every row is the same height, so don't let the view measure all 64k / bytesPerLine of them.
+    ui->tableView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
     setNumBytesPerLine(bytesPerLine);
 
     delegate = new MemoryDumpDelegate(memDevice, ui->tableView);
     ui->tableView->setItemDelegate(delegate);
-    refreshMemoryLines(0, 0);
 }
 
 void MemoryDumpPane::setNumBytesPerLine(quint16 bytesPerLine)
@@ -77,23 +89,11 @@ void MemoryDumpPane::setNumBytesPerLine(quint16 bytesPerLine)
     auto effective_line_size = 1 << (int)pow2;
     // Don't allow sizes larger than 16 for now
     if(effective_line_size >= 16) effective_line_size = 16;
-    else this->bytesPerLine = (quint16) effective_line_size;
-    data->clear();
-    // Insert 1 column for address, 8 for memory bytes, and 1 for character dump
-    data->insertColumns(0, 1+bytesPerLine+1);
-    // Insert enough rows to hold 64k of memory
-    data->insertRows(0, (1<<16)/bytesPerLine);
-    // Set the addresses of every row now, as they will not change during execution of the program.
-    for(int it = 0; it < (1<<16) /bytesPerLine; it++) {
-        data->setData(data->index(it, 0), QString("%1").arg(it*bytesPerLine, 4, 16, QChar('0')).toUpper() + space);
-    }
-
-    // Hook the table view into the model, and size everything correctly
-    ui->tableView->setModel(data);
-    // Safe to use new inline, as it will be deleted when this class is destructed,
-    ui->tableView->setSelectionModel(new DisableEdgeSelectionModel(data, this));
-    ui->tableView->resizeRowsToContents();
-    refreshMemory();
+    this->bytesPerLine = static_cast<quint16>(effective_line_size);
+    // The model holds no items, so resetting it only discards cached rows.
+    data->setBytesPerLine(this->bytesPerLine);
+    highlightedData.clear();
+    resizeToContents();
 }
 
 void MemoryDumpPane::setHighlightPC(bool highlightPC)
@@ -114,79 +114,56 @@ void MemoryDumpPane::showTitleLabel(bool showLabel)
 
 MemoryDumpPane::~MemoryDumpPane()
 {
+    // Memory may outlive this pane, so it must stop counting into stats that are about to be deleted.
+    if(!memDevice.isNull() && memDevice->getAccessStats() == accessStats.data()) memDevice->setAccessStats(nullptr);
     delete ui;
-    delete data;
     delete delegate;
 }
 
 void MemoryDumpPane::refreshMemory()
 {
     // Refreshing memory is equivilant to refreshing all memory addresses.
-    // Since refreshMemoryLines(quint16,quint16) is deffensive, just refresh the maximum
-    // number of lines that could ever be had.
-    refreshMemoryLines(0, 0xffff);
+    // The model also re-checks which addresses exist, as the memory map may have changed.
+    data->refreshAll();
 }
 
 void MemoryDumpPane::refreshMemoryLines(quint16 firstByte, quint16 lastByte)
 {
-    // There are 8 bytes per line, so divide the byte numbers by 8 to
-    // get the line number.
-    quint16 firstLine = firstByte / bytesPerLine;
-    quint16 lastLine = lastByte / bytesPerLine;
-    quint8 tempData;
-    QChar ch;
-    QString memoryDumpLine;
-    // Disable screen updates while re-writing all data fields to save execution time.
-    bool updates = ui->tableView->updatesEnabled();
-    ui->tableView->setUpdatesEnabled(false);
-    // Use <= comparison, so when firstLine == lastLine that the line is stil refreshed
-    for(int row = firstLine; row <= lastLine; row++) {
-        memoryDumpLine.clear();
-        for(int col = 0; col < bytesPerLine + 1; col++) {
-            // Only access memory if it is in range
-            if(quint32(row * bytesPerLine + col) <= memDevice->maxAddress()) {
-                // Use the data in the memory section to set the value in the model.
-                memDevice->getByte(static_cast<quint16>(row * bytesPerLine + col), tempData);
-                data->setData(data->index(row, col + 1), QString("%1").arg(tempData, 2, 16, QChar('0')).toUpper());
-                ch = QChar(tempData);
-                if (ch.isPrint()) {
-                    memoryDumpLine.append(ch);
-                }
-                else {
-                    memoryDumpLine.append(".");
-                }
-            }
-            // Otherwise place a sentinel character to denote the address being inacessible.
-            else {
-                data->setData(data->index(row, col + 1), "zz");
-                memoryDumpLine.append(".");
-            }
-
+    // The model only re-formats these lines once the view asks for them,
+    // and the view only asks for them if they are visible.
+    data->refreshLines(firstByte, lastByte);
+}
 
-        }
-        data->setData(data->index(row, 1+bytesPerLine), memoryDumpLine.append(space));
+void MemoryDumpPane::refreshPages(const QVector<quint8> &pages)
+{
+    // Refresh runs of adjacent pages together, so that the view is notified once per run.
+    for(int it = 0; it < pages.size();) {
+        int end = it;
+        while(end + 1 < pages.size() && pages[end + 1] == pages[end] + 1) end++;
+        refreshMemoryLines(static_cast<quint16>(pages[it] * AMemoryDevice::pageSize),
+                           static_cast<quint16>((pages[end] + 1) * AMemoryDevice::pageSize - 1));
+        it = end + 1;
     }
-    lineSize = 0;
-    for(int it = 0; it < data->columnCount(); it++) {
-        lineSize += static_cast<unsigned int>(ui->tableView->columnWidth(it));
+}
+
+void MemoryDumpPane::refreshPages(const SimulationSnapshot &snapshot)
+{
+    const QVector<quint8>& pages = snapshot.dirtyPages;
+    // Copy runs of adjacent pages together, so that the view is notified once per run.
+    for(int it = 0; it < pages.size();) {
+        int end = it;
+        while(end + 1 < pages.size() && pages[end + 1] == pages[end] + 1) end++;
+        data->writeBytes(static_cast<quint16>(pages[it] * AMemoryDevice::pageSize),
+                         snapshot.pageBytes.constData() + it * AMemoryDevice::pageSize,
+                         (end - it + 1) * AMemoryDevice::pageSize);
+        it = end + 1;
     }
-    lineSize += QFontMetrics(ui->tableView->font()).boundingRect(space).width();
-    ui->tableView->setUpdatesEnabled(updates);
-    ui->tableView->resizeColumnsToContents();
 }
 
 void MemoryDumpPane::clearHighlight()
 {
-    // Don't to remove BackgroundRole & ForegroundRole from data->itemData(...) map,
-    // followed by a data->setItemData(...) call.
-    // Even though items were removed from the map and both calls were successful, the tableView would not remove the old highlighting.
-    // Explicitly setting the field to QVariant (nothing) reutrns the field to default styling.
-    while (!highlightedData.isEmpty()) {
-        quint16 address = highlightedData.takeFirst();
-        QStandardItem *item = data->item(address/8, address%8 +1);
-        item->setData(QVariant(), Qt::BackgroundRole);
-        item->setData(QVariant(), Qt::ForegroundRole);
-    }
+    highlightedData.clear();
+    data->clearHighlights();
 }
 
 void MemoryDumpPane::highlight()
@@ -234,6 +211,8 @@ void MemoryDumpPane::updateMemory()
 {
     QList<quint16> list;
     QSet<quint16> linesToBeUpdated;
+    // A run may have paused after the last snapshot was drawn, so re-read the pages written since.
+    refreshPages(memDevice->takeDirtyPages());
     // Don't clear the memDevice's written / set bytes, since other UI components might
     // need access to them.
     // However, must clear the local cache of modified bytes, or there is the potential to over-highlight.
@@ -248,11 +227,16 @@ void MemoryDumpPane::updateMemory()
     list = linesToBeUpdated.toList();
     std::sort(list.begin(), list.end());
 
-    for(auto x: list) {
-        // Multiply by 8 to convert from line # to address of first byte on a line.
-        refreshMemoryLines(x * bytesPerLine, x * bytesPerLine);
+    // Refresh runs of adjacent lines together, so that the view is notified once per run.
+    for(int it = 0; it < list.size();) {
+        int end = it;
+        while(end + 1 < list.size() && list[end + 1] == list[end] + 1) end++;
+        // Multiply by bytesPerLine to convert from line # to address of first byte on a line.
+        refreshMemoryLines(static_cast<quint16>(list[it] * bytesPerLine),
+                           static_cast<quint16>(list[end] * bytesPerLine));
+        it = end + 1;
     }
-
+    refreshHeatmap();
 }
 
 void MemoryDumpPane::scrollToTop()
@@ -310,12 +294,7 @@ void MemoryDumpPane::onFontChanged(QFont font)
 {
     ui->tableView->setFont(font);
     ui->scrollToLineEdit->setFont(font);
-    ui->tableView->resizeColumnsToContents();
-    lineSize = 0;
-    for(int it = 0; it < data->columnCount(); it++) {
-        lineSize += static_cast<unsigned int>(ui->tableView->columnWidth(it));
-    }
-    lineSize += QFontMetrics(font).boundingRect(space).width();
+    resizeToContents();
     ui->tableView->adjustSize();
     setMaximumWidth(sizeHint().width());
 }
@@ -329,36 +308,63 @@ void MemoryDumpPane::onDarkModeChanged(bool darkMode)
         clearHighlight();
         highlight();
     }
+    // The heatmap's color also depends on the theme, and counts don't change while the simulation is paused.
+    if(!inSimulation) refreshHeatmap();
 }
 
-void MemoryDumpPane::onMemoryChanged(quint16 address, quint8)
+void MemoryDumpPane::onMemoryChanged(quint16 address, quint8 newValue)
 {
-    // Do not use address+1 or address-1, as an address at the end of a line
-    // would incorrectly trigger a refresh of an adjacent line.
-    // Refresh memoryLines(...) will work correctly if both start and end addresses are the same.
+    // The change may be reported after the simulation has resumed, so use the value it carries rather than reading memory.
     modifiedBytes.insert(address);
-    this->refreshMemoryLines(address, address);
+    data->writeBytes(address, &newValue, 1);
 }
 
 void MemoryDumpPane::onSimulationStarted()
 {
     inSimulation = true;
+    // The simulation updates the access counters from another thread, so they must not be attached or detached while it runs.
+    ui->heatmapComboBox->setEnabled(false);
 }
 
 void MemoryDumpPane::onSimulationFinished()
 {
     inSimulation = false;
+    ui->heatmapComboBox->setEnabled(true);
     refreshMemory();
+    refreshHeatmap();
+}
+
+void MemoryDumpPane::refreshHeatmap()
+{
+    if(!showHeatmap || accessStats.isNull()) return;
+    QColor color;
+    switch(heatmapAccess) {
+    case MemoryAccessStats::Access::Read:
+        color = colors->combCircuitBlue;
+        break;
+    case MemoryAccessStats::Access::Write:
+        color = colors->combCircuitRed;
+        break;
+    case MemoryAccessStats::Access::Execute:
+        color = colors->combCircuitGreen;
+        break;
+    }
+    // Shade on a log scale, since a loop's instructions are executed far more often than the rest of the program.
+    const int shades = MemoryDumpModel::heatmapShades;
+    double maxLog = std::log2(static_cast<double>(accessStats->getMaxCount(heatmapAccess)));
+    QVector<quint8> levels(1 << 16, 0);
+    for(int address = 0; address < (1 << 16); address++) {
+        quint32 count = accessStats->getCount(heatmapAccess, static_cast<quint16>(address));
+        if(count == 0) continue;
+        else if(maxLog <= 0) levels[address] = static_cast<quint8>(shades - 1);
+        else levels[address] = static_cast<quint8>(1 + std::lround((shades - 2) * std::log2(static_cast<double>(count)) / maxLog));
+    }
+    data->setHeatmap(levels, color);
 }
 
 void MemoryDumpPane::highlightByte(quint16 memAddr, QColor foreground, QColor background)
 {
-    // Rows contain 8 bytes of memory.
-    // The first column is an address, so the first byte in a row is in column one.
-    QModelIndex index = data->index(memAddr/bytesPerLine, memAddr%bytesPerLine +1);
-    // Set style data of item from parameters.
-    data->setData(index, foreground ,Qt::ForegroundRole);
-    data->setData(index, background, Qt::BackgroundRole);
+    data->highlightByte(memAddr, foreground, background);
 }
 
 void MemoryDumpPane::mouseReleaseEvent(QMouseEvent *)
@@ -375,6 +381,20 @@ void MemoryDumpPane::scrollToByte(quint16 address)
     connect(ui->tableView->verticalScrollBar(), &QScrollBar::valueChanged, this, &MemoryDumpPane::scrollToLine, Qt::UniqueConnection);
 }
 
+void MemoryDumpPane::resizeToContents()
+{
+    // Column widths only depend on the font and the number of bytes per line,
+    // so they need not be recomputed when memory changes.
+    ui->tableView->resizeColumnsToContents();
+    ui->tableView->resizeRowToContents(0);
+    ui->tableView->verticalHeader()->setDefaultSectionSize(ui->tableView->rowHeight(0));
+    lineSize = 0;
+    for(int it = 0; it < data->columnCount(); it++) {
+        lineSize += static_cast<unsigned int>(ui->tableView->columnWidth(it));
+    }
+    lineSize += QFontMetrics(ui->tableView->font()).boundingRect(space).width();
+}
+
 void MemoryDumpPane::scrollToPC()
 {
     quint16 value = cpu->getCPURegWordStart(Enu::CPURegisters::PC);
@@ -415,6 +435,26 @@ void MemoryDumpPane::scrollToAddress(QString string)
     }
 }
 
+void MemoryDumpPane::onHeatmapChanged(int index)
+{
+    if(memDevice.isNull()) return;
+    showHeatmap = index > 0;
+    if(!showHeatmap) {
+        if(memDevice->getAccessStats() == accessStats.data()) memDevice->setAccessStats(nullptr);
+        accessStats.clear();
+        data->setHeatmap({}, QColor());
+        return;
+    }
+    // Items are in the same order as the values of MemoryAccessStats::Access.
+    heatmapAccess = static_cast<MemoryAccessStats::Access>(index - 1);
+    // Counting starts now, so the heatmap is filled in by the next run or step.
+    if(accessStats.isNull()) {
+        accessStats = QSharedPointer<MemoryAccessStats>::create();
+        memDevice->setAccessStats(accessStats.data());
+    }
+    refreshHeatmap();
+}
+
 void MemoryDumpPane::scrollToLine(int /*scrollBarValue*/)
 {
     // The scrollbar value does not have an intuitive relation to
@@ -427,6 +467,197 @@ void MemoryDumpPane::scrollToLine(int /*scrollBarValue*/)
     ui->scrollToLineEdit->setText(str);
 }
 
+MemoryDumpModel::MemoryDumpModel(QObject *parent): QAbstractTableModel(parent),
+    memDevice(nullptr), bytes(1 << 16, 0), rowCache(256), highlights()
+{
+
+}
+
+MemoryDumpModel::~MemoryDumpModel()
+{
+
+}
+
+void MemoryDumpModel::setMemory(QSharedPointer<MainMemory> memory)
+{
+    beginResetModel();
+    memDevice = memory;
+    maxAddress = memDevice.isNull() ? 0 : memDevice->maxAddress();
+    readRows(0, rowCount() - 1);
+    rowCache.clear();
+    endResetModel();
+}
+
+quint16 MemoryDumpModel::getBytesPerLine() const noexcept
+{
+    return bytesPerLine;
+}
+
+void MemoryDumpModel::setBytesPerLine(quint16 bytesPerLine)
+{
+    Q_ASSERT(bytesPerLine != 0);
+    beginResetModel();
+    this->bytesPerLine = bytesPerLine;
+    rowCache.clear();
+    highlights.clear();
+    endResetModel();
+}
+
+void MemoryDumpModel::refreshLines(quint16 firstByte, quint16 lastByte)
+{
+    int firstRow = firstByte / bytesPerLine;
+    int lastRow = lastByte / bytesPerLine;
+    readRows(firstRow, lastRow);
+    // Use <= comparison, so when firstRow == lastRow that the line is stil refreshed
+    for(int row = firstRow; row <= lastRow; row++) {
+        rowCache.remove(row);
+    }
+    emitRowsChanged(firstRow, lastRow, {Qt::DisplayRole, Qt::EditRole});
+}
+
+void MemoryDumpModel::refreshAll()
+{
+    if(!memDevice.isNull()) maxAddress = memDevice->maxAddress();
+    readRows(0, rowCount() - 1);
+    rowCache.clear();
+    emitRowsChanged(0, rowCount() - 1, {Qt::DisplayRole, Qt::EditRole});
+}
+
+void MemoryDumpModel::writeBytes(quint16 firstByte, const quint8 *values, int count)
+{
+    Q_ASSERT(count > 0 && firstByte + count <= bytes.size());
+    std::copy_n(values, count, bytes.begin() + firstByte);
+    int firstRow = firstByte / bytesPerLine;
+    int lastRow = (firstByte + count - 1) / bytesPerLine;
+    for(int row = firstRow; row <= lastRow; row++) {
+        rowCache.remove(row);
+    }
+    emitRowsChanged(firstRow, lastRow, {Qt::DisplayRole, Qt::EditRole});
+}
+
+void MemoryDumpModel::highlightByte(quint16 address, QColor foreground, QColor background)
+{
+    highlights[address] = {foreground, background};
+    // The first column is an address, so the first byte in a row is in column one.
+    QModelIndex cell = index(address / bytesPerLine, address % bytesPerLine + 1);
+    emit dataChanged(cell, cell, {Qt::ForegroundRole, Qt::BackgroundRole});
+}
+
+void MemoryDumpModel::setHeatmap(QVector<quint8> shades, QColor color)
+{
+    Q_ASSERT(shades.isEmpty() || shades.size() == (1 << 16));
+    if(shades.isEmpty() && heatmap.isEmpty()) return;
+    heatmap = std::move(shades);
+    for(int it = 1; it < heatmapShades; it++) {
+        heatmapColors[it] = color;
+        heatmapColors[it].setAlpha(255 * it / (heatmapShades - 1));
+    }
+    emitRowsChanged(0, rowCount() - 1, {Qt::BackgroundRole});
+}
+
+void MemoryDumpModel::clearHighlights()
+{
+    // Collect the old highlights first, so that data(...) no longer returns them once the view is notified.
+    QHash<quint16, Highlight> old;
+    old.swap(highlights);
+    for(auto it = old.keyBegin(); it != old.keyEnd(); ++it) {
+        QModelIndex cell = index(*it / bytesPerLine, *it % bytesPerLine + 1);
+        emit dataChanged(cell, cell, {Qt::ForegroundRole, Qt::BackgroundRole});
+    }
+}
+
+int MemoryDumpModel::rowCount(const QModelIndex &parent) const
+{
+    // Enough rows to hold 64k of memory.
+    if(parent.isValid()) return 0;
+    return (1 << 16) / bytesPerLine;
+}
+
+int MemoryDumpModel::columnCount(const QModelIndex &parent) const
+{
+    // 1 column for address, 1 for each memory byte, and 1 for character dump
+    if(parent.isValid()) return 0;
+    return 1 + bytesPerLine + 1;
+}
+
+QVariant MemoryDumpModel::data(const QModelIndex &index, int role) const
+{
+    if(!index.isValid() || memDevice.isNull()) return QVariant();
+    switch(role) {
+    case Qt::DisplayRole:
+        [[fallthrough]];
+    case Qt::EditRole:
+        return formatRow(index.row())[index.column()];
+    case Qt::ForegroundRole:
+        [[fallthrough]];
+    case Qt::BackgroundRole:
+    {
+        // Only byte columns are highlighted.
+        if(index.column() == 0 || index.column() == columnCount() - 1) return QVariant();
+        auto address = static_cast<quint16>(index.row() * bytesPerLine + index.column() - 1);
+        auto it = highlights.constFind(address);
+        if(it != highlights.constEnd()) return role == Qt::ForegroundRole ? it->foreground : it->background;
+        // Highlights are drawn over the heatmap.
+        else if(role == Qt::BackgroundRole && !heatmap.isEmpty() && heatmap[address] != 0) {
+            return heatmapColors[heatmap[address]];
+        }
+        return QVariant();
+    }
+    default:
+        return QVariant();
+    }
+}
+
+Qt::ItemFlags MemoryDumpModel::flags(const QModelIndex &index) const
+{
+    if(!index.isValid()) return Qt::NoItemFlags;
+    // MemoryDumpDelegate decides which cells may actually be edited.
+    return Qt::ItemIsSelectable | Qt::ItemIsEnabled | Qt::ItemIsEditable;
+}
+
+const QStringList &MemoryDumpModel::formatRow(int row) const
+{
+    if(QStringList* cached = rowCache.object(row)) return *cached;
+    auto *columns = new QStringList();
+    columns->reserve(columnCount());
+    quint32 base = static_cast<quint32>(row) * bytesPerLine;
+    columns->append(QString("%1").arg(base, 4, 16, QChar('0')).toUpper() + space);
+    QString memoryDumpLine;
+    for(quint32 address = base; address < base + bytesPerLine; address++) {
+        // Only show memory if it is in range
+        if(address <= maxAddress) {
+            quint8 tempData = bytes[static_cast<int>(address)];
+            columns->append(QString("%1").arg(tempData, 2, 16, QChar('0')).toUpper());
+            QChar ch = QChar(tempData);
+            memoryDumpLine.append(ch.isPrint() ? ch : QChar('.'));
+        }
+        // Otherwise place a sentinel character to denote the address being inacessible.
+        else {
+            columns->append("zz");
+            memoryDumpLine.append(".");
+        }
+    }
+    columns->append(memoryDumpLine.append(space));
+    // The cache takes ownership of the row.
+    rowCache.insert(row, columns);
+    return *columns;
+}
+
+void MemoryDumpModel::readRows(int firstRow, int lastRow)
+{
+    if(memDevice.isNull()) return;
+    quint32 end = std::min(static_cast<quint32>(lastRow + 1) * bytesPerLine, maxAddress + 1);
+    // Only access memory if it is in range
+    for(quint32 address = static_cast<quint32>(firstRow) * bytesPerLine; address < end; address++) {
+        memDevice->getByte(static_cast<quint16>(address), bytes[static_cast<int>(address)]);
+    }
+}
+
+void MemoryDumpModel::emitRowsChanged(int firstRow, int lastRow, const QVector<int> &roles)
+{
+    emit dataChanged(index(firstRow, 0), index(lastRow, columnCount() - 1), roles);
+}
+
 MemoryDumpDelegate::MemoryDumpDelegate(QSharedPointer<MainMemory> memory, QObject *parent): QStyledItemDelegate(parent),
     memDevice(memory), canEdit(true)
 {
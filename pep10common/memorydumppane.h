@@ -23,18 +23,24 @@
 #ifndef MEMORYDUMPPANE_H
 #define MEMORYDUMPPANE_H
 
+#include <QAbstractTableModel>
+#include <QCache>
+#include <QHash>
 #include <QScrollBar>
 #include <QSet>
-#include <QStandardItemModel>
+#include <QStringList>
 #include <QStyledItemDelegate>
 #include <QWidget>
 #include "colors.h"
+#include "memoryaccessstats.h"
 namespace Ui {
     class MemoryDumpPane;
 }
 class MainMemory;
 class ACPUModel;
 class MemoryDumpDelegate;
+struct SimulationSnapshot;
+class MemoryDumpModel;
 class MemoryDumpPane : public QWidget {
     Q_OBJECT
     Q_DISABLE_COPY(MemoryDumpPane)
@@ -64,11 +70,20 @@ public:
 
     void refreshMemory();
     // Post: the entire memory pane is refreshed
+    // Refreshing reads memory, so only refresh while the simulation is not running.
 
     void refreshMemoryLines(quint16 firstByte, quint16 lastByte);
     // Post: The memory dump is refresed from the line containing startByte to the line
     // containing endByte. Called by load().
 
+    void refreshPages(const QVector<quint8>& pages);
+    // Post: The lines of each page (of AMemoryDevice::pageSize bytes) in pages are refreshed.
+    // Pages must be in increasing order, as in SimulationSnapshot::dirtyPages.
+
+    void refreshPages(const SimulationSnapshot& snapshot);
+    // Post: The lines of each dirty page in snapshot are redrawn from the snapshot's copy of the page.
+    // Memory is not read, so this may be called while the simulation is running.
+
     void clearHighlight();
     // Post: Everything is unhighlighted.
 
@@ -108,9 +123,12 @@ public slots:
     void onSimulationStarted();
     void onSimulationFinished();
 
+    // Post: The heatmap (if any) is recomputed from the access counts. Only call while the simulation is paused or stopped.
+    void refreshHeatmap();
+
 private:
     Ui::MemoryDumpPane *ui;
-    QStandardItemModel* data;
+    MemoryDumpModel* data;
     quint32 lineSize;
     quint16 bytesPerLine = {8};
     QSharedPointer<MainMemory> memDevice;
@@ -130,6 +148,11 @@ private:
     // This is used to delay a clear of the QList bytesWrittenLastStep when leaving a trap that modifies bytes
     // to allow highlighting of modified bytes in trap instructions.
 
+    // Accesses are only counted while a heatmap is shown, so that memory is not slowed down otherwise.
+    QSharedPointer<MemoryAccessStats> accessStats;
+    MemoryAccessStats::Access heatmapAccess;
+    bool showHeatmap;
+
         // Used to highlight/unhighlight individual bytes.
     void highlightByte(quint16 memAddr, QColor foreground, QColor background);
 
@@ -137,11 +160,84 @@ private:
 
     void scrollToByte(quint16 address);
 
+    // Resize the columns to fit the current font, and recompute the width of a line.
+    void resizeToContents();
+
 private slots:
     void scrollToPC();
     void scrollToSP();
     void scrollToAddress(QString string);
     void scrollToLine(int scrollBarValue);
+    // Start or stop counting accesses when a heatmap is chosen.
+    void onHeatmapChanged(int index);
+};
+
+/*
+ * Table model that presents the contents of a MainMemory as a memory dump.
+ * Each row holds an address column, one column per byte, and a column with the character dump of the row.
+ *
+ * No items are stored. Cells are formatted when the view asks for them, and only the rows most
+ * recently formatted (which are the ones the view is displaying) are cached.
+ * Rows are formatted from the model's own copy of memory, so the view may be drawn and scrolled while
+ * a simulation thread owns memory. When memory changes, call refreshLines(...) to re-read the affected
+ * rows and to notify the view that only those rows changed. While the simulation is running, use
+ * writeBytes(...) with the contents of a snapshot instead.
+ */
+class MemoryDumpModel: public QAbstractTableModel {
+    Q_OBJECT
+public:
+    explicit MemoryDumpModel(QObject* parent = nullptr);
+    ~MemoryDumpModel() override;
+
+    void setMemory(QSharedPointer<MainMemory> memory);
+    quint16 getBytesPerLine() const noexcept;
+    // Changing the number of bytes per line resets the model.
+    void setBytesPerLine(quint16 bytesPerLine);
+
+    // Re-read and re-format the lines containing the bytes from firstByte to lastByte inclusive.
+    void refreshLines(quint16 firstByte, quint16 lastByte);
+    // Re-read and re-format every line, and re-check which addresses are backed by memory.
+    void refreshAll();
+    // Replace count bytes starting at firstByte with values, and re-format their lines without reading memory.
+    void writeBytes(quint16 firstByte, const quint8* values, int count);
+
+    // Colors are applied to a byte until clearHighlights() is called.
+    void highlightByte(quint16 address, QColor foreground, QColor background);
+    void clearHighlights();
+
+    // Number of shades in a heatmap, where shade 0 is not shaded.
+    static constexpr int heatmapShades = 8;
+    // Shade the background of every byte that is not highlighted by its entry in shades, using color
+    // for the brightest shade. An empty vector removes the heatmap.
+    void setHeatmap(QVector<quint8> shades, QColor color);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+    Qt::ItemFlags flags(const QModelIndex& index) const override;
+
+private:
+    // Copy the bytes of rows firstRow through lastRow inclusive from memory.
+    void readRows(int firstRow, int lastRow);
+    // Text of every column in a row.
+    const QStringList& formatRow(int row) const;
+    void emitRowsChanged(int firstRow, int lastRow, const QVector<int>& roles = QVector<int>());
+
+    QSharedPointer<MainMemory> memDevice;
+    quint16 bytesPerLine = {8};
+    // MainMemory::maxAddress() visits every chip, so only call it when the memory map may have changed.
+    quint32 maxAddress = {0};
+    // Copy of every byte of memory, which rows are formatted from.
+    QVector<quint8> bytes;
+    // A few screens worth of rows; rows scrolled out of view are evicted first.
+    mutable QCache<int, QStringList> rowCache;
+    struct Highlight {
+        QColor foreground, background;
+    };
+    QHash<quint16, Highlight> highlights;
+    // One shade per address, or empty if there is no heatmap.
+    QVector<quint8> heatmap;
+    QColor heatmapColors[heatmapShades];
 };
 
 /*
@@ -20,10 +20,10 @@
     along with this program.  If not, see <http://www.gnu.org/licenses/>.
 */
 #include <QFontDialog>
-#include <QScrollBar>
 
 #include "outputpane.h"
 #include "pep.h"
+#include "textoutputbuffer.h"
 #include "ui_outputpane.h"
 
 OutputPane::OutputPane(QWidget *parent) :
@@ -31,6 +31,7 @@ OutputPane::OutputPane(QWidget *parent) :
     ui(new Ui::OutputPane)
 {
     ui->setupUi(this);
+    output = new TextOutputBuffer(ui->plainTextEdit, this);
 
     ui->label->setFont(QFont(Pep::labelFont, Pep::labelFontSize));
     ui->plainTextEdit->setFont(QFont(Pep::codeFont, Pep::ioFontSize));
@@ -43,13 +44,17 @@ OutputPane::~OutputPane()
 
 void OutputPane::appendOutput(QString str)
 {
-    ui->plainTextEdit->setPlainText(ui->plainTextEdit->toPlainText().append(str));
-    ui->plainTextEdit->verticalScrollBar()->setValue(ui->plainTextEdit->verticalScrollBar()->maximum());
+    output->append(str);
+}
+
+void OutputPane::setScrollbackLimit(int lines)
+{
+    output->setScrollbackLimit(lines);
 }
 
 void OutputPane::clearOutput()
 {
-    ui->plainTextEdit->clear();
+    output->clear();
 }
 
 void OutputPane::highlightOnFocus()
@@ -74,7 +79,7 @@ void OutputPane::copy()
 
 void OutputPane::clearText()
 {
-    ui->plainTextEdit->clear();
+    output->clear();
 }
 
 void OutputPane::onFontChanged(QFont font)
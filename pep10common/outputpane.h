@@ -25,6 +25,8 @@
 
 #include <QWidget>
 
+class TextOutputBuffer;
+
 namespace Ui {
     class OutputPane;
 }
@@ -37,7 +39,10 @@ public:
     ~OutputPane() override;
 
     void appendOutput(QString str);
-    // Post: str is appended to the text edit
+    // Post: str is appended to the text edit by the next frame
+
+    void setScrollbackLimit(int lines);
+    // Post: at most the last lines lines are kept, or every line if lines is 0
 
     void clearOutput();
     // Post: the output is cleared
@@ -57,6 +62,7 @@ public slots:
 
 private:
     Ui::OutputPane *ui;
+    TextOutputBuffer *output;
 
     void mouseReleaseEvent(QMouseEvent *) override;
 };
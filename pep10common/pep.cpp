@@ -511,6 +511,15 @@ void initDecoderTableHelperTrap(EMnemonic val,int startIdx,int distance){
     }
 }
 
+quint8 Pep::encodeInstruction(EMnemonic mnemon, EAddrMode addrMode)
+{
+    for(int it = 0; it <= 255; it++) {
+        if(decodeMnemonic[it] == mnemon && decodeAddrMode[it] == addrMode) return static_cast<quint8>(it);
+    }
+    Q_ASSERT_X(false, "Pep::encodeInstruction", "No instruction specifier decodes to the pair.");
+    return 0;
+}
+
 void Pep::initDecoderTables()
 {
     decodeMnemonic[0] = EMnemonic::RET; decodeAddrMode[0] = EAddrMode::NONE;
@@ -589,6 +598,7 @@ QMap<Enu::EMnemonic, QString> Pep::defaultEnumToMicrocodeInstrSymbol;
 QMap<Enu::EAddrMode, QString> Pep::defaultEnumToMicrocodeAddrSymbol;
 QVector<QString> Pep::instSpecToMicrocodeInstrSymbol;
 QVector<QString> Pep::instSpecToMicrocodeAddrSymbol;
+quint32 Pep::microDecoderTablesRevision = 0;
 QString Pep::defaultStartSymbol;
 void Pep::initMicroDecoderTables()
 {
@@ -636,4 +646,5 @@ void Pep::initMicroDecoderTables()
         instSpecToMicrocodeInstrSymbol[it] = defaultEnumToMicrocodeInstrSymbol[Pep::decodeMnemonic[it]].toLower();
         instSpecToMicrocodeAddrSymbol[it] = defaultEnumToMicrocodeAddrSymbol[Pep::decodeAddrMode[it]];
     }
+    microDecoderTablesRevision++;
 }
@@ -119,6 +119,9 @@ public:
     // Decoder tables
     static QVector<Enu::EMnemonic> decodeMnemonic;
     static QVector<Enu::EAddrMode> decodeAddrMode;
+    // Inverse of the decoder tables: the first instruction specifier that decodes to mnemon and addrMode.
+    // Unary instructions use EAddrMode::NONE. Some instruction specifier must decode to the pair.
+    static quint8 encodeInstruction(Enu::EMnemonic mnemon, Enu::EAddrMode addrMode);
     // Does a particular instruction perform a store instead of a load?
     static bool isStoreMnemonic(Enu::EMnemonic);
     static void initDecoderTables();
@@ -131,6 +134,8 @@ public:
 
     static QVector<QString> instSpecToMicrocodeInstrSymbol;
     static QVector<QString> instSpecToMicrocodeAddrSymbol;
+    // Incremented whenever the symbols above are changed, so that tables resolved from them may detect they are stale.
+    static quint32 microDecoderTablesRevision;
     // The default symbol to denote the start of the von-Neumann cycle
     static QString defaultStartSymbol;
     static void initMicroDecoderTables();
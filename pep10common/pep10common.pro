@@ -26,21 +26,26 @@ HEADERS += \
     byteconverterdec.h \
     byteconverterhex.h \
     byteconverterinstr.h \
+    cachememory.h \
     colors.h \
     enu.h \
     inputpane.h \
     interrupthandler.h \
     iowidget.h \
     mainmemory.h \
+    memoryaccessstats.h \
     memorychips.h \
     memorydumppane.h \
     optional_helper.h \
     outputpane.h \
     pep.h \
+    simulationsnapshot.h \
+    simulationthread.h \
     symbolentry.h \
     symboltable.h \
     symbolvalue.h \
     terminalpane.h \
+    textoutputbuffer.h \
     updatechecker.h \
     registerfile.h \
     darkhelper.h \
@@ -56,19 +61,24 @@ SOURCES += \
     byteconverterdec.cpp \
     byteconverterhex.cpp \
     byteconverterinstr.cpp \
+    cachememory.cpp \
     colors.cpp \
     inputpane.cpp \
     interrupthandler.cpp \
     iowidget.cpp \
     mainmemory.cpp \
+    memoryaccessstats.cpp \
     memorychips.cpp \
     memorydumppane.cpp \
     outputpane.cpp \
     pep.cpp \
+    simulationsnapshot.cpp \
+    simulationthread.cpp \
     symbolentry.cpp \
     symboltable.cpp \
     symbolvalue.cpp \
     terminalpane.cpp \
+    textoutputbuffer.cpp \
     updatechecker.cpp \
     enu.cpp \
     registerfile.cpp
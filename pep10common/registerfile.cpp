@@ -199,6 +199,15 @@ void RegisterFile::flattenFile()
     statusBitsStart = statusBitsCurrent;
 }
 
+void RegisterFile::copyArchitecturalState(const RegisterFile &other)
+{
+    // OS is the last register the ISA can observe, and it occupies bytes 11 & 12.
+    static const std::size_t architecturalBytes = static_cast<std::size_t>(Enu::CPURegisters::OS) + 2;
+    memcpy(registersCurrent.data(), other.registersCurrent.data(), architecturalBytes);
+    statusBitsCurrent = other.statusBitsCurrent;
+    flattenFile();
+}
+
 bool RegisterFile::crackStatusBit(quint8 statusBits, Enu::EStatusBit bit)
 {
     int mask = 0;
@@ -105,6 +105,12 @@ public:
 
     // Copy all current values to the starting values.
     void flattenFile();
+
+    // Replace the registers visible to ISA programs (A, X, SP, PC, TR, IS, OS) and the status bits
+    // with the current values of other, and then flatten the file. Temporaries and the constant
+    // registers used by microcode are left untouched, so a microcoded CPU may adopt the state of
+    // an ISA level CPU between instructions, and vice versa.
+    void copyArchitecturalState(const RegisterFile& other);
 };
 
 #endif // REGISTERFILE_H
@@ -0,0 +1,119 @@
+#include "simulationsnapshot.h"
+
+#include <algorithm>
+#include <iterator>
+#include <QMutexLocker>
+#include "amemorydevice.h"
+
+quint8 SimulationSnapshot::registerByte(Enu::CPURegisters reg) const
+{
+    auto index = static_cast<std::size_t>(reg);
+    return index < registers.size() ? registers[index] : 0;
+}
+
+quint16 SimulationSnapshot::registerWord(Enu::CPURegisters reg) const
+{
+    auto index = static_cast<std::size_t>(reg);
+    if(index + 1 >= registers.size()) return 0;
+    return static_cast<quint16>(registers[index] << 8 | registers[index + 1]);
+}
+
+bool SimulationSnapshot::statusBit(Enu::EStatusBit bit) const
+{
+    switch(bit) {
+    case Enu::STATUS_N: return statusBits & Enu::NMask;
+    case Enu::STATUS_Z: return statusBits & Enu::ZMask;
+    case Enu::STATUS_V: return statusBits & Enu::VMask;
+    case Enu::STATUS_C: return statusBits & Enu::CMask;
+    case Enu::STATUS_S: return statusBits & Enu::SMask;
+    }
+    return false;
+}
+
+quint8 SimulationSnapshot::memoryRegister(Enu::EMemoryRegisters reg) const
+{
+    auto index = static_cast<std::size_t>(reg);
+    return index < memoryRegisters.size() ? memoryRegisters[index] : 0;
+}
+
+SnapshotPublisher::SnapshotPublisher(int framesPerSecond, QObject *parent): QObject(parent),
+    mutex(), framesPerSecond(0), frameIntervalMs(0), frameTimer(), latest(nullptr)
+{
+    setFramesPerSecond(framesPerSecond);
+}
+
+SnapshotPublisher::~SnapshotPublisher() = default;
+
+int SnapshotPublisher::getFramesPerSecond() const noexcept
+{
+    QMutexLocker lock(&mutex);
+    return framesPerSecond;
+}
+
+void SnapshotPublisher::setFramesPerSecond(int framesPerSecond)
+{
+    QMutexLocker lock(&mutex);
+    this->framesPerSecond = std::max(framesPerSecond, 1);
+    frameIntervalMs = 1000 / this->framesPerSecond;
+}
+
+bool SnapshotPublisher::isFrameDue() const noexcept
+{
+    QMutexLocker lock(&mutex);
+    return !frameTimer.isValid() || frameTimer.hasExpired(frameIntervalMs);
+}
+
+void SnapshotPublisher::publish(SimulationSnapshot snapshot)
+{
+    bool wasTaken;
+    {
+        QMutexLocker lock(&mutex);
+        frameTimer.start();
+        wasTaken = latest.isNull();
+        // Views skip the replaced snapshot, so they must still refresh the pages it dirtied.
+        if(!wasTaken && !latest->dirtyPages.isEmpty()) {
+            const QVector<quint8>& older = latest->dirtyPages, &newer = snapshot.dirtyPages;
+            QVector<quint8> pages, bytes;
+            pages.reserve(older.size() + newer.size());
+            bytes.reserve(pages.capacity() * AMemoryDevice::pageSize);
+            int olderIt = 0, newerIt = 0;
+            while(olderIt < older.size() || newerIt < newer.size()) {
+                // A page dirtied by both snapshots holds the newer snapshot's bytes.
+                const SimulationSnapshot* from;
+                int index;
+                if(newerIt < newer.size() && (olderIt == older.size() || newer[newerIt] <= older[olderIt])) {
+                    if(olderIt < older.size() && older[olderIt] == newer[newerIt]) olderIt++;
+                    from = &snapshot;
+                    index = newerIt++;
+                }
+                else {
+                    from = latest.data();
+                    index = olderIt++;
+                }
+                pages.append(from->dirtyPages[index]);
+                std::copy_n(from->pageBytes.cbegin() + index * AMemoryDevice::pageSize, AMemoryDevice::pageSize,
+                            std::back_inserter(bytes));
+            }
+            snapshot.dirtyPages = std::move(pages);
+            snapshot.pageBytes = std::move(bytes);
+        }
+        latest = QSharedPointer<SimulationSnapshot>::create(std::move(snapshot));
+    }
+    // Only signal once until the views catch up, so the event queue can't fill with stale frames.
+    if(wasTaken) emit frameReady();
+}
+
+QSharedPointer<const SimulationSnapshot> SnapshotPublisher::takeLatest()
+{
+    QMutexLocker lock(&mutex);
+    QSharedPointer<const SimulationSnapshot> out = latest;
+    latest.reset();
+    return out;
+}
+
+void SnapshotPublisher::clear()
+{
+    QMutexLocker lock(&mutex);
+    latest.reset();
+    frameTimer.invalidate();
+}
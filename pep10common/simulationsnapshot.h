@@ -0,0 +1,83 @@
+#ifndef SIMULATIONSNAPSHOT_H
+#define SIMULATIONSNAPSHOT_H
+
+#include <array>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QObject>
+#include <QSharedPointer>
+#include <QVector>
+#include "enu.h"
+
+/*
+ * Copy of the state of a running simulation, which views may display without touching the CPU.
+ *
+ * Rather than every view pulling state from the CPU after every instruction, the CPU publishes a
+ * snapshot at most once per frame, and views refresh only from the latest snapshot.
+ */
+struct SimulationSnapshot
+{
+    quint64 instructionCount = 0;
+    quint64 cycleCount = 0;
+    // Current value of registers A through T5, indexed by Enu::CPURegisters.
+    // Only microcoded CPUs fill in the temporary registers T1 through T5.
+    std::array<quint8, 22> registers {};
+    // NZVCS bits, as in Enu::EMask.
+    quint8 statusBits = 0;
+    quint16 operandValue = 0;
+    int callDepth = 0;
+    // Microprogram counter, and memory registers indexed by Enu::EMemoryRegisters. Only microcoded CPUs fill these in.
+    quint16 microPC = 0;
+    std::array<quint8, 5> memoryRegisters {};
+    // Pages of memory (see AMemoryDevice::pageSize) written or set since the previous snapshot, in increasing order.
+    QVector<quint8> dirtyPages;
+    // Contents of each of the dirty pages, AMemoryDevice::pageSize bytes per page, in the same order as dirtyPages.
+    QVector<quint8> pageBytes;
+
+    quint8 registerByte(Enu::CPURegisters reg) const;
+    quint16 registerWord(Enu::CPURegisters reg) const;
+    bool statusBit(Enu::EStatusBit bit) const;
+    quint8 memoryRegister(Enu::EMemoryRegisters reg) const;
+};
+
+/*
+ * Hands snapshots from a simulation to the views displaying it, at a bounded frame rate.
+ *
+ * The simulation asks isFrameDue() every so often, and publishes a snapshot when it is. Publishing
+ * replaces any snapshot the views have not yet taken, so views never fall behind a fast simulation;
+ * the dirty pages of a replaced snapshot (and their contents) carry over, so no memory change goes unrefreshed.
+ * frameReady() is emitted once per batch of untaken snapshots. It may be emitted from any thread.
+ * All methods may be called from any thread, so the views may clear() the publisher while the
+ * simulation is publishing to it.
+ */
+class SnapshotPublisher : public QObject
+{
+    Q_OBJECT
+public:
+    explicit SnapshotPublisher(int framesPerSecond = 30, QObject* parent = nullptr);
+    ~SnapshotPublisher() override;
+
+    int getFramesPerSecond() const noexcept;
+    void setFramesPerSecond(int framesPerSecond);
+
+    // Returns true if a frame's worth of time has passed since the last snapshot was published.
+    bool isFrameDue() const noexcept;
+    void publish(SimulationSnapshot snapshot);
+    // Returns the latest snapshot, or nullptr if none was published since the last call.
+    QSharedPointer<const SimulationSnapshot> takeLatest();
+    // Discard any untaken snapshot, and make a frame due immediately.
+    void clear();
+
+signals:
+    void frameReady();
+
+private:
+    // Guards every member below it.
+    mutable QMutex mutex;
+    int framesPerSecond;
+    qint64 frameIntervalMs;
+    QElapsedTimer frameTimer;
+    QSharedPointer<SimulationSnapshot> latest;
+};
+
+#endif // SIMULATIONSNAPSHOT_H
@@ -0,0 +1,216 @@
+#include "simulationthread.h"
+
+#include <QCoreApplication>
+#include <QMetaObject>
+
+#include "acpumodel.h"
+#include "mainmemory.h"
+#include "memorychips.h"
+
+SimulationCommandQueue::SimulationCommandQueue(quint32 capacity): buffer(), mask(0),
+    head(0), tail(0), sleeping(false), doorbell(0)
+{
+    quint32 size = 1;
+    while(size < capacity) size <<= 1;
+    buffer.resize(size);
+    mask = size - 1;
+}
+
+SimulationCommandQueue::~SimulationCommandQueue() = default;
+
+bool SimulationCommandQueue::push(SimulationCommand command)
+{
+    quint32 at = tail.load(std::memory_order_relaxed);
+    if(at - head.load(std::memory_order_acquire) > mask) return false;
+    buffer[at & mask] = std::move(command);
+    tail.store(at + 1);
+    // Only pay for the semaphore if the consumer might be asleep.
+    if(sleeping.load()) doorbell.release();
+    return true;
+}
+
+bool SimulationCommandQueue::tryPop(SimulationCommand &command)
+{
+    quint32 at = head.load(std::memory_order_relaxed);
+    if(at == tail.load()) return false;
+    command = std::move(buffer[at & mask]);
+    head.store(at + 1, std::memory_order_release);
+    return true;
+}
+
+SimulationCommand SimulationCommandQueue::waitPop()
+{
+    SimulationCommand command;
+    while(!tryPop(command)) {
+        // Announce the intent to sleep before checking the queue a final time, so that a
+        // concurrent push either is seen here or sees sleeping and rings the doorbell.
+        sleeping.store(true);
+        if(tryPop(command)) {
+            sleeping.store(false);
+            break;
+        }
+        doorbell.acquire();
+        sleeping.store(false);
+    }
+    return command;
+}
+
+SimulationThread::SimulationThread(QSharedPointer<ACPUModel> cpu, QSharedPointer<MainMemory> memory, QObject *parent):
+    QThread(parent), cpu(std::move(cpu)), memory(std::move(memory)), commands(), deferred(), pending(), parked(false)
+{
+    this->cpu->setEventPump([this]() { pollCommands(); });
+    this->memory->setInputWaiter([this](quint16 address) { waitForInput(address); });
+    connect(this, &SimulationThread::commandFinished, this, &SimulationThread::onCommandFinished, Qt::QueuedConnection);
+}
+
+SimulationThread::~SimulationThread()
+{
+    shutdown();
+    cpu->setEventPump(nullptr);
+    memory->setInputWaiter(nullptr);
+}
+
+void SimulationThread::runSimulation(std::function<void()> done)
+{
+    pending.enqueue(std::move(done));
+    post({SimulationCommand::Type::Run, {}, 0, 0});
+}
+
+void SimulationThread::step(std::function<void()> job, std::function<void()> done)
+{
+    pending.enqueue(std::move(done));
+    post({SimulationCommand::Type::Step, std::move(job), 0, 0});
+}
+
+void SimulationThread::interrupt()
+{
+    post({SimulationCommand::Type::Break, {}, 0, 0});
+}
+
+void SimulationThread::cancel()
+{
+    post({SimulationCommand::Type::Cancel, {}, 0, 0});
+}
+
+void SimulationThread::postInput(quint16 address, quint8 value)
+{
+    post({SimulationCommand::Type::InputAvailable, {}, address, value});
+}
+
+bool SimulationThread::isBusy() const noexcept
+{
+    return !pending.isEmpty() && !parked.load();
+}
+
+void SimulationThread::shutdown()
+{
+    if(!isRunning()) return;
+    pending.clear();
+    cancel();
+    post({SimulationCommand::Type::Quit, {}, 0, 0});
+    // The simulation may be parked in invokeBlocking(...) waiting on this thread,
+    // so keep handling those calls until the simulation exits.
+    while(!wait(10)) {
+        QCoreApplication::sendPostedEvents(nullptr, QEvent::MetaCall);
+    }
+}
+
+void SimulationThread::invokeBlocking(QObject *context, std::function<void()> function)
+{
+    if(QThread::currentThread() == context->thread()) {
+        function();
+        return;
+    }
+    parked.store(true);
+    QMetaObject::invokeMethod(context, std::move(function), Qt::BlockingQueuedConnection);
+    parked.store(false);
+}
+
+void SimulationThread::run()
+{
+    while(true) {
+        SimulationCommand command;
+        if(!deferred.empty()) {
+            command = std::move(deferred.front());
+            deferred.pop_front();
+        }
+        else command = commands.waitPop();
+        if(!execute(std::move(command))) return;
+    }
+}
+
+void SimulationThread::onCommandFinished()
+{
+    // Callbacks may have been discarded by shutdown().
+    if(pending.isEmpty()) return;
+    std::function<void()> done = pending.dequeue();
+    if(done) done();
+}
+
+void SimulationThread::post(SimulationCommand command)
+{
+    // The queue only fills if the simulation falls thousands of commands behind,
+    // in which case wait for it to catch up rather than dropping input.
+    while(!commands.push(command)) {
+        QThread::yieldCurrentThread();
+    }
+}
+
+bool SimulationThread::execute(SimulationCommand command)
+{
+    switch(command.type) {
+    case SimulationCommand::Type::Run:
+        cpu->onRun();
+        break;
+    case SimulationCommand::Type::Step:
+        if(command.job) command.job();
+        break;
+    case SimulationCommand::Type::Quit:
+        return false;
+    default:
+        handleControl(command);
+        return true;
+    }
+    emit commandFinished();
+    return true;
+}
+
+bool SimulationThread::handleControl(const SimulationCommand &command)
+{
+    switch(command.type) {
+    case SimulationCommand::Type::Break:
+        cpu->enableDebugging();
+        cpu->forceBreakpoint(Enu::BreakpointTypes::ASSEMBLER);
+        return true;
+    case SimulationCommand::Type::Cancel:
+        // Canceling input makes any waiting read fail, which unwinds the command in progress.
+        memory->clearIO();
+        cpu->onCancelExecution();
+        return true;
+    case SimulationCommand::Type::InputAvailable:
+        // Buffered by memory if no read is waiting on it.
+        memory->onInputReceived(command.address, command.value);
+        return true;
+    default:
+        return false;
+    }
+}
+
+void SimulationThread::pollCommands()
+{
+    SimulationCommand command;
+    while(commands.tryPop(command)) {
+        if(!handleControl(command)) deferred.push_back(std::move(command));
+    }
+}
+
+void SimulationThread::waitForInput(quint16 address)
+{
+    auto chip = static_cast<InputChip*>(memory->chipAt(address));
+    quint16 offsetFromBase = address - chip->getBaseAddress();
+    // Input may have already been delivered (or aborted) while the UI handled the request.
+    while(chip->waitingForInput(offsetFromBase)) {
+        SimulationCommand command = commands.waitPop();
+        if(!handleControl(command)) deferred.push_back(std::move(command));
+    }
+}
@@ -0,0 +1,145 @@
+#ifndef SIMULATIONTHREAD_H
+#define SIMULATIONTHREAD_H
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <vector>
+#include <QQueue>
+#include <QSemaphore>
+#include <QSharedPointer>
+#include <QThread>
+
+class ACPUModel;
+class MainMemory;
+
+/*
+ * A request sent from the UI to a SimulationThread.
+ */
+struct SimulationCommand
+{
+    enum class Type
+    {
+        // Call ACPUModel::onRun().
+        Run,
+        // Call job, e.g. to step into, over, or out of an instruction.
+        Step,
+        // Enable debugging and force an assembler breakpoint.
+        Break,
+        // Cancel execution and any outstanding input requests.
+        Cancel,
+        // Deliver value to the input device at address.
+        InputAvailable,
+        // Stop the simulation thread.
+        Quit,
+    };
+    Type type = Type::Quit;
+    std::function<void()> job;
+    quint16 address = 0;
+    quint8 value = 0;
+};
+
+/*
+ * Bounded queue of commands with a single producer and a single consumer.
+ *
+ * Pushing and popping only touch a pair of atomic indices, so a running simulation may poll
+ * for commands every few instructions at almost no cost. The semaphore is only used to wake
+ * a consumer that went to sleep in waitPop() because the queue was empty.
+ */
+class SimulationCommandQueue
+{
+public:
+    // Capacity is rounded up to a power of 2.
+    explicit SimulationCommandQueue(quint32 capacity = 4096);
+    ~SimulationCommandQueue();
+
+    // Returns false if the queue is full. Only call from the producer thread.
+    bool push(SimulationCommand command);
+    // Returns false if the queue is empty. Only call from the consumer thread.
+    bool tryPop(SimulationCommand& command);
+    // Blocks until a command is available. Only call from the consumer thread.
+    SimulationCommand waitPop();
+
+private:
+    std::vector<SimulationCommand> buffer;
+    quint32 mask;
+    // Index of the next command to pop, written only by the consumer.
+    std::atomic<quint32> head;
+    // Index of the next command to push, written only by the producer.
+    std::atomic<quint32> tail;
+    std::atomic<bool> sleeping;
+    QSemaphore doorbell;
+};
+
+/*
+ * Thread which runs a CPU, so that long simulations never block the UI.
+ *
+ * The UI posts commands, and is told when each run or step has finished through the done
+ * callback passed with it, which is called on the UI thread in the order commands were posted.
+ * While a command executes, the CPU polls for break, cancel, and input commands instead of
+ * processing UI events, and waits on the command queue when an input device has no input.
+ *
+ * Signals which require the UI to inspect the CPU mid-command (such as breakpoints, input
+ * requests, and the end of the simulation) should be forwarded with invokeBlocking(...), which
+ * parks the simulation until the UI has handled them. Otherwise, the UI must not touch the CPU
+ * or memory while isBusy().
+ */
+class SimulationThread : public QThread
+{
+    Q_OBJECT
+public:
+    explicit SimulationThread(QSharedPointer<ACPUModel> cpu, QSharedPointer<MainMemory> memory, QObject* parent = nullptr);
+    // Cancels any command in progress, and waits for the thread to exit.
+    ~SimulationThread() override;
+
+    // Unless noted, the following must be called from the thread owning this object.
+
+    // Execute until completion, cancelation, error, or breakpoint, then call done.
+    void runSimulation(std::function<void()> done = {});
+    // Execute job on the simulation thread, then call done. An empty job is a no-op,
+    // so step({}, done) calls done once every command before it has finished.
+    void step(std::function<void()> job, std::function<void()> done = {});
+    // Pause the simulation at the next instruction, as if an assembler breakpoint were hit.
+    void interrupt();
+    void cancel();
+    void postInput(quint16 address, quint8 value);
+    // True while a command is executing, unless the simulation is parked in invokeBlocking(...).
+    bool isBusy() const noexcept;
+    // Stop the thread, discarding any done callbacks which have not been called.
+    void shutdown();
+
+    // Call function on context's thread, and wait for it to return. May be called from any thread.
+    void invokeBlocking(QObject* context, std::function<void()> function);
+
+signals:
+    // Emitted from the simulation thread after each run or step.
+    void commandFinished();
+
+protected:
+    void run() override;
+
+private slots:
+    void onCommandFinished();
+
+private:
+    void post(SimulationCommand command);
+    // Returns false if command asks the thread to quit.
+    bool execute(SimulationCommand command);
+    // Handle commands which may interrupt a command in progress. Returns false for any other command.
+    bool handleControl(const SimulationCommand& command);
+    // Called by the CPU instead of processing UI events.
+    void pollCommands();
+    // Called by memory when the input device at address has no input.
+    void waitForInput(quint16 address);
+
+    QSharedPointer<ACPUModel> cpu;
+    QSharedPointer<MainMemory> memory;
+    SimulationCommandQueue commands;
+    // Runs and steps popped while another command was executing. Only used by the simulation thread.
+    std::deque<SimulationCommand> deferred;
+    // Done callbacks for commands that have not yet finished. Only used by the owning thread.
+    QQueue<std::function<void()>> pending;
+    std::atomic<bool> parked;
+};
+
+#endif // SIMULATIONTHREAD_H
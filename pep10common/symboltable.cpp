@@ -26,49 +26,94 @@
 #include "symbolentry.h"
 #include "symbolvalue.h"
 
-using SymbolID = QAtomicInt;
+using SymbolID = SymbolTable::SymbolID;
 using SymbolEntryPtr = QSharedPointer<SymbolEntry>;
 using AbstractSymbolValuePtr = QSharedPointer<AbstractSymbolValue>;
-SymbolID SymbolTable::nextUserSymbolID = 0;
 
-SymbolID SymbolTable::getNextUserSymbolID()
+// Initial number of hash slots. Must be a power of two.
+static const int initialHashSlots = 64;
+
+SymbolTable::SymbolTable(): externalSymbols(), symbolEntries(), symbolNames(), symbolHashes(),
+    externalFlags(), importTable(nullptr), importedReferences(), importedReferenceSet(),
+    hashSlots(initialHashSlots, emptySlot)
 {
-    QAtomicInt newSymbolID = ++nextUserSymbolID;
-	return newSymbolID;
-}
 
-SymbolTable::SymbolTable() = default;
+}
 
 SymbolTable::~SymbolTable() = default;
 
-SymbolEntryPtr SymbolTable::getValue(SymbolID symbolID) const
+int SymbolTable::findSlot(const QString &symbolName, uint hash) const
+{
+    const int mask = hashSlots.size() - 1;
+    // Use raw data pointers, since implicitly shared containers would otherwise check for detaches.
+    const qint32* slots = hashSlots.constData();
+    const uint* hashes = symbolHashes.constData();
+    const QString* names = symbolNames.constData();
+    // The table is never more than half full, so the probe always reaches an empty slot.
+    for(int slot = static_cast<int>(hash) & mask; ; slot = (slot + 1) & mask) {
+        qint32 id = slots[slot];
+        if(id == emptySlot) return slot;
+        else if(hashes[id] == hash && names[id] == symbolName) return slot;
+    }
+}
+
+void SymbolTable::growHashSlots()
 {
+    hashSlots.fill(emptySlot, hashSlots.size() * 2);
+    const int mask = hashSlots.size() - 1;
+    for(qint32 id = 0; id < symbolHashes.size(); id++) {
+        // Names are unique, so each symbol only needs to find an empty slot.
+        int slot = static_cast<int>(symbolHashes[id]) & mask;
+        while(hashSlots[slot] != emptySlot) slot = (slot + 1) & mask;
+        hashSlots[slot] = id;
+    }
+}
 
-    auto index = symbolDictionary.find(symbolID);
-    if(index == symbolDictionary.end()) return QSharedPointer<SymbolEntry>();
-    return index.value();
+SymbolEntryPtr SymbolTable::insertSymbolAt(const QString &symbolName, uint hash, int slot)
+{
+    SymbolID id = static_cast<SymbolID>(symbolEntries.size());
+    symbolNames.append(symbolName);
+    symbolHashes.append(hash);
+    externalFlags.append(false);
+    symbolEntries.append(QSharedPointer<SymbolEntry>::create(this, id, symbolName));
+    hashSlots[slot] = static_cast<qint32>(id);
+    // Keep the load factor at or below 1/2, so that probe sequences stay short.
+    if(symbolEntries.size() * 2 > hashSlots.size()) growHashSlots();
+    return symbolEntries.last();
+}
+
+SymbolEntryPtr SymbolTable::getLocalValue(const QString &symbolName) const
+{
+    qint32 id = hashSlots[findSlot(symbolName, qHash(symbolName))];
+    if(id == emptySlot)  return nullptr;
+    return symbolEntries[id];
+}
+
+SymbolEntryPtr SymbolTable::getValue(SymbolID symbolID) const
+{
+    if(symbolID >= static_cast<SymbolID>(symbolEntries.size())) return QSharedPointer<SymbolEntry>();
+    return symbolEntries[static_cast<int>(symbolID)];
 }
 
 SymbolEntryPtr SymbolTable::getValue(const QString & symbolName) const
 {
-    auto index = symbolLookup.find(symbolName);
-    if(index == symbolLookup.end())  return nullptr;
-    return getValue(index.value());
+    auto local = getLocalValue(symbolName);
+    if(!local.isNull() || importTable.isNull()) return local;
+    return importTable->getExternalSymbol(symbolName);
 }
 
 SymbolEntryPtr SymbolTable::insertSymbol(const QString & symbolName)
 {
+    uint hash = qHash(symbolName);
+    int slot = findSlot(symbolName, hash);
     // We don't want multiple symbols to exists in the same table with the same name.
-    if(exists(symbolName)) return getValue(symbolName);
-	SymbolID id = SymbolTable::getNextUserSymbolID();
-    symbolLookup.insert(symbolName, id);
-    auto val = symbolDictionary.insert(id, QSharedPointer<SymbolEntry>::create(this, id, symbolName));
-	return val.value();
+    if(hashSlots[slot] != emptySlot) return symbolEntries[hashSlots[slot]];
+    return insertSymbolAt(symbolName, hash, slot);
 }
 
 SymbolEntryPtr SymbolTable::setValue(SymbolID symbolID, AbstractSymbolValuePtr value)
 {
-    SymbolEntryPtr rval = symbolDictionary[symbolID];
+    SymbolEntryPtr rval = getValue(symbolID);
     // If the symbol has already been defined, this function vall constitutes a redefinition.
     if(rval->isDefined()) {
         rval->setMultiplyDefined();
@@ -80,23 +125,31 @@ SymbolEntryPtr SymbolTable::setValue(SymbolID symbolID, AbstractSymbolValuePtr v
 SymbolEntryPtr SymbolTable::setValue(const QString & symbolName, AbstractSymbolValuePtr value)
 {
     // If the table doesn't contain a symbol, create it first.
-    if(!exists(symbolName)) insertSymbol(symbolName);
-    return setValue(symbolLookup.find(symbolName).value(), std::move(value));
+    return setValue(insertSymbol(symbolName)->getSymbolID(), std::move(value));
 }
 
 SymbolTable::SymbolEntryPtr SymbolTable::reference(const QString &symbolName)
 {
-    auto index = symbolLookup.find(symbolName);
-    if(index == symbolLookup.end()) return insertSymbol(symbolName);
-    return getValue(index.value());
+    uint hash = qHash(symbolName);
+    int slot = findSlot(symbolName, hash);
+    if(hashSlots[slot] != emptySlot) return symbolEntries[hashSlots[slot]];
+    // Resolve the symbol through the imported table instead of creating a local copy.
+    if(!importTable.isNull()) {
+        auto imported = importTable->getExternalSymbol(symbolName);
+        if(!imported.isNull()) {
+            if(!importedReferenceSet.contains(imported.data())) {
+                importedReferenceSet.insert(imported.data());
+                importedReferences.append(imported);
+            }
+            return imported;
+        }
+    }
+    return insertSymbolAt(symbolName, hash, slot);
 }
 
 SymbolTable::SymbolEntryPtr SymbolTable::define(const QString &symbolName)
 {
-    auto index = symbolLookup.find(symbolName);
-    SymbolTable::SymbolEntryPtr entry;
-    if(index == symbolLookup.end()) entry = insertSymbol(symbolName);
-    else entry = getValue(index.value());
+    SymbolTable::SymbolEntryPtr entry = insertSymbol(symbolName);
     // Defining a symbol "increases" the definition state by one.
     if(entry->isUndefined()) entry->setDefinedState(DefStates::SINGLE);
     else if(entry->isDefined()) entry->setDefinedState(DefStates::MULTIPLE);
@@ -107,7 +160,11 @@ void SymbolTable::declareExternal(const QString &symbolName)
 {
     // an EXPORT statement does not declare a symbol,
     // so therefore we are referencing one that already exists.
-    externalSymbols.push_back(reference(symbolName));
+    auto entry = reference(symbolName);
+    // Symbols imported from another table may not be re-exported.
+    if(entry->getParentTable() != this) return;
+    externalFlags[static_cast<int>(entry->getSymbolID())] = true;
+    externalSymbols.push_back(entry);
 }
 
 const QList<QSharedPointer<SymbolEntry>> SymbolTable::getExternalSymbols() const
@@ -116,20 +173,60 @@ const QList<QSharedPointer<SymbolEntry>> SymbolTable::getExternalSymbols() const
     return this->externalSymbols;
 }
 
+SymbolEntryPtr SymbolTable::getExternalSymbol(const QString &symbolName) const
+{
+    qint32 id = hashSlots[findSlot(symbolName, qHash(symbolName))];
+    if(id == emptySlot || !externalFlags[id]) return nullptr;
+    return symbolEntries[id];
+}
+
+void SymbolTable::setImportTable(QSharedPointer<const SymbolTable> imports)
+{
+    importTable = imports;
+    importedReferences.clear();
+    importedReferenceSet.clear();
+}
+
+QSharedPointer<const SymbolTable> SymbolTable::getImportTable() const
+{
+    return importTable;
+}
+
+const QVector<SymbolEntryPtr> &SymbolTable::getImportedSymbols() const
+{
+    return importedReferences;
+}
+
 bool SymbolTable::exists(const QString& symbolName) const
 {
-    return symbolLookup.find(symbolName) != symbolLookup.end();
+    if(existsLocally(symbolName)) return true;
+    return !importTable.isNull() && !importTable->getExternalSymbol(symbolName).isNull();
+}
+
+bool SymbolTable::existsLocally(const QString &symbolName) const
+{
+    return hashSlots[findSlot(symbolName, qHash(symbolName))] != emptySlot;
 }
 
 bool SymbolTable::exists(SymbolID symbolID) const
 {
-    return symbolDictionary.find(symbolID) != symbolDictionary.end();
+    return symbolID < static_cast<SymbolID>(symbolEntries.size());
+}
+
+int SymbolTable::size() const
+{
+    return symbolEntries.size();
+}
+
+bool SymbolTable::isEmpty() const
+{
+    return symbolEntries.isEmpty();
 }
 
 quint32 SymbolTable::numMultiplyDefinedSymbols() const
 {
     quint32 count = 0;
-    for(const auto& ptr : this->symbolDictionary) {
+    for(const auto& ptr : this->symbolEntries) {
         count += ptr->isMultiplyDefined() ? 1 : 0;
     }
     return count;
@@ -138,7 +235,7 @@ quint32 SymbolTable::numMultiplyDefinedSymbols() const
 quint32 SymbolTable::numUndefinedSymbols() const
 {
     quint32 count = 0;
-    for(const auto& ptr : this->symbolDictionary) {
+    for(const auto& ptr : this->symbolEntries) {
         count += ptr->isUndefined() ? 1 : 0;
     }
     return count;
@@ -146,7 +243,7 @@ quint32 SymbolTable::numUndefinedSymbols() const
 
 void SymbolTable::setOffset(quint16 value, quint16 threshhold)
 {
-    for(SymbolEntryPtr ptr : this->symbolDictionary) {
+    for(const SymbolEntryPtr& ptr : this->symbolEntries) {
         if(ptr->getRawValue()->getSymbolType() == SymbolType::ADDRESS && ptr->getValue() >= threshhold) {
             static_cast<SymbolValueLocation*>(ptr->getRawValue().data())->setOffset(value);
         }
@@ -159,17 +256,11 @@ void SymbolTable::clearOffset()
     setOffset(0, 0);
 }
 
-QList<SymbolEntryPtr> SymbolTable::getSymbolEntries() const
+const QVector<SymbolEntryPtr>& SymbolTable::getSymbolEntries() const
 {
-    return symbolDictionary.values();
+    return symbolEntries;
 }
 
-const QMap<SymbolTable::SymbolID, SymbolTable::SymbolEntryPtr> SymbolTable::getSymbolMap() const
-{
-    return symbolDictionary;
-}
-
-
 QString SymbolTable::getSymbolTableListing() const
 {
 
@@ -177,7 +268,8 @@ QString SymbolTable::getSymbolTableListing() const
     static const QString symTableStr = "Symbol table\n";
     static const QString headerStr = "Symbol    Value        Symbol    Value\n";
     QString build;
-    QList<QSharedPointer<SymbolEntry>> list = getSymbolEntries();
+    // Imported symbols referenced by this table are listed alongside local symbols.
+    QVector<QSharedPointer<SymbolEntry>> list = getSymbolEntries() + getImportedSymbols();
     std::sort(list.begin(),list.end(), SymbolAlphabeticComparator);
 
     // Don't generate an empty symbol table.
@@ -25,7 +25,10 @@
 #include <memory>
 #include <QMap>
 #include <QMutex>
+#include <QSet>
 #include <QSharedPointer>
+#include <QString>
+#include <QVector>
 
 class SymbolEntry;
 class AbstractSymbolValue;
@@ -34,23 +37,52 @@ class AbstractSymbolValue;
  * The SymbolTable class provides lookups base on the names and unique identifiers of a group of SymbolEntries.
  * A SymbolEntry is created by calling insertSymbol(...), and can then be looked up by name or by its unique identifier.
  *
+ * Symbol names are interned: each name is stored once, in the order symbols were created, and a symbol's
+ * identifier is its index in that order. Names are mapped to identifiers with an open addressing hash table,
+ * so lookups by name or by identifier take constant time. Symbols are never removed from a table, so both
+ * identifiers and SymbolEntry pointers remain valid for the lifetime of the table.
+ *
+ * A table may import the symbols exported by another table (e.g. a user program importing the operating system's
+ * .EXPORT'ed symbols). Imported symbols are resolved through the other table rather than being copied, so one
+ * operating system table may be shared, read only, by any number of user program tables across threads.
+ * An imported table must not be modified while it is shared.
  */
 class SymbolTable
 {
 public:
     // This type uniquely identifies a SymbolEntry within a symbol table.
     // It is not gaurenteed to be unique across runs or between multiple SymbolTable instances at runtime.
-    using SymbolID = QAtomicInt;
+    using SymbolID = quint32;
     // Convenience typdefs of commonly used templated types to reduce code verbosity.
     using SymbolEntryPtr = QSharedPointer<SymbolEntry>;
     using AbstractSymbolValuePtr = QSharedPointer<AbstractSymbolValue>;
 
 private:
-    static SymbolID nextUserSymbolID;
-	static SymbolID getNextUserSymbolID();
+    // Marks a hash slot that does not refer to any symbol.
+    static constexpr qint32 emptySlot = -1;
     QList<SymbolEntryPtr> externalSymbols;
-    QMap<SymbolID, SymbolEntryPtr> symbolDictionary;
-    QMap<QString, SymbolID> symbolLookup;
+    // Indexed by SymbolID.
+    QVector<SymbolEntryPtr> symbolEntries;
+    QVector<QString> symbolNames;
+    QVector<uint> symbolHashes;
+    // True if the symbol with that ID was declared with declareExternal(...).
+    QVector<bool> externalFlags;
+    // Table whose external symbols are visible in this table.
+    QSharedPointer<const SymbolTable> importTable;
+    // Imported symbols referenced by this table, in the order they were first referenced.
+    QVector<SymbolEntryPtr> importedReferences;
+    QSet<const SymbolEntry*> importedReferenceSet;
+    // Open addressing hash table of SymbolIDs, probed linearly.
+    // Size is always a power of two, and at most half of the slots are in use.
+    QVector<qint32> hashSlots;
+    // Return the slot containing symbolName, or the empty slot where it should be inserted.
+    int findSlot(const QString& symbolName, uint hash) const;
+    // Double the number of hash slots, and rehash all existing symbols.
+    void growHashSlots();
+    // Create a new symbol in the empty slot returned by findSlot(...).
+    SymbolEntryPtr insertSymbolAt(const QString& symbolName, uint hash, int slot);
+    // Return the symbol only if it is defined in this table, rather than imported.
+    SymbolEntryPtr getLocalValue(const QString& symbolName) const;
 
 public:
     explicit SymbolTable();
@@ -68,19 +100,34 @@ public:
 	SymbolEntryPtr setValue(const QString & symbolName, AbstractSymbolValuePtr value);
 
     // Indicate that you are referencing a (supposedly) declared symbol.
-    // If the symbol is not in the symbol table, it will bre created.
+    // If the symbol is not in the symbol table or its imports, it will bre created.
     SymbolEntryPtr reference(const QString & symbolName);
     // Indicate that you are defining a new symbol. If the symbol
     // already exists, the symbol will be flagged as multiply defined.
+    // Definitions are always local, even if an imported symbol has the same name.
     SymbolEntryPtr define(const QString & symbolName);
     // Declare a symbol as external, allowing it to be used in other translation units.
     void declareExternal(const QString & symbolName);
     // Return the list of symbols that may be linked externally.
     const QList<QSharedPointer<SymbolEntry>> getExternalSymbols() const;
+    // Return the external symbol with the passed name, or nullptr if no such symbol was declared external.
+    SymbolEntryPtr getExternalSymbol(const QString & symbolName) const;
+
+    // Make the external symbols of imports visible through reference(...), getValue(...), and exists(...).
+    // Must be set before any symbols are referenced.
+    void setImportTable(QSharedPointer<const SymbolTable> imports);
+    QSharedPointer<const SymbolTable> getImportTable() const;
+    // Return the imported symbols that have been referenced, in the order they were first referenced.
+    const QVector<SymbolEntryPtr>& getImportedSymbols() const;
 
-    // Check if a symbol exists.
+    // Check if a symbol exists in this table or its imports.
     bool exists(const QString& symbolName) const;
     bool exists(SymbolID symbolID) const;
+    // Check if a symbol exists in this table, ignoring imports.
+    bool existsLocally(const QString& symbolName) const;
+    // Number of symbols in the table, excluding imports.
+    int size() const;
+    bool isEmpty() const;
     // Get the count of symbols that have definition problems.
 	quint32 numMultiplyDefinedSymbols() const;
 	quint32 numUndefinedSymbols() const;
@@ -89,10 +136,9 @@ public:
     void setOffset(quint16 value, quint16 threshhold = 0);
     // Set the offset of all relocatable symbols to 0.
     void clearOffset();
-    QList<SymbolEntryPtr> getSymbolEntries() const;
-    // Return the map of all symbolic definitions. Used to provide access to iterators
-    // to perform custom operations and comparisions over all symbols.
-    const QMap<SymbolID, SymbolEntryPtr> getSymbolMap() const;
+    // Return all symbols defined in this table, in the order that they were created.
+    // Used to provide access to iterators to perform custom operations and comparisions over all symbols.
+    const QVector<SymbolEntryPtr>& getSymbolEntries() const;
 
     QString getSymbolTableListing() const;
 };
@@ -20,10 +20,10 @@
 */
 
 #include <QFontDialog>
-#include <QScrollBar>
 
 #include "pep.h"
 #include "terminalpane.h"
+#include "textoutputbuffer.h"
 #include "ui_terminalpane.h"
 
 TerminalPane::TerminalPane(QWidget *parent) :
@@ -33,6 +33,7 @@ TerminalPane::TerminalPane(QWidget *parent) :
     ui->setupUi(this);
 
     waiting = false;
+    output = new TextOutputBuffer(ui->plainTextEdit, this);
 
     connect(ui->plainTextEdit, &QPlainTextEdit::undoAvailable, this, &TerminalPane::undoAvailable);
     connect(ui->plainTextEdit, &QPlainTextEdit::redoAvailable, this, &TerminalPane::redoAvailable);
@@ -57,9 +58,12 @@ void TerminalPane::cancelWaiting()
 
 void TerminalPane::appendOutput(QString str)
 {
-    ui->plainTextEdit->setPlainText(ui->plainTextEdit->toPlainText().append(str));
-    strokeString.append(str);
-    ui->plainTextEdit->verticalScrollBar()->setValue(ui->plainTextEdit->verticalScrollBar()->maximum()); // Scroll to bottom
+    output->append(str);
+}
+
+void TerminalPane::setScrollbackLimit(int lines)
+{
+    output->setScrollbackLimit(lines);
 }
 
 void TerminalPane::waitingForInput()
@@ -67,16 +71,12 @@ void TerminalPane::waitingForInput()
     waiting = true;
     displayTerminal();
     ui->plainTextEdit->setFocus();
-    while(waiting) {
-        QApplication::processEvents();
-    }
 }
 
 void TerminalPane::clearTerminal()
 {
-    ui->plainTextEdit->clear();
+    output->clear();
     retString = "";
-    strokeString = "";
 }
 
 void TerminalPane::highlightOnFocus()
@@ -136,13 +136,13 @@ void TerminalPane::redo()
 
 void TerminalPane::displayTerminal()
 {
+    // Only the input line changes as keys are typed, so only replace it.
     if(waiting) {
-        ui->plainTextEdit->setPlainText(strokeString + retString + QString("_"));
+        output->setTail(retString + QString("_"));
     }
     else {
-        ui->plainTextEdit->setPlainText(strokeString + retString);
+        output->setTail(retString);
     }
-    ui->plainTextEdit->verticalScrollBar()->setValue(ui->plainTextEdit->verticalScrollBar()->maximum()); // Scroll to bottom
 }
 
 bool TerminalPane::eventFilter(QObject *, QEvent *event)
@@ -157,11 +157,14 @@ bool TerminalPane::eventFilter(QObject *, QEvent *event)
         }
         else if (e->key() == Qt::Key_Enter || e->key() == Qt::Key_Return) {
             retString.append('\n');
-            strokeString.append(retString);
             waiting = false;
             emit inputReady(retString);
+            // The entered line is now part of the output, and may no longer be edited.
+            QString entered = retString;
             retString = "";
             displayTerminal();
+            output->append(entered);
+            output->flush();
             emit inputReceived();
             return true;
         }
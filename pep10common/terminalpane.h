@@ -26,6 +26,8 @@
 #include <QKeyEvent>
 #include <QWidget>
 
+class TextOutputBuffer;
+
 namespace Ui {
     class TerminalPane;
 }
@@ -41,10 +43,14 @@ public:
     // Post: if the terminal was waiting for input, cancel the wait
 
     void appendOutput(QString str);
-    // Post: str is appended to the text edit
+    // Post: str is appended to the text edit by the next frame
+
+    void setScrollbackLimit(int lines);
+    // Post: at most the last lines lines are kept, or every line if lines is 0
 
     void waitingForInput();
     // Post: Sets the writability of the text edit to true, and prevents previously entered text from being modified
+    // Returns immediately; the line is emitted through inputReady once the user enters it
 
     void clearTerminal();
     // Post: Clears the terminal
@@ -73,7 +79,8 @@ private:
 
     bool waiting;
 
-    QString strokeString;
+    // Displays output, followed by the input being typed as its tail.
+    TextOutputBuffer *output;
     QString retString;
 
     void displayTerminal();
@@ -0,0 +1,70 @@
+#include "textoutputbuffer.h"
+
+#include <algorithm>
+#include <QPlainTextEdit>
+#include <QScrollBar>
+#include <QTextCursor>
+
+TextOutputBuffer::TextOutputBuffer(QPlainTextEdit *edit, QObject *parent): QObject(parent),
+    edit(edit), flushTimer(), pending(), tailLength(0)
+{
+    edit->setUndoRedoEnabled(false);
+    edit->setMaximumBlockCount(defaultScrollbackLimit);
+    flushTimer.setSingleShot(true);
+    flushTimer.setInterval(flushIntervalMs);
+    connect(&flushTimer, &QTimer::timeout, this, &TextOutputBuffer::flush);
+}
+
+TextOutputBuffer::~TextOutputBuffer() = default;
+
+int TextOutputBuffer::getScrollbackLimit() const noexcept
+{
+    return edit->maximumBlockCount();
+}
+
+void TextOutputBuffer::setScrollbackLimit(int lines)
+{
+    edit->setMaximumBlockCount(std::max(lines, 0));
+}
+
+void TextOutputBuffer::append(const QString &str)
+{
+    pending.append(str);
+    if(!flushTimer.isActive()) flushTimer.start();
+}
+
+void TextOutputBuffer::flush()
+{
+    flushTimer.stop();
+    if(pending.isEmpty()) return;
+    QTextCursor cursor(edit->document());
+    cursor.movePosition(QTextCursor::End);
+    cursor.movePosition(QTextCursor::Left, QTextCursor::MoveAnchor, tailLength);
+    cursor.insertText(pending);
+    pending.clear();
+    scrollToBottom();
+}
+
+void TextOutputBuffer::clear()
+{
+    flushTimer.stop();
+    pending.clear();
+    tailLength = 0;
+    edit->clear();
+}
+
+void TextOutputBuffer::setTail(const QString &text)
+{
+    flush();
+    QTextCursor cursor(edit->document());
+    cursor.movePosition(QTextCursor::End);
+    cursor.movePosition(QTextCursor::Left, QTextCursor::KeepAnchor, tailLength);
+    cursor.insertText(text);
+    tailLength = text.length();
+    scrollToBottom();
+}
+
+void TextOutputBuffer::scrollToBottom()
+{
+    edit->verticalScrollBar()->setValue(edit->verticalScrollBar()->maximum());
+}
@@ -0,0 +1,56 @@
+#ifndef TEXTOUTPUTBUFFER_H
+#define TEXTOUTPUTBUFFER_H
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+class QPlainTextEdit;
+
+/*
+ * Appends program output to the end of a plain text edit.
+ *
+ * Replacing the text of a document costs time proportional to its length, so re-setting the text
+ * for every character a program prints takes quadratic time. Instead, output is collected until the
+ * next frame, and then inserted at the end of the document with a cursor, so that each character is
+ * only laid out once. The edit keeps at most the last scrollbackLimit lines.
+ *
+ * Owners may keep text of their own after the output, such as a terminal's partially typed input.
+ * That text is the tail, and output is always inserted before it.
+ */
+class TextOutputBuffer : public QObject
+{
+    Q_OBJECT
+public:
+    static constexpr int defaultScrollbackLimit = 10000;
+    static constexpr int flushIntervalMs = 1000 / 30;
+
+    // Undo is disabled on edit, since inserted output would otherwise be recorded forever.
+    explicit TextOutputBuffer(QPlainTextEdit* edit, QObject* parent = nullptr);
+    ~TextOutputBuffer() override;
+
+    int getScrollbackLimit() const noexcept;
+    // Drop the oldest lines beyond lines. A limit of 0 keeps every line.
+    void setScrollbackLimit(int lines);
+
+    // Queue str to be displayed on the next frame.
+    void append(const QString& str);
+    // Display any queued output now.
+    void flush();
+    // Discard any queued output, and clear the edit.
+    void clear();
+
+    // Replace the tail with text. Queued output is flushed first, so it always precedes the tail.
+    void setTail(const QString& text);
+
+private:
+    void scrollToBottom();
+
+    QPlainTextEdit* edit;
+    QTimer flushTimer;
+    QString pending;
+    // Number of characters at the end of the document which belong to the tail.
+    int tailLength;
+};
+
+#endif // TEXTOUTPUTBUFFER_H
@@ -0,0 +1,178 @@
+#ifndef ALUTABLES_H
+#define ALUTABLES_H
+
+#include <array>
+#include "enu.h"
+
+/*
+ * Outputs of the 8 bit ALU, precomputed at compile time.
+ *
+ * Tabulating every (function, A, B, carry in) would need 2M entries (4 MiB). That is beyond what
+ * compilers will evaluate as a constant expression, and far too large to stay in cache, so each
+ * lookup would cost more than the arithmetic it replaces. Instead:
+ *  - Every function number has a set of traits, so inputs may be validated without a switch.
+ *  - Unary functions are fully tabulated by (function, carry in, A). Evaluating one is a single lookup.
+ *  - Binary functions compute their result and carry directly, and look up N & Z by result.
+ *
+ * The tables reproduce the previous switch-based ALU bit for bit. That includes how V is derived
+ * for ASLA and ROLA, which also raises Z when A<6> is 1.
+ */
+namespace ALUTables {
+    struct Output
+    {
+        quint8 result = 0;
+        quint8 NZVC = 0;
+    };
+
+    // Properties of an ALU function number, combined as bit flags.
+    enum FunctionTraits : quint8
+    {
+        // The function number selects one of the ALU's functions.
+        Defined = 0x01,
+        // The function only consumes A. Matches CPUDataSection::aluFnIsUnary().
+        Unary = 0x02,
+        // The function needs a carry in from CSMux to produce a result.
+        NeedsCarry = 0x04,
+    };
+
+    constexpr quint8 traitsOf(int func) noexcept
+    {
+        quint8 traits = 0;
+        if(func <= Enu::NZVCA_func) traits |= Defined;
+        if(func == Enu::A_func || func >= Enu::nA_func) traits |= Unary;
+        if(func == Enu::ApBpCin_func || func == Enu::ApnBpCin_func
+                || func == Enu::ROLA_func || func == Enu::RORA_func) traits |= NeedsCarry;
+        return traits;
+    }
+
+    constexpr quint8 NZOf(quint8 result) noexcept
+    {
+        return static_cast<quint8>(((result & 0x80) ? Enu::NMask : 0) | (result == 0 ? Enu::ZMask : 0));
+    }
+
+    // Compute the output of a defined, unary function.
+    constexpr Output calculateUnary(int func, quint8 a, bool carryIn) noexcept
+    {
+        Output out;
+        switch(func) {
+        case Enu::A_func:
+            out.result = a;
+            break;
+        case Enu::nA_func:
+            out.result = static_cast<quint8>(~a);
+            break;
+        case Enu::ASLA_func:
+            carryIn = false;
+            [[fallthrough]];
+        case Enu::ROLA_func:
+            out.result = static_cast<quint8>(a << 1 | quint8{carryIn});
+            out.NZVC |= Enu::CMask * ((a & 0x80) >> 7); // Carry out equals the hi order bit
+            out.NZVC |= Enu::VMask * (((a << 1) ^ a) >> 7); // Signed overflow if a<hi> doesn't match a<hi-1>
+            break;
+        case Enu::ASRA_func:
+            carryIn = a & 128; // RORA and ASRA only differ by how the carryIn is calculated
+            [[fallthrough]];
+        case Enu::RORA_func:
+            out.result = static_cast<quint8>(a >> 1 | static_cast<quint8>(carryIn) << 7);
+            out.NZVC |= Enu::CMask * (a & 1); // Carry out is lowest order bit of a
+            break;
+        case Enu::NZVCA_func:
+            // Moves A to NZVC, without computing N & Z from the result.
+            out.NZVC = a & (Enu::NMask | Enu::ZMask | Enu::VMask | Enu::CMask);
+            return out;
+        default:
+            return out;
+        }
+        out.NZVC |= NZOf(out.result);
+        return out;
+    }
+
+    template <typename T, std::size_t size, typename Generator>
+    constexpr std::array<T, size> generate(Generator generator) noexcept
+    {
+        std::array<T, size> table {};
+        for(std::size_t it = 0; it < size; it++) {
+            table[it] = generator(it);
+        }
+        return table;
+    }
+
+    // Traits of all 256 values the ALU control signal may take.
+    inline constexpr std::array<quint8, 256> functionTraits =
+            generate<quint8, 256>([](std::size_t func) { return traitsOf(static_cast<int>(func)); });
+
+    // N & Z bits of each result.
+    inline constexpr std::array<quint8, 256> NZFlags =
+            generate<quint8, 256>([](std::size_t result) { return NZOf(static_cast<quint8>(result)); });
+
+    // Outputs of unary functions, indexed by (function << 9) | (carry in << 8) | A.
+    // Entries of binary functions are unused.
+    inline constexpr std::array<Output, 16 * 2 * 256> unaryOutputs =
+            generate<Output, 16 * 2 * 256>([](std::size_t index) {
+                return calculateUnary(static_cast<int>(index >> 9), static_cast<quint8>(index & 0xFF),
+                                      (index >> 8) & 1);
+            });
+
+    // Compute the output of a defined, binary function.
+    constexpr Output calculateBinary(int func, quint8 a, quint8 b, bool carryIn) noexcept
+    {
+        Output out;
+        switch(func) {
+        case Enu::ApB_func:
+            carryIn = false;
+            break;
+        case Enu::ApnBp1_func:
+            carryIn = true;
+            b = static_cast<quint8>(~b);
+            break;
+        case Enu::ApnBpCin_func:
+            b = static_cast<quint8>(~b);
+            break;
+        case Enu::ApBpCin_func:
+            break;
+        case Enu::AandB_func:
+            out.result = a & b;
+            out.NZVC = NZFlags[out.result];
+            return out;
+        case Enu::nAandB_func:
+            out.result = static_cast<quint8>(~(a & b));
+            out.NZVC = NZFlags[out.result];
+            return out;
+        case Enu::AorB_func:
+            out.result = a | b;
+            out.NZVC = NZFlags[out.result];
+            return out;
+        case Enu::nAorB_func:
+            out.result = static_cast<quint8>(~(a | b));
+            out.NZVC = NZFlags[out.result];
+            return out;
+        case Enu::AxorB_func:
+            out.result = a ^ b;
+            out.NZVC = NZFlags[out.result];
+            return out;
+        default:
+            return out;
+        }
+        // All that remains are the adders.
+        out.result = static_cast<quint8>(a + b + quint8{carryIn});
+        // Carry out if result is unsigned less than a or b.
+        out.NZVC |= Enu::CMask * quint8{out.result < a || out.result < b};
+        // There is a signed overflow iff the high order bits of the input are the same,
+        // and the inputs & output differs in sign.
+        out.NZVC |= Enu::VMask * ((~(a ^ b) & (a ^ out.result)) >> 7);
+        out.NZVC |= NZFlags[out.result];
+        return out;
+    }
+
+    // Output of a defined function. B is ignored by unary functions, and carry in
+    // is ignored by functions without the NeedsCarry trait.
+    constexpr Output calculate(quint8 func, quint8 a, quint8 b, bool carryIn) noexcept
+    {
+        if(functionTraits[func] & Unary) {
+            return unaryOutputs[static_cast<std::size_t>(func) << 9 | static_cast<std::size_t>(carryIn) << 8 | a];
+        }
+        return calculateBinary(func, a, b, carryIn);
+    }
+}
+
+#endif // ALUTABLES_H
@@ -0,0 +1,403 @@
+#include "compiledmicrostep.h"
+#include "amemorydevice.h"
+#include "cpudata.h"
+#include "registerfile.h"
+
+CompiledMicroStep::CompiledMicroStep() noexcept
+{
+    append([](const CompiledMicroStep&, CPUDataSection& data, CycleState&) {
+        data.mainBusState = Enu::None;
+        return true;
+    });
+}
+
+CompiledMicroStep::CompiledMicroStep(Enu::CPUType type, const Enu::ControlSignals &control,
+                                     const Enu::ClockSignals &clock) noexcept:
+    aReg(control[Enu::A]), bReg(control[Enu::B]), cReg(control[Enu::C]),
+    aluFunc(control[Enu::ALU]), csMux(control[Enu::CSMux]),
+    memRead(control[Enu::MemRead] == 1), memWrite(control[Enu::MemWrite] == 1),
+    checkMARChanged(clock[Enu::MARCk] && control[Enu::A] != Enu::signalDisabled
+                    && control[Enu::B] != Enu::signalDisabled)
+{
+    const bool twoByte = type == Enu::TwoByteDataBus;
+    const bool hasAB = aReg != Enu::signalDisabled && bReg != Enu::signalDisabled;
+
+    // Resolve the ALU's A input.
+    if(control[Enu::AMux] == 0 && !twoByte) aluSource = ALUSource::MDR;
+    else if(control[Enu::AMux] == 0 && control[Enu::EOMux] == 0) aluSource = ALUSource::MDRE;
+    else if(control[Enu::AMux] == 0 && control[Enu::EOMux] == 1) aluSource = ALUSource::MDRO;
+    else if(control[Enu::AMux] == 1) aluSource = ALUSource::ABus;
+
+    // Determine which values computed at the start of the cycle are consumed by a clock.
+    // A LoadCk without a destination fails before it looks at the C bus.
+    const bool usesC = (clock[Enu::LoadCk] && cReg != Enu::signalDisabled)
+            || (!twoByte && clock[Enu::MDRCk] && control[Enu::MDRMux] == 1)
+            || (twoByte && clock[Enu::MDRECk] && control[Enu::MDREMux] == 1)
+            || (twoByte && clock[Enu::MDROCk] && control[Enu::MDROMux] == 1);
+    const bool usesStatus = clock[Enu::NCk] || clock[Enu::ZCk] || clock[Enu::VCk]
+            || clock[Enu::CCk] || clock[Enu::SCk];
+    const bool usesALU = usesStatus || (usesC && control[Enu::CMux] == 1);
+
+    // Update the bus state first, as the rest of the read / write functionality depends on it.
+    if(!memRead && !memWrite) {
+        // Without a memory signal, the bus goes back to doing nothing regardless of MAR.
+        append([](const CompiledMicroStep&, CPUDataSection& data, CycleState&) {
+            data.mainBusState = Enu::None;
+            return true;
+        });
+    }
+    else {
+        append([](const CompiledMicroStep& step, CPUDataSection& data, CycleState&) {
+            bool marChanged = false;
+            if(step.checkMARChanged) {
+                marChanged = !(data.getRegisterBankByte(step.aReg) == data.memoryRegisters[Enu::MEM_MARA]
+                        && data.getRegisterBankByte(step.bReg) == data.memoryRegisters[Enu::MEM_MARB]);
+            }
+            data.mainBusState = CPUDataSection::nextMainBusState(data.mainBusState, marChanged,
+                                                                 step.memRead, step.memWrite);
+            return true;
+        });
+    }
+
+    // Compute the ALU output and C bus before any register is clocked.
+    if(usesALU) {
+        append([](const CompiledMicroStep& step, CPUDataSection& data, CycleState& state) {
+            quint8 a = 0, b = 0;
+            bool hasA = true, hasB = step.bReg != Enu::signalDisabled, hasCIn = true, carryIn = false;
+            switch(step.aluSource) {
+            case ALUSource::ABus:
+                hasA = step.aReg != Enu::signalDisabled;
+                if(hasA) a = data.getRegisterBankByte(step.aReg);
+                break;
+            case ALUSource::MDR:
+                a = data.memoryRegisters[Enu::MEM_MDR];
+                break;
+            case ALUSource::MDRE:
+                a = data.memoryRegisters[Enu::MEM_MDRE];
+                break;
+            case ALUSource::MDRO:
+                a = data.memoryRegisters[Enu::MEM_MDRO];
+                break;
+            case ALUSource::None:
+                hasA = false;
+                break;
+            }
+            if(hasB) b = data.getRegisterBankByte(step.bReg);
+            if(step.csMux == 0) carryIn = data.registerBank->readStatusBitsCurrent() & Enu::CMask;
+            else if(step.csMux == 1) carryIn = data.registerBank->readStatusBitsCurrent() & Enu::SMask;
+            else hasCIn = false;
+            state.hasALUOutput = data.computeALUOutput(step.aluFunc, hasA, a, hasB, b,
+                                                       hasCIn, carryIn, state.alu, state.NZVC);
+            return true;
+        });
+    }
+    if(usesC && control[Enu::CMux] == 0) {
+        // The NZVC bits (minus S) are directly routed to the C bus.
+        append([](const CompiledMicroStep&, CPUDataSection& data, CycleState& state) {
+            state.c = data.registerBank->readStatusBitsCurrent() & (~Enu::SMask);
+            state.hasC = true;
+            return true;
+        });
+    }
+    else if(usesC && control[Enu::CMux] == 1) {
+        append([](const CompiledMicroStep&, CPUDataSection&, CycleState& state) {
+            state.c = state.alu;
+            state.hasC = state.hasALUOutput;
+            return true;
+        });
+    }
+    // Otherwise the C bus has no output, which CycleState already reflects.
+
+    // Handle write to memory. The bus can only become ready on a cycle that asserts MemWrite.
+    if(memWrite && !twoByte) {
+        append([](const CompiledMicroStep&, CPUDataSection& data, CycleState&) {
+            if(data.mainBusState == Enu::MemWriteReady) {
+                auto address = static_cast<quint16>((data.memoryRegisters[Enu::MEM_MARA]<<8)
+                        | data.memoryRegisters[Enu::MEM_MARB]);
+                data.memDevice->writeByte(address, data.memoryRegisters[Enu::MEM_MDR]);
+            }
+            return true;
+        });
+    }
+    else if(memWrite) {
+        append([](const CompiledMicroStep&, CPUDataSection& data, CycleState&) {
+            if(data.mainBusState == Enu::MemWriteReady) {
+                auto address = static_cast<quint16>((data.memoryRegisters[Enu::MEM_MARA]<<8)
+                        | data.memoryRegisters[Enu::MEM_MARB]);
+                address &= 0xFFFE; // Memory access ignores lowest order bit
+                data.memDevice->writeWord(address, data.memoryRegisters[Enu::MEM_MDRE]*256
+                                          + data.memoryRegisters[Enu::MEM_MDRO]);
+            }
+            return true;
+        });
+    }
+
+    // MARCk
+    if(clock[Enu::MARCk] && twoByte && control[Enu::MARMux] == 0) {
+        append([](const CompiledMicroStep&, CPUDataSection& data, CycleState&) {
+            data.onSetMemoryRegister(Enu::MEM_MARA, data.memoryRegisters[Enu::MEM_MDRE]);
+            data.onSetMemoryRegister(Enu::MEM_MARB, data.memoryRegisters[Enu::MEM_MDRO]);
+            return true;
+        });
+    }
+    else if(clock[Enu::MARCk] && hasAB && (!twoByte || control[Enu::MARMux] == 1)) {
+        append([](const CompiledMicroStep& step, CPUDataSection& data, CycleState&) {
+            data.onSetMemoryRegister(Enu::MEM_MARA, data.getRegisterBankByte(step.aReg));
+            data.onSetMemoryRegister(Enu::MEM_MARB, data.getRegisterBankByte(step.bReg));
+            return true;
+        });
+    }
+    else if(clock[Enu::MARCk] && !twoByte) {
+        append([](const CompiledMicroStep&, CPUDataSection& data, CycleState&) {
+            data.hadDataError = true;
+            data.errorMessage = "No values on A & B during MARCk.";
+            return false;
+        });
+    }
+    else if(clock[Enu::MARCk]) {
+        append([](const CompiledMicroStep&, CPUDataSection& data, CycleState&) {
+            data.hadDataError = true;
+            data.errorMessage = "MARMux has no output but MARCk.";
+            return false;
+        });
+    }
+
+    // LoadCk
+    if(clock[Enu::LoadCk] && cReg == Enu::signalDisabled) {
+        append([](const CompiledMicroStep&, CPUDataSection& data, CycleState&) {
+            data.hadDataError = true;
+            data.errorMessage = "No destination register specified for LoadCk.";
+            return true;
+        });
+    }
+    else if(clock[Enu::LoadCk]) {
+        append([](const CompiledMicroStep& step, CPUDataSection& data, CycleState& state) {
+            if(!state.hasC) {
+                data.hadDataError = true;
+                data.errorMessage = "No value on C Bus to clock in.";
+            }
+            else data.onSetRegisterByte(step.cReg, state.c);
+            return true;
+        });
+    }
+
+    // MDRCk
+    if(clock[Enu::MDRCk] && !twoByte) {
+        switch(control[Enu::MDRMux]) {
+        case 0: // Pick memory
+            append([](const CompiledMicroStep&, CPUDataSection& data, CycleState&) {
+                auto address = static_cast<quint16>((data.memoryRegisters[Enu::MEM_MARA]<<8)
+                        + data.memoryRegisters[Enu::MEM_MARB]);
+                if(data.mainBusState != Enu::MemReadReady) {
+                    data.hadDataError = true;
+                    data.errorMessage = "No value from data bus to write to MDR.";
+                }
+                else {
+                    quint8 value = 0;
+                    data.memDevice->getByte(address, value);
+                    data.onSetMemoryRegister(Enu::MEM_MDR, value);
+                }
+                return true;
+            });
+            break;
+        case 1: // Pick C Bus
+            append([](const CompiledMicroStep&, CPUDataSection& data, CycleState& state) {
+                if(!state.hasC) {
+                    data.hadDataError = true;
+                    data.errorMessage = "No value on C bus to write to MDR.";
+                }
+                else data.onSetMemoryRegister(Enu::MEM_MDR, state.c);
+                return true;
+            });
+            break;
+        default:
+            append([](const CompiledMicroStep&, CPUDataSection& data, CycleState&) {
+                data.hadDataError = true;
+                data.errorMessage = "No value to clock into MDR.";
+                return true;
+            });
+            break;
+        }
+    }
+
+    // MDRECk
+    if(clock[Enu::MDRECk] && twoByte) {
+        switch(control[Enu::MDREMux]) {
+        case 0: // Pick memory
+            append([](const CompiledMicroStep&, CPUDataSection& data, CycleState&) {
+                auto address = static_cast<quint16>((data.memoryRegisters[Enu::MEM_MARA]<<8)
+                        | data.memoryRegisters[Enu::MEM_MARB]);
+                address &= 0xFFFE; // Memory access ignores lowest order bit
+                quint8 value = 0;
+                if(data.mainBusState != Enu::MemReadReady) {
+                    data.hadDataError = true;
+                    data.errorMessage = "No value from data bus to write to MDRE.";
+                    return false;
+                }
+                else if(!data.memDevice->readByte(address, value)) {
+                    data.hadDataError = true;
+                    data.errorMessage = "Unable to read from memory into MDRE.";
+                    return false;
+                }
+                data.onSetMemoryRegister(Enu::MEM_MDRE, value);
+                return true;
+            });
+            break;
+        case 1: // Pick C Bus
+            append([](const CompiledMicroStep&, CPUDataSection& data, CycleState& state) {
+                if(!state.hasC) {
+                    data.hadDataError = true;
+                    data.errorMessage = "No value on C bus to write to MDRE.";
+                    return false;
+                }
+                data.onSetMemoryRegister(Enu::MEM_MDRE, state.c);
+                return true;
+            });
+            break;
+        default:
+            append([](const CompiledMicroStep&, CPUDataSection& data, CycleState&) {
+                data.hadDataError = true;
+                data.errorMessage = "No value to clock into MDRE.";
+                return true;
+            });
+            break;
+        }
+    }
+
+    // MDROCk
+    if(clock[Enu::MDROCk] && twoByte) {
+        switch(control[Enu::MDROMux]) {
+        case 0: // Pick memory
+            append([](const CompiledMicroStep&, CPUDataSection& data, CycleState&) {
+                auto address = static_cast<quint16>((data.memoryRegisters[Enu::MEM_MARA]<<8)
+                        | data.memoryRegisters[Enu::MEM_MARB]);
+                address &= 0xFFFE; // Memory access ignores lowest order bit
+                address += 1;
+                quint8 value = 0;
+                if(data.mainBusState != Enu::MemReadReady) {
+                    data.hadDataError = true;
+                    data.errorMessage = "No value from data bus to write to MDRO.";
+                    return false;
+                }
+                else if(!data.memDevice->readByte(address, value)) {
+                    data.hadDataError = true;
+                    // Message matches the interpreter, which reports MDRE for both halves.
+                    data.errorMessage = "Unable to read from memory into MDRE.";
+                    return false;
+                }
+                data.onSetMemoryRegister(Enu::MEM_MDRO, value);
+                return true;
+            });
+            break;
+        case 1: // Pick C Bus
+            append([](const CompiledMicroStep&, CPUDataSection& data, CycleState& state) {
+                if(!state.hasC) {
+                    data.hadDataError = true;
+                    data.errorMessage = "No value on C bus to write to MDRO.";
+                    return false;
+                }
+                data.onSetMemoryRegister(Enu::MEM_MDRO, state.c);
+                return true;
+            });
+            break;
+        default:
+            append([](const CompiledMicroStep&, CPUDataSection& data, CycleState&) {
+                data.hadDataError = true;
+                data.errorMessage = "No value to clock into MDRO.";
+                return true;
+            });
+            break;
+        }
+    }
+
+    // NCk
+    if(clock[Enu::NCk]) {
+        append([](const CompiledMicroStep&, CPUDataSection& data, CycleState& state) {
+            if(state.hasALUOutput) data.onSetStatusBit(Enu::STATUS_N, Enu::NMask & state.NZVC);
+            else state.statusBitError = true;
+            return true;
+        });
+    }
+
+    // ZCk
+    if(clock[Enu::ZCk] && control[Enu::AndZ] == 0) {
+        append([](const CompiledMicroStep&, CPUDataSection& data, CycleState& state) {
+            if(state.hasALUOutput) data.onSetStatusBit(Enu::STATUS_Z, Enu::ZMask & state.NZVC);
+            else state.statusBitError = true;
+            return true;
+        });
+    }
+    else if(clock[Enu::ZCk] && control[Enu::AndZ] == 1) {
+        append([](const CompiledMicroStep&, CPUDataSection& data, CycleState& state) {
+            if(state.hasALUOutput) {
+                data.onSetStatusBit(Enu::STATUS_Z, static_cast<bool>((Enu::ZMask & state.NZVC)
+                                                                     && data.getStatusBit(Enu::STATUS_Z)));
+            }
+            else state.statusBitError = true;
+            return true;
+        });
+    }
+    else if(clock[Enu::ZCk]) {
+        // Without an AndZ selection, Z can never be clocked.
+        append([](const CompiledMicroStep&, CPUDataSection&, CycleState& state) {
+            state.statusBitError = true;
+            return true;
+        });
+    }
+
+    // VCk
+    if(clock[Enu::VCk]) {
+        append([](const CompiledMicroStep&, CPUDataSection& data, CycleState& state) {
+            if(state.hasALUOutput) data.onSetStatusBit(Enu::STATUS_V, Enu::VMask & state.NZVC);
+            else state.statusBitError = true;
+            return true;
+        });
+    }
+
+    // CCk
+    if(clock[Enu::CCk]) {
+        append([](const CompiledMicroStep&, CPUDataSection& data, CycleState& state) {
+            if(state.hasALUOutput) data.onSetStatusBit(Enu::STATUS_C, Enu::CMask & state.NZVC);
+            else state.statusBitError = true;
+            return true;
+        });
+    }
+
+    // SCk
+    if(clock[Enu::SCk]) {
+        append([](const CompiledMicroStep&, CPUDataSection& data, CycleState& state) {
+            if(state.hasALUOutput) data.onSetStatusBit(Enu::STATUS_S, Enu::CMask & state.NZVC);
+            else state.statusBitError = true;
+            return true;
+        });
+    }
+
+    if(usesStatus) {
+        append([](const CompiledMicroStep&, CPUDataSection& data, CycleState& state) {
+            if(state.statusBitError) {
+                data.hadDataError = true;
+                data.errorMessage = "ALU Error: No output from ALU to clock into status bits.";
+            }
+            return true;
+        });
+    }
+}
+
+void CompiledMicroStep::execute(CPUDataSection &data) const noexcept
+{
+    CycleState state;
+    for(int it = 0; it < opCount; it++) {
+        if(!operations[it](*this, data, state)) return;
+    }
+}
+
+int CompiledMicroStep::operationCount() const noexcept
+{
+    return opCount;
+}
+
+void CompiledMicroStep::append(Operation operation) noexcept
+{
+    Q_ASSERT(opCount < maxOperations);
+    operations[opCount++] = operation;
+}
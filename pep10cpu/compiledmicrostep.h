@@ -0,0 +1,64 @@
+#ifndef COMPILEDMICROSTEP_H
+#define COMPILEDMICROSTEP_H
+
+#include <array>
+#include "enu.h"
+class CPUDataSection;
+
+/*
+ * A line of microcode translated ahead of time into the operations that it enables.
+ *
+ * CPUDataSection::onStep() inspects every control and clock signal on every cycle, even though
+ * most lines of microcode only enable a handful of them. Compiling a line resolves the A, B, and C
+ * bus sources, the mux selections, and the ALU function once, and records an operation only for
+ * each clock the line actually raises. Executing the step runs that short list of operations in
+ * the same order as the interpreter, so both produce the same state and errors on every cycle.
+ *
+ * A compiled step depends only on the signals of its line and the width of the data bus,
+ * so a microprogram may be compiled once when a simulation starts.
+ */
+class CompiledMicroStep
+{
+public:
+    // A step without any signals. It only lets the main bus return to idle.
+    CompiledMicroStep() noexcept;
+    CompiledMicroStep(Enu::CPUType type, const Enu::ControlSignals& control,
+                      const Enu::ClockSignals& clock) noexcept;
+
+    // Perform a single cycle on the data section. Prefer CPUDataSection::stepCompiled(...),
+    // which also clears any errors left over from the previous cycle.
+    void execute(CPUDataSection& data) const noexcept;
+    // Number of operations performed each time this step is executed.
+    int operationCount() const noexcept;
+
+private:
+    // Values that are computed at the start of a cycle, before any register is clocked.
+    struct CycleState
+    {
+        quint8 c = 0, alu = 0, NZVC = 0;
+        bool hasC = false, hasALUOutput = false, statusBitError = false;
+    };
+    // An operation returns false if the rest of the cycle must be skipped,
+    // which is how the interpreter reacts to some errors.
+    using Operation = bool (*)(const CompiledMicroStep& step, CPUDataSection& data, CycleState& state);
+    // Where the ALU's A input comes from, as selected by AMux (and EOMux on the two byte bus).
+    enum class ALUSource : quint8
+    {
+        None, ABus, MDR, MDRE, MDRO
+    };
+    // Enough for a line that raises every clock on the two byte bus.
+    static constexpr int maxOperations = 16;
+
+    void append(Operation operation) noexcept;
+
+    std::array<Operation, maxOperations> operations {};
+    quint8 opCount = 0;
+
+    // Operands resolved from the control signals when the line was compiled.
+    quint8 aReg = Enu::signalDisabled, bReg = Enu::signalDisabled, cReg = Enu::signalDisabled;
+    quint8 aluFunc = Enu::signalDisabled, csMux = Enu::signalDisabled;
+    ALUSource aluSource = ALUSource::None;
+    bool memRead = false, memWrite = false, checkMARChanged = false;
+};
+
+#endif // COMPILEDMICROSTEP_H
@@ -1,4 +1,6 @@
 #include "cpudata.h"
+#include "alutables.h"
+#include "compiledmicrostep.h"
 #include "microcode.h"
 #include "microcodeprogram.h"
 #include "amemorydevice.h"
@@ -10,8 +12,8 @@
 #include <registerfile.h>
 CPUDataSection::CPUDataSection(Enu::CPUType type, QSharedPointer<AMemoryDevice> memDev, QObject *parent): QObject(parent), memDevice(std::move(memDev)),
     cpuFeatures(type), mainBusState(Enu::None),
-    registerBank(QSharedPointer<RegisterFile>::create()), memoryRegisters(6), controlSignals(Pep::numControlSignals()),
-    clockSignals(Pep::numClockSignals()), emitEvents(true), hadDataError(false), errorMessage(""),
+    registerBank(QSharedPointer<RegisterFile>::create()), memoryRegisters(6), controlSignals(),
+    clockSignals(), emitEvents(true), hadDataError(false), errorMessage(""),
     isALUCacheValid(false), ALUHasOutputCache(false), ALUOutputCache(0), ALUStatusBitCache(0)
 {
     presetStaticRegisters();
@@ -23,7 +25,7 @@ CPUDataSection::~CPUDataSection() = default;
 bool CPUDataSection::aluFnIsUnary() const
 {
     //The only alu functions that are unary are 0 & 10..15
-    return controlSignals[Enu::ALU] == 0 || controlSignals[Enu::ALU] >= 10;
+    return ALUTables::functionTraits[controlSignals[Enu::ALU]] & ALUTables::Unary;
 }
 
 bool CPUDataSection::getAMuxOutput(quint8& result) const
@@ -82,111 +84,39 @@ bool CPUDataSection::calculateALUOutput(quint8 &res, quint8 &NZVC) const
     }
     // This function should not set any errors.
     // Errors will be handled by step(..)
-    quint8 a, b;
+    quint8 a = 0, b = 0;
     bool carryIn = false;
     bool hasA = getAMuxOutput(a), hasB = valueOnBBus(b);
     bool hasCIn = calculateCSMuxOutput(carryIn);
-    if(!((aluFnIsUnary() && hasA) || (hasA && hasB))) {
+    return computeALUOutput(controlSignals[Enu::ALU], hasA, a, hasB, b, hasCIn, carryIn, res, NZVC);
+}
+
+bool CPUDataSection::computeALUOutput(quint8 aluFunc, bool hasA, quint8 a, bool hasB, quint8 b,
+                                      bool hasCIn, bool carryIn, quint8 &res, quint8 &NZVC) const
+{
+    const quint8 traits = ALUTables::functionTraits[aluFunc];
+    if(!(((traits & ALUTables::Unary) && hasA) || (hasA && hasB))) {
         // The ALU output calculation would not be meaningful given its current function and inputs
         isALUCacheValid = true;
         ALUHasOutputCache = false;
         return ALUHasOutputCache;
     }
-    // Unless otherwise noted, do not return true (sucessfully) early, or the calculation for the NZ bits will be skipped.
-    switch(controlSignals[Enu::ALU]) {
-    case Enu::A_func: // A
-        res = a;
-        break;
-    case Enu::ApB_func: // A plus B
-        res = a + b;
-        NZVC |= Enu::CMask * quint8{res<a||res<b}; // Carry out if result is unsigned less than a or b.
-        // There is a signed overflow iff the high order bits of the input are the same,
-        // and the inputs & output differs in sign.
-        // Shifts in 0's (unsigned chars), so after shift, only high order bit remain.
-        NZVC |= Enu::VMask * ((~(a ^ b) & (a ^ res)) >> 7) ;
-        break;
-    case Enu::ApnBp1_func: // A plus ~B plus 1
-        hasCIn = true;
-        carryIn = true;
-        [[fallthrough]];
-    case Enu::ApnBpCin_func: // A plus ~B plus Cin
-        // Clang thinks this is a garbage value. It isn't.
-        // Lots of "errors" spawn from this, but this is well-defined behavior.
-        b = ~b;
-        [[fallthrough]];
-    case Enu::ApBpCin_func: // A plus B plus Cin
-        // Expected carry in, none was provided, so ALU calculation yeilds a meaningless result
-        if (!hasCIn) return false;
-        // Might cause overflow, but overflow is well defined for unsigned ints
-        res = a + b + quint8{carryIn};
-        NZVC |= Enu::CMask * quint8{res<a||res<b}; // Carry out if result is unsigned less than a or b.
-        // There is a signed overflow iff the high order bits of the input are the same,
-        // and the inputs & output differs in sign.
-        // Shifts in 0's (unsigned chars), so after shift, only high order bit remain.
-        NZVC |= Enu::VMask * ((~(a ^ b) & (a ^ res)) >> 7) ;
-        break;
-    case Enu::AandB_func: // A * B
-        res = a & b;
-        break;
-    case Enu::nAandB_func: // ~(A * B)
-        res = ~(a & b);
-        break;
-    case Enu::AorB_func: // A + B
-        res = a | b;
-        break;
-    case Enu::nAorB_func: // ~(A + B)
-        res = ~(a | b);
-        break;
-    case Enu::AxorB_func: // A xor B
-        res = a ^ b;
-        break;
-    case Enu::nA_func: // ~A
-        res = ~a;
-        break;
-    case Enu::ASLA_func: // ASL A
-        res = static_cast<quint8>(a<<1);
-        NZVC |= Enu::CMask * ((a & 0x80) >> 7); // Carry out equals the hi order bit
-        NZVC |= Enu::VMask * (((a << 1) ^ a) >>7); // Signed overflow if a<hi> doesn't match a<hi-1>
-        break;
-    case Enu::ROLA_func: // ROL A
-        if (!hasCIn) return false;
-        res = static_cast<quint8>(a<<1 | quint8{carryIn});
-        NZVC |= Enu::CMask * ((a & 0x80) >> 7); // Carry out equals the hi order bit
-        NZVC |= Enu::VMask * (((a << 1) ^a) >>7); // Signed overflow if a<hi> doesn't match a<hi-1>
-        break;
-    case Enu::ASRA_func: // ASR A
-        hasCIn = true;
-        carryIn = a & 128; // RORA and ASRA only differ by how the carryIn is calculated
-        [[fallthrough]];
-    case Enu::RORA_func: // ROR a
-        if (!hasCIn) return false;
-        // A will not be sign extended since it is unsigned.
-        // Widen carryIn so that << yields a meaningful result.
-        res = static_cast<quint8>(a >> 1 | static_cast<quint8>(carryIn) << 7);
-        // Carry out is lowest order bit of a
-        NZVC |= Enu::CMask * (a & 1);
-        break;
-    case Enu::NZVCA_func: // Move A to NZVC
-        res = 0;
-        NZVC |= Enu::NMask & a;
-        NZVC |= Enu::ZMask & a;
-        NZVC |= Enu::VMask & a;
-        NZVC |= Enu::CMask & a;
-        return true; // Must return early to avoid NZ calculation
-    default: // If the default has been hit, then an invalid function was selected
+    // An invalid function was selected, or an expected carry in was not provided,
+    // so the ALU calculation yields a meaningless result.
+    if(!(traits & ALUTables::Defined) || ((traits & ALUTables::NeedsCarry) && !hasCIn)) {
         return false;
     }
-    // Calculate N, then shift to correct position
-    NZVC |= (res & 0x80) ? Enu::NMask : 0; // Result is negative if high order bit is 1
-    // Calculate Z, then shift to correct position
-    NZVC |= (res == 0) ? Enu::ZMask : 0;
+    const ALUTables::Output output = ALUTables::calculate(aluFunc, a, b, carryIn);
+    res = output.result;
+    NZVC |= output.NZVC;
+    // Moving A to NZVC produces no meaningful result, so it is not cached.
+    if(aluFunc == Enu::NZVCA_func) return true;
     // Save the result of the ALU calculation
     ALUOutputCache = res;
     ALUStatusBitCache = NZVC;
     isALUCacheValid = true;
     ALUHasOutputCache = true;
     return ALUHasOutputCache;
-
 }
 
 Enu::CPUType CPUDataSection::getCPUType() const
@@ -340,45 +270,19 @@ void CPUDataSection::onSetControlSignal(Enu::EControlSignals control, quint8 val
 }
 
 bool CPUDataSection::setSignalsFromMicrocode(const MicroCode *line)
-{ 
-    /*
-     * Verify that both arrays of control signals are the same length,
-     * so that memcpy is safe. Otherwise, raise an exception that must be dealt with
-     * informing the simulation that the CPU has an unrecoverable error.
-     *
-     * Memcpy was used instead of a for loop, as the original loop was profiled
-     * to be the most time consuming piece of the simulation. Memcpy yielded a ~30%
-     * increase in perfomance.
-     */
-    if(controlSignals.length() == line->getControlSignals().length()) {
-        // Memcpy is safe as long as both arrays match in size.
-        memcpy(controlSignals.data(),
-               line->getControlSignals().data(),
-               static_cast<std::size_t>(controlSignals.length()));
-    }
-    else {
-        hadDataError = true;
-        errorMessage = "Control signals did not match in length";
-        throw std::invalid_argument("Argument's # of control signals did not match internal \
-        number of control signals");
-    }
-
-    // Same verification as described above, except for clock signals.
-    if(clockSignals.length() == line->getClockSignals().length()) {
-        // Memcpy is safe as long as both arrays match in size.
-        memcpy(clockSignals.data(),
-               line->getClockSignals().data(),
-               static_cast<std::size_t>(clockSignals.length()));
-    }
-    else {
-        hadDataError = true;
-        errorMessage = "Clock signals did not match in length";
-        throw std::invalid_argument("Argument's # of clock signals did not match internal \
-        number of clock signals");
-    }
+{
+    // Both signal sets are fixed size, so they always match the microcode line
+    // and are copied in a few register-width moves.
+    setSignals(line->getControlSignals(), line->getClockSignals());
     return true;
 }
 
+void CPUDataSection::setSignals(const Enu::ControlSignals &control, const Enu::ClockSignals &clock) noexcept
+{
+    controlSignals = control;
+    clockSignals = clock;
+}
+
 void CPUDataSection::setEmitEvents(bool b)
 {
     emitEvents = b;
@@ -394,60 +298,61 @@ QString CPUDataSection::getErrorMessage() const
     return errorMessage;
 }
 
-void CPUDataSection::handleMainBusState() noexcept
+Enu::MainBusState CPUDataSection::nextMainBusState(Enu::MainBusState state, bool marChanged,
+                                                   bool memRead, bool memWrite) noexcept
 {
-    bool marChanged = false;
-    quint8 a, b;
-    if(clockSignals[Enu::MARCk] && valueOnABus(a) && valueOnBBus(b)) {
-        marChanged = !(a == memoryRegisters[Enu::MEM_MARA] && b == memoryRegisters[Enu::MEM_MARB]);
-    }
-    switch(mainBusState)
+    switch(state)
     {
     case Enu::None:
         //One cannot change MAR contents and initiate a R/W on same cycle
         if(!marChanged) {
-            if(controlSignals[Enu::MemRead] == 1) mainBusState = Enu::MemReadFirstWait;
-            else if(controlSignals[Enu::MemWrite] == 1) mainBusState = Enu::MemWriteFirstWait;
+            if(memRead) return Enu::MemReadFirstWait;
+            else if(memWrite) return Enu::MemWriteFirstWait;
         }
-        break;
+        return Enu::None;
     case Enu::MemReadFirstWait:
-        if(!marChanged && controlSignals[Enu::MemRead] == 1) mainBusState = Enu::MemReadSecondWait;
-        else if(marChanged && controlSignals[Enu::MemRead] == 1); //Initiating a new read brings us back to first wait
-        else if(controlSignals[Enu::MemWrite] == 1) mainBusState = Enu::MemWriteFirstWait; //Switch from read to write.
-        else mainBusState = Enu::None; //If neither are check, bus goes back to doing nothing
-        break;
+        if(!marChanged && memRead) return Enu::MemReadSecondWait;
+        else if(marChanged && memRead) return Enu::MemReadFirstWait; //Initiating a new read brings us back to first wait
+        else if(memWrite) return Enu::MemWriteFirstWait; //Switch from read to write.
+        else return Enu::None; //If neither are check, bus goes back to doing nothing
     case Enu::MemReadSecondWait:
-        if(!marChanged && controlSignals[Enu::MemRead] == 1) mainBusState = Enu::MemReadReady;
-        else if(marChanged && controlSignals[Enu::MemRead] == 1) mainBusState = Enu::MemReadFirstWait;
-        else if(controlSignals[Enu::MemWrite] == 1) mainBusState = Enu::MemWriteFirstWait;
-        else mainBusState = Enu::None; //If neither are check, bus goes back to doing nothing
-        break;
+        if(!marChanged && memRead) return Enu::MemReadReady;
+        else if(marChanged && memRead) return Enu::MemReadFirstWait;
+        else if(memWrite) return Enu::MemWriteFirstWait;
+        else return Enu::None; //If neither are check, bus goes back to doing nothing
     case Enu::MemReadReady:
-        if(controlSignals[Enu::MemRead] == 1) mainBusState = Enu::MemReadFirstWait; //Another MemRead will bring us back to first MemRead, regardless of it MarChanged
-        else if(controlSignals[Enu::MemWrite] == 1) mainBusState = Enu::MemWriteFirstWait;
-        else mainBusState = Enu::None; //If neither are check, bus goes back to doing nothing
-        break;
+        if(memRead) return Enu::MemReadFirstWait; //Another MemRead will bring us back to first MemRead, regardless of it MarChanged
+        else if(memWrite) return Enu::MemWriteFirstWait;
+        else return Enu::None; //If neither are check, bus goes back to doing nothing
     case Enu::MemWriteFirstWait:
-        if(!marChanged && controlSignals[Enu::MemWrite] == 1) mainBusState = Enu::MemWriteSecondWait;
-        else if(marChanged && controlSignals[Enu::MemWrite] == 1); //Initiating a new write brings us back to first wait
-        else if(controlSignals[Enu::MemRead] == 1) mainBusState = Enu::MemReadFirstWait; //Switch from write to read.
-        else mainBusState = Enu::None; //If neither are check, bus goes back to doing nothing
-        break;
+        if(!marChanged && memWrite) return Enu::MemWriteSecondWait;
+        else if(marChanged && memWrite) return Enu::MemWriteFirstWait; //Initiating a new write brings us back to first wait
+        else if(memRead) return Enu::MemReadFirstWait; //Switch from write to read.
+        else return Enu::None; //If neither are check, bus goes back to doing nothing
     case Enu::MemWriteSecondWait:
-        if(!marChanged && controlSignals[Enu::MemWrite] == 1) mainBusState = Enu::MemWriteReady;
-        else if(marChanged && controlSignals[Enu::MemWrite] == 1) mainBusState = Enu::MemWriteFirstWait; //Initiating a new write brings us back to first wait
-        else if(controlSignals[Enu::MemRead] == 1) mainBusState = Enu::MemReadFirstWait; //Switch from write to read.
-        else mainBusState = Enu::None; //If neither are check, bus goes back to doing nothing
-        break;
+        if(!marChanged && memWrite) return Enu::MemWriteReady;
+        else if(marChanged && memWrite) return Enu::MemWriteFirstWait; //Initiating a new write brings us back to first wait
+        else if(memRead) return Enu::MemReadFirstWait; //Switch from write to read.
+        else return Enu::None; //If neither are check, bus goes back to doing nothing
     case Enu::MemWriteReady:
-        if(controlSignals[Enu::MemWrite]==1)mainBusState = Enu::MemWriteFirstWait; //Another MemWrite will reset the bus state back to first MemWrite
-        else if(controlSignals[Enu::MemRead]==1) mainBusState = Enu::MemReadFirstWait; //Switch from write to read.
-        else mainBusState = Enu::None; //If neither are check, bus goes back to doing nothing
-        break;
+        if(memWrite) return Enu::MemWriteFirstWait; //Another MemWrite will reset the bus state back to first MemWrite
+        else if(memRead) return Enu::MemReadFirstWait; //Switch from write to read.
+        else return Enu::None; //If neither are check, bus goes back to doing nothing
     default:
-        mainBusState = Enu::None;
-        break;
+        return Enu::None;
+    }
+}
+
+void CPUDataSection::handleMainBusState() noexcept
+{
+    bool marChanged = false;
+    quint8 a, b;
+    if(clockSignals[Enu::MARCk] && valueOnABus(a) && valueOnBBus(b)) {
+        marChanged = !(a == memoryRegisters[Enu::MEM_MARA] && b == memoryRegisters[Enu::MEM_MARB]);
     }
+    mainBusState = nextMainBusState(mainBusState, marChanged,
+                                    controlSignals[Enu::MemRead] == 1,
+                                    controlSignals[Enu::MemWrite] == 1);
 }
 
 void CPUDataSection::stepOneByte() noexcept
@@ -771,17 +676,13 @@ void CPUDataSection::presetStaticRegisters() noexcept
 void CPUDataSection::clearControlSignals() noexcept
 {
     //Set all control signals to disabled
-    for(auto& controlSignal : controlSignals) {
-        controlSignal = Enu::signalDisabled;
-    }
+    controlSignals.fill(Enu::signalDisabled);
 }
 
 void CPUDataSection::clearClockSignals() noexcept
 {
     //Set all clock signals to low
-    for(auto& clockSignal : clockSignals) {
-        clockSignal = false;
-    }
+    clockSignals.reset();
 }
 
 void CPUDataSection::clearRegisters() noexcept
@@ -815,6 +716,14 @@ void CPUDataSection::onStep() noexcept
     }
 }
 
+void CPUDataSection::stepCompiled(const CompiledMicroStep &step) noexcept
+{
+    //If the error hasn't been handled by now, clear it
+    clearErrors();
+    isALUCacheValid = false;
+    step.execute(*this);
+}
+
 void CPUDataSection::onClock() noexcept
 {
     //When the clock button is pushed, execute whatever control signals are set, and the clear their values
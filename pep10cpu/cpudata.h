@@ -8,6 +8,7 @@
 #include <QString>
 #include "enu.h"
 class AMemoryDevice;
+class CompiledMicroStep;
 class InterfaceMCCPU;
 class MemorySection;
 class MicroCode;
@@ -17,6 +18,8 @@ class CPUDataSection: public QObject
     Q_OBJECT
     friend class CPUControlSection;
     friend class InterfaceMCCPU;
+    friend class CompiledMicroStep;
+    friend class MicroTraceRecorder;
 public:
     CPUDataSection(Enu::CPUType type, QSharedPointer<AMemoryDevice> memDevice, QObject *parent = nullptr );
     ~CPUDataSection() override;
@@ -44,7 +47,12 @@ public:
     bool getStatusBit(Enu::EStatusBit) const;
 
     bool setSignalsFromMicrocode(const MicroCode* line);
+    // Load the signals for the next cycle directly, e.g. from a linked microprogram.
+    void setSignals(const Enu::ControlSignals& control, const Enu::ClockSignals& clock) noexcept;
     void setEmitEvents(bool b);
+    // Execute one cycle of a precompiled line of microcode instead of interpreting the current signals.
+    // The signals of the line should still be loaded with setSignals(...) so that they may be displayed.
+    void stepCompiled(const CompiledMicroStep& step) noexcept;
     //Return information about errors on the last step
     bool hadErrorOnStep() const;
     QString getErrorMessage() const;
@@ -79,8 +87,8 @@ private:
     QVector<quint8> memoryRegisters;
 
     //Control Signals
-    QVector<quint8> controlSignals;
-    QVector<bool> clockSignals;
+    Enu::ControlSignals controlSignals;
+    Enu::ClockSignals clockSignals;
 
     //Error handling
     bool hadDataError;
@@ -99,7 +107,14 @@ private:
     void clearRegisters() noexcept;
     void clearErrors() noexcept;
 
+    // Compute the ALU's output from already resolved inputs, and cache the result for the rest of the cycle.
+    bool computeALUOutput(quint8 aluFunc, bool hasA, quint8 a, bool hasB, quint8 b,
+                          bool hasCIn, bool carryIn, quint8 &res, quint8 &NZVC) const;
+
     //Simulation stepping logic
+    // Transition of the main bus between cycles, given whether MAR changed and which memory signals are set.
+    static Enu::MainBusState nextMainBusState(Enu::MainBusState state, bool marChanged,
+                                              bool memRead, bool memWrite) noexcept;
     void handleMainBusState() noexcept;
     void stepOneByte() noexcept;
     void stepTwoByte() noexcept;
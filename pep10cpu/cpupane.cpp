@@ -36,6 +36,8 @@
 #include "pep.h"
 #include "microcode.h"
 #include "cpudata.h"
+#include "microcodeprogram.h"
+#include "simulationsnapshot.h"
 using namespace Enu;
 CpuPane::CpuPane( QWidget *parent) :
         QWidget(parent),
@@ -999,6 +1001,40 @@ void CpuPane::repaintOnScroll(int distance)
     cpuPaneItems->update();
 }
 
+void CpuPane::updateCpu(const SimulationSnapshot &snapshot)
+{
+    setRegister(Enu::Acc, snapshot.registerWord(CPURegisters::A));
+    setRegister(Enu::X, snapshot.registerWord(CPURegisters::X));
+    setRegister(Enu::SP, snapshot.registerWord(CPURegisters::SP));
+    setRegister(Enu::PC, snapshot.registerWord(CPURegisters::PC));
+    setRegister(Enu::Trap, snapshot.registerWord(CPURegisters::TR));
+    setRegister(Enu::IR, static_cast<int>(snapshot.registerByte(CPURegisters::IS)<<16) +
+                snapshot.registerWord(CPURegisters::OS));
+    setRegister(Enu::T1, snapshot.registerByte(CPURegisters::T1));
+    setRegister(Enu::T2, snapshot.registerWord(CPURegisters::T2));
+    setRegister(Enu::T3, snapshot.registerWord(CPURegisters::T3));
+    setRegister(Enu::T4, snapshot.registerWord(CPURegisters::T4));
+    setRegister(Enu::T5, snapshot.registerWord(CPURegisters::T5));
+    setRegister(Enu::MARAREG, snapshot.memoryRegister(Enu::MEM_MARA));
+    setRegister(Enu::MARBREG, snapshot.memoryRegister(Enu::MEM_MARB));
+    setRegister(Enu::MDRREG, snapshot.memoryRegister(Enu::MEM_MDR));
+    setRegister(Enu::MDROREG, snapshot.memoryRegister(Enu::MEM_MDRO));
+    setRegister(Enu::MDREREG, snapshot.memoryRegister(Enu::MEM_MDRE));
+    setStatusBit(Enu::N, snapshot.statusBit(Enu::STATUS_N));
+    setStatusBit(Enu::Z, snapshot.statusBit(Enu::STATUS_Z));
+    setStatusBit(Enu::V, snapshot.statusBit(Enu::STATUS_V));
+    setStatusBit(Enu::Cbit, snapshot.statusBit(Enu::STATUS_C));
+    setStatusBit(Enu::S, snapshot.statusBit(Enu::STATUS_S));
+    const MicroCode *code = simulatedProgram.isNull() ? nullptr : simulatedProgram->getCodeLine(snapshot.microPC);
+    if(code != nullptr) code->setCpuLabels(cpuPaneItems);
+    ui->graphicsView->invalidateScene();
+}
+
+void CpuPane::onSimulationStarted()
+{
+    simulatedProgram = cpu->getProgram();
+}
+
 void CpuPane::onSimulationUpdate()
 {
     setRegister(Enu::Acc, dataSection->getRegisterBankWord(CPURegisters::A));
@@ -35,6 +35,8 @@ namespace Ui {
 }
 class InterfaceMCCPU;
 class CPUDataSection;
+class MicrocodeProgram;
+struct SimulationSnapshot;
 class CpuPane : public QWidget {
     Q_OBJECT
 public:
@@ -61,6 +63,10 @@ public:
     void clearCpu();
     void clearCpuControlSignals();
 
+    // Display the registers and microcode line of a snapshot, rather than those of the CPU.
+    // Used while the simulation runs on another thread, as the data section may not be read then.
+    void updateCpu(const SimulationSnapshot& snapshot);
+
     // These are used by the main window in order to allow it to use the
     //  <enter> key to step.
     void clock();
@@ -74,6 +80,8 @@ protected:
     QGraphicsScene *scene;
     CpuGraphicsItems *cpuPaneItems {nullptr};
     Enu::CPUType type;
+    // The program being simulated, which can't change until the simulation finishes.
+    QSharedPointer<const MicrocodeProgram> simulatedProgram;
 
 private:
     Ui::CpuPane *ui;
@@ -95,6 +103,7 @@ public slots:
     void onMemoryRegisterChanged(Enu::EMemoryRegisters,quint8 oldVal,quint8 newVal);
     void onStatusBitChanged(Enu::EStatusBit,bool value);
     void repaintOnScroll(int distance);
+    void onSimulationStarted();
     void onSimulationUpdate();
     void onSimulationFinished();
     void onDarkModeChanged(bool darkMode, QString styleSheet);
@@ -2,6 +2,7 @@
 
 #include <utility>
 #include "microcodeprogram.h"
+#include "microtracerecorder.h"
 InterfaceMCCPU::InterfaceMCCPU(Enu::CPUType type) noexcept: microprogramCounter(0), microCycleCounter(0),
     microBreakpointHit(false), sharedProgram(nullptr), type(type)
 {
@@ -41,6 +42,16 @@ Enu::CPUType InterfaceMCCPU::getCPUType() const noexcept
     return type;
 }
 
+void InterfaceMCCPU::setTraceRecorder(QSharedPointer<MicroTraceRecorder> recorder) noexcept
+{
+    traceRecorder = std::move(recorder);
+}
+
+QSharedPointer<MicroTraceRecorder> InterfaceMCCPU::getTraceRecorder() const noexcept
+{
+    return traceRecorder;
+}
+
 void InterfaceMCCPU::reset() noexcept
 {
     microprogramCounter = 0;
@@ -24,6 +24,7 @@
 #include "enu.h"
 class MicroCode;
 class MicrocodeProgram;
+class MicroTraceRecorder;
 /*
  * InterfaceMCCPU describes the operations that may be performed on a microcoded
  * CPU. Inherit in combination with ACPUModel to form a complete description of
@@ -50,6 +51,11 @@ public:
     void setMicrocodeProgram(QSharedPointer<MicrocodeProgram> sharedProgram);
     Enu::CPUType getCPUType() const noexcept;
 
+    // Record the data section into recorder after every cycle, or stop recording if nullptr.
+    // The recorder is cleared whenever a simulation starts.
+    void setTraceRecorder(QSharedPointer<MicroTraceRecorder> recorder) noexcept;
+    QSharedPointer<MicroTraceRecorder> getTraceRecorder() const noexcept;
+
     // Clear program counters & breakpoint status
     void reset() noexcept;
 
@@ -79,6 +85,7 @@ protected:
     quint64 microCycleCounter;
     bool microBreakpointHit;
     QSharedPointer<MicrocodeProgram> sharedProgram;
+    QSharedPointer<MicroTraceRecorder> traceRecorder;
     Enu::CPUType type;
 };
 
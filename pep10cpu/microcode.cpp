@@ -30,11 +30,11 @@
 #include "cpudata.h"
 
 MicroCode::MicroCode(Enu::CPUType cpuType, bool useExtendedFatures): cpuType(cpuType),
-    controlSignals(Pep::numControlSignals(), Enu::signalDisabled),
-    clockSignals(Pep::numClockSignals(), false), breakpoint(false),
+    controlSignals(), clockSignals(), breakpoint(false),
     extendedFeatures(useExtendedFatures), branchFunc(Enu::Assembler_Assigned),
     symbol(nullptr), trueTargetAddr(nullptr), falseTargetAddr(nullptr)
 {
+    controlSignals.fill(Enu::signalDisabled);
     // Initialize all memory controls, normal controls, and clocklines to disabled.
     for(auto memLines : Pep::memControlToMnemonMap.keys()) {
         controlSignals[memLines] = Enu::signalDisabled;
@@ -330,7 +330,7 @@ quint8 MicroCode::getControlSignal(Enu::EControlSignals field) const
     return controlSignals[field];
 }
 
-const QVector<quint8> MicroCode::getControlSignals() const
+const Enu::ControlSignals &MicroCode::getControlSignals() const
 {
     return controlSignals;
 }
@@ -340,7 +340,7 @@ bool MicroCode::getClockSignal(Enu::EClockSignals field) const
     return clockSignals[field];
 }
 
-const QVector<bool> MicroCode::getClockSignals() const
+const Enu::ClockSignals &MicroCode::getClockSignals() const
 {
     return clockSignals;
 }
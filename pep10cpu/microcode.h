@@ -60,9 +60,9 @@ public:
     bool hasClockSignal(Enu::EClockSignals field) const;
 
     quint8 getControlSignal(Enu::EControlSignals field) const;
-    const QVector<quint8> getControlSignals() const;
+    const Enu::ControlSignals& getControlSignals() const;
     bool getClockSignal(Enu::EClockSignals field) const;
-    const QVector<bool> getClockSignals() const;
+    const Enu::ClockSignals& getClockSignals() const;
 
     bool hasBreakpoint() const;
     Enu::EBranchFunctions getBranchFunction() const;
@@ -83,8 +83,8 @@ public:
 
 private:
     Enu::CPUType cpuType;
-    QVector<quint8> controlSignals;
-    QVector<bool> clockSignals;
+    Enu::ControlSignals controlSignals;
+    Enu::ClockSignals clockSignals;
     QString cComment;
     bool breakpoint, extendedFeatures;
     Enu::EBranchFunctions branchFunc = Enu::Unconditional;
@@ -1,5 +1,6 @@
 #include "microcodeprogram.h"
 #include "microcode.h"
+#include "pep.h"
 #include "symbolentry.h"
 #include "symbolvalue.h"
 MicrocodeProgram::MicrocodeProgram()
@@ -61,6 +62,27 @@ MicrocodeProgram::MicrocodeProgram(QVector<AMicroCode*>objectCode, QSharedPointe
             line->setFalseTarget(static_cast<MicroCode*>(programVec[microcodeVec[it]])->getSymbol());
         }
     }
+    link();
+    decoderTable = buildDecoderTable(*symTable);
+    decoderTableRevision = Pep::microDecoderTablesRevision;
+}
+
+void MicrocodeProgram::link()
+{
+    linkedVec.clear();
+    linkedVec.reserve(microcodeVec.length());
+    for(int it = 0; it < microcodeVec.length(); it++) {
+        auto* line = static_cast<const MicroCode*>(programVec[microcodeVec[it]]);
+        LinkedMicroCode entry;
+        entry.line = line;
+        entry.controlSignals = line->getControlSignals();
+        entry.clockSignals = line->getClockSignals();
+        entry.branchFunction = line->getBranchFunction();
+        // Targets were assigned by the constructor, so they are never null.
+        entry.trueTarget = static_cast<quint16>(line->getTrueTarget()->getValue());
+        entry.falseTarget = static_cast<quint16>(line->getFalseTarget()->getValue());
+        linkedVec.append(entry);
+    }
 }
 
 QSharedPointer<const SymbolTable> MicrocodeProgram::getSymTable() const
@@ -118,3 +140,46 @@ int MicrocodeProgram::codeLength() const
     return microcodeVec.length();
 }
 
+const QVector<LinkedMicroCode> &MicrocodeProgram::getLinkedCode() const
+{
+    return linkedVec;
+}
+
+
+const MicroDecoderTable &MicrocodeProgram::getDecoderTable() const
+{
+    return decoderTable;
+}
+
+bool MicrocodeProgram::isDecoderTableCurrent() const
+{
+    return decoderTableRevision == Pep::microDecoderTablesRevision;
+}
+
+MicroDecoderTable MicrocodeProgram::buildDecoderTable(const SymbolTable &symbolTable)
+{
+    MicroDecoderTable table;
+    for(int it = 0; it <= 255; ++it) {
+        MicroDecoderEntry entry;
+        Enu::EMnemonic mnemon = Pep::decodeMnemonic[it];
+        if(Pep::isUnaryMap[mnemon] || Pep::isTrapMap[mnemon]) {
+            entry.flags |= MicroDecoderEntry::Unary;
+        }
+        // Instead of causing an error before execution starts,
+        // flag the entry as invalid so that the error can be caught at runtime.
+        // This allows microprogram fragments that do not define all instructions
+        // to be created, which is of instructional value to students
+        auto val = symbolTable.getValue(Pep::instSpecToMicrocodeInstrSymbol[it]);
+        if(val != nullptr && val->isDefined()) {
+            entry.flags |= MicroDecoderEntry::InstrValid;
+            entry.instrAddr = static_cast<quint16>(val->getValue());
+        }
+        val = symbolTable.getValue(Pep::instSpecToMicrocodeAddrSymbol[it]);
+        if(val != nullptr && val->isDefined()) {
+            entry.flags |= MicroDecoderEntry::AddrModeValid;
+            entry.addrModeAddr = static_cast<quint16>(val->getValue());
+        }
+        table[static_cast<quint8>(it)] = entry;
+    }
+    return table;
+}
@@ -2,15 +2,61 @@
 #define MICROCODEPROGRAM_H
 #include "enu.h"
 #include <QVector>
+#include <QSharedPointer>
+#include <array>
 class AMicroCode;
 class MicroCode;
 class SymbolTable;
+
+/*
+ * A line of microcode lowered into a form that can be executed without
+ * consulting the symbol table. Entries are produced once, when the program
+ * is constructed, as microcode programs are immutable while they run.
+ */
+struct LinkedMicroCode
+{
+    // The line this entry was lowered from, which still provides the (mutable) breakpoint flag.
+    const MicroCode* line;
+    Enu::ControlSignals controlSignals;
+    Enu::ClockSignals clockSignals;
+    Enu::EBranchFunctions branchFunction;
+    // Indices of the branch targets in the microcode listing.
+    quint16 trueTarget, falseTarget;
+};
+
+/*
+ * The decode step for a single instruction specifier: whether the instruction is unary at
+ * the hardware level, and the first lines of microcode implementing its addressing mode and
+ * instruction. Resolved from Pep::instSpecToMicrocode*Symbol through the program's symbol table.
+ */
+struct MicroDecoderEntry
+{
+    enum Flags : quint8
+    {
+        // The instruction symbol is defined, and instrAddr is the line it labels.
+        InstrValid = 0x01,
+        // The addressing mode symbol is defined, and addrModeAddr is the line it labels.
+        AddrModeValid = 0x02,
+        // IsUnary branches to its true target. All traps are unary at the hardware level.
+        Unary = 0x04,
+    };
+    quint16 instrAddr = 0, addrModeAddr = 0;
+    quint8 flags = 0;
+};
+using MicroDecoderTable = std::array<MicroDecoderEntry, 256>;
+
 class MicrocodeProgram
 {
 private:
     QSharedPointer<SymbolTable> symTable;
     QVector<AMicroCode*> programVec;
     QVector<int> preconditionsVec, postconditionsVec, microcodeVec;
+    QVector<LinkedMicroCode> linkedVec;
+    MicroDecoderTable decoderTable;
+    // Value of Pep::microDecoderTablesRevision when decoderTable was built.
+    quint32 decoderTableRevision = 0;
+    // Lower every line of microcode into linkedVec. Must run after branch targets are assigned.
+    void link();
 public:
     MicrocodeProgram();
     ~MicrocodeProgram();
@@ -24,6 +70,14 @@ public:
     const MicroCode* getCodeLine(quint16 codeLine) const;
     MicroCode* getCodeLine(quint16 codeLine);
     int codeLength() const;
+    // Lines of microcode lowered for execution, indexed the same as getCodeLine(...).
+    const QVector<LinkedMicroCode>& getLinkedCode() const;
+    // Decoder table built when the program was constructed. If the decoder symbols
+    // have since been edited, it is stale, and isDecoderTableCurrent() is false.
+    const MicroDecoderTable& getDecoderTable() const;
+    bool isDecoderTableCurrent() const;
+    // Resolve the current Pep:: decoder symbols against a symbol table.
+    static MicroDecoderTable buildDecoderTable(const SymbolTable& symbolTable);
 };
 
 #endif // MICROCODEPROGRAM_H
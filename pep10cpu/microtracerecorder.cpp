@@ -0,0 +1,286 @@
+#include "microtracerecorder.h"
+
+#include <algorithm>
+
+#include "cpudata.h"
+#include "registerfile.h"
+
+MicroTraceRecorder::MicroTraceRecorder(int arenaBytes, quint32 keyframeInterval):
+    arena(std::max(arenaBytes, maxRecordSize)), keyframeInterval(std::max(keyframeInterval, quint32{1}))
+{
+
+}
+
+MicroTraceRecorder::~MicroTraceRecorder() = default;
+
+bool MicroTraceRecorder::getUseRunLengthCompression() const noexcept
+{
+    return useRunLengthCompression;
+}
+
+void MicroTraceRecorder::setUseRunLengthCompression(bool useCompression) noexcept
+{
+    useRunLengthCompression = useCompression;
+    // A run may only continue the record immediately before it.
+    tail.runOffset = -1;
+    tail.deltaOffset = -1;
+}
+
+void MicroTraceRecorder::clear() noexcept
+{
+    keyframes.clear();
+    full = false;
+    firstCycle = 0;
+    count = 0;
+    tail = Cursor();
+    last = CycleState();
+}
+
+bool MicroTraceRecorder::record(quint64 cycle, quint16 microPC, bool prefetchValid, const CPUDataSection &data)
+{
+    if(full) return false;
+    else if(count == 0) firstCycle = cycle;
+    else if(cycle != firstCycle + count) return false;
+
+    CycleState current = capture(microPC, prefetchValid, data);
+    bool isKeyframe = count % keyframeInterval == 0;
+    std::array<quint8, maxRecordSize> buffer;
+    int length = encode(last, current, isKeyframe, buffer.data());
+    quint8* base = arena.data();
+
+    // A cycle that changed the state the same way as the previous one extends (or starts) a run.
+    if(useRunLengthCompression && !isKeyframe && tail.deltaOffset >= 0 && length == tail.deltaLength
+            && std::equal(buffer.begin(), buffer.begin() + length, base + tail.deltaOffset)) {
+        if(tail.runOffset >= 0 && base[tail.runOffset + 1] < 255) {
+            base[tail.runOffset + 1]++;
+            tail.runLength++;
+        }
+        else if(tail.end + 2 <= arena.size()) {
+            tail.runOffset = tail.end;
+            tail.runLength = 1;
+            base[tail.end++] = Repeat;
+            base[tail.end++] = 1;
+        }
+        else {
+            full = true;
+            return false;
+        }
+    }
+    else if(tail.end + length <= arena.size()) {
+        if(isKeyframe) keyframes.append({count, tail.end});
+        std::copy(buffer.begin(), buffer.begin() + length, base + tail.end);
+        tail.deltaOffset = tail.end;
+        tail.deltaLength = length;
+        tail.runOffset = -1;
+        tail.runLength = 0;
+        tail.end += length;
+    }
+    else {
+        full = true;
+        return false;
+    }
+    tail.index = count++;
+    last = current;
+    return true;
+}
+
+bool MicroTraceRecorder::truncateAfter(quint64 cycle)
+{
+    if(cycle < firstCycle || cycle - firstCycle >= count) return false;
+    quint64 index = cycle - firstCycle;
+    CycleState state;
+    Cursor cursor;
+    seek(index, state, cursor);
+    // If the cycle is in the middle of a run, shorten the run to end at it.
+    if(cursor.runOffset >= 0) arena[cursor.runOffset + 1] = static_cast<quint8>(cursor.runLength);
+    while(!keyframes.isEmpty() && keyframes.last().index > index) keyframes.removeLast();
+    tail = cursor;
+    last = state;
+    count = index + 1;
+    full = false;
+    return true;
+}
+
+quint64 MicroTraceRecorder::getFirstCycle() const noexcept
+{
+    return firstCycle;
+}
+
+quint64 MicroTraceRecorder::getCycleCount() const noexcept
+{
+    return count;
+}
+
+bool MicroTraceRecorder::isFull() const noexcept
+{
+    return full;
+}
+
+int MicroTraceRecorder::getBytesUsed() const noexcept
+{
+    return tail.end;
+}
+
+bool MicroTraceRecorder::stateAt(quint64 cycle, CycleState &state) const
+{
+    if(cycle < firstCycle || cycle - firstCycle >= count) return false;
+    Cursor cursor;
+    seek(cycle - firstCycle, state, cursor);
+    return true;
+}
+
+bool MicroTraceRecorder::restore(quint64 cycle, CPUDataSection &data) const
+{
+    CycleState state;
+    if(!stateAt(cycle, state)) return false;
+    restore(state, data);
+    return true;
+}
+
+void MicroTraceRecorder::restore(const CycleState &state, CPUDataSection &data)
+{
+    // Go through the data section's slots, so that any attached views are updated.
+    // The slots ignore the static registers, which never change.
+    for(quint8 reg = 0; reg <= Enu::maxRegisterNumber; reg++) {
+        data.onSetRegisterByte(reg, state.registers[reg]);
+    }
+    data.onSetStatusBit(Enu::STATUS_N, state.statusBits & Enu::NMask);
+    data.onSetStatusBit(Enu::STATUS_Z, state.statusBits & Enu::ZMask);
+    data.onSetStatusBit(Enu::STATUS_V, state.statusBits & Enu::VMask);
+    data.onSetStatusBit(Enu::STATUS_C, state.statusBits & Enu::CMask);
+    data.onSetStatusBit(Enu::STATUS_S, state.statusBits & Enu::SMask);
+    data.getRegisterBank().flattenFile();
+    for(int reg = Enu::MEM_MARA; reg <= Enu::MEM_MDRE; reg++) {
+        data.onSetMemoryRegister(static_cast<Enu::EMemoryRegisters>(reg), state.memoryRegisters[static_cast<std::size_t>(reg)]);
+    }
+    data.mainBusState = state.busState;
+    data.isALUCacheValid = false;
+    data.clearErrors();
+}
+
+MicroTraceRecorder::CycleState MicroTraceRecorder::capture(quint16 microPC, bool prefetchValid, const CPUDataSection &data)
+{
+    CycleState state;
+    state.microPC = microPC;
+    state.prefetchValid = prefetchValid;
+    state.busState = data.getMainBusState();
+    state.statusBits = data.getRegisterBank().readStatusBitsCurrent();
+    for(int reg = Enu::MEM_MARA; reg <= Enu::MEM_MDRE; reg++) {
+        state.memoryRegisters[static_cast<std::size_t>(reg)] = data.getMemoryRegister(static_cast<Enu::EMemoryRegisters>(reg));
+    }
+    for(quint8 reg = 0; reg <= Enu::maxRegisterNumber; reg++) {
+        state.registers[reg] = data.getRegisterBankByte(reg);
+    }
+    return state;
+}
+
+int MicroTraceRecorder::encode(const CycleState &from, const CycleState &to, bool keyframe, quint8 *out)
+{
+    quint8 flags = keyframe ? Keyframe : 0;
+    if(to.prefetchValid) flags |= PrefetchValid;
+    int size = 1;
+    if(keyframe || to.microPC != static_cast<quint16>(from.microPC + 1)) {
+        flags |= MicroPCJump;
+        out[size++] = static_cast<quint8>(to.microPC);
+        out[size++] = static_cast<quint8>(to.microPC >> 8);
+    }
+    if(keyframe || to.busState != from.busState) {
+        flags |= BusState;
+        out[size++] = static_cast<quint8>(to.busState);
+    }
+    if(keyframe || to.statusBits != from.statusBits) {
+        flags |= StatusBits;
+        out[size++] = to.statusBits;
+    }
+
+    quint8 memoryMask = 0;
+    for(std::size_t reg = 0; reg < to.memoryRegisters.size(); reg++) {
+        if(keyframe || to.memoryRegisters[reg] != from.memoryRegisters[reg]) memoryMask |= 1 << reg;
+    }
+    if(memoryMask != 0) {
+        flags |= MemoryRegisters;
+        out[size++] = memoryMask;
+        for(std::size_t reg = 0; reg < to.memoryRegisters.size(); reg++) {
+            if(memoryMask & (1 << reg)) out[size++] = to.memoryRegisters[reg];
+        }
+    }
+
+    quint32 registerMask = 0;
+    for(std::size_t reg = 0; reg < to.registers.size(); reg++) {
+        if(keyframe || to.registers[reg] != from.registers[reg]) registerMask |= quint32{1} << reg;
+    }
+    if(registerMask != 0) {
+        flags |= Registers;
+        for(int byte = 0; byte < 4; byte++) {
+            out[size++] = static_cast<quint8>(registerMask >> (8 * byte));
+        }
+        for(std::size_t reg = 0; reg < to.registers.size(); reg++) {
+            if(registerMask & (quint32{1} << reg)) out[size++] = to.registers[reg];
+        }
+    }
+    out[0] = flags;
+    return size;
+}
+
+int MicroTraceRecorder::decode(int offset, CycleState &state) const
+{
+    const quint8* start = arena.constData() + offset;
+    const quint8* at = start;
+    quint8 flags = *at++;
+    if(flags & Keyframe) state = CycleState();
+    state.prefetchValid = flags & PrefetchValid;
+    if(flags & MicroPCJump) {
+        state.microPC = static_cast<quint16>(at[0] | at[1] << 8);
+        at += 2;
+    }
+    else state.microPC++;
+    if(flags & BusState) state.busState = static_cast<Enu::MainBusState>(*at++);
+    if(flags & StatusBits) state.statusBits = *at++;
+    if(flags & MemoryRegisters) {
+        quint8 memoryMask = *at++;
+        for(std::size_t reg = 0; reg < state.memoryRegisters.size(); reg++) {
+            if(memoryMask & (1 << reg)) state.memoryRegisters[reg] = *at++;
+        }
+    }
+    if(flags & Registers) {
+        quint32 registerMask = quint32{at[0]} | quint32{at[1]} << 8 | quint32{at[2]} << 16 | quint32{at[3]} << 24;
+        at += 4;
+        for(std::size_t reg = 0; reg < state.registers.size(); reg++) {
+            if(registerMask & (quint32{1} << reg)) state.registers[reg] = *at++;
+        }
+    }
+    return static_cast<int>(at - start);
+}
+
+void MicroTraceRecorder::seek(quint64 index, CycleState &state, Cursor &cursor) const
+{
+    // Start from the last keyframe at or before index. The first record is always a keyframe.
+    auto keyframe = std::upper_bound(keyframes.cbegin(), keyframes.cend(), index,
+                                     [](quint64 value, const KeyframeEntry& frame) { return value < frame.index; });
+    --keyframe;
+    cursor = Cursor();
+    cursor.index = keyframe->index;
+    cursor.deltaOffset = keyframe->offset;
+    cursor.deltaLength = decode(keyframe->offset, state);
+    cursor.end = keyframe->offset + cursor.deltaLength;
+
+    const quint8* base = arena.constData();
+    while(cursor.index < index) {
+        if(base[cursor.end] == Repeat) {
+            quint64 repeats = std::min<quint64>(base[cursor.end + 1], index - cursor.index);
+            for(quint64 it = 0; it < repeats; it++) decode(cursor.deltaOffset, state);
+            cursor.index += repeats;
+            cursor.runOffset = cursor.end;
+            cursor.runLength = static_cast<int>(repeats);
+            cursor.end += 2;
+        }
+        else {
+            cursor.deltaOffset = cursor.end;
+            cursor.deltaLength = decode(cursor.end, state);
+            cursor.runOffset = -1;
+            cursor.runLength = 0;
+            cursor.end += cursor.deltaLength;
+            cursor.index++;
+        }
+    }
+}
@@ -0,0 +1,126 @@
+#ifndef MICROTRACERECORDER_H
+#define MICROTRACERECORDER_H
+
+#include <array>
+#include <QVector>
+#include "enu.h"
+class CPUDataSection;
+
+/*
+ * Records the state of a data section after every cycle, so that it may be analyzed offline
+ * or rebuilt at any earlier cycle ("time travel" debugging).
+ *
+ * A record only stores what changed since the previous cycle: the microprogram counter (unless
+ * it advanced to the next line), the main bus state, the status bits, MARA, MARB, and the MDRs,
+ * and the registers in the register bank. Every keyframeInterval cycles, a keyframe stores the
+ * full state instead, so that rebuilding a cycle only decodes the records since the nearest
+ * keyframe. Records are appended to an arena allocated up front; once it is full, recording stops
+ * rather than allocating or discarding history. With run length compression enabled, a cycle whose
+ * record is identical to the previous one (e.g. the wait states of a memory access) extends a run
+ * instead of being stored again.
+ *
+ * Control and clock signals are not recorded, since they are determined by the microprogram
+ * counter and the microprogram. Neither is memory, so rewinding a data section does not undo
+ * memory writes.
+ */
+class MicroTraceRecorder
+{
+public:
+    // Everything recorded about a single cycle, after the cycle executed.
+    struct CycleState
+    {
+        // The line of microcode to be executed in the following cycle.
+        quint16 microPC = 0;
+        bool prefetchValid = false;
+        Enu::MainBusState busState = Enu::None;
+        quint8 statusBits = 0;
+        // Indexed by Enu::EMemoryRegisters.
+        std::array<quint8, 5> memoryRegisters {};
+        std::array<quint8, Enu::maxRegisterNumber + 1> registers {};
+    };
+
+    explicit MicroTraceRecorder(int arenaBytes = 1 << 24, quint32 keyframeInterval = 4096);
+    ~MicroTraceRecorder();
+
+    bool getUseRunLengthCompression() const noexcept;
+    void setUseRunLengthCompression(bool useCompression) noexcept;
+
+    // Discard all records.
+    void clear() noexcept;
+    // Record the state of data after cycle number cycle. Cycles must be recorded consecutively,
+    // starting from any cycle number. Returns false, and stops recording, if the arena is full.
+    bool record(quint64 cycle, quint16 microPC, bool prefetchValid, const CPUDataSection& data);
+    // Discard every record after cycle, so that recording may resume from it after rewinding.
+    bool truncateAfter(quint64 cycle);
+
+    // Range of recorded cycles, [first, first + count).
+    quint64 getFirstCycle() const noexcept;
+    quint64 getCycleCount() const noexcept;
+    bool isFull() const noexcept;
+    int getBytesUsed() const noexcept;
+
+    // Rebuild the state after a recorded cycle. Returns false if the cycle was not recorded.
+    bool stateAt(quint64 cycle, CycleState& state) const;
+    // Load the registers, status bits, memory registers, and bus state of a recorded cycle
+    // into data. Memory and signals are unchanged. Returns false if the cycle was not recorded.
+    bool restore(quint64 cycle, CPUDataSection& data) const;
+    static void restore(const CycleState& state, CPUDataSection& data);
+
+private:
+    // Flags in the first byte of a record, which determine the fields that follow.
+    enum RecordFlags : quint8
+    {
+        // The microprogram counter follows, otherwise it is one more than the previous.
+        MicroPCJump = 0x01,
+        BusState = 0x02,
+        StatusBits = 0x04,
+        // A mask of changed memory registers follows, and then their values.
+        MemoryRegisters = 0x08,
+        // A 32 bit mask of changed registers follows, and then their values.
+        Registers = 0x10,
+        // Not a change flag; the value of the prefetch valid bit.
+        PrefetchValid = 0x20,
+        // Applies to the zeroed state, rather than the previous cycle.
+        Keyframe = 0x40,
+        // The previous record is applied as many more times as the following byte specifies.
+        Repeat = 0x80,
+    };
+    // Size of the largest record, which is a keyframe.
+    static constexpr int maxRecordSize = 1 + 2 + 1 + 1 + 1 + 5 + 4 + (Enu::maxRegisterNumber + 1);
+
+    struct KeyframeEntry
+    {
+        quint64 index;
+        int offset;
+    };
+    // Position in the arena after decoding up to some record.
+    struct Cursor
+    {
+        quint64 index = 0;
+        // Offset past the last decoded record.
+        int end = 0;
+        // Most recent record that was not a repeat, and the repeat that follows it, if any.
+        int deltaOffset = -1, deltaLength = 0, runOffset = -1;
+        // Number of repetitions of the run that were decoded.
+        int runLength = 0;
+    };
+
+    static CycleState capture(quint16 microPC, bool prefetchValid, const CPUDataSection& data);
+    static int encode(const CycleState& from, const CycleState& to, bool keyframe, quint8* out);
+    // Apply the record at offset to state, returning the length of the record.
+    int decode(int offset, CycleState& state) const;
+    // Decode the records up to and including index, which must have been recorded.
+    void seek(quint64 index, CycleState& state, Cursor& cursor) const;
+
+    QVector<quint8> arena;
+    QVector<KeyframeEntry> keyframes;
+    quint32 keyframeInterval;
+    bool useRunLengthCompression = true;
+    bool full = false;
+    quint64 firstCycle = 0, count = 0;
+    // Write position and repetition state after the last record.
+    Cursor tail;
+    CycleState last;
+};
+
+#endif // MICROTRACERECORDER_H
@@ -8,6 +8,7 @@
 #include "interrupthandler.h"
 #include "microcode.h"
 #include "microcodeprogram.h"
+#include "microtracerecorder.h"
 #include "partialmicrocodedmemoizer.h"
 #include "pep.h"
 #include "registerfile.h"
@@ -101,6 +102,7 @@ void PartialMicrocodedCPU::onSimulationStarted()
     microBreakpointHit = false;
     memoizer->clear();
     memory->clearErrors();
+    if(traceRecorder) traceRecorder->clear();
     ACPUModel::handler->clearQueuedInterrupts();
 }
 
@@ -203,26 +205,12 @@ void PartialMicrocodedCPU::onMCStep()
     // Do step logic
     const MicroCode* prog = sharedProgram->getCodeLine(microprogramCounter);
 
-    try {
-        data->setSignalsFromMicrocode(prog);
-    }
-    /*
-     * An invalid_argument execption will be thrown if data's memcpy would fail.
-     * By catching this exception, we convert a hard failure to a friendly error message
-     * for the user application. Any other exceptions should crash the program, because
-     * we do not expect other issues to arise from memcpy.
-     *
-     * Since exceptions are zero-cost during error-free execution, and failing to set microcode
-     * signals would be irreparable, the decisions to communicate failure through execptions
-     * was made as a perfomance decision.
-     */
-    catch (std::invalid_argument &) {
-        return;
-    }
+    data->setSignalsFromMicrocode(prog);
 
     data->onStep();
     branchHandler();
     microCycleCounter++;
+    if(traceRecorder) traceRecorder->record(microCycleCounter, microprogramCounter, false, *data);
     //qDebug().nospace().noquote() << prog->getSourceCode();
 
     if(/*microprogramCounter == 0 ||*/ executionFinished) {
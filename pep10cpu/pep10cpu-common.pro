@@ -4,6 +4,9 @@
 QT += webenginewidgets widgets printsupport concurrent
 INCLUDEPATH += $$PWD\..\pep10common
 VPATH += $$PWD\..\pep10common
+# The ALU tables in alutables.h are generated at compile time, which takes
+# more constant evaluation steps than MSVC allows by default.
+win32-msvc*: QMAKE_CXXFLAGS += /constexpr:steps10000000
 
 FORMS += \
     cpupane.ui \
@@ -11,6 +14,8 @@ FORMS += \
     microobjectcodepane.ui \
 
 HEADERS += \
+    alutables.h \
+    compiledmicrostep.h \
     cpudata.h \
     cpupane.h \
     cpugraphicsitems.h \
@@ -21,6 +26,7 @@ HEADERS += \
     microcodeeditor.h \
     microcodepane.h \
     microcodeprogram.h \
+    microtracerecorder.h \
     microobjectcodepane.h \
     partialmicrocodedcpu.h \
     partialmicrocodedmemoizer.h \
@@ -32,6 +38,7 @@ HEADERS += \
     tristatelabel.h \
 
 SOURCES += \
+    compiledmicrostep.cpp \
     cpudata.cpp \
     cpupane.cpp \
     cpugraphicsitems.cpp \
@@ -42,6 +49,7 @@ SOURCES += \
     microcodeeditor.cpp \
     microcodepane.cpp \
     microcodeprogram.cpp \
+    microtracerecorder.cpp \
     microobjectcodepane.cpp \
     partialmicrocodedcpu.cpp \
     partialmicrocodedmemoizer.cpp \
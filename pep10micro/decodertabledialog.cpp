@@ -102,4 +102,5 @@ void DecoderTableDelegate::setModelData(QWidget *editor, QAbstractItemModel *mod
     else if(index.column() == 2){
         Pep::instSpecToMicrocodeAddrSymbol[index.row()] = index.data().toString();
     }
+    Pep::microDecoderTablesRevision++;
 }
@@ -1,6 +1,6 @@
 #include "fullmicrocodedcpu.h"
 
-#include <QApplication>
+#include <algorithm>
 #include <QTimer>
 
 #include "amemorydevice.h"
@@ -8,10 +8,14 @@
 #include "cpudata.h"
 #include "fullmicrocodedmemoizer.h"
 #include "interrupthandler.h"
+#include "isaprofiler.h"
+#include "memoryaccessstats.h"
 #include "microcode.h"
 #include "microcodeprogram.h"
+#include "microtracerecorder.h"
 #include "pep.h"
 #include "registerfile.h"
+#include "simulationsnapshot.h"
 #include "symbolentry.h"
 FullMicrocodedCPU::FullMicrocodedCPU(const AsmProgramManager* manager, QSharedPointer<AMemoryDevice> memoryDev, QObject* parent) noexcept: ACPUModel (memoryDev, parent),
     InterfaceMCCPU(Enu::CPUType::TwoByteDataBus),
@@ -45,9 +49,98 @@ bool FullMicrocodedCPU::atMicroprogramStart() const noexcept
     return rVal;
 }
 
+bool FullMicrocodedCPU::getPrefetchValid() const noexcept
+{
+    return isPrefetchValid;
+}
+
 void FullMicrocodedCPU::setMicroPCToStart() noexcept
 {
     microprogramCounter = startLine;
+    recordingKey = -1;
+}
+
+void FullMicrocodedCPU::loadArchitecturalState(const RegisterFile &registers, int callDepth)
+{
+    // Clears bus state, memory registers, and temporaries, while re-presetting the constant registers.
+    data->onClearCPU();
+    data->getRegisterBank().copyArchitecturalState(registers);
+    this->callDepth = callDepth;
+    // Waits pending from whoever used memory before, such as an ISA level CPU sharing a cache, are not ours.
+    memory->takeWaitCycles();
+    microprogramCounter = startLine;
+    isPrefetchValid = false;
+    recordingKey = -1;
+    controlError = false;
+    errorMessage = "";
+    executionFinished = false;
+    microBreakpointHit = false;
+    asmBreakpointHit = false;
+}
+
+bool FullMicrocodedCPU::rewindToCycle(quint64 cycle)
+{
+    MicroTraceRecorder::CycleState state;
+    if(traceRecorder.isNull() || !traceRecorder->stateAt(cycle, state)) return false;
+    MicroTraceRecorder::restore(state, *data);
+    // Recording continues from the restored cycle.
+    traceRecorder->truncateAfter(cycle);
+    microprogramCounter = state.microPC;
+    isPrefetchValid = state.prefetchValid;
+    microCycleCounter = cycle;
+    // Waits are only added as instructions finish, so undo those of every instruction finished after cycle.
+    auto undone = std::upper_bound(waitCheckpoints.begin(), waitCheckpoints.end(), cycle,
+                                   [](quint64 target, const QPair<quint64, quint64>& checkpoint) {
+        return target < checkpoint.first;
+    });
+    if(undone != waitCheckpoints.end()) {
+        memoryWaitCycles = undone->second;
+        waitCheckpoints.erase(undone, waitCheckpoints.end());
+    }
+    memory->takeWaitCycles();
+    // Rewinding into an earlier instruction must not leave it starting in the future.
+    instructionStartCycle = std::min(instructionStartCycle, cycle);
+    recordingKey = -1;
+    controlError = false;
+    errorMessage = "";
+    executionFinished = false;
+    microBreakpointHit = false;
+    asmBreakpointHit = false;
+    return true;
+}
+
+bool FullMicrocodedCPU::getUseInstructionSummaries() const noexcept
+{
+    return useInstructionSummaries;
+}
+
+void FullMicrocodedCPU::setUseInstructionSummaries(bool useSummaries) noexcept
+{
+    useInstructionSummaries = useSummaries;
+    recordingKey = -1;
+}
+
+bool FullMicrocodedCPU::getUseCompiledMicrocode() const noexcept
+{
+    return useCompiledMicrocode;
+}
+
+void FullMicrocodedCPU::setUseCompiledMicrocode(bool useCompiled) noexcept
+{
+    useCompiledMicrocode = useCompiled;
+}
+
+SimulationSnapshot FullMicrocodedCPU::captureSnapshot() const
+{
+    SimulationSnapshot snapshot = ACPUModel::captureSnapshot();
+    for(int reg = static_cast<int>(Enu::CPURegisters::T1); reg < static_cast<int>(snapshot.registers.size()); reg++) {
+        snapshot.registers[static_cast<std::size_t>(reg)] = data->getRegisterBankByte(static_cast<quint8>(reg));
+    }
+    for(int reg = Enu::MEM_MARA; reg <= Enu::MEM_MDRE; reg++) {
+        snapshot.memoryRegisters[static_cast<std::size_t>(reg)] = data->getMemoryRegister(static_cast<Enu::EMemoryRegisters>(reg));
+    }
+    snapshot.microPC = microprogramCounter;
+    return snapshot;
 }
 
 bool FullMicrocodedCPU::getStatusBitCurrent(Enu::EStatusBit bit) const
@@ -122,8 +215,23 @@ void FullMicrocodedCPU::onSimulationStarted()
         startLine = 0;
     }
     memoizer->clear();
-    calculateInstrJT();
-    calculateAddrJT();
+    linkedProgram = sharedProgram->getLinkedCode();
+    compiledProgram.clear();
+    compiledProgram.reserve(linkedProgram.size());
+    for(const auto& line : linkedProgram) {
+        compiledProgram.append(CompiledMicroStep(Enu::CPUType::TwoByteDataBus,
+                                                 line.controlSignals, line.clockSignals));
+    }
+    if(sharedProgram->isDecoderTableCurrent()) {
+        decoderTable = sharedProgram->getDecoderTable();
+    } else {
+        decoderTable = MicrocodeProgram::buildDecoderTable(*sharedProgram->getSymTable());
+    }
+    // Paths depend on the microprogram and its decoder tables, so summaries can't outlive a simulation.
+    summaries.fill(InstructionSummary());
+    recordingKey = -1;
+    if(traceRecorder) traceRecorder->clear();
+    waitCheckpoints.clear();
     ACPUModel::handler->clearQueuedInterrupts();
 }
 
@@ -219,6 +327,9 @@ void FullMicrocodedCPU::onResetCPU()
     // Reset all internal state, but keep loaded micropgoram & breakpoints
     data->onClearCPU();
     ACPUModel::memory->clearErrors();
+    ACPUModel::memory->clearStatistics();
+    memoryWaitCycles = 0;
+    waitCheckpoints.clear();
     memoizer->clear();
     InterfaceMCCPU::reset();
     InterfaceISACPU::reset();
@@ -228,6 +339,7 @@ void FullMicrocodedCPU::onResetCPU()
     controlError = false;
     executionFinished = false;
     isPrefetchValid = false;
+    recordingKey = -1;
     errorMessage = "";
     microBreakpointHit = false;
     asmBreakpointHit = false;
@@ -240,70 +352,60 @@ void FullMicrocodedCPU::onMCStep()
     asmBreakpointHit = false;
 
     if(microprogramCounter == startLine) {
-        // Store PC at the start of the cycle, so that we know where the instruction started from.
-        // Also store any other values needed for detailed statistics.
-        // Also, must initialize InterfaceISACPU:opValCache here for FullMicrocoded CPU
-        // to fulfill its contract with InterfaceISACPU.
-        memoizer->storeStateInstrStart();
-        memory->onCycleStarted();
-        InterfaceISACPU::calculateStackChangeStart(this->getCPURegByteStart(Enu::CPURegisters::IS));
+        onInstructionStarted();
+        // Record the path of this instruction if it has not been summarized yet.
+        if(useInstructionSummaries) {
+            int key = summaryKey();
+            if(summaries[static_cast<std::size_t>(key)].state == InstructionSummary::State::Unrecorded) {
+                recordingKey = key;
+                summaries[static_cast<std::size_t>(key)].path.clear();
+            }
+        }
+    }
+    if(recordingKey >= 0) {
+        InstructionSummary& summary = summaries[static_cast<std::size_t>(recordingKey)];
+        if(summary.path.size() < maxSummaryLength) {
+            summary.path.append(microprogramCounter);
+        }
+        else {
+            summary.state = InstructionSummary::State::Rejected;
+            summary.path.clear();
+            recordingKey = -1;
+        }
     }
 
     // Do step logic
-    const MicroCode* prog = sharedProgram->getCodeLine(microprogramCounter);
+    const LinkedMicroCode& prog = linkedProgram.constData()[microprogramCounter];
 
     this->setSignalsFromMicrocode(prog);
-    try {
-        data->setSignalsFromMicrocode(prog);
-    }
-    /*
-     * An invalid_argument execption will be thrown if data's memcpy would fail.
-     * By catching this exception, we convert a hard failure to a friendly error message
-     * for the user application. Any other exceptions should crash the program, because
-     * we do not expect other issues to arise from memcpy.
-     *
-     * Since exceptions are zero-cost during error-free execution, and failing to set microcode
-     * signals would be irreparable, the decisions to communicate failure through execptions
-     * was made as a perfomance decision.
-     */
-    catch (std::invalid_argument &) {
-        return;
-    }
+    data->setSignals(prog.controlSignals, prog.clockSignals);
 
     // Step inside the data section, then hnalde updating microprogram counter.
-    data->onStep();
+    if(useCompiledMicrocode) data->stepCompiled(compiledProgram.constData()[microprogramCounter]);
+    else data->onStep();
     branchHandler();
     microCycleCounter++;
+    if(traceRecorder) traceRecorder->record(microCycleCounter, microprogramCounter, isPrefetchValid, *data);
 
     // If we just finished an entire ISA level instruction, perform additional
     // simulation logic needed to mantain ISA level state.
     if(microprogramCounter == startLine || executionFinished) {
-        quint16 progCounter = getCPURegWordStart(Enu::CPURegisters::PC);
-        InterfaceISACPU::calculateStackChangeEnd(this->getCPURegByteCurrent(Enu::CPURegisters::IS),
-                                                 this->getCPURegWordCurrent(Enu::CPURegisters::OS),
-                                                 this->getCPURegWordStart(Enu::CPURegisters::SP),
-                                                 this->getCPURegWordStart(Enu::CPURegisters::PC),
-                                                 this->getCPURegWordCurrent(Enu::CPURegisters::A));
-        memoizer->storeStateInstrEnd();
-        updateAtInstructionEnd();
-        emit asmInstructionFinished();
-        asmInstructionCounter++;
-        // qDebug().noquote().nospace() << memoizer->memoize();
-        data->getRegisterBank().flattenFile();
-        // If execution finished on this instruction, then restore original starting program counter,
-        // as the instruction at the current program counter will not be executed.
-        if(executionFinished) {
-            data->getRegisterBank().writePCStart(progCounter);
-            emit simulationFinished();
-        }
-
+        if(recordingKey >= 0) {
+            InstructionSummary& summary = summaries[static_cast<std::size_t>(recordingKey)];
+            // Only an instruction that returned to the start of the cycle may be replayed.
+            if(microprogramCounter == startLine && !executionFinished && !hadErrorOnStep()) {
+                summary.state = InstructionSummary::State::Recorded;
+            }
+            else summary.path.clear();
+            recordingKey = -1;
+        }
+        onInstructionFinished();
     }
 
     // Modulus must be greater than 1, or there will be no gaurentee of forward progress.
     // If modulus were 1, then debug debug breakpoints that were signaled externally
     // during process events would never be cleared by branch handler.
-    if(microCycleCounter % 5000 == 0) {
-        QApplication::processEvents();
+    if(processEventsIfDue(microCycleCounter - 1)) {
         if(inDebug && (microBreakpointHit || asmBreakpointHit)) {
             // If a breakpoint was forced on us by the processEvents(), react to it now.
             // Clear breakpoint flags, otherwise we might get stuck
@@ -320,7 +422,7 @@ void FullMicrocodedCPU::onMCStep()
             ACPUModel::handler->interupt(Interrupts::BREAKPOINT_ASM);
         }
         // Trap on micrcode breakpoints
-        else if(sharedProgram->getCodeLine(microprogramCounter)->hasBreakpoint()) {
+        else if(linkedProgram.constData()[microprogramCounter].line->hasBreakpoint()) {
             ACPUModel::handler->interupt(Interrupts::BREAKPOINT_MICRO);
         }
     }
@@ -328,6 +430,13 @@ void FullMicrocodedCPU::onMCStep()
     ACPUModel::handler->handleQueuedInterrupts();
 }
 
+void FullMicrocodedCPU::doMCStepWhile(std::function<bool ()> condition)
+{
+    do{
+        if(!applyInstructionSummary()) onMCStep();
+    } while(condition());
+}
+
 void FullMicrocodedCPU::onClock()
 {
     //Do clock logic
@@ -418,11 +527,14 @@ void FullMicrocodedCPU::runUntilLoaded()
     doISAStepWhile(cond);
     // Clear memory at end to hide the fact that the user program was loaded.
     memory->clearBytesWritten();
+    // Likewise, only profile the user program and the OS code it calls.
+    if(profiler) profiler->clear();
+    memory->clearStatistics();
 }
 
 quint64 FullMicrocodedCPU::getCycleCount()
 {
-    return memoizer->getCycleCount();
+    return memoizer->getCycleCount() + memoryWaitCycles;
 }
 
 quint64 FullMicrocodedCPU::getInstructionCount()
@@ -440,120 +552,117 @@ void FullMicrocodedCPU::branchHandler()
     // If execution is already finished, then nothing to update.
     if(executionFinished) return;
     else if(hadErrorOnStep()) executionFinished = true;
-    const MicroCode* prog = sharedProgram->getCodeLine(microprogramCounter);
+    const LinkedMicroCode& prog = linkedProgram.constData()[microprogramCounter];
     int temp = microprogramCounter;
-    quint8 byte = 0;
     QString tempString;
-    QSharedPointer<const SymbolTable> symTable = this->sharedProgram->getSymTable();
     QSharedPointer<SymbolEntry> val;
-    switch(prog->getBranchFunction())
+    switch(prog.branchFunction)
     {
     case Enu::Unconditional:
-        temp = prog->getTrueTarget()->getValue();
+        temp = prog.trueTarget;
         break;
     case Enu::uBRGT:
         if((!data->getStatusBit(Enu::STATUS_N) && !data->getStatusBit(Enu::STATUS_Z))) {
-            temp = prog->getTrueTarget()->getValue();
+            temp = prog.trueTarget;
         }
         else {
-            temp = prog->getFalseTarget()->getValue();
+            temp = prog.falseTarget;
         }
         break;
     case Enu::uBRGE:
         if((!data->getStatusBit(Enu::STATUS_N))) {
-            temp = prog->getTrueTarget()->getValue();
+            temp = prog.trueTarget;
         }
         else {
-            temp = prog->getFalseTarget()->getValue();
+            temp = prog.falseTarget;
         }
         break;
     case Enu::uBREQ:
         if(data->getStatusBit(Enu::STATUS_Z)) {
-            temp = prog->getTrueTarget()->getValue();
+            temp = prog.trueTarget;
         }
         else {
-            temp = prog->getFalseTarget()->getValue();
+            temp = prog.falseTarget;
         }
         break;
     case Enu::uBRLE:
         if(data->getStatusBit(Enu::STATUS_N) || data->getStatusBit(Enu::STATUS_Z)) {
-            temp = prog->getTrueTarget()->getValue();
+            temp = prog.trueTarget;
         }
         else {
-            temp = prog->getFalseTarget()->getValue();
+            temp = prog.falseTarget;
         }
         break;
     case Enu::uBRLT:
         if(data->getStatusBit(Enu::STATUS_N)) {
-            temp = prog->getTrueTarget()->getValue();
+            temp = prog.trueTarget;
         }
         else {
-            temp = prog->getFalseTarget()->getValue();
+            temp = prog.falseTarget;
         }
         break;
     case Enu::uBRNE:
         if((!data->getStatusBit(Enu::STATUS_Z))) {
-            temp = prog->getTrueTarget()->getValue();
+            temp = prog.trueTarget;
         }
         else {
-            temp = prog->getFalseTarget()->getValue();
+            temp = prog.falseTarget;
         }
         break;
     case Enu::uBRV:
         if(data->getStatusBit(Enu::STATUS_V)) {
-            temp = prog->getTrueTarget()->getValue();
+            temp = prog.trueTarget;
         }
         else {
-            temp = prog->getFalseTarget()->getValue();
+            temp = prog.falseTarget;
         }
         break;
     case Enu::uBRC:
         if(data->getStatusBit(Enu::STATUS_C))  {
-            temp = prog->getTrueTarget()->getValue();
+            temp = prog.trueTarget;
         }
         else {
-            temp = prog->getFalseTarget()->getValue();
+            temp = prog.falseTarget;
         }
         break;
     case Enu::uBRS:
         if(data->getStatusBit(Enu::STATUS_S)) {
-            temp = prog->getTrueTarget()->getValue();
+            temp = prog.trueTarget;
         }
         else {
-            temp = prog->getFalseTarget()->getValue();
+            temp = prog.falseTarget;
         }
         break;
     case Enu::IsPrefetchValid:
         if(isPrefetchValid) {
-            temp = prog->getTrueTarget()->getValue();
+            temp = prog.trueTarget;
         }
         else {
-            temp = prog->getFalseTarget()->getValue();
+            temp = prog.falseTarget;
         }
         break;
     case Enu::IsUnary:
-        byte = data->getRegisterBankByte(8);
         // At the hardware level, all traps are unary.
         // If it is a non-unary trap at the ASM level, loading the argument is part of the microcode trap handlers responsibility.
-        if(Pep::isUnaryMap[Pep::decodeMnemonic[byte]] || Pep::isTrapMap[Pep::decodeMnemonic[byte]]) {
-            temp = prog->getTrueTarget()->getValue();
+        if(decoderTable[data->getRegisterBankByte(8)].flags & MicroDecoderEntry::Unary) {
+            temp = prog.trueTarget;
         }
         else {
-            temp = prog->getFalseTarget()->getValue();
+            temp = prog.falseTarget;
         }
         break;
     case Enu::IsPCEven:
         if(data->getRegisterBankByte(7)%2 == 0) {
-            temp = prog->getTrueTarget()->getValue();
+            temp = prog.trueTarget;
         }
         else {
-            temp = prog->getFalseTarget()->getValue();
+            temp = prog.falseTarget;
         }
         break;
     case Enu::AddressingModeDecoder:
         // If the value in the instruction specifier decoder table is invalid,
         // report the unrecoverable error.
-        if(!addrModeJT[data->getRegisterBankByte(8)].isValid) {
+        if(!(decoderTable[data->getRegisterBankByte(8)].flags & MicroDecoderEntry::AddrModeValid)) {
             executionFinished = true;
             controlError = true;
             // Get the enumerated & string values of current instruction.
@@ -568,14 +677,14 @@ void FullMicrocodedCPU::branchHandler()
         }
         else{
             // Otherwise branch to the appropriate address in the instruction specifer jump table.
-           temp = addrModeJT[data->getRegisterBankByte(8)].addr;
+           temp = decoderTable[data->getRegisterBankByte(8)].addrModeAddr;
         }
 
         break;
     case Enu::InstructionSpecifierDecoder:
         // If the value in the instruction specifier decoder table is invalid,
         // report the unrecoverable error.
-        if(!instrSpecJT[data->getRegisterBankByte(8)].isValid) {
+        if(!(decoderTable[data->getRegisterBankByte(8)].flags & MicroDecoderEntry::InstrValid)) {
             executionFinished = true;
             controlError = true;
             // Get the enumerated & string values of current instruction.
@@ -590,7 +699,7 @@ void FullMicrocodedCPU::branchHandler()
         }
         else{
             // Otherwise branch to the appropriate address in the instruction specifer jump table.
-           temp = instrSpecJT[data->getRegisterBankByte(8)].addr;
+           temp = decoderTable[data->getRegisterBankByte(8)].instrAddr;
         }
 
         break;
@@ -608,7 +717,7 @@ void FullMicrocodedCPU::branchHandler()
         //If there was an error in the control section, make sure the CPU stops
         executionFinished = true;
     }
-    else if(temp == microprogramCounter && prog->getBranchFunction() != Enu::Stop) {
+    else if(temp == microprogramCounter && prog.branchFunction != Enu::Stop) {
         executionFinished  = true;
         controlError = true;
         errorMessage = "ERROR: µInstructions cannot branch to themselves";
@@ -635,54 +744,6 @@ void FullMicrocodedCPU::updateAtInstructionEnd()
     }
 }
 
-void FullMicrocodedCPU::calculateInstrJT()
-{
-    // Symbol table of the current microprogram
-    QSharedPointer<const SymbolTable> symTable = this->sharedProgram->getSymTable();
-    QSharedPointer<SymbolEntry> val;
-    FullMicrocodedCPU::decoder_entry entry;
-    for(int it = 0; it <= 255; ++it) {
-        QString tempString = Pep::instSpecToMicrocodeInstrSymbol[it];
-        val = symTable->getValue(tempString);
-        // Instead of causing an error before execution starts,
-        // flag the entry as invalid so that the error can be caught at runtime.
-        // This allows microprogram fragments that do not define all instructions
-        // to be created, which is of instructional value to students
-        if(val == nullptr || !val->isDefined()) {
-            entry.isValid = false;
-        }
-        else {
-            entry.isValid = true;
-            entry.addr = static_cast<quint16>(val->getValue());
-        }
-        instrSpecJT[static_cast<quint8>(it)] = entry;
-    }
-}
-
-void FullMicrocodedCPU::calculateAddrJT()
-{
-    // Symbol table of the current microprogram
-    QSharedPointer<const SymbolTable> symTable = this->sharedProgram->getSymTable();
-    QSharedPointer<SymbolEntry> val;
-    FullMicrocodedCPU::decoder_entry entry;
-    for(int it = 0; it <= 255; ++it) {
-        QString tempString = Pep::instSpecToMicrocodeAddrSymbol[it];
-        val = symTable->getValue(tempString);
-        // Instead of causing an error before execution starts,
-        // flag the entry as invalid so that the error can be caught at runtime.
-        // This allows microprogram fragments that do not define all instructions
-        // to be created, which is of instructional value to students
-        if(val == nullptr || !val->isDefined()) {
-            entry.isValid = false;
-        }
-        else {
-            entry.isValid = true;
-            entry.addr = static_cast<quint16>(val->getValue());
-        }
-        addrModeJT[static_cast<quint8>(it)] = entry;
-    }
-}
-
 void FullMicrocodedCPU::breakpointAsmHandler()
 {
     asmBreakpointHit = true;
@@ -695,11 +756,11 @@ void FullMicrocodedCPU::breakpointMicroHandler()
     emit hitBreakpoint(Enu::BreakpointTypes::MICROCODE);
 }
 
-void FullMicrocodedCPU::setSignalsFromMicrocode(const MicroCode *line)
+void FullMicrocodedCPU::setSignalsFromMicrocode(const LinkedMicroCode &line)
 {
     int val;
-    if(line->getClockSignal(Enu::EClockSignals::PValidCk)) {
-        val = line->getControlSignal(Enu::EControlSignals::PValid);
+    if(line.clockSignals[Enu::EClockSignals::PValidCk]) {
+        val = line.controlSignals[Enu::EControlSignals::PValid];
         if(val == Enu::signalDisabled) {
             errorMessage = "Error: Asserted PValidCk, but PValid was disabled.";
             controlError = true;
@@ -709,3 +770,114 @@ void FullMicrocodedCPU::setSignalsFromMicrocode(const MicroCode *line)
         }
     }
 }
+
+int FullMicrocodedCPU::summaryKey() const
+{
+    quint16 pc = data->getRegisterBankWord(Enu::CPURegisters::PC);
+    quint8 instr = 0;
+    memory->getByte(pc, instr);
+    return instr | (isPrefetchValid ? 1 << 8 : 0) | (pc & 1) << 9;
+}
+
+bool FullMicrocodedCPU::applyInstructionSummary()
+{
+    // Breakpoints must be checked on every line while debugging, only compiled steps may be
+    // executed without going through the data section's signals, and a trace needs every cycle.
+    if(!useInstructionSummaries || !useCompiledMicrocode || inDebug || traceRecorder
+            || microprogramCounter != startLine || executionFinished) return false;
+    const InstructionSummary& summary = summaries[static_cast<std::size_t>(summaryKey())];
+    if(summary.state != InstructionSummary::State::Recorded) return false;
+
+    microBreakpointHit = false;
+    asmBreakpointHit = false;
+    onInstructionStarted();
+
+    const quint64 startCycle = microCycleCounter;
+    const quint16* path = summary.path.constData();
+    const int length = summary.path.size();
+    const LinkedMicroCode* prog = nullptr;
+    for(int it = 0; it < length; it++) {
+        prog = &linkedProgram.constData()[microprogramCounter];
+        setSignalsFromMicrocode(*prog);
+        data->stepCompiled(compiledProgram.constData()[microprogramCounter]);
+        microCycleCounter++;
+        if(prog->branchFunction == Enu::Unconditional && !hadErrorOnStep()) {
+            microprogramCounter = prog->trueTarget;
+            continue;
+        }
+        // Conditional branches may depend on data, so resolve them as usual. If the instruction
+        // leaves the recorded path, onMCStep() finishes it from the line actually reached.
+        branchHandler();
+        quint16 expected = it + 1 < length ? path[it + 1] : startLine;
+        if(executionFinished || microprogramCounter != expected) break;
+    }
+    // Display the signals of the last line, as if every line had been stepped.
+    data->setSignals(prog->controlSignals, prog->clockSignals);
+
+    if(microprogramCounter == startLine || executionFinished) {
+        onInstructionFinished();
+    }
+    // Keep the interface responsive at the same rate as onMCStep().
+    processEventsIfDue(startCycle);
+    ACPUModel::handler->handleQueuedInterrupts();
+    return true;
+}
+
+bool FullMicrocodedCPU::processEventsIfDue(quint64 fromCycle)
+{
+    if(snapshotPublisher.isNull()) {
+        if(microCycleCounter / 5000 == fromCycle / 5000) return false;
+    }
+    // Only refresh the UI once per frame, so that running is not slowed by redrawing.
+    // Reading the clock is cheap, but not free, so only check it every few hundred cycles.
+    else if(microCycleCounter / 256 == fromCycle / 256 || !snapshotPublisher->isFrameDue()) return false;
+    else publishSnapshot(asmInstructionCounter, microCycleCounter, getOperandValue());
+    processEvents();
+    return true;
+}
+
+void FullMicrocodedCPU::onInstructionStarted()
+{
+    // Store PC at the start of the cycle, so that we know where the instruction started from.
+    // Also store any other values needed for detailed statistics.
+    // Also, must initialize InterfaceISACPU:opValCache here for FullMicrocoded CPU
+    // to fulfill its contract with InterfaceISACPU.
+    memoizer->storeStateInstrStart();
+    memory->onCycleStarted();
+    instructionStartCycle = microCycleCounter;
+    InterfaceISACPU::calculateStackChangeStart(this->getCPURegByteStart(Enu::CPURegisters::IS));
+}
+
+void FullMicrocodedCPU::onInstructionFinished()
+{
+    quint16 progCounter = getCPURegWordStart(Enu::CPURegisters::PC);
+    InterfaceISACPU::calculateStackChangeEnd(this->getCPURegByteCurrent(Enu::CPURegisters::IS),
+                                             this->getCPURegWordCurrent(Enu::CPURegisters::OS),
+                                             this->getCPURegWordStart(Enu::CPURegisters::SP),
+                                             this->getCPURegWordStart(Enu::CPURegisters::PC),
+                                             this->getCPURegWordCurrent(Enu::CPURegisters::A));
+    quint64 waitCycles = memory->takeWaitCycles();
+    if(traceRecorder && waitCycles != 0) waitCheckpoints.append({microCycleCounter, memoryWaitCycles});
+    memoryWaitCycles += waitCycles;
+    if(profiler) {
+        profiler->recordInstruction(progCounter, this->getCPURegByteCurrent(Enu::CPURegisters::IS),
+                                    this->getCPURegWordCurrent(Enu::CPURegisters::PC),
+                                    static_cast<quint32>(microCycleCounter - instructionStartCycle + waitCycles));
+    }
+    if(MemoryAccessStats* stats = memory->getAccessStats()) {
+        Enu::EMnemonic mnemon = Pep::decodeMnemonic[this->getCPURegByteCurrent(Enu::CPURegisters::IS)];
+        stats->recordExecute(progCounter, Pep::isUnaryMap[mnemon] ? 1 : 3);
+    }
+    memoizer->storeStateInstrEnd();
+    updateAtInstructionEnd();
+    emit asmInstructionFinished();
+    asmInstructionCounter++;
+    // qDebug().noquote().nospace() << memoizer->memoize();
+    data->getRegisterBank().flattenFile();
+    // If execution finished on this instruction, then restore original starting program counter,
+    // as the instruction at the current program counter will not be executed.
+    if(executionFinished) {
+        data->getRegisterBank().writePCStart(progCounter);
+        emit simulationFinished();
+    }
+}
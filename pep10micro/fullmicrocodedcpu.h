@@ -3,10 +3,14 @@
 
 #include "interfacemccpu.h"
 #include "interfaceisacpu.h"
+#include "compiledmicrostep.h"
+#include "microcodeprogram.h"
 #include <QElapsedTimer>
+#include <QPair>
 #include <array>
 class CPUDataSection;
 class FullMicrocodedMemoizer;
+class RegisterFile;
 class FullMicrocodedCPU : public ACPUModel, public InterfaceMCCPU, public InterfaceISACPU
 {
     Q_OBJECT
@@ -19,12 +23,37 @@ public:
     // Returns true if the microprogram counter is at the
     // start of the von neumann cycle.
     bool atMicroprogramStart() const noexcept;
+    // Returns true if the byte following the last instruction specifier has
+    // already been fetched, and will be used as the next instruction specifier.
+    bool getPrefetchValid() const noexcept;
     // Set the microprogram counter to whatever the value of "start" is.
     // This can be used to skip the initialization steps at the top
     // of a microcode program.
     void setMicroPCToStart() noexcept;
+    // Adopt the ISA visible registers, status bits, and call depth of another CPU that is
+    // between instructions. The data section is otherwise reset, and the microprogram counter
+    // is placed at the start of the von neumann cycle, so the next instruction is fetched
+    // from memory rather than from a stale prefetch.
+    // Must be called after onSimulationStarted(). Memory is not copied, and its pending wait cycles are discarded.
+    void loadArchitecturalState(const RegisterFile& registers, int callDepth);
+    // Return the data section, microprogram counter, and cycle counter to how they were after
+    // a cycle held by the trace recorder, and discard the trace after it. Memory wait cycles are
+    // restored to their total after the last instruction finished by then, and the waits of a partly
+    // rewound instruction are dropped. Memory (including the state of a cache), call depth, and
+    // statistics are not rewound. Returns false if there is no recorder, or it lacks the cycle.
+    bool rewindToCycle(quint64 cycle);
+    // Microcode is executed as precompiled steps unless disabled, in which case
+    // the data section interprets the signals of each line on every cycle.
+    bool getUseCompiledMicrocode() const noexcept;
+    void setUseCompiledMicrocode(bool useCompiled) noexcept;
+    // Instructions are replayed from their recorded summaries unless disabled, or a trace is
+    // being recorded. See InstructionSummary.
+    bool getUseInstructionSummaries() const noexcept;
+    void setUseInstructionSummaries(bool useSummaries) noexcept;
 
     // ACPUModel interface
+    // Also copies the temporary registers, memory registers, and microprogram counter.
+    SimulationSnapshot captureSnapshot() const override;
     bool getStatusBitCurrent(Enu::EStatusBit) const override;
     bool getStatusBitStart(Enu::EStatusBit) const override;
     quint8 getCPURegByteCurrent(Enu::CPURegisters reg) const override;
@@ -39,6 +68,8 @@ public:
     // InterfaceMCCPU interface
     void setCPUType(Enu::CPUType type)  override;
     void onMCStep() override;
+    // Applies instruction summaries where possible, and otherwise calls onMCStep().
+    void doMCStepWhile(std::function<bool(void)> condition) override;
     void onClock() override;
 
     // InterfaceISACPU interface
@@ -70,37 +101,78 @@ private:
     CPUDataSection *data;
     QSharedPointer<CPUDataSection> dataShared;
     FullMicrocodedMemoizer *memoizer;
-    // A class to represent a single item in the instruction specifier
-    // or addressing mode decoder.
-    struct decoder_entry {
-        quint16 addr;
-        bool isValid;
-    };
-
-    // For each instruction in the instruction set, map the instruction to
-    // the first line of microcode that implements it.This calculation is
-    // done each time a microprogram is run to account for mnemonic redefinitons.
-    // Any modification to the Pep:: instruction mappings while the simulator is running
-    // could cause the microprogram to error in unexpected ways.
-    std::array<decoder_entry, 256> instrSpecJT {};
-
-    // For each of the 256 instruction specifier values, map the
-    // addressing mode associated with that IS to the first line of
-    // microcode implementing that addressing mode. Do not modify
-    // any of the Pep:: addressing mode maps while the simulator
-    // is running, else a microprogram might fail unexpectedly.
-    std::array<decoder_entry, 256> addrModeJT {};
+    // For each of the 256 instruction specifier values, whether it is unary and the first
+    // lines of microcode implementing its addressing mode and instruction, so that
+    // IsUnary, AMD, and ISD are each a single lookup. Taken from the microprogram, which
+    // builds it when assembled, unless the decoder symbols were edited since. Any modification
+    // to the Pep:: decoder maps while the simulator is running will not be reflected until
+    // the next simulation.
+    MicroDecoderTable decoderTable {};
     quint16 startLine = 0;
+    // The microprogram lowered for execution. Refreshed at the start of every simulation,
+    // so that the simulation loop need not resolve branch targets through the symbol table.
+    QVector<LinkedMicroCode> linkedProgram;
+    // Each line of linkedProgram compiled for the two byte data bus, indexed the same way.
+    QVector<CompiledMicroStep> compiledProgram;
+    bool useCompiledMicrocode = true;
+
+    /*
+     * The path through the microprogram taken by an instruction.
+     *
+     * For a fixed microprogram, the lines executed by an instruction are determined by its
+     * instruction specifier, the parity of PC, and whether the prefetch is valid (together, its key),
+     * except where the instruction branches on status bits it computed. The first time an instruction
+     * completes, the lines it executed are recorded as the summary for its key. Later instructions
+     * with the same key replay those compiled steps back to back, without updating the displayed
+     * signals, following unconditional branches, or checking for interrupts on every cycle.
+     * Conditional branches are still resolved, and replay hands over to onMCStep() at the first
+     * branch that leaves the recorded path, so a summary never changes the state, the errors, or
+     * the number of cycles of an instruction.
+     *
+     * Summaries are never applied while debugging, since breakpoints must be checked on every line.
+     */
+    struct InstructionSummary
+    {
+        enum class State : quint8
+        {
+            Unrecorded, Recorded, Rejected
+        };
+        State state = State::Unrecorded;
+        // Microprogram counter at each cycle, beginning with startLine.
+        QVector<quint16> path;
+    };
+    // Instructions whose paths are longer than this are always stepped line by line.
+    static constexpr int maxSummaryLength = 512;
+    // Indexed by summaryKey().
+    std::array<InstructionSummary, 1024> summaries;
+    bool useInstructionSummaries = true;
+    // Key of the summary being recorded, or -1 if no path is being recorded.
+    int recordingKey = -1;
+    // Key of the instruction starting at the current PC.
+    int summaryKey() const;
+    // If the microprogram counter is at the start of an instruction which has been summarized,
+    // execute the instruction from its summary and return true. Otherwise, return false.
+    bool applyInstructionSummary();
+    // If the UI is due for an update since the cycle fromCycle, publish a snapshot (if there is a
+    // publisher) and process events. Returns true if events were processed.
+    bool processEventsIfDue(quint64 fromCycle);
+    // Bookkeeping needed at the start and end of each ISA level instruction.
+    void onInstructionStarted();
+    void onInstructionFinished();
+    // Value of microCycleCounter when the current instruction started, so it can be profiled.
+    quint64 instructionStartCycle = 0;
+    // Cycles that memory accesses waited for beyond the bus protocol, such as cache misses.
+    // The microcode cannot stall, so they are added to the cycle count when each instruction finishes.
+    quint64 memoryWaitCycles = 0;
+    // While a trace is recorded, the cycle at which each instruction that waited on memory finished,
+    // and memoryWaitCycles before its waits were added, so that rewindToCycle(...) may undo them.
+    QVector<QPair<quint64, quint64>> waitCheckpoints;
 
     void breakpointAsmHandler();
     void breakpointMicroHandler();
-    void setSignalsFromMicrocode(const MicroCode *line);
+    void setSignalsFromMicrocode(const LinkedMicroCode &line);
     void branchHandler() override;
     void updateAtInstructionEnd() override;
-    // For all 256 instructions in the Pep/9 insturction set,
-    // map the instruction to the first line of microcode that implements it.
-    void calculateInstrJT();
-    void calculateAddrJT();
 };
 
 #endif // FULLMICROCODEDCPU_H
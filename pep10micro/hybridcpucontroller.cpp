@@ -0,0 +1,87 @@
+#include "hybridcpucontroller.h"
+
+#include <algorithm>
+
+#include "amemorydevice.h"
+#include "cpudata.h"
+#include "fullmicrocodedcpu.h"
+#include "isacpu.h"
+#include "registerfile.h"
+
+HybridCPUController::HybridCPUController(QSharedPointer<IsaCpu> isaCPU, QSharedPointer<FullMicrocodedCPU> microCPU):
+    isaCPU(isaCPU), microCPU(microCPU)
+{
+
+}
+
+HybridCPUController::~HybridCPUController() = default;
+
+void HybridCPUController::onSimulationStarted()
+{
+    isaCPU->onSimulationStarted();
+    microCPU->onSimulationStarted();
+    level = Level::ISA;
+}
+
+HybridCPUController::Level HybridCPUController::getLevel() const noexcept
+{
+    return level;
+}
+
+template <typename Predicate>
+bool HybridCPUController::stepISAUntil(quint64 maxInstructions, Predicate stop)
+{
+    // Only the ISA level may be fast forwarded, otherwise the two CPUs would diverge.
+    if(level != Level::ISA) return false;
+    auto canContinue = [this](){
+        return !isaCPU->getExecutionFinished() && !isaCPU->hadErrorOnStep();
+    };
+    for(quint64 it = 0; it < maxInstructions && canContinue(); it++) {
+        isaCPU->stepInto();
+        if(stop()) break;
+    }
+    return canContinue();
+}
+
+bool HybridCPUController::fastForward(quint64 instructionCount)
+{
+    return stepISAUntil(instructionCount, [](){return false;});
+}
+
+bool HybridCPUController::fastForwardToPC(quint16 pc, quint64 maxInstructions)
+{
+    auto atPC = [this, pc](){
+        return isaCPU->getCPURegWordCurrent(Enu::CPURegisters::PC) == pc;
+    };
+    return stepISAUntil(maxInstructions, atPC) && atPC();
+}
+
+void HybridCPUController::switchToMicrocode()
+{
+    if(level == Level::Microcode) return;
+    transferMemory(isaCPU->getMemoryDevice(), microCPU->getMemoryDevice());
+    microCPU->loadArchitecturalState(isaCPU->getRegisterBank(), isaCPU->getCallDepth());
+    level = Level::Microcode;
+}
+
+bool HybridCPUController::switchToISA()
+{
+    if(level == Level::ISA) return true;
+    else if(!microCPU->atMicroprogramStart()) return false;
+    transferMemory(microCPU->getMemoryDevice(), isaCPU->getMemoryDevice());
+    isaCPU->loadArchitecturalState(microCPU->getDataSection()->getRegisterBank(), microCPU->getCallDepth());
+    level = Level::ISA;
+    return true;
+}
+
+void HybridCPUController::transferMemory(const AMemoryDevice *from, AMemoryDevice *to)
+{
+    if(from == to) return;
+    // maxAddress() is the size of a device, and no device may be larger than the address space.
+    quint32 size = std::min({from->maxAddress(), to->maxAddress(), quint32{1} << 16});
+    quint8 value = 0;
+    for(quint32 address = 0; address < size; address++) {
+        from->getByte(static_cast<quint16>(address), value);
+        to->setByte(static_cast<quint16>(address), value);
+    }
+}
@@ -0,0 +1,68 @@
+#ifndef HYBRIDCPUCONTROLLER_H
+#define HYBRIDCPUCONTROLLER_H
+
+#include <QSharedPointer>
+#include <limits>
+
+class AMemoryDevice;
+class FullMicrocodedCPU;
+class IsaCpu;
+
+/*
+ * Runs a program at the ISA level until it reaches the point of interest, and then continues
+ * cycle-accurately on the microcoded CPU.
+ *
+ * Interpreting microcode from the very first instruction means interpreting the whole OS loader,
+ * and every instruction preceding the few whose microcode is actually of interest. The controller
+ * instead steps an IsaCpu until a program counter or instruction count is reached, and then moves
+ * the ISA visible registers, status bits, call depth, and (if the CPUs do not share a device) the
+ * contents of memory into a FullMicrocodedCPU. State may later be handed back to the IsaCpu,
+ * but only between instructions, since partially executed microcode has no ISA level equivalent.
+ *
+ * Both CPUs must be loaded with the same program, and the caller remains responsible for
+ * resetting and initializing them. Execution statistics and memory traces are not transferred;
+ * each CPU only records what it executed itself.
+ */
+class HybridCPUController
+{
+public:
+    enum class Level
+    {
+        ISA, Microcode
+    };
+
+    HybridCPUController(QSharedPointer<IsaCpu> isaCPU, QSharedPointer<FullMicrocodedCPU> microCPU);
+    ~HybridCPUController();
+
+    // Prepare both CPUs for simulation. Execution starts at the ISA level.
+    void onSimulationStarted();
+    Level getLevel() const noexcept;
+
+    // Execute up to instructionCount instructions on the IsaCpu.
+    // Returns true if all instructions executed, and the simulation may continue at either level.
+    bool fastForward(quint64 instructionCount);
+    // Execute instructions on the IsaCpu until the next instruction to execute is at address pc.
+    // At least one instruction is executed, so that the controller may fast forward from one
+    // invocation of a routine to the next.
+    // Returns true if the address was reached, and the simulation may continue at either level.
+    bool fastForwardToPC(quint16 pc, quint64 maxInstructions = std::numeric_limits<quint64>::max());
+
+    // Continue execution on the FullMicrocodedCPU, which starts by fetching the next instruction.
+    void switchToMicrocode();
+    // Continue execution on the IsaCpu. Fails, returning false, if the
+    // microcoded CPU is in the middle of an instruction.
+    bool switchToISA();
+
+private:
+    // Stop conditions are tested after each instruction.
+    template <typename Predicate>
+    bool stepISAUntil(quint64 maxInstructions, Predicate stop);
+    // Copy all of memory, unless both CPUs share a device.
+    static void transferMemory(const AMemoryDevice* from, AMemoryDevice* to);
+
+    QSharedPointer<IsaCpu> isaCPU;
+    QSharedPointer<FullMicrocodedCPU> microCPU;
+    Level level = Level::ISA;
+};
+
+#endif // HYBRIDCPUCONTROLLER_H
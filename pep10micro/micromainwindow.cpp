@@ -59,6 +59,7 @@
 #include "darkhelper.h"
 #include "decodertabledialog.h"
 #include "fullmicrocodedcpu.h"
+#include "isaprofiler.h"
 #include "microhelpdialog.h"
 #include "macroassemblerdriver.h"
 #include "mainmemory.h"
@@ -70,6 +71,8 @@
 #include "microobjectcodepane.h"
 #include "updatechecker.h"
 #include "registerfile.h"
+#include "simulationsnapshot.h"
+#include "simulationthread.h"
 #include "symboltable.h"
 
 MicroMainWindow::MicroMainWindow(QWidget *parent) :
@@ -104,7 +107,15 @@ MicroMainWindow::MicroMainWindow(QWidget *parent) :
     ui->asmProgramTracePane->init(controlSection, programManager);
     ui->microcodeWidget->init(controlSection, dataSection, true);
     ui->microObjectCodePane->init(controlSection, true);
+    // Profile every run, so that the statistics can show which functions took the most cycles.
+    controlSection->setProfiler(QSharedPointer<IsaProfiler>::create());
     ui->executionStatisticsWidget->init(controlSection, true);
+    snapshotPublisher = QSharedPointer<SnapshotPublisher>::create();
+    controlSection->setSnapshotPublisher(snapshotPublisher);
+    // Run the CPU on its own thread, so that long simulations never block the UI.
+    simulation = new SimulationThread(controlSection, memDevice, this);
+    stopRequested = false;
+    simulation->start();
 
     programManager->setMacroRegistry(macro_registry);
 
@@ -140,8 +151,13 @@ MicroMainWindow::MicroMainWindow(QWidget *parent) :
 
     // Connect IOWidget to memory
     ui->ioWidget->bindToMemorySection(memDevice.get());
-    // Connect IO events
-    connect(memDevice.get(), &MainMemory::inputRequested, this, &MicroMainWindow::onInputRequested, Qt::QueuedConnection);
+    // Memory belongs to the simulation thread while running, so route typed input through it.
+    disconnect(ui->ioWidget, &IOWidget::inputReady, memDevice.get(), nullptr);
+    connect(ui->ioWidget, &IOWidget::inputReady, simulation, &SimulationThread::postInput);
+    // Connect IO events. The simulation waits for input on its own thread, so the request is handled while it is parked.
+    connect(memDevice.get(), &MainMemory::inputRequested, this, [this](quint16 address) {
+        simulation->invokeBlocking(this, [this, address]() { onInputRequested(address); });
+    }, Qt::DirectConnection);
     connect(memDevice.get(), &MainMemory::outputWritten, this, &MicroMainWindow::onOutputReceived, Qt::QueuedConnection);
 
     // Connect Undo / Redo events
@@ -153,14 +169,19 @@ MicroMainWindow::MicroMainWindow(QWidget *parent) :
     connect(ui->ioWidget, &IOWidget::redoAvailable, this, &MicroMainWindow::setRedoability);
 
     // Connect simulation events.
+    connect(snapshotPublisher.get(), &SnapshotPublisher::frameReady, this, &MicroMainWindow::onSimulationFrame, Qt::QueuedConnection);
     // Events that fire on simulationUpdate should be UniqueConnections, as they will be repeatedly connected and disconnected
     // via connectMicroDraw() and disconnectMicroDraw().
     connect(this, &MicroMainWindow::simulationUpdate, ui->cpuWidget, &CpuPane::onSimulationUpdate, Qt::UniqueConnection);
     connect(this, &MicroMainWindow::simulationUpdate, ui->memoryWidget, &MemoryDumpPane::updateMemory, Qt::UniqueConnection);
     connect(this, &MicroMainWindow::simulationUpdate, ui->memoryTracePane, &NewMemoryTracePane::updateTrace, Qt::UniqueConnection);
     connect(this, &MicroMainWindow::simulationStarted, ui->memoryWidget, &MemoryDumpPane::onSimulationStarted);
+    connect(this, &MicroMainWindow::simulationStarted, ui->cpuWidget, &CpuPane::onSimulationStarted);
     connect(this, &MicroMainWindow::simulationStarted, ui->memoryTracePane, &NewMemoryTracePane::onSimulationStarted);
-    connect(controlSection.get(), &FullMicrocodedCPU::hitBreakpoint, this, &MicroMainWindow::onBreakpointHit);
+    // Views inspect the CPU when it stops, so park the simulation until they have.
+    connect(controlSection.get(), &FullMicrocodedCPU::hitBreakpoint, this, [this](Enu::BreakpointTypes type) {
+        simulation->invokeBlocking(this, [this, type]() { onBreakpointHit(type); });
+    }, Qt::DirectConnection);
 
     // Clear IOWidget every time a simulation is started.
     connect(this, &MicroMainWindow::simulationStarted, ui->ioWidget, &IOWidget::onClear);
@@ -171,14 +192,18 @@ MicroMainWindow::MicroMainWindow(QWidget *parent) :
     connect(ui->actionSystem_Clear_CPU, &QAction::triggered, ui->executionStatisticsWidget, &ExecutionStatisticsWidget::onClear);
     // Post finished events to the event queue so that they are processed after simulation updates.
     connect(this, &MicroMainWindow::simulationFinished, ui->microObjectCodePane, &MicroObjectCodePane::onSimulationFinished, Qt::QueuedConnection);
-    connect(this, &MicroMainWindow::simulationFinished, controlSection.get(), &FullMicrocodedCPU::onSimulationFinished, Qt::QueuedConnection);
+    connect(this, &MicroMainWindow::simulationFinished, simulation, [this]() {
+        simulation->step([this]() { controlSection->onSimulationFinished(); });
+    }, Qt::QueuedConnection);
     connect(this, &MicroMainWindow::simulationFinished, ui->cpuWidget, &CpuPane::onSimulationFinished, Qt::QueuedConnection);
     connect(this, &MicroMainWindow::simulationFinished, ui->memoryWidget, &MemoryDumpPane::onSimulationFinished, Qt::QueuedConnection);
     connect(this, &MicroMainWindow::simulationFinished, ui->memoryTracePane, &NewMemoryTracePane::onSimulationFinished, Qt::QueuedConnection);
     connect(this, &MicroMainWindow::simulationFinished, ui->executionStatisticsWidget, &ExecutionStatisticsWidget::onSimulationFinished, Qt::QueuedConnection);
 
     // Connect MainWindow so that it can propogate simulationFinished event and clean up when execution is finished.
-    connect(controlSection.get(), &FullMicrocodedCPU::simulationFinished, this, &MicroMainWindow::onSimulationFinished);
+    connect(controlSection.get(), &FullMicrocodedCPU::simulationFinished, this, [this]() {
+        simulation->invokeBlocking(this, [this]() { onSimulationFinished(); });
+    }, Qt::DirectConnection);
 
 
     // Connect simulation events that are internal to the class.
@@ -281,6 +306,7 @@ MicroMainWindow::MicroMainWindow(QWidget *parent) :
 
 MicroMainWindow::~MicroMainWindow()
 {
+    simulation->shutdown();
     delete ui;
     delete helpDialog;
     delete aboutPepDialog;
@@ -306,6 +332,8 @@ void MicroMainWindow::closeEvent(QCloseEvent *event)
         // the entire application alive.
         helpDialog->close();
         writeSettings();
+        // Stop the simulation while the views it reports to still exist.
+        simulation->shutdown();
         event->accept();
     }
     else {
@@ -401,6 +429,8 @@ void MicroMainWindow::connectViewUpdate()
     // If application is running, active lines shouldn't be highlighted at the begin of the instruction, as this would be misleading.
     connect(this, &MicroMainWindow::simulationStarted, this, static_cast<void(MicroMainWindow::*)()>(&MicroMainWindow::highlightActiveLines), Qt::UniqueConnection);
     dataSection->setEmitEvents(true);
+    // Views are refreshed directly again, so a frame that was not yet displayed would only show stale state.
+    snapshotPublisher->clear();
 }
 
 void MicroMainWindow::disconnectViewUpdate()
@@ -890,10 +920,6 @@ void MicroMainWindow::assembleDefaultOperatingSystem()
     if(!defaultOSText.isEmpty()) {
         QSharedPointer<AsmProgram> prog;
         auto elist = QList<QPair<int, QString>>();
-        qDebug() << macro_registry->getCoreMacros();
-        for(auto macro : macro_registry->getCoreMacros()) {
-            qDebug() << macro->macroText;
-        }
         MacroAssemblerDriver assembler(macro_registry);
         auto output = assembler.assembleOperatingSystem(defaultOSText);
         // If the operating system failed to assembly, we can't progress any further.
@@ -1391,6 +1417,20 @@ void MicroMainWindow::on_actionBuild_Load_Object_triggered()
 
 void MicroMainWindow::on_actionBuild_Execute_triggered()
 {
+    auto finish = [this]() {
+        // If the simulator finished, then propogate that information to connect components.
+        if(controlSection->getExecutionFinished()) {
+            debugState = DebugState::DISABLED;
+            onSimulationFinished();
+            emit simulationFinished();
+        }
+        // Otherwise, the simulator paused execution, so don't explicitly terminate
+        // the simulator.
+        else {
+            handleDebugButtons();
+            emit simulationUpdate();
+        }
+    };
     loadOperatingSystem();
     debugState = DebugState::RUN;
     if (initializeSimulation()) {
@@ -1399,28 +1439,32 @@ void MicroMainWindow::on_actionBuild_Execute_triggered()
         ui->memoryWidget->clearHighlight();
         ui->memoryWidget->refreshMemory();
         controlSection->onSimulationStarted();
-        controlSection->onRun();
-        connectViewUpdate();
+        simulation->runSimulation([this, finish]() {
+            connectViewUpdate();
+            finish();
+        });
     }
     else {
         debugState = DebugState::DISABLED;
-    }
-    // If the simulator finished, then propogate that information to connect components.
-    if(controlSection->getExecutionFinished()) {
-        debugState = DebugState::DISABLED;
-        onSimulationFinished();
-        emit simulationFinished();
-    }
-    // Otherwise, the simulator paused execution, so don't explicitly terminate
-    // the simulator.
-    else {
-        handleDebugButtons();
-        emit simulationUpdate();
+        finish();
     }
 }
 
 void MicroMainWindow::on_actionBuild_Run_triggered()
 {
+    auto finish = [this]() {
+        // If the simulator finished, then propogate that information to connect components.
+        if(controlSection->getExecutionFinished()) {
+            debugState = DebugState::DISABLED;
+            onSimulationFinished();
+        }
+        // Otherwise, the simulator paused execution, so don't explicitly terminate
+        // the simulator.
+        else {
+            handleDebugButtons();
+            emit simulationUpdate();
+        }
+    };
     if(!on_actionBuild_Assemble_triggered()) return;
     loadOperatingSystem();
     loadObjectCodeProgram();
@@ -1434,23 +1478,14 @@ void MicroMainWindow::on_actionBuild_Run_triggered()
         ui->memoryWidget->updateMemory();
         ui->memoryTracePane->updateTrace();
         controlSection->onSimulationStarted();
-        controlSection->onRun();
-        connectViewUpdate();
-
+        simulation->runSimulation([this, finish]() {
+            connectViewUpdate();
+            finish();
+        });
     }
     else {
         debugState = DebugState::DISABLED;
-   }
-    // If the simulator finished, then propogate that information to connect components.
-    if(controlSection->getExecutionFinished()) {
-        debugState = DebugState::DISABLED;
-        onSimulationFinished();
-    }
-    // Otherwise, the simulator paused execution, so don't explicitly terminate
-    // the simulator.
-    else {
-        handleDebugButtons();
-        emit simulationUpdate();
+        finish();
     }
 }
 
@@ -1582,6 +1617,18 @@ bool MicroMainWindow::on_actionDebug_Start_Debugging_Loader_triggered()
 
 void MicroMainWindow::on_actionDebug_Stop_Debugging_triggered()
 {
+    // A running simulation must first unwind on its own thread, so reset the views once it has.
+    if(simulation->isBusy()) {
+        if(!stopRequested) {
+            stopRequested = true;
+            simulation->cancel();
+            simulation->step({}, [this]() {
+                stopRequested = false;
+                on_actionDebug_Stop_Debugging_triggered();
+            });
+        }
+        return;
+    }
     connectViewUpdate();
     highlightActiveLines();
     debugState = DebugState::DISABLED;
@@ -1622,15 +1669,19 @@ void MicroMainWindow::on_actionDebug_Single_Step_Assembler_triggered()
 void MicroMainWindow::on_actionDebug_Interupt_Execution_triggered()
 {
     // Enable debugging in CPU and then temporarily pause execution.
-    controlSection->enableDebugging();
-    controlSection->forceBreakpoint(Enu::BreakpointTypes::ASSEMBLER);
-    connectViewUpdate();
-    debugState = DebugState::DEBUG_ISA;
-    highlightActiveLines();
-    handleDebugButtons();
-    // Interupt should activate the assembler debugger tab, as this is the level where it makes the most sense.
-    ui->tabWidget->setCurrentIndex(ui->tabWidget->indexOf(ui->debuggerTab));
-    ui->debuggerTabWidget->setCurrentIndex(ui->debuggerTabWidget->indexOf(ui->assemblerDebuggerTab));
+    simulation->interrupt();
+    // Execution pauses on the simulation thread, so only update the views once it has.
+    simulation->step({}, [this]() {
+        // The program may have finished before the interrupt was handled.
+        if(debugState == DebugState::DISABLED) return;
+        connectViewUpdate();
+        debugState = DebugState::DEBUG_ISA;
+        highlightActiveLines();
+        handleDebugButtons();
+        // Interupt should activate the assembler debugger tab, as this is the level where it makes the most sense.
+        ui->tabWidget->setCurrentIndex(ui->tabWidget->indexOf(ui->debuggerTab));
+        ui->debuggerTabWidget->setCurrentIndex(ui->debuggerTabWidget->indexOf(ui->assemblerDebuggerTab));
+    });
 }
 
 void MicroMainWindow::on_actionDebug_Continue_triggered()
@@ -1638,16 +1689,16 @@ void MicroMainWindow::on_actionDebug_Continue_triggered()
     debugState = DebugState::DEBUG_RESUMED;
     handleDebugButtons();
     disconnectViewUpdate();
-    controlSection->onRun();
-    if(controlSection->hadErrorOnStep()) {
-        return; // we'll just return here instead of letting it fail and go to the bottom
-    }
-    connectViewUpdate();
-    if(controlSection->stoppedForBreakpoint()) {
-        emit simulationUpdate();
-        QApplication::processEvents();
-        highlightActiveLines();
-    }
+    simulation->runSimulation([this]() {
+        if(controlSection->hadErrorOnStep()) {
+            return; // we'll just return here instead of letting it fail and go to the bottom
+        }
+        connectViewUpdate();
+        if(controlSection->stoppedForBreakpoint()) {
+            emit simulationUpdate();
+            highlightActiveLines();
+        }
+    });
 }
 
 void MicroMainWindow::on_actionDebug_Step_Over_Assembler_triggered()
@@ -1660,24 +1711,24 @@ void MicroMainWindow::on_actionDebug_Step_Over_Assembler_triggered()
     // until this step finishes.
     debugState = DebugState::DEBUG_RESUMED;
     handleDebugButtons();
-    controlSection->stepOver();
-    // The step has finished. The program may have been canceled
-    // during the execution of that step, so only transition to
-    // debugging at the ISA level if the simulation is still ongoing.
-    if(debugState != DebugState::DISABLED) {
-            // Actions will be refreshed on simulationUpdate.
-            debugState = DebugState::DEBUG_ISA;
-    }
-    connectViewUpdate();
-    emit simulationUpdate();
+    simulation->step([this]() { controlSection->stepOver(); }, [this]() {
+        // The step has finished. The program may have been canceled
+        // during the execution of that step, so only transition to
+        // debugging at the ISA level if the simulation is still ongoing.
+        if(debugState != DebugState::DISABLED) {
+                // Actions will be refreshed on simulationUpdate.
+                debugState = DebugState::DEBUG_ISA;
+        }
+        connectViewUpdate();
+        emit simulationUpdate();
+    });
 }
 
 void MicroMainWindow::on_actionDebug_Step_Into_Assembler_triggered()
 {
     debugState = DebugState::DEBUG_ISA;
     ui->debuggerTabWidget->setCurrentIndex(ui->debuggerTabWidget->indexOf(ui->assemblerDebuggerTab));
-    controlSection->stepInto();
-    emit simulationUpdate();
+    simulation->step([this]() { controlSection->stepInto(); }, [this]() { emit simulationUpdate(); });
 }
 
 void MicroMainWindow::on_actionDebug_Step_Out_Assembler_triggered()
@@ -1690,16 +1741,17 @@ void MicroMainWindow::on_actionDebug_Step_Out_Assembler_triggered()
     // until this step finishes.
     debugState = DebugState::DEBUG_RESUMED;
     handleDebugButtons();
-    controlSection->stepOut();
-    // The step has finished. The program may have been canceled
-    // during the execution of that step, so only transition to
-    // debugging at the ISA level if the simulation is still ongoing.
-    if(debugState != DebugState::DISABLED) {
-            // Actions will be refreshed on simulationUpdate.
-            debugState = DebugState::DEBUG_ISA;
-    }
-    connectViewUpdate();
-    emit simulationUpdate();
+    simulation->step([this]() { controlSection->stepOut(); }, [this]() {
+        // The step has finished. The program may have been canceled
+        // during the execution of that step, so only transition to
+        // debugging at the ISA level if the simulation is still ongoing.
+        if(debugState != DebugState::DISABLED) {
+                // Actions will be refreshed on simulationUpdate.
+                debugState = DebugState::DEBUG_ISA;
+        }
+        connectViewUpdate();
+        emit simulationUpdate();
+    });
 }
 
 void MicroMainWindow::on_actionDebug_Single_Step_Microcode_triggered()
@@ -1710,9 +1762,7 @@ void MicroMainWindow::on_actionDebug_Single_Step_Microcode_triggered()
             memDevice->clearBytesSet();
             memDevice->clearBytesWritten();
     }
-    controlSection->onMCStep();
-    emit simulationUpdate();
-
+    simulation->step([this]() { controlSection->onMCStep(); }, [this]() { emit simulationUpdate(); });
 }
 
 void MicroMainWindow::onMicroBreakpointHit()
@@ -1816,6 +1866,14 @@ void MicroMainWindow::onSimulationFinished()
 
 }
 
+void MicroMainWindow::onSimulationFrame()
+{
+    QSharedPointer<const SimulationSnapshot> snapshot = snapshotPublisher->takeLatest();
+    if(snapshot.isNull()) return;
+    ui->memoryWidget->refreshPages(*snapshot);
+    ui->cpuWidget->updateCpu(*snapshot);
+}
+
 void MicroMainWindow::onDarkModeChanged()
 {
     isInDarkMode = inDarkMode();
@@ -43,6 +43,8 @@ class DecoderTableDialog;
 class FullMicrocodedCPU;
 class MicroHelpDialog;
 class MainMemory;
+class SimulationThread;
+class SnapshotPublisher;
 class MicrocodePane;
 class MicroObjectCodePane;
 class CPUDataSection;
@@ -89,6 +91,12 @@ private:
     QSharedPointer<MainMemory> memDevice;
     QSharedPointer<FullMicrocodedCPU> controlSection;
     QSharedPointer<CPUDataSection> dataSection;
+    // Snapshots the CPU publishes while running, so that views refresh once per frame.
+    QSharedPointer<SnapshotPublisher> snapshotPublisher;
+    // Thread running the CPU. Only touch the CPU or memory from the UI while it is not busy.
+    SimulationThread* simulation;
+    // Set while waiting for a canceled simulation to unwind, so that the views are only reset once.
+    bool stopRequested;
 
     // Dialogues
     MicroHelpDialog *helpDialog;
@@ -252,6 +260,8 @@ private slots:
 
     //Run events
     void onSimulationFinished();
+    // Refresh views from the latest snapshot published by a running simulation.
+    void onSimulationFrame();
 
     // Byte converter
     void slotByteConverterDecEdited(const QString &);
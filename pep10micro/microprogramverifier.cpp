@@ -0,0 +1,343 @@
+#include "microprogramverifier.h"
+
+#include <QRunnable>
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+#include <atomic>
+#include <random>
+
+#include "asmprogram.h"
+#include "asmprogrammanager.h"
+#include "fullmicrocodedcpu.h"
+#include "isacpu.h"
+#include "mainmemory.h"
+#include "memoizerhelper.h"
+#include "memorychips.h"
+#include "microcodeprogram.h"
+#include "pep.h"
+#include "registerfile.h"
+
+/*
+ * Verifies instruction specifiers taken from a shared queue until the queue is empty.
+ */
+class MicroprogramVerifier::Worker : public QRunnable
+{
+public:
+    Worker(const MicroprogramVerifier& verifier, std::atomic<int>& nextIndex, InstructionResult* results);
+    ~Worker() override;
+    void run() override;
+
+private:
+    // Memory is reloaded with a fresh random image after this many trials.
+    static const quint64 trialsPerImage = 256;
+    const MicroprogramVerifier& verifier;
+    std::atomic<int>& nextIndex;
+    InstructionResult* results;
+
+    // Simulation objects are allocated in run(), so that they belong to the worker thread.
+    QSharedPointer<MainMemory> isaMemory, microMemory;
+    QSharedPointer<IsaCpu> isaCPU;
+    QSharedPointer<FullMicrocodedCPU> microCPU;
+    // Contents of memory at the start of every trial.
+    QVector<quint8> image;
+
+    InstructionResult verifyInstruction(quint8 instructionSpecifier);
+    // Fill memory with random bytes, overlaid with the operating system.
+    void loadImage(std::mt19937_64& random);
+    // Execute one instruction on both CPUs. Returns false and describes the
+    // first difference if the CPUs disagree.
+    bool runTrial(quint8 instructionSpecifier, const TrialState& state, QString& divergence);
+    bool compareCPUs(QString& divergence) const;
+    // Restore each byte touched by the last trial to its value in the image.
+    void restoreMemory();
+};
+
+MicroprogramVerifier::Worker::Worker(const MicroprogramVerifier &verifier, std::atomic<int> &nextIndex,
+                                     InstructionResult *results):
+    verifier(verifier), nextIndex(nextIndex), results(results)
+{
+
+}
+
+MicroprogramVerifier::Worker::~Worker() = default;
+
+void MicroprogramVerifier::Worker::run()
+{
+    // 64k of RAM, so that no random address is unwritable.
+    isaMemory = QSharedPointer<MainMemory>::create(nullptr);
+    isaMemory->insertChip(QSharedPointer<RAMChip>(new RAMChip(1<<16, 0, isaMemory.get())), 0);
+    microMemory = QSharedPointer<MainMemory>::create(nullptr);
+    microMemory->insertChip(QSharedPointer<RAMChip>(new RAMChip(1<<16, 0, microMemory.get())), 0);
+    isaCPU = QSharedPointer<IsaCpu>::create(verifier.manager, isaMemory, nullptr);
+    microCPU = QSharedPointer<FullMicrocodedCPU>::create(verifier.manager, microMemory, nullptr);
+    microCPU->setMicrocodeProgram(verifier.program);
+    isaCPU->onResetCPU();
+    microCPU->onResetCPU();
+    isaCPU->onSimulationStarted();
+    microCPU->onSimulationStarted();
+
+    const int count = verifier.instructionSpecifiers.size();
+    for(int index = nextIndex++; index < count; index = nextIndex++) {
+        results[index] = verifyInstruction(verifier.instructionSpecifiers[index]);
+    }
+}
+
+MicroprogramVerifier::InstructionResult MicroprogramVerifier::Worker::verifyInstruction(quint8 instructionSpecifier)
+{
+    InstructionResult result;
+    result.instructionSpecifier = instructionSpecifier;
+    // Derive states from the instruction specifier, so that they are independent of scheduling.
+    std::mt19937_64 random(verifier.seed ^ ((instructionSpecifier + 1ull) * 0x9E3779B97F4A7C15ull));
+    std::uniform_int_distribution<quint16> word;
+    for(quint64 trial = 0; trial < verifier.trialsPerInstruction; trial++) {
+        if(trial % trialsPerImage == 0) loadImage(random);
+        TrialState state;
+        state.A = word(random);
+        state.X = word(random);
+        state.SP = word(random);
+        state.PC = word(random);
+        state.operandSpecifier = word(random);
+        state.NZVC = word(random) & (Enu::NMask | Enu::ZMask | Enu::VMask | Enu::CMask);
+
+        result.trials++;
+        QString divergence;
+        bool agreed = runTrial(instructionSpecifier, state, divergence);
+        restoreMemory();
+        if(!agreed) {
+            result.passed = false;
+            result.divergentState = state;
+            result.divergence = divergence;
+            break;
+        }
+    }
+    return result;
+}
+
+void MicroprogramVerifier::Worker::loadImage(std::mt19937_64 &random)
+{
+    image.resize(1<<16);
+    std::uniform_int_distribution<quint16> byte(0, 255);
+    for(auto& value : image) {
+        value = static_cast<quint8>(byte(random));
+    }
+    auto os = verifier.manager->getOperatingSystem();
+    if(!os.isNull()) {
+        auto objectCode = os->getObjectCode();
+        quint32 address = os->getBurnAddress();
+        for(int it = 0; it < objectCode.size() && address + static_cast<quint32>(it) < (1<<16); it++) {
+            image[static_cast<int>(address) + it] = objectCode[it];
+        }
+    }
+    for(auto memory : {isaMemory, microMemory}) {
+        memory->loadValues(0, image);
+        memory->clearBytesSet();
+        memory->clearBytesWritten();
+        memory->clearErrors();
+    }
+}
+
+bool MicroprogramVerifier::Worker::runTrial(quint8 instructionSpecifier, const TrialState &state, QString &divergence)
+{
+    // Place the instruction and its operand specifier at PC.
+    for(auto memory : {isaMemory, microMemory}) {
+        memory->setByte(state.PC, instructionSpecifier);
+        memory->setByte(static_cast<quint16>(state.PC + 1), static_cast<quint8>(state.operandSpecifier >> 8));
+        memory->setByte(static_cast<quint16>(state.PC + 2), static_cast<quint8>(state.operandSpecifier));
+        memory->clearErrors();
+    }
+
+    RegisterFile initial;
+    initial.writeRegisterWord(Enu::CPURegisters::A, state.A);
+    initial.writeRegisterWord(Enu::CPURegisters::X, state.X);
+    initial.writeRegisterWord(Enu::CPURegisters::SP, state.SP);
+    initial.writeRegisterWord(Enu::CPURegisters::PC, state.PC);
+    initial.writeStatusBits(state.NZVC);
+    initial.flattenFile();
+    isaCPU->loadArchitecturalState(initial, 0);
+    microCPU->loadArchitecturalState(initial, 0);
+
+    isaCPU->stepInto();
+
+    microMemory->clearBytesWritten();
+    const quint64 cycleLimit = microCPU->getCycleCounter() + verifier.maxCyclesPerInstruction;
+    FullMicrocodedCPU* micro = microCPU.get();
+    micro->doMCStepWhile([micro, cycleLimit](){
+        return !micro->hadErrorOnStep() && !micro->getExecutionFinished()
+                && !micro->atMicroprogramStart() && micro->getCycleCounter() < cycleLimit;
+    });
+    return compareCPUs(divergence);
+}
+
+bool MicroprogramVerifier::Worker::compareCPUs(QString &divergence) const
+{
+    // Both levels rejecting the instruction is agreement, even if their messages differ.
+    if(isaCPU->hadErrorOnStep() || microCPU->hadErrorOnStep()) {
+        if(isaCPU->hadErrorOnStep() && microCPU->hadErrorOnStep()) return true;
+        divergence = QString("ISA level reported \"%1\", microcode reported \"%2\".")
+                .arg(isaCPU->hadErrorOnStep() ? isaCPU->getErrorMessage() : "no error",
+                     microCPU->hadErrorOnStep() ? microCPU->getErrorMessage() : "no error");
+        return false;
+    }
+    else if(!microCPU->getExecutionFinished() && !microCPU->atMicroprogramStart()) {
+        divergence = QString("Microcode did not finish the instruction within %1 cycles.")
+                .arg(verifier.maxCyclesPerInstruction);
+        return false;
+    }
+    else if(isaCPU->getExecutionFinished() != microCPU->getExecutionFinished()) {
+        divergence = isaCPU->getExecutionFinished() ? "ISA level stopped, but microcode did not."
+                                                    : "Microcode stopped, but ISA level did not.";
+        return false;
+    }
+
+    static const QVector<QPair<Enu::CPURegisters, QString>> registers = {
+        {Enu::CPURegisters::A, "A"}, {Enu::CPURegisters::X, "X"},
+        {Enu::CPURegisters::SP, "SP"}, {Enu::CPURegisters::PC, "PC"},
+    };
+    for(const auto& reg : registers) {
+        quint16 expected = isaCPU->getCPURegWordCurrent(reg.first);
+        quint16 actual = microCPU->getCPURegWordCurrent(reg.first);
+        if(expected != actual) {
+            divergence = QString("%1 should be 0x%2, but microcode produced 0x%3.")
+                    .arg(reg.second, formatNum(expected), formatNum(actual));
+            return false;
+        }
+    }
+
+    static const QVector<QPair<Enu::EStatusBit, QString>> statusBits = {
+        {Enu::STATUS_N, "N"}, {Enu::STATUS_Z, "Z"}, {Enu::STATUS_V, "V"}, {Enu::STATUS_C, "C"},
+    };
+    for(const auto& bit : statusBits) {
+        bool expected = isaCPU->getStatusBitCurrent(bit.first);
+        bool actual = microCPU->getStatusBitCurrent(bit.first);
+        if(expected != actual) {
+            divergence = QString("%1 should be %2, but microcode produced %3.")
+                    .arg(bit.second).arg(expected).arg(actual);
+            return false;
+        }
+    }
+
+    // Bytes written by only one CPU will differ unless the value happened to be unchanged.
+    QSet<quint16> written = isaMemory->getBytesWritten();
+    written.unite(microMemory->getBytesWritten());
+    QList<quint16> addresses = written.values();
+    std::sort(addresses.begin(), addresses.end());
+    for(auto address : addresses) {
+        quint8 expected = 0, actual = 0;
+        isaMemory->getByte(address, expected);
+        microMemory->getByte(address, actual);
+        if(expected != actual) {
+            divergence = QString("Mem[0x%1] should be 0x%2, but microcode produced 0x%3.")
+                    .arg(formatNum(address), formatNum(expected), formatNum(actual));
+            return false;
+        }
+    }
+    return true;
+}
+
+void MicroprogramVerifier::Worker::restoreMemory()
+{
+    QSet<quint16> touched;
+    for(auto memory : {isaMemory, microMemory}) {
+        touched.unite(memory->getBytesWritten());
+        touched.unite(memory->getBytesSet());
+    }
+    for(auto memory : {isaMemory, microMemory}) {
+        for(auto address : touched) {
+            memory->setByte(address, image[address]);
+        }
+        memory->clearBytesWritten();
+        memory->clearBytesSet();
+    }
+}
+
+MicroprogramVerifier::MicroprogramVerifier(QSharedPointer<MicrocodeProgram> program, const AsmProgramManager *manager):
+    program(program), manager(manager), threadCount(QThread::idealThreadCount())
+{
+    for(int it = 0; it < 256; it++) {
+        instructionSpecifiers.append(static_cast<quint8>(it));
+    }
+}
+
+MicroprogramVerifier::~MicroprogramVerifier() = default;
+
+quint64 MicroprogramVerifier::getTrialsPerInstruction() const noexcept
+{
+    return trialsPerInstruction;
+}
+
+void MicroprogramVerifier::setTrialsPerInstruction(quint64 trials) noexcept
+{
+    trialsPerInstruction = trials;
+}
+
+quint64 MicroprogramVerifier::getSeed() const noexcept
+{
+    return seed;
+}
+
+void MicroprogramVerifier::setSeed(quint64 seed) noexcept
+{
+    this->seed = seed;
+}
+
+int MicroprogramVerifier::getThreadCount() const noexcept
+{
+    return threadCount;
+}
+
+void MicroprogramVerifier::setThreadCount(int threads) noexcept
+{
+    threadCount = threads;
+}
+
+quint64 MicroprogramVerifier::getMaxCyclesPerInstruction() const noexcept
+{
+    return maxCyclesPerInstruction;
+}
+
+void MicroprogramVerifier::setMaxCyclesPerInstruction(quint64 cycles) noexcept
+{
+    maxCyclesPerInstruction = cycles;
+}
+
+void MicroprogramVerifier::setInstructionSpecifiers(QVector<quint8> specifiers)
+{
+    instructionSpecifiers = specifiers;
+}
+
+QVector<MicroprogramVerifier::InstructionResult> MicroprogramVerifier::verify() const
+{
+    QVector<InstructionResult> results(instructionSpecifiers.size());
+    std::atomic<int> nextIndex {0};
+    // Each worker writes only the results of the instructions it took from the queue.
+    InstructionResult* resultData = results.data();
+
+    QThreadPool pool;
+    int workers = std::max(1, std::min(threadCount, instructionSpecifiers.size()));
+    pool.setMaxThreadCount(workers);
+    for(int it = 0; it < workers; it++) {
+        pool.start(new Worker(*this, nextIndex, resultData));
+    }
+    pool.waitForDone();
+    return results;
+}
+
+QString MicroprogramVerifier::formatResult(const InstructionResult &result)
+{
+    Enu::EMnemonic mnemonic = Pep::decodeMnemonic[result.instructionSpecifier];
+    QString instruction = Pep::enumToMnemonMap[mnemonic];
+    if(!Pep::isUnaryMap[mnemonic]) {
+        instruction += ", " + Pep::intToAddrMode(Pep::decodeAddrMode[result.instructionSpecifier]).toLower();
+    }
+    QString header = QString("0x%1 %2").arg(formatNum(result.instructionSpecifier), instruction);
+    if(result.passed) {
+        return QString("%1: passed %2 trials.").arg(header).arg(result.trials);
+    }
+    const TrialState& state = result.divergentState;
+    return QString("%1: diverged on trial %2 (A=0x%3, X=0x%4, SP=0x%5, PC=0x%6, OprndSpec=0x%7, NZVC=%8). %9")
+            .arg(header).arg(result.trials)
+            .arg(formatNum(state.A), formatNum(state.X), formatNum(state.SP), formatNum(state.PC),
+                 formatNum(state.operandSpecifier))
+            .arg(QString::number(state.NZVC, 2).rightJustified(4, '0'), result.divergence);
+}
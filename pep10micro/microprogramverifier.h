@@ -0,0 +1,86 @@
+#ifndef MICROPROGRAMVERIFIER_H
+#define MICROPROGRAMVERIFIER_H
+
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+
+class AsmProgramManager;
+class MicrocodeProgram;
+
+/*
+ * Checks a Pep/10 microprogram against the ISA level semantics implemented by IsaCpu.
+ *
+ * Each instruction specifier is executed in many randomized initial states. A state consists of
+ * random values for A, X, SP, PC, and NZVC, a random operand specifier, and 64k of random memory
+ * over which the operating system is loaded, so that traps reach the same handler at both levels.
+ * The instruction is executed once by an IsaCpu and once by a FullMicrocodedCPU, after which
+ * the registers, status bits, errors, and every byte written by either CPU are compared.
+ * The first divergence for an instruction specifier ends its trials.
+ *
+ * Instruction specifiers are distributed over a pool of worker threads, one per core by default.
+ * Each worker owns a pair of CPUs and memories, which are reset between trials by restoring only
+ * the bytes the previous trial touched, rather than rebuilding the simulators. Every instruction
+ * specifier derives its random states from the seed and its own value, so results do not depend
+ * on the number of threads or how instructions were scheduled.
+ *
+ * The microprogram must have been assembled for the two byte data bus with the full control
+ * section, and the operating system must have been assembled into the program manager.
+ */
+class MicroprogramVerifier
+{
+public:
+    // Initial state of a trial, as seen at the ISA level.
+    struct TrialState
+    {
+        quint16 A = 0, X = 0, SP = 0, PC = 0, operandSpecifier = 0;
+        quint8 NZVC = 0;
+    };
+
+    // Outcome of verifying one instruction specifier.
+    struct InstructionResult
+    {
+        quint8 instructionSpecifier = 0;
+        // Number of trials executed, including the one that diverged.
+        quint64 trials = 0;
+        bool passed = true;
+        // If the microprogram diverged, the state which exposed it and the first difference.
+        TrialState divergentState;
+        QString divergence;
+    };
+
+    MicroprogramVerifier(QSharedPointer<MicrocodeProgram> program, const AsmProgramManager* manager);
+    ~MicroprogramVerifier();
+
+    quint64 getTrialsPerInstruction() const noexcept;
+    void setTrialsPerInstruction(quint64 trials) noexcept;
+    quint64 getSeed() const noexcept;
+    void setSeed(quint64 seed) noexcept;
+    // Defaults to QThread::idealThreadCount().
+    int getThreadCount() const noexcept;
+    void setThreadCount(int threads) noexcept;
+    // A microprogram which does not return to the start of the von neumann cycle
+    // within this many cycles is considered to have diverged.
+    quint64 getMaxCyclesPerInstruction() const noexcept;
+    void setMaxCyclesPerInstruction(quint64 cycles) noexcept;
+    // Instruction specifiers to verify, which default to all 256.
+    void setInstructionSpecifiers(QVector<quint8> specifiers);
+
+    // Verify every instruction specifier, blocking until all worker threads have finished.
+    // Results are in the same order as the instruction specifiers.
+    QVector<InstructionResult> verify() const;
+    // Format a result as a single line suitable for a log.
+    static QString formatResult(const InstructionResult& result);
+
+private:
+    class Worker;
+    QSharedPointer<MicrocodeProgram> program;
+    const AsmProgramManager* manager;
+    QVector<quint8> instructionSpecifiers;
+    quint64 trialsPerInstruction = 1000;
+    quint64 seed = 0;
+    int threadCount;
+    quint64 maxCyclesPerInstruction = 1000;
+};
+
+#endif // MICROPROGRAMVERIFIER_H
@@ -4,10 +4,14 @@
 
 HEADERS += \
     fullmicrocodedcpu.h \
-    fullmicrocodedmemoizer.h
+    fullmicrocodedmemoizer.h \
+    hybridcpucontroller.h \
+    microprogramverifier.h
 
 SOURCES += \
     fullmicrocodedcpu.cpp \
-    fullmicrocodedmemoizer.cpp
+    fullmicrocodedmemoizer.cpp \
+    hybridcpucontroller.cpp \
+    microprogramverifier.cpp
 
 
@@ -30,11 +30,16 @@
 #include "asmprogram.h"
 #include "asmprogrammanager.h"
 #include "boundexecisacpu.h"
+#include "boundexecmicrocpu.h"
+#include "hybridcpucontroller.h"
 #include "isaasm.h"
 #include "isacpu.h"
+#include "isaprofiler.h"
 #include "macroassemblerdriver.h"
 #include "mainmemory.h"
+#include "memoryaccessstats.h"
 #include "memorychips.h"
+#include "microcodeprogram.h"
 #include "pep.h"
 #include "symbolentry.h"
 #include "symboltable.h"
@@ -109,6 +114,7 @@ void ASMRunHelper::onOutputReceived(quint16 address, quint8 value)
 {
     if(address == powerOff) {
         this->cpu->onCancelExecution();
+        if(!microCpu.isNull()) microCpu->onCancelExecution();
     }
     else if(address == charOut && outputFile != nullptr) {
         // Use a temporary (anonymous) text stream to make writing easy.
@@ -161,22 +167,41 @@ void ASMRunHelper::runProgram()
     }
 
     // Make sure to set up any last minute flags needed by CPU to perform simulation.
-    cpu->onSimulationStarted();
+    if(hybrid.isNull()) cpu->onSimulationStarted();
+    else hybrid->onSimulationStarted();
     cpu->runUntilLoaded();
     qDebug().noquote() << "User program has been loaded.\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n";
     QThread::currentThread()->msleep(1000);
-    if(!cpu->onRun()) {
+    bool success = hybrid.isNull() ? cpu->onRun() : runHybrid();
+    if(!success) {
+        // Report the error of whichever CPU was executing when it occurred.
+        QString errorMessage = (microCpu.isNull() || cpu->hadErrorOnStep()) ? cpu->getErrorMessage()
+                                                                            : microCpu->getErrorMessage();
         qDebug().noquote()
                 << "The CPU failed for the following reason: "
-                << cpu->getErrorMessage();
+                << errorMessage;
         QTextStream (&*outputFile)
                 << "[["
-                << cpu->getErrorMessage()
+                << errorMessage
                 << "]]";
     }
 
 }
 
+bool ASMRunHelper::runHybrid()
+{
+    // The program stopped, or failed, before reaching the microcode.
+    if(!hybrid->fastForward(fastForwardInstructions)) {
+        return !cpu->hadErrorOnStep();
+    }
+    hybrid->switchToMicrocode();
+    bool success = microCpu->onRun();
+    // Cycles include the time spent waiting on memory, such as for cache misses.
+    std::cout << "\n" << QString("Microcode executed %1 instructions in %2 cycles.\n")
+                 .arg(microCpu->getInstructionCount()).arg(microCpu->getCycleCount()).toStdString() << std::flush;
+    return success;
+}
+
 void ASMRunHelper::run()
 {
 
@@ -188,7 +213,28 @@ void ASMRunHelper::run()
         QSharedPointer<RAMChip> ramChip(new RAMChip(1<<16, 0, memory.get()));
         memory->insertChip(ramChip, 0);
 
-        cpu = QSharedPointer<BoundExecIsaCpu>::create(maxSimSteps, &manager, memory, nullptr);
+        // The CPU only sees the cache, while IO and loading still go to the memory it wraps.
+        QSharedPointer<AMemoryDevice> cpuMemory = memory;
+        if(useCache) {
+            cache = QSharedPointer<CacheMemory>::create(memory, cacheConfig);
+            cpuMemory = cache;
+        }
+        cpu = QSharedPointer<BoundExecIsaCpu>::create(maxSimSteps, &manager, cpuMemory, nullptr);
+        if(!microprogram.isNull()) {
+            microCpu = QSharedPointer<BoundExecMicroCpu>::create(maxMicroCycles, &manager, cpuMemory, nullptr);
+            microCpu->setMicrocodeProgram(microprogram);
+            hybrid = QSharedPointer<HybridCPUController>::create(cpu, microCpu);
+        }
+        if(!profileFile.filePath().isEmpty()) {
+            profiler = QSharedPointer<IsaProfiler>::create();
+            cpu->setProfiler(profiler);
+            // Calls continue across the switch, so both levels share a profile.
+            if(!microCpu.isNull()) microCpu->setProfiler(profiler);
+        }
+        if(!memoryStatsFile.filePath().isEmpty()) {
+            memoryStats = QSharedPointer<MemoryAccessStats>::create();
+            cpuMemory->setAccessStats(memoryStats.data());
+        }
 
         // Connect IO events. IO *MUST* complete before execution moves forward.
         // Use a blocking connection to serialize IO. Use asynchronous connection
@@ -209,6 +255,10 @@ void ASMRunHelper::run()
     // Clear & initialize all values in CPU before starting simulation.
     cpu->reset();
     cpu->initCPU();
+    if(!microCpu.isNull()) {
+        microCpu->onResetCPU();
+        microCpu->initCPU();
+    }
 
     // Instead of directly allowing run() to kill itself, uses events to "schedule"
     // shutting down the application. This should ensure all IO completes. We were
@@ -216,7 +266,13 @@ void ASMRunHelper::run()
     // cause a race condition with IO pending for the file. The overhead of the simulation events
     // seems to "serialize" writes / closing.
     connect(cpu.get(), &IsaCpu::simulationFinished, this, &ASMRunHelper::onSimulationFinished);
+    if(!microCpu.isNull()) {
+        connect(microCpu.get(), &FullMicrocodedCPU::simulationFinished, this, &ASMRunHelper::onSimulationFinished);
+    }
     runProgram();
+    if(!profiler.isNull()) writeProfile();
+    if(!memoryStats.isNull()) writeMemoryStats();
+    if(!cache.isNull()) writeCacheStats();
 
     // Make sure any outstanding events are handled.
     QCoreApplication::processEvents();
@@ -226,3 +282,84 @@ void ASMRunHelper::set_echo_charout(bool echo)
 {
     this->echo = echo;
 }
+
+void ASMRunHelper::set_profile_file(QString profile_file)
+{
+    profileFile = QFileInfo(profile_file);
+}
+
+void ASMRunHelper::writeProfile()
+{
+    // Object code has no symbols, so only the functions of the operating system can be named.
+    IsaProfiler::SymbolNamer namer = IsaProfiler::symbolNamer(&manager);
+    QFile file(profileFile.absoluteFilePath());
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
+        qDebug().noquote() << errLogOpenErr.arg(file.fileName());
+        return;
+    }
+    QTextStream(&file) << profiler->getFoldedStacks(namer);
+    file.close();
+
+    std::cout << "\n" << QString("%1 %2 %3 %4").arg(QString("Function"), -16).arg(QString("Calls"), 12)
+                 .arg(QString("Inclusive"), 14).arg(QString("Exclusive"), 14).toStdString() << "\n";
+    for(const IsaProfiler::FunctionStats& function : profiler->getFunctionStats(namer)) {
+        std::cout << QString("%1 %2 %3 %4").arg(function.name, -16).arg(function.calls, 12)
+                     .arg(function.inclusiveInstructions, 14).arg(function.exclusiveInstructions, 14)
+                     .toStdString() << "\n";
+    }
+    std::cout << std::flush;
+}
+
+void ASMRunHelper::set_memory_stats_file(QString stats_file)
+{
+    memoryStatsFile = QFileInfo(stats_file);
+}
+
+void ASMRunHelper::writeMemoryStats()
+{
+    QFile file(memoryStatsFile.absoluteFilePath());
+    if(!file.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
+        qDebug().noquote() << errLogOpenErr.arg(file.fileName());
+        return;
+    }
+    QTextStream(&file) << "first_instruction,instructions,pages,written_pages,lowest_written_page,highest_written_page\n"
+                       << memoryStats->getWorkingSetReport();
+    file.close();
+
+    using Access = MemoryAccessStats::Access;
+    std::cout << "\n" << QString("%1 %2 %3 %4").arg(QString("Page"), -6).arg(QString("Reads"), 12)
+                 .arg(QString("Writes"), 12).arg(QString("Executes"), 12).toStdString() << "\n";
+    // Only list the pages that were accessed, which for most programs is a small part of memory.
+    for(int page = 0; page < AMemoryDevice::pageCount; page++) {
+        auto asPage = static_cast<quint8>(page);
+        quint64 reads = memoryStats->getPageCount(Access::Read, asPage);
+        quint64 writes = memoryStats->getPageCount(Access::Write, asPage);
+        quint64 executes = memoryStats->getPageCount(Access::Execute, asPage);
+        if(reads == 0 && writes == 0 && executes == 0) continue;
+        QString address = "0x" + QString("%1").arg(page * AMemoryDevice::pageSize, 4, 16, QLatin1Char('0')).toUpper();
+        std::cout << QString("%1 %2 %3 %4").arg(address, -6).arg(reads, 12).arg(writes, 12).arg(executes, 12)
+                     .toStdString() << "\n";
+    }
+    std::cout << std::flush;
+}
+
+void ASMRunHelper::set_cache_config(CacheConfig config)
+{
+    useCache = true;
+    cacheConfig = config;
+}
+
+void ASMRunHelper::set_microprogram(QSharedPointer<MicrocodeProgram> microprogram, quint64 fast_forward, quint64 max_cycles)
+{
+    this->microprogram = microprogram;
+    fastForwardInstructions = fast_forward;
+    maxMicroCycles = max_cycles;
+}
+
+void ASMRunHelper::writeCacheStats()
+{
+    const CacheConfig& config = cache->getConfig();
+    std::cout << "\n" << QString("Cache: %1 bytes, %2 byte lines, %3 way\n")
+                 .arg(config.size).arg(config.lineSize).arg(config.associativity).toStdString()
+              << cache->getStats().toString().toStdString() << std::flush;
+}
@@ -25,9 +25,16 @@
 #include <QtCore>
 #include <QRunnable>
 
+#include "cachememory.h"
+
 class AsmProgramManager;
 class BoundExecIsaCpu;
+class BoundExecMicroCpu;
+class HybridCPUController;
+class IsaProfiler;
+class MemoryAccessStats;
 class MainMemory;
+class MicrocodeProgram;
 
 /*
  * This class is responsible for executing a single assembly language program.
@@ -78,6 +85,22 @@ public:
 
     // Echo the values written to CharOut to the console.
     void set_echo_charout(bool echo);
+
+    // Profile the program. Once it finishes, write its folded call stacks to profile_file,
+    // and print the hottest functions to the console.
+    void set_profile_file(QString profile_file);
+
+    // Count the memory accesses of the program. Once it finishes, write its working set over time
+    // to stats_file, and print the accesses to each page to the console.
+    void set_memory_stats_file(QString stats_file);
+
+    // Run the program through a cache of the given shape. Once it finishes, print the cache's statistics.
+    void set_cache_config(CacheConfig config);
+
+    // Execute the user program on a microcoded CPU running microprogram, which must use the two byte
+    // data bus and full control section. The loader and the first fast_forward instructions of the
+    // user program execute at the ISA level, after which at most max_cycles execute in microcode.
+    void set_microprogram(QSharedPointer<MicrocodeProgram> microprogram, quint64 fast_forward, quint64 max_cycles);
 private:
     const QString objectCodeString;
     QFileInfo programOutput, programInput;
@@ -107,13 +130,39 @@ private:
     // Control if the values written to CharOut get echoed to the console.
     bool echo = false;
 
+    // If set, the profile is written here.
+    QFileInfo profileFile;
+    QSharedPointer<IsaProfiler> profiler;
+    // If set, the memory access statistics are written here.
+    QFileInfo memoryStatsFile;
+    QSharedPointer<MemoryAccessStats> memoryStats;
+    // If set, the CPU accesses memory through a cache of this shape.
+    bool useCache = false;
+    CacheConfig cacheConfig;
+    QSharedPointer<CacheMemory> cache;
+    // If set, the user program finishes on microCpu, which shares memory with cpu.
+    QSharedPointer<MicrocodeProgram> microprogram;
+    quint64 fastForwardInstructions = 0, maxMicroCycles = 0;
+    QSharedPointer<BoundExecMicroCpu> microCpu;
+    QSharedPointer<HybridCPUController> hybrid;
+
     // Helper method responsible for buffering input, opening output streams,
     // converting string object code to a byte list, and executing the object
     // code in memory.
     void runProgram();
+    // Fast forward the user program at the ISA level, and then finish it in microcode.
+    // Returns false if either CPU failed.
+    bool runHybrid();
 
     // Load the object code of the operating system into memory from manager.
     void loadOperatingSystem();
 
+    // Write the profile of the completed program.
+    void writeProfile();
+    // Write the memory access statistics of the completed program.
+    void writeMemoryStats();
+    // Print the statistics of the cache.
+    void writeCacheStats();
+
 };
 #endif // ASMRUNHELPER_H
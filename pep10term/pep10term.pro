@@ -50,7 +50,8 @@ SOURCES += \
     microstephelper.cpp \
     termhelper.cpp \
     boundexecisacpu.cpp \
-    termmain.cpp
+    termmain.cpp \
+    verifyhelper.cpp
 
 # Default rules for deployment.
 qnx: target.path = /tmp/$${TARGET}/bin
@@ -67,7 +68,8 @@ HEADERS += \
     microstephelper.h \
     termformatter.h \
     termhelper.h \
-    boundexecisacpu.h
+    boundexecisacpu.h \
+    verifyhelper.h
 
 RESOURCES += \
     ../pep10asm/pep10asm-macros.qrc \
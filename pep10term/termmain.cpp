@@ -32,6 +32,7 @@
 #include "asmprogrammanager.h"
 #include "boundexecisacpu.h"
 #include "boundexecmicrocpu.h"
+#include "cachememory.h"
 #include "CLI11.hpp"
 #include "cpubuildhelper.h"
 #include "cpurunhelper.h"
@@ -41,6 +42,7 @@
 #include "microstephelper.h"
 #include "pep.h"
 #include "termformatter.h"
+#include "verifyhelper.h"
 
 const std::string application_description = "Translate and run Pep/10 assembly language and microcode programs.";
 const std::string asm_description = "Assemble a Pep/10 assembler source code program to object code.";
@@ -50,6 +52,7 @@ const std::string cpuasm_description = "Check a Pep/10 microcode program for syn
 const std::string cpurun_description = "Run a Pep/10 microcode program with an optional list of preconditions.";
 const std::string macros_description = "Print all available macros.";
 const std::string listing_description = "Print the listing of a macro.";
+const std::string verify_description = "Verify a Pep/10 microcode program against the ISA level semantics of every instruction.";
 
 const std::string asm_description_detailed = "Assemble a Pep/1- assembler source code program to object code. \
 The source_file must be a .pep file. \
@@ -72,6 +75,13 @@ If there are micro-assembly errors or UnitPost errors an error log file named <s
 If there are no errors the error log file is not created. \
 Supports 1- and 2-byte data buses with the 1-byte data bus as the default.";
 
+const std::string verify_description_detailed = "Verify a Pep/10 microcode program against the ISA level semantics of every instruction. \
+The source_file must be a .pepcpu file using the 2-byte data bus and the full control section. \
+Every instruction specifier is executed from many random register, status bit, and memory states by both the microcode \
+and the ISA level simulator, spread across all cores. \
+The first divergence for each instruction specifier is written to the console. \
+If there are micro-assembly errors an error log file named <source_file>_errLog.txt is created with the error messages.";
+
 const std::string asm_input_file_text = "Input Pep/10 source program for assembler.";
 const std::string asm_output_file_text = "Output object code generated from source.";
 const std::string asm_run_log = "Override the name of the default error log file.";
@@ -79,6 +89,19 @@ const std::string obj_input_file_text = "Input Pep/10 object code program for si
 const std::string charin_file_text = "File buffered behind the charIn input port.";
 const std::string charout_file_text = "File to which the charOut output port is streamed..";
 const std::string charout_echo_text = "Echo data written to charOut to std::out.";
+const std::string profile_file_text = "Profile the program, writing a flamegraph compatible folded-stack file \
+and printing the instructions spent in each function.";
+const std::string memory_stats_file_text = "Count the memory accesses of the program, writing its working set \
+over time as CSV and printing the accesses to each page.";
+const std::string cache_spec_text = "Simulate a cache in front of memory, printing its hits and misses. \
+The cache is described by comma separated key=value pairs, such as size=512,ways=4,replace=fifo. \
+Keys are size, line, ways, replace (lru, fifo, random), write (back, through), allocate (yes, no), \
+hit, latency, and seed.";
+const std::string run_microcode_text = "Execute the user program on the microcoded CPU, using this Pep/10 microcode program. \
+The microcode program must use the 2-byte data bus and the full control section. \
+The loader is executed at the ISA level, and the cycles executed by the microcode are printed when the program finishes.";
+const std::string run_fast_forward_text = "The number of user program instructions executed at the ISA level \
+before switching to the microcoded CPU. Defaults to 0.";
 
 const std::string listing_name = "The name of the macro whose listing is to be shown.";
 
@@ -95,10 +118,19 @@ const std::string cpu_preconditions = "A Pep/10 .pepcpu file containg UnitPre an
 Using this flag overrides all UnitPre and UnitPost statements in source_file.";
 const std::string cpu_run_log = "Override the name of the default error log file.";
 
+const std::string verify_trials_text = "The number of random states in which each instruction specifier is executed. Defaults to 1000.";
+const std::string verify_seed_text = "Seed from which random states are generated. Defaults to 0.";
+const std::string verify_threads_text = "The number of threads used for verification. Defaults to one per core.";
+const std::string verify_cycles_text = "The maximum number of CPU cycles a single instruction may execute. Defaults to 1000.";
+const std::string verify_report_text = "File to which the result for every instruction specifier is written.";
+
 struct command_line_values {
     bool had_version{false}, had_about{false}, had_d2{false}, had_full_control{false}, had_echo_output{false};
-    std::string e{}, s{}, o{}, i{}, mc{}, p{};
+    std::string e{}, s{}, o{}, i{}, mc{}, p{}, profile{}, memory_stats{}, cache{}, microcode{};
     uint64_t m{2500};
+    uint64_t fast_forward{0}, max_micro_cycles{0};
+    uint64_t trials{1000}, seed{0}, max_cycles{1000};
+    int threads{0};
     bool early_exit = false;
 };
 
@@ -110,6 +142,7 @@ void handle_asm(command_line_values&, QSharedPointer<MacroRegistry>, QRunnable**
 void handle_run(command_line_values&, QRunnable**);
 void handle_cpuasm(command_line_values&, QRunnable**);
 void handle_cpurun(command_line_values&, QRunnable**);
+void handle_verify(command_line_values&, QRunnable**);
 void handle_macros(command_line_values&, QSharedPointer<MacroRegistry>);
 void handle_listing(command_line_values&, QSharedPointer<MacroRegistry>);
 
@@ -186,6 +219,27 @@ int main(int argc, char *argv[])
     run_subcommand->add_option("-o", values.o, charout_file_text)->expected(1);
     parameter_formatting["run"]["o"] = "charout_file";
     run_subcommand->add_flag("--echo-output", values.had_echo_output, charout_echo_text);
+    // File where the folded call stacks of a profile will be stored.
+    run_subcommand->add_option("--profile", values.profile, profile_file_text)->expected(1);
+    parameter_formatting["run"]["profile"] = "profile_file";
+    // File where the working set of the program will be stored.
+    run_subcommand->add_option("--memory-stats", values.memory_stats, memory_stats_file_text)->expected(1);
+    parameter_formatting["run"]["memory-stats"] = "stats_file";
+    // Shape and policies of a cache placed in front of memory.
+    run_subcommand->add_option("--cache", values.cache, cache_spec_text)->expected(1);
+    parameter_formatting["run"]["cache"] = "cache_spec";
+    // Microprogram on which the user program will be executed.
+    auto run_microcode_option = run_subcommand->add_option("--microcode", values.microcode, run_microcode_text)->expected(1);
+    parameter_formatting["run"]["microcode"] = "microcode_file";
+    run_subcommand->add_option("--fast-forward", values.fast_forward, run_fast_forward_text)->expected(1)
+            ->needs(run_microcode_option);
+    parameter_formatting["run"]["fast-forward"] = "instructions";
+    // Maximum number of cycles to be executed by the microcode.
+    std::string run_max_cycles_text = QString::fromStdString(microMaxStepText).arg(BoundExecMicroCpu::getDefaultMaxCycles()).toStdString();
+    run_subcommand->add_option("--max-cycles", values.max_micro_cycles, run_max_cycles_text)->expected(1)
+            ->check(CLI::PositiveNumber)->needs(run_microcode_option)
+            ->default_val(std::to_string(BoundExecMicroCpu::getDefaultMaxCycles()));
+    parameter_formatting["run"]["max-cycles"] = "max_cycles";
     //run_subcommand->add_option("-e", obj_input_file_text);
     // Maximum number of instructions to be executed.
     std::string max_steps_text = QString::fromStdString(isaMaxStepText).arg(BoundExecIsaCpu::getDefaultMaxSteps()).toStdString();
@@ -241,6 +295,29 @@ int main(int argc, char *argv[])
     // Create a runnable application from command line arguments
     cpurun_subcommand->callback(std::function<void()>([&](){handle_cpurun(values, &run);}));
 
+    // Subcommands for VERIFY
+    parameter_formatting.insert_or_assign("verify", std::map<std::string,std::string>());
+    auto verify_subcommand = parser.add_subcommand("verify", verify_description);
+    detailed_descriptions["verify"] = verify_description_detailed;
+    // File where errors will be written. By default, will be written to a file based on the mc name.
+    verify_subcommand->add_option("-e", values.e, cpu_run_log)->expected(1);
+    parameter_formatting["verify"]["e"] = "error_file";
+    // File where the result of each instruction will be written.
+    verify_subcommand->add_option("-o", values.o, verify_report_text)->expected(1);
+    parameter_formatting["verify"]["o"] = "report_file";
+    verify_subcommand->add_option("-n", values.trials, verify_trials_text)->expected(1)->check(CLI::PositiveNumber);
+    parameter_formatting["verify"]["n"] = "trials";
+    verify_subcommand->add_option("-j", values.threads, verify_threads_text)->expected(1)->check(CLI::PositiveNumber);
+    parameter_formatting["verify"]["j"] = "threads";
+    verify_subcommand->add_option("-m", values.max_cycles, verify_cycles_text)->expected(1)->check(CLI::PositiveNumber);
+    parameter_formatting["verify"]["m"] = "max_cycles";
+    verify_subcommand->add_option("--seed", values.seed, verify_seed_text)->expected(1);
+    parameter_formatting["verify"]["seed"] = "seed";
+    // Microcode input file.
+    verify_subcommand->add_option("-s", values.mc, cpuasm_input_file_text)->expected(1)->required(true);
+    parameter_formatting["verify"]["s"] = "microcode_file";
+    verify_subcommand->callback(std::function<void()>([&](){handle_verify(values, &run);}));
+
     // Subcommands for MACROS
     auto macros_subcommand = parser.add_subcommand("macros", macros_description);
     macros_subcommand->callback(std::function<void()>([&](){handle_macros(values, registry);}));
@@ -375,6 +452,35 @@ void handle_run(command_line_values &values,
     QString textOutputFileName = QString::fromStdString(values.o);
     // Attempt to parse stepMax string as an integer.
     quint64 stepMaxValue = values.m;
+    // Reject a malformed cache before doing any work.
+    CacheConfig cacheConfig;
+    if(!values.cache.empty()) {
+        QString error = CacheConfig::parse(QString::fromStdString(values.cache), cacheConfig);
+        if(!error.isEmpty()) throw CLI::ValidationError(error.toStdString(), -1);
+    }
+    // Likewise, reject a microprogram that fails to assemble.
+    QSharedPointer<MicrocodeProgram> microprogram;
+    if(!values.microcode.empty()) {
+        QFile microcodeFile(QString::fromStdString(values.microcode));
+        if(!microcodeFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+            throw CLI::ValidationError(errLogOpenErr.arg(microcodeFile.fileName()).toStdString(), -1);
+        }
+        QString microprogramText = Pep::removeCycleNumbers(QTextStream(&microcodeFile).readAll());
+        microcodeFile.close();
+        // Only the full microcoded CPU can execute object code.
+        Pep::initMicroEnumMnemonMaps(Enu::CPUType::TwoByteDataBus, true);
+        auto programResult = buildMicroprogramHelper(Enu::CPUType::TwoByteDataBus, true, microprogramText);
+        if(!programResult.elist.isEmpty()) {
+            const auto& firstError = programResult.elist.first();
+            QString error = QString("Microcode failed to assemble. Line %1: %2")
+                    .arg(firstError.first + 1).arg(firstError.second);
+            throw CLI::ValidationError(error.toStdString(), -1);
+        }
+        else if(!programResult.success || programResult.program.isNull()) {
+            throw CLI::ValidationError("Microcode failed to assemble.", -1);
+        }
+        microprogram = programResult.program;
+    }
 
     // Load object code string from file if possible, else print error log.
     QFile objFile(objCodeFileName);
@@ -390,6 +496,18 @@ void handle_run(command_line_values &values,
     ASMRunHelper *helper = new ASMRunHelper(objText, stepMaxValue, textOutputFileName,
                                             textInputFileName, *AsmProgramManager::getInstance());
     helper->set_echo_charout(values.had_echo_output);
+    if(!values.profile.empty()) {
+        helper->set_profile_file(QString::fromStdString(values.profile));
+    }
+    if(!values.memory_stats.empty()) {
+        helper->set_memory_stats_file(QString::fromStdString(values.memory_stats));
+    }
+    if(!values.cache.empty()) {
+        helper->set_cache_config(cacheConfig);
+    }
+    if(!microprogram.isNull()) {
+        helper->set_microprogram(microprogram, values.fast_forward, values.max_micro_cycles);
+    }
     QObject::connect(helper, &ASMRunHelper::finished, QCoreApplication::instance(), &QCoreApplication::quit);
 
     (*runnable) = helper;
@@ -517,6 +635,43 @@ void handle_cpurun(command_line_values &values, QRunnable **run)
     }
 }
 
+void handle_verify(command_line_values &values, QRunnable **run)
+{
+    // Needs a microcode source program to be well defined.
+    if(values.mc.empty()) {
+        throw CLI::ValidationError("Must set microcode input (-s).", -1);
+    }
+
+    // Verification always uses the full microcoded CPU.
+    Pep::initMicroEnumMnemonMaps(Enu::CPUType::TwoByteDataBus, true);
+
+    QString microcodeFileName = QString::fromStdString(values.mc);
+    QFile microcodeFile(microcodeFileName);
+    if(!microcodeFile.open(QIODevice::ReadOnly | QIODevice::Text)) {
+        throw CLI::ValidationError(errLogOpenErr.arg(microcodeFile.fileName()).toStdString(), -1);
+    }
+
+    QTextStream microprogramStream(&microcodeFile);
+    QString microprogramText = Pep::removeCycleNumbers(microprogramStream.readAll());
+    microcodeFile.close();
+
+    VerifyHelper *helper = new VerifyHelper(microprogramText, QFileInfo(microcodeFile),
+                                            *AsmProgramManager::getInstance(), nullptr);
+    helper->set_trials(values.trials);
+    helper->set_seed(values.seed);
+    helper->set_threads(values.threads);
+    helper->set_max_cycles(values.max_cycles);
+    if(!values.e.empty()) {
+        helper->set_error_file(QString::fromStdString(values.e));
+    }
+    if(!values.o.empty()) {
+        helper->set_report_file(QString::fromStdString(values.o));
+    }
+
+    QObject::connect(helper, &VerifyHelper::finished, QCoreApplication::instance(), &QCoreApplication::quit);
+    (*run) = helper;
+}
+
 void handle_macros(command_line_values &values, QSharedPointer<MacroRegistry> registry)
 {
     values.early_exit = true;
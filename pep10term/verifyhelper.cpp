@@ -0,0 +1,146 @@
+// File: verifyhelper.cpp
+/*
+    Pep10Term is a  command line tool utility for assembling Pep/10 programs to
+    object code and executing object code programs.
+
+    Copyright (C) 2019-2020 J. Stanley Warford & Matthew McRaven, Pepperdine University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#include "verifyhelper.h"
+
+#include <QElapsedTimer>
+
+#include "cpubuildhelper.h"
+#include "microprogramverifier.h"
+#include "termhelper.h"
+
+VerifyHelper::VerifyHelper(const QString microcodeProgram, QFileInfo microcodeProgramFile,
+                           const AsmProgramManager& manager, QObject *parent) :
+    QObject(parent), microcodeProgram(microcodeProgram),
+    microcodeProgramFile(microcodeProgramFile), manager(manager)
+{
+    // Default error log name to the base name of the file with an _errLog.txt extension.
+    this->error_log = microcodeProgramFile.absoluteDir().absoluteFilePath(
+                microcodeProgramFile.baseName() + "_errLog.txt");
+}
+
+VerifyHelper::~VerifyHelper() = default;
+
+void VerifyHelper::set_trials(quint64 trials)
+{
+    this->trials = trials;
+}
+
+void VerifyHelper::set_seed(quint64 seed)
+{
+    this->seed = seed;
+}
+
+void VerifyHelper::set_threads(int threads)
+{
+    this->threads = threads;
+}
+
+void VerifyHelper::set_max_cycles(quint64 max_cycles)
+{
+    this->max_cycles = max_cycles;
+}
+
+void VerifyHelper::set_error_file(QString error_file)
+{
+    this->error_log = error_file;
+}
+
+void VerifyHelper::set_report_file(QString report_file)
+{
+    this->report = report_file;
+}
+
+void VerifyHelper::run()
+{
+    auto programResult = buildMicroprogramHelper(Enu::CPUType::TwoByteDataBus, true,
+                                                 microcodeProgram);
+    // If there were errors assembling input program, attempt to write all of
+    // them to the error file.
+    // If the error file can't be opened, log that failure to standard output.
+    if(!programResult.elist.isEmpty()) {
+        QFile errorLog(error_log.absoluteFilePath());
+        if(!errorLog.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
+            qDebug().noquote() << errLogOpenErr.arg(errorLog.fileName());
+        }
+        else {
+            QTextStream errAsStream(&errorLog);
+            auto textList = microcodeProgram.split("\n");
+            for(const auto& errorPair : programResult.elist) {
+                // The first element of the error pair is the line number which
+                // caused the error, allowing us to write the offending line
+                // and error message to the console.
+                errAsStream << textList[errorPair.first] << errorPair.second << endl;
+            }
+            // Error log should be flushed automatically.
+            errorLog.close();
+        }
+    }
+    if(!programResult.success || programResult.program.isNull() || !programResult.elist.isEmpty()) {
+        qDebug() << "Error(s) generated in microcode input. See error log.";
+        emit finished();
+        return;
+    }
+    qDebug() << "Program assembled successfully.";
+
+    MicroprogramVerifier verifier(programResult.program, &manager);
+    verifier.setTrialsPerInstruction(trials);
+    verifier.setSeed(seed);
+    verifier.setMaxCyclesPerInstruction(max_cycles);
+    if(threads > 0) verifier.setThreadCount(threads);
+
+    QElapsedTimer timer;
+    timer.start();
+    auto results = verifier.verify();
+    auto elapsed = timer.elapsed();
+
+    // Report every instruction if requested, but only divergences on the console.
+    QFile reportFile(report.absoluteFilePath());
+    bool writeReport = !report.filePath().isEmpty();
+    if(writeReport && !reportFile.open(QIODevice::WriteOnly | QIODevice::Text | QIODevice::Truncate)) {
+        qDebug().noquote() << errLogOpenErr.arg(reportFile.fileName());
+        writeReport = false;
+    }
+    QTextStream reportStream(&reportFile);
+    int diverged = 0;
+    quint64 totalTrials = 0;
+    for(const auto& result : results) {
+        QString line = MicroprogramVerifier::formatResult(result);
+        if(writeReport) reportStream << line << endl;
+        if(!result.passed) {
+            qDebug().noquote() << line;
+            diverged++;
+        }
+        totalTrials += result.trials;
+    }
+    if(writeReport) reportFile.close();
+
+    qDebug().noquote().nospace() << "Executed " << totalTrials << " trials in " << elapsed << " ms using "
+                                 << verifier.getThreadCount() << " threads.";
+    if(diverged == 0) {
+        qDebug() << "Microcode matches the ISA level for all instructions.";
+    }
+    else {
+        qDebug().noquote().nospace() << "Microcode diverged from the ISA level for "
+                                     << diverged << " of " << results.size() << " instruction specifiers.";
+    }
+    emit finished();
+}
@@ -0,0 +1,81 @@
+// File: verifyhelper.h
+/*
+    Pep10Term is a  command line tool utility for assembling Pep/10 programs to
+    object code and executing object code programs.
+
+    Copyright (C) 2019-2020 J. Stanley Warford & Matthew McRaven, Pepperdine University
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 3 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+*/
+
+#ifndef VERIFYHELPER_H
+#define VERIFYHELPER_H
+
+#include <QFileInfo>
+#include <QObject>
+#include <QRunnable>
+
+class AsmProgramManager;
+
+/*
+ * This class is responsible for verifying a Pep/10 Micro microcode program against
+ * the ISA level semantics of every instruction, using a MicroprogramVerifier.
+ *
+ * The microcode program must be a full control section, two byte data bus program,
+ * with line numbers already stripped. The default operating system must already be
+ * installed in the program manager.
+ *
+ * If the program fails to assemble, an error log is written like cpurun would.
+ * Otherwise, the result for every instruction specifier is written to the report file,
+ * and each divergence is also written to the console.
+ *
+ * When verification finishes, finished() will be emitted so that the application may shut down safely.
+ */
+class VerifyHelper: public QObject, public QRunnable {
+    Q_OBJECT
+public:
+    explicit VerifyHelper(QString microcodeProgram, QFileInfo microcodeProgramFile,
+                          const AsmProgramManager& manager,
+                          QObject *parent = nullptr);
+    ~VerifyHelper() override;
+
+    void set_trials(quint64 trials);
+    void set_seed(quint64 seed);
+    // If threads is 0, use one thread per core.
+    void set_threads(int threads);
+    void set_max_cycles(quint64 max_cycles);
+    // Instead of using the microcode file as a base file name, manually specify the error file path.
+    void set_error_file(QString error_file);
+    void set_report_file(QString report_file);
+
+signals:
+    // Signals fired when the verification completes, or microcode assembly fails.
+    void finished();
+
+public:
+    // Pre: The Pep10 mnemonic maps have been initialized for a two byte bus with a full control section.
+    // Pre: The microcode program does not contain line numbers.
+    // Post:All instruction specifiers have been verified, and their results reported.
+    void run() override;
+
+private:
+    const QString microcodeProgram;
+    QFileInfo microcodeProgramFile;
+    const AsmProgramManager& manager;
+    QFileInfo error_log, report;
+    quint64 trials{1000}, seed{0}, max_cycles{1000};
+    int threads{0};
+};
+
+#endif // VERIFYHELPER_H
@@ -14,22 +14,52 @@ win32{
 }
 
 SOURCES +=  \
+    testhelpers.cpp \
     testmain.cpp \
+    tst_alu.cpp \
     tst_assembleos.cpp \
     tst_assembleprograms.cpp \
     tst_assembler.cpp \
+    tst_cachememory.cpp \
+    tst_compiledmicrostep.cpp \
+    tst_hybridcpucontroller.cpp \
+    tst_instructionsummary.cpp \
+    tst_isaprofiler.cpp \
+    tst_isaundolog.cpp \
     tst_linker.cpp \
+    tst_memoryaccessstats.cpp \
+    tst_microdecodertable.cpp \
+    tst_microprogramverifier.cpp \
+    tst_microtracerecorder.cpp \
     tst_prepreocessorfail.cpp \
+    tst_snapshotpublisher.cpp \
+    tst_stacktrace.cpp \
+    tst_symboltable.cpp \
     tst_tokenbuffer.cpp \
     tst_tokenizer.cpp \
     tst_userosintegration.cpp
 
 HEADERS += \
+    testhelpers.h \
+    tst_alu.h \
     tst_assembleos.h \
     tst_assembleprograms.h \
     tst_assembler.h \
+    tst_cachememory.h \
+    tst_compiledmicrostep.h \
+    tst_hybridcpucontroller.h \
+    tst_instructionsummary.h \
+    tst_isaprofiler.h \
+    tst_isaundolog.h \
     tst_linker.h \
+    tst_memoryaccessstats.h \
+    tst_microdecodertable.h \
+    tst_microprogramverifier.h \
+    tst_microtracerecorder.h \
     tst_prepreocessorfail.h \
+    tst_snapshotpublisher.h \
+    tst_stacktrace.h \
+    tst_symboltable.h \
     tst_tokenbuffer.h \
     tst_tokenizer.h \
     tst_userosintegration.h
@@ -37,6 +67,7 @@ HEADERS += \
 INCLUDEPATH += $$PWD/../../pep10common
 INCLUDEPATH += $$PWD/../../pep10asm
 INCLUDEPATH += $$PWD/../../pep10cpu
+INCLUDEPATH += $$PWD/../../pep10micro
 
 #Include own directory in VPATH, otherwise qmake might accidentally import files with
 #the same name from other directories.
@@ -44,11 +75,15 @@ VPATH += $$PWD
 VPATH += $$PWD/../../pep10common
 VPATH += $$PWD/../../pep10asm
 VPATH += $$PWD/../../pep10cpu
+VPATH += $$PWD/../../pep10micro
 include(../../pep10common/pep10common.pro)
 include(../../pep10asm/pep10asm-common.pro)
 include(../../pep10cpu/pep10cpu-common.pro)
+include(../../pep10micro/pep10micro-common.pro)
 
 #Must manually add resource files we care about.
 RESOURCES += \
     ../../pep10asm/pep10asm-macros.qrc \
     ../../pep10asm/pep10asm-helpresources.qrc \
+    ../../pep10cpu/pep10cpu-helpresources.qrc \
+    ../../pep10micro/pep10micro-helpresources.qrc \
@@ -0,0 +1,178 @@
+#include "testhelpers.h"
+
+#include <QDirIterator>
+#include <QFileInfo>
+
+#include "asmprogram.h"
+#include "asmprogrammanager.h"
+#include "fullmicrocodedcpu.h"
+#include "isacpu.h"
+#include "macroassemblerdriver.h"
+#include "macroregistry.h"
+#include "mainmemory.h"
+#include "memorychips.h"
+#include "microasm.h"
+#include "microcode.h"
+#include "microcodeprogram.h"
+#include "pep.h"
+#include "registerfile.h"
+#include "symboltable.h"
+
+QSharedPointer<MainMemory> createMemory()
+{
+    auto memory = QSharedPointer<MainMemory>::create(nullptr);
+    QSharedPointer<RAMChip> ramChip(new RAMChip(1<<16, 0, memory.get()));
+    memory->insertChip(ramChip, 0);
+    return memory;
+}
+
+// The operating system registers its system calls as macros, so user programs
+// must be assembled with the registry the operating system was assembled with.
+static QSharedPointer<MacroRegistry> sharedRegistry()
+{
+    static auto registry = QSharedPointer<MacroRegistry>::create();
+    return registry;
+}
+
+bool installOperatingSystem()
+{
+    auto manager = AsmProgramManager::getInstance();
+    if(!manager->getOperatingSystem().isNull()) return true;
+    QString osText = Pep::resToString(":/help-asm/figures/pep10os.pep", false);
+    MacroAssemblerDriver assembler(sharedRegistry());
+    auto asmResult = assembler.assembleOperatingSystem(osText);
+    if(!asmResult.success || asmResult.program.isNull()) return false;
+    manager->setOperatingSystem(asmResult.program);
+    return true;
+}
+
+QSharedPointer<AsmProgram> assembleUserProgram(const QString &text, QString &error)
+{
+    auto os = AsmProgramManager::getInstance()->getOperatingSystem();
+    MacroAssemblerDriver assembler(sharedRegistry());
+    auto asmResult = assembler.assembleUserProgram(text, os->getSymbolTable());
+    if(!asmResult.success || asmResult.program.isNull()) {
+        error = "User program failed to assemble.";
+        return nullptr;
+    }
+    return asmResult.program;
+}
+
+void loadOperatingSystemAndProgram(MainMemory &memory, const AsmProgram &program)
+{
+    auto os = AsmProgramManager::getInstance()->getOperatingSystem();
+    memory.loadValues(os->getBurnAddress(), os->getObjectCode());
+    memory.loadValues(program.getBurnAddress(), program.getObjectCode());
+}
+
+QString branchingProgramText()
+{
+    return QString(
+        "         BR      main\n"
+        "total:   .WORD   0\n"
+        "odd:     .WORD   0\n"
+        "table:   .WORD   7\n"
+        "         .WORD   -12\n"
+        "         .WORD   300\n"
+        "         .WORD   -1\n"
+        "         .WORD   0\n"
+        "         .WORD   0x7FFF\n"
+        "         .WORD   -32768\n"
+        "         .WORD   43\n"
+        ";Sum the halves of non-negative entries, and the complements of negative ones.\n"
+        "main:    LDWX    0,i\n"
+        "loop:    LDWA    table,x\n"
+        "         BRLT    negative\n"
+        "         ASRA\n"
+        "         BRC     isOdd\n"
+        "         BR      accum\n"
+        "isOdd:   LDWA    odd,d\n"
+        "         ADDA    1,i\n"
+        "         STWA    odd,d\n"
+        "         LDWA    table,x\n"
+        "         ASRA\n"
+        "         BR      accum\n"
+        "negative:NEGA\n"
+        "         BRV     accum\n"
+        "         NOTA\n"
+        "accum:   ADDA    total,d\n"
+        "         STWA    total,d\n"
+        "         @DECO   total,d\n"
+        "         @SYUNOP\n"
+        "         ADDX    2,i\n"
+        "         CPWX    16,i\n"
+        "         BRLT    loop\n"
+        "         LDWA    odd,d\n"
+        "         CALL    times3\n"
+        "         STWA    odd,d\n"
+        "         @HEXO   odd,d\n"
+        "done:    BR      done\n"
+        ";\n"
+        "times3:  STWA    -2,s\n"
+        "         SUBSP   2,i\n"
+        "         ADDA    0,s\n"
+        "         ADDA    0,s\n"
+        "         ADDSP   2,i\n"
+        "         RET\n"
+        "         .END\n");
+}
+
+void startIsaCpu(IsaCpu &cpu, quint16 pc, quint16 sp)
+{
+    cpu.onSimulationStarted();
+    cpu.getRegisterBank().writeRegisterWord(Enu::CPURegisters::PC, pc);
+    cpu.getRegisterBank().writeRegisterWord(Enu::CPURegisters::SP, sp);
+    cpu.getRegisterBank().flattenFile();
+}
+
+void startMicroCpu(FullMicrocodedCPU &cpu, quint16 pc, quint16 sp)
+{
+    cpu.onSimulationStarted();
+    RegisterFile registers;
+    registers.writeRegisterWord(Enu::CPURegisters::PC, pc);
+    registers.writeRegisterWord(Enu::CPURegisters::SP, sp);
+    registers.flattenFile();
+    cpu.loadArchitecturalState(registers, 0);
+}
+
+QVector<MicrocodeExample> microcodeExamples()
+{
+    QVector<MicrocodeExample> examples;
+    QDirIterator it = QDirIterator(":/help-cpu/figures/", QStringList()<<"*.pepcpu");
+    while(it.hasNext()) {
+        auto file = it.next();
+        QString text = Pep::resToString(file, false);
+        auto type = text.contains("Two-byte data bus") ? Enu::TwoByteDataBus : Enu::OneByteDataBus;
+        examples.append({QFileInfo(file).fileName(), text, type});
+    }
+    return examples;
+}
+
+QSharedPointer<MicrocodeProgram> assembleMicrocode(const QString &text, Enu::CPUType type,
+                                                   bool fullControl, QString &error)
+{
+    Pep::initMicroEnumMnemonMaps(type, fullControl);
+    MicroAsm assembler(type, fullControl);
+    auto symbolTable = QSharedPointer<SymbolTable>::create();
+    QVector<AMicroCode*> codeList;
+    bool success = true;
+    for(const auto& sourceLine : text.split('\n')) {
+        AMicroCode* code = nullptr;
+        QString lineError;
+        if(!assembler.processSourceLine(symbolTable.data(), sourceLine, code, lineError)) {
+            if(success) error = lineError;
+            success = false;
+        }
+        if(code != nullptr) codeList.append(code);
+    }
+    // The program owns the lines, so construct it even on failure so that they are freed.
+    auto program = QSharedPointer<MicrocodeProgram>::create(codeList, symbolTable);
+    if(!success) return nullptr;
+    return program;
+}
+
+QSharedPointer<MicrocodeProgram> assembleStockMicroprogram(QString &error)
+{
+    QString text = Pep::resToString(":/help-micro/pep10micro.pepmicro", false);
+    return assembleMicrocode(text, Enu::CPUType::TwoByteDataBus, true, error);
+}
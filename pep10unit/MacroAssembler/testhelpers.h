@@ -0,0 +1,63 @@
+#ifndef TESTHELPERS_H
+#define TESTHELPERS_H
+
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+
+#include "enu.h"
+
+class AsmProgram;
+class FullMicrocodedCPU;
+class IsaCpu;
+class MainMemory;
+class MicrocodeProgram;
+
+/*
+ * Fixtures shared by the tests that simulate programs.
+ */
+
+// Construct a memory device with 64k of RAM.
+QSharedPointer<MainMemory> createMemory();
+
+// Assemble the default operating system into AsmProgramManager::getInstance(), unless one is present.
+// Returns false if the operating system fails to assemble.
+bool installOperatingSystem();
+
+// Assemble a user program against the operating system installed by installOperatingSystem(),
+// which must have succeeded. Returns nullptr and sets error if the program fails to assemble.
+QSharedPointer<AsmProgram> assembleUserProgram(const QString& text, QString& error);
+
+// Load the installed operating system and a user program into memory at their burn addresses.
+void loadOperatingSystemAndProgram(MainMemory& memory, const AsmProgram& program);
+
+// A user program with loops, data dependent branches, a call, and unary and nonunary traps.
+// Instructions of both lengths put the instruction specifiers at both even and odd addresses.
+// It never returns to the operating system, and instead spins at the symbol "done".
+QString branchingProgramText();
+
+// Prepare an IsaCpu to execute a program already in its memory, starting at pc.
+void startIsaCpu(IsaCpu& cpu, quint16 pc, quint16 sp = 0x6000);
+
+// Prepare a FullMicrocodedCPU, whose microprogram has been set, to execute a program already in
+// its memory, starting at pc. The microprogram counter starts at the start of the von neumann cycle.
+void startMicroCpu(FullMicrocodedCPU& cpu, quint16 pc, quint16 sp = 0x6000);
+
+// A microcode example from the help documentation.
+struct MicrocodeExample
+{
+    QString fileName, text;
+    // Examples declare the width of their data bus in their header comment.
+    Enu::CPUType type;
+};
+QVector<MicrocodeExample> microcodeExamples();
+
+// Assemble a microprogram, after initializing the microcode mnemonics for type and control section.
+// Returns nullptr and sets error if any line fails to assemble.
+QSharedPointer<MicrocodeProgram> assembleMicrocode(const QString& text, Enu::CPUType type,
+                                                   bool fullControl, QString& error);
+
+// Assemble the Pep/10 microprogram shipped with Pep10Micro, which uses the two byte data bus and full control section.
+QSharedPointer<MicrocodeProgram> assembleStockMicroprogram(QString& error);
+
+#endif // TESTHELPERS_H
@@ -7,6 +7,20 @@
 #include "tst_assembleos.h"
 #include "tst_assembleprograms.h"
 #include "tst_userosintegration.h"
+#include "tst_symboltable.h"
+#include "tst_compiledmicrostep.h"
+#include "tst_alu.h"
+#include "tst_microtracerecorder.h"
+#include "tst_isaundolog.h"
+#include "tst_isaprofiler.h"
+#include "tst_memoryaccessstats.h"
+#include "tst_cachememory.h"
+#include "tst_microprogramverifier.h"
+#include "tst_microdecodertable.h"
+#include "tst_hybridcpucontroller.h"
+#include "tst_instructionsummary.h"
+#include "tst_snapshotpublisher.h"
+#include "tst_stacktrace.h"
 #include "pep.h"
 int main(int argc, char *argv[])
 {
@@ -15,6 +29,7 @@ int main(int argc, char *argv[])
     Pep::initMnemonicMaps();
     Pep::initAddrModesMap();
     Pep::initDecoderTables();
+    Pep::initMicroDecoderTables();
 
     int ret = 0;
     // Test the preprocessor first.
@@ -29,6 +44,10 @@ int main(int argc, char *argv[])
     TokenBufferTest tokenBuffer;
     ret += QTest::qExec(&tokenBuffer, argc, argv);
 
+    // Test the symbol table that the assembler and linker depend on.
+    SymbolTableTest symbolTableTest;
+    ret += QTest::qExec(&symbolTableTest, argc, argv);
+
     // Then test that the assembler works.
     AssemblerTest assemblerTest;
     ret += QTest::qExec(&assemblerTest, argc, argv);
@@ -46,8 +65,60 @@ int main(int argc, char *argv[])
     AssembleOS os;
     ret += QTest::qExec(&os, argc, argv);
 
-    // Lastly, try assembling all sample programs.
+    // Then try assembling all sample programs.
     AssemblePrograms progs;
     ret += QTest::qExec(&progs, argc, argv);
+
+    // Check that the tabulated ALU matches the switch-based ALU it replaced.
+    ALUTest aluTest;
+    ret += QTest::qExec(&aluTest, argc, argv);
+
+    // Check that compiled microcode behaves exactly like interpreted microcode.
+    CompiledMicroStepTest compiledMicroStep;
+    ret += QTest::qExec(&compiledMicroStep, argc, argv);
+
+    // Check that micro-step traces rebuild every recorded cycle.
+    MicroTraceRecorderTest microTraceRecorder;
+    ret += QTest::qExec(&microTraceRecorder, argc, argv);
+
+    // Check that the ISA level CPU can step backwards.
+    IsaUndoLogTest isaUndoLog;
+    ret += QTest::qExec(&isaUndoLog, argc, argv);
+
+    // Check that the profiler attributes execution to the right functions.
+    IsaProfilerTest isaProfiler;
+    ret += QTest::qExec(&isaProfiler, argc, argv);
+
+    // Check that memory accesses are counted for heatmaps and working sets.
+    MemoryAccessStatsTest memoryAccessStats;
+    ret += QTest::qExec(&memoryAccessStats, argc, argv);
+
+    // Check that the cache counts hits and misses under each of its policies, and that the microcoded CPU waits for it.
+    CacheMemoryTest cacheMemory;
+    ret += QTest::qExec(&cacheMemory, argc, argv);
+
+    // Check that the verifier accepts the stock microprogram and rejects a mutated one.
+    MicroprogramVerifierTest microprogramVerifier;
+    ret += QTest::qExec(&microprogramVerifier, argc, argv);
+
+    // Check that precomputed microcode decoder tables agree with the decoder symbols.
+    MicroDecoderTableTest microDecoderTable;
+    ret += QTest::qExec(&microDecoderTable, argc, argv);
+
+    // Check that a program fast forwarded at the ISA level finishes in microcode as if run in microcode throughout.
+    HybridCPUControllerTest hybridCPUController;
+    ret += QTest::qExec(&hybridCPUController, argc, argv);
+
+    // Check that replaying instruction summaries matches stepping every line of microcode.
+    InstructionSummaryTest instructionSummary;
+    ret += QTest::qExec(&instructionSummary, argc, argv);
+
+    // Check that snapshots are coalesced for the views without losing dirty pages.
+    SnapshotPublisherTest snapshotPublisher;
+    ret += QTest::qExec(&snapshotPublisher, argc, argv);
+
+    // Check that the stack and heap traces keep their frames as the program calls and returns.
+    StackTraceTest stackTrace;
+    ret += QTest::qExec(&stackTrace, argc, argv);
     return ret;
 }
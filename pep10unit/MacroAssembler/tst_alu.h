@@ -0,0 +1,27 @@
+#ifndef TST_ALU_H
+#define TST_ALU_H
+
+#include <QtTest>
+
+/*
+ * Test that the precomputed ALU tables agree with the switch-based ALU they replaced,
+ * and benchmark the two against each other.
+ */
+class ALUTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    ALUTest();
+    ~ALUTest() override;
+
+private slots:
+    // Compare every function, A, B, and carry in against the switch-based ALU.
+    void case_exhaustiveEquivalence();
+
+    // Benchmark evaluating every function over all A & B.
+    void benchmark_calculate_data();
+    void benchmark_calculate();
+};
+
+#endif // TST_ALU_H
@@ -52,3 +52,24 @@ void AssemblePrograms::assemblePrograms()
              "Sample program contains no code.");
 
 }
+
+void AssemblePrograms::case_programOutlivesAssembler()
+{
+    QString programText = Pep::resToString(":/help-asm/figures/fig0522.pep", false);
+    QSharedPointer<AsmProgram> program;
+    QString listing;
+    {
+        MacroAssemblerDriver assembler(registry);
+        auto asmResult = assembler.assembleUserProgram(programText, operatingSystem->getSymbolTable());
+        QVERIFY2(asmResult.success, "Assembly of sample program did not succede.");
+        program = asmResult.program;
+        listing = program->getProgramListing();
+        // Re-assembling replaces the driver's assembly graph, and with it the graph's
+        // ownership of its code lines.
+        QVERIFY2(assembler.assembleUserProgram(programText, operatingSystem->getSymbolTable()).success,
+                 "Re-assembly of sample program did not succede.");
+    }
+    // The program must keep its lines, including those in macro bodies, alive.
+    QCOMPARE(program->getProgramListing(), listing);
+    QVERIFY2(!program->getObjectCode().isEmpty(), "Sample program contains no object code.");
+}
@@ -16,6 +16,7 @@ private slots:
     void initTestCase();
     void assemblePrograms_data();
     void assemblePrograms();
+    void case_programOutlivesAssembler();
 
 private:
     QString osText;
@@ -0,0 +1,334 @@
+#include "tst_cachememory.h"
+#include "testhelpers.h"
+
+#include <functional>
+#include <stdexcept>
+
+#include "asmprogram.h"
+#include "asmprogrammanager.h"
+#include "cachememory.h"
+#include "fullmicrocodedcpu.h"
+#include "hybridcpucontroller.h"
+#include "isacpu.h"
+#include "isaprofiler.h"
+#include "mainmemory.h"
+#include "memoryaccessstats.h"
+#include "memorychips.h"
+#include "microcodeprogram.h"
+#include "microtracerecorder.h"
+#include "symbolentry.h"
+#include "symboltable.h"
+
+// A 64 byte cache of 16 byte lines, where a hit waits 1 cycle and memory 10 cycles.
+static CacheConfig smallConfig(quint16 ways, CacheConfig::Replacement replacement = CacheConfig::Replacement::LRU)
+{
+    CacheConfig config;
+    config.size = 64;
+    config.lineSize = 16;
+    config.associativity = ways;
+    config.replacement = replacement;
+    config.hitLatency = 1;
+    config.memoryLatency = 10;
+    return config;
+}
+
+// Far more cycles than the test program needs, so that a runaway CPU fails instead of hanging.
+static const quint64 maxCycles = 1000000;
+
+// Run the microcoded CPU until it is between instructions and stop() is true.
+static bool runMicroUntil(FullMicrocodedCPU& cpu, std::function<bool()> stop)
+{
+    const quint64 limit = cpu.getCycleCounter() + maxCycles;
+    auto stopped = [&cpu, &stop](){ return cpu.atMicroprogramStart() && stop(); };
+    cpu.doMCStepWhile([&cpu, &stopped, limit](){
+        return !cpu.hadErrorOnStep() && !cpu.getExecutionFinished()
+                && cpu.getCycleCounter() < limit && !stopped();
+    });
+    return !cpu.hadErrorOnStep() && stopped();
+}
+
+CacheMemoryTest::CacheMemoryTest()
+{
+
+}
+
+CacheMemoryTest::~CacheMemoryTest() = default;
+
+void CacheMemoryTest::initTestCase()
+{
+    QVERIFY2(installOperatingSystem(), "Assembly of operating system did not succede");
+    QString error;
+    microprogram = assembleStockMicroprogram(error);
+    QVERIFY2(!microprogram.isNull(), qPrintable(error));
+    program = assembleUserProgram(branchingProgramText(), error);
+    QVERIFY2(!program.isNull(), qPrintable(error));
+    done = static_cast<quint16>(program->getSymbolTable()->getValue("done")->getValue());
+}
+
+void CacheMemoryTest::case_config()
+{
+    QVERIFY(CacheConfig().validate().isEmpty());
+
+    CacheConfig config;
+    QVERIFY(CacheConfig::parse("size=512, ways=4,replace=FIFO,write=through,allocate=no,latency=20", config).isEmpty());
+    QCOMPARE(config.size, quint32{512});
+    QCOMPARE(config.associativity, quint16{4});
+    QCOMPARE(config.lineSize, quint16{16});
+    QVERIFY(config.replacement == CacheConfig::Replacement::FIFO);
+    QVERIFY(config.write == CacheConfig::Write::Through);
+    QVERIFY(!config.writeAllocate);
+    QCOMPARE(config.memoryLatency, quint32{20});
+
+    // A failed parse leaves the configuration unchanged.
+    QVERIFY(!CacheConfig::parse("size=100", config).isEmpty());
+    QVERIFY(!CacheConfig::parse("size=64,ways=8", config).isEmpty());
+    QVERIFY(!CacheConfig::parse("replace=mru", config).isEmpty());
+    QVERIFY(!CacheConfig::parse("colour=red", config).isEmpty());
+    QVERIFY(!CacheConfig::parse("size", config).isEmpty());
+    QCOMPARE(config.size, quint32{512});
+
+    config.associativity = 3;
+    bool threw = false;
+    try {
+        CacheMemory cache(createMemory(), config);
+    }
+    catch(std::invalid_argument&) {
+        threw = true;
+    }
+    QVERIFY(threw);
+}
+
+void CacheMemoryTest::case_directMapped()
+{
+    auto memory = createMemory();
+    CacheMemory cache(memory, smallConfig(1));
+    quint8 value = 0;
+
+    // A miss fills the line, and the rest of the line then hits.
+    QVERIFY(cache.readByte(0x0000, value));
+    QCOMPARE(cache.takeWaitCycles(), quint64{11});
+    QCOMPARE(cache.takeWaitCycles(), quint64{0});
+    QVERIFY(cache.readByte(0x000F, value));
+    QCOMPARE(cache.takeWaitCycles(), quint64{1});
+    QVERIFY(cache.contains(0x0008));
+    QVERIFY(!cache.contains(0x0010));
+
+    // 0x0040 maps to the same set as 0x0000, so it replaces it.
+    memory->setByte(0x0040, 0x5A);
+    QVERIFY(cache.readByte(0x0040, value));
+    QCOMPARE(value, quint8{0x5A});
+    QVERIFY(!cache.contains(0x0000));
+
+    const CacheStats& stats = cache.getStats();
+    QCOMPARE(stats.readHits, quint64{1});
+    QCOMPARE(stats.readMisses, quint64{2});
+    QCOMPARE(stats.evictions, quint64{1});
+    QCOMPARE(stats.writeBacks, quint64{0});
+    QCOMPARE(stats.waitCycles, quint64{23});
+    QCOMPARE(stats.hitRate(), 1.0 / 3);
+}
+
+void CacheMemoryTest::case_replacement()
+{
+    quint8 value = 0;
+    // 0x0000, 0x0020, and 0x0040 all map to set 0 of a 2 way cache.
+    CacheMemory lru(createMemory(), smallConfig(2, CacheConfig::Replacement::LRU));
+    CacheMemory fifo(createMemory(), smallConfig(2, CacheConfig::Replacement::FIFO));
+    for(CacheMemory* cache : {&lru, &fifo}) {
+        cache->readByte(0x0000, value);
+        cache->readByte(0x0020, value);
+        cache->readByte(0x0000, value);
+        cache->readByte(0x0040, value);
+        QCOMPARE(cache->getStats().readHits, quint64{1});
+        QCOMPARE(cache->getStats().evictions, quint64{1});
+    }
+    // LRU keeps the line that was just used, while FIFO evicts the line that was filled first.
+    QVERIFY(lru.contains(0x0000));
+    QVERIFY(!lru.contains(0x0020));
+    QVERIFY(!fifo.contains(0x0000));
+    QVERIFY(fifo.contains(0x0020));
+
+    // Random replacement is repeatable for the same seed.
+    CacheMemory first(createMemory(), smallConfig(2, CacheConfig::Replacement::Random));
+    CacheMemory second(createMemory(), smallConfig(2, CacheConfig::Replacement::Random));
+    for(quint16 address = 0; address < 0x0400; address += 0x0020) {
+        first.readByte(address, value);
+        second.readByte(address, value);
+    }
+    for(quint16 address = 0; address < 0x0400; address += 0x0020) {
+        QCOMPARE(first.contains(address), second.contains(address));
+    }
+}
+
+void CacheMemoryTest::case_writePolicies()
+{
+    quint8 value = 0;
+    // Write back only copies a line to memory when a dirty line is evicted.
+    CacheMemory back(createMemory(), smallConfig(1));
+    QVERIFY(back.writeByte(0x0000, 0x12));
+    QCOMPARE(back.takeWaitCycles(), quint64{11});
+    back.writeByte(0x0040, 0x34);
+    QCOMPARE(back.takeWaitCycles(), quint64{21});
+    QCOMPARE(back.getStats().writeMisses, quint64{2});
+    QCOMPARE(back.getStats().writeBacks, quint64{1});
+    // Values always reach memory, since the cache does not hold data.
+    back.getMemory()->getByte(0x0000, value);
+    QCOMPARE(value, quint8{0x12});
+    QVERIFY(back.getBytesWritten().contains(0x0040));
+
+    // Write through copies every write, so evicted lines are never dirty.
+    CacheConfig config = smallConfig(1);
+    config.write = CacheConfig::Write::Through;
+    CacheMemory through(createMemory(), config);
+    through.writeByte(0x0000, 0x12);
+    QCOMPARE(through.takeWaitCycles(), quint64{21});
+    through.writeByte(0x0001, 0x12);
+    QCOMPARE(through.takeWaitCycles(), quint64{11});
+    through.readByte(0x0040, value);
+    QCOMPARE(through.getStats().writeHits, quint64{1});
+    QCOMPARE(through.getStats().writeBacks, quint64{0});
+
+    // Without write allocate, a write miss goes to memory and leaves the cache alone.
+    config.write = CacheConfig::Write::Back;
+    config.writeAllocate = false;
+    CacheMemory noAllocate(createMemory(), config);
+    noAllocate.writeByte(0x0000, 0x12);
+    QCOMPARE(noAllocate.takeWaitCycles(), quint64{11});
+    QVERIFY(!noAllocate.contains(0x0000));
+    QCOMPARE(noAllocate.getStats().writeMisses, quint64{1});
+}
+
+void CacheMemoryTest::case_uncachedAndClear()
+{
+    auto memory = QSharedPointer<MainMemory>::create(nullptr);
+    QSharedPointer<RAMChip> ramChip(new RAMChip(0xFF00, 0, memory.get()));
+    QSharedPointer<OutputChip> outputChip(new OutputChip(1, 0xFF00, memory.get()));
+    memory->insertChip(ramChip, 0);
+    memory->insertChip(outputChip, 0xFF00);
+    CacheMemory cache(memory, smallConfig(1));
+    MemoryAccessStats accessStats;
+    cache.setAccessStats(&accessStats);
+
+    QVERIFY(cache.writeByte(0xFF00, 'a'));
+    QCOMPARE(cache.takeWaitCycles(), quint64{10});
+    QCOMPARE(cache.getStats().uncached, quint64{1});
+    QCOMPARE(cache.getStats().misses(), quint64{0});
+    QVERIFY(!cache.contains(0xFF00));
+
+    quint8 value = 0;
+    cache.readByte(0x0000, value);
+    QCOMPARE(accessStats.getCount(MemoryAccessStats::Access::Read, 0x0000), quint32{1});
+    QCOMPARE(accessStats.getCount(MemoryAccessStats::Access::Write, 0xFF00), quint32{1});
+
+    // Clearing statistics, as a CPU does when it is reset, also empties the cache.
+    cache.clearStatistics();
+    QCOMPARE(cache.getStats().readMisses, quint64{0});
+    QCOMPARE(cache.getStats().waitCycles, quint64{0});
+    QCOMPARE(cache.takeWaitCycles(), quint64{0});
+    QVERIFY(!cache.contains(0x0000));
+    QCOMPARE(accessStats.getCount(MemoryAccessStats::Access::Read, 0x0000), quint32{0});
+    cache.setAccessStats(nullptr);
+}
+
+void CacheMemoryTest::case_microcodedCPU()
+{
+    // The microcode cannot stall, so without a cache the same program takes the same number of cycles.
+    auto plainMemory = createMemory();
+    loadOperatingSystemAndProgram(*plainMemory, *program);
+    FullMicrocodedCPU plain(AsmProgramManager::getInstance(), plainMemory);
+    plain.setMicrocodeProgram(microprogram);
+    plain.onResetCPU();
+    startMicroCpu(plain, program->getBurnAddress());
+    QVERIFY2(runMicroUntil(plain, [&plain, this](){
+        return plain.getCPURegWordCurrent(Enu::CPURegisters::PC) == done;
+    }), qPrintable(plain.getErrorMessage()));
+    QCOMPARE(plain.getCycleCount(), plain.getCycleCounter());
+
+    auto memory = createMemory();
+    loadOperatingSystemAndProgram(*memory, *program);
+    auto cache = QSharedPointer<CacheMemory>::create(memory, smallConfig(2));
+    FullMicrocodedCPU cpu(AsmProgramManager::getInstance(), cache);
+    cpu.setMicrocodeProgram(microprogram);
+    auto profiler = QSharedPointer<IsaProfiler>::create();
+    cpu.setProfiler(profiler);
+    cpu.onResetCPU();
+    startMicroCpu(cpu, program->getBurnAddress());
+    QVERIFY2(runMicroUntil(cpu, [&cpu, this](){
+        return cpu.getCPURegWordCurrent(Enu::CPURegisters::PC) == done;
+    }), qPrintable(cpu.getErrorMessage()));
+
+    const CacheStats& stats = cache->getStats();
+    QVERIFY(stats.misses() > 0);
+    QVERIFY(stats.waitCycles >= stats.misses() * 10);
+    QCOMPARE(cpu.getCycleCounter(), plain.getCycleCounter());
+    QCOMPARE(cpu.getCycleCount(), cpu.getCycleCounter() + stats.waitCycles);
+    // Every cycle belongs to a finished instruction, so the profile accounts for all of them.
+    QCOMPARE(profiler->getInstructionCount(), cpu.getInstructionCount());
+    QCOMPARE(profiler->getCycleCount(), cpu.getCycleCount());
+}
+
+void CacheMemoryTest::case_rewindWaitCycles()
+{
+    auto memory = createMemory();
+    loadOperatingSystemAndProgram(*memory, *program);
+    auto cache = QSharedPointer<CacheMemory>::create(memory, smallConfig(2));
+    FullMicrocodedCPU cpu(AsmProgramManager::getInstance(), cache);
+    cpu.setMicrocodeProgram(microprogram);
+    cpu.onResetCPU();
+    cpu.setTraceRecorder(QSharedPointer<MicroTraceRecorder>::create());
+    startMicroCpu(cpu, program->getBurnAddress());
+
+    QVERIFY2(runMicroUntil(cpu, [&cpu](){ return cpu.getInstructionCount() == 20; }),
+             qPrintable(cpu.getErrorMessage()));
+    const quint64 cycle = cpu.getCycleCounter(), total = cpu.getCycleCount();
+    QVERIFY(total > cycle);
+    QVERIFY2(runMicroUntil(cpu, [&cpu, this](){
+        return cpu.getCPURegWordCurrent(Enu::CPURegisters::PC) == done;
+    }), qPrintable(cpu.getErrorMessage()));
+    QVERIFY(cpu.getCycleCount() - cpu.getCycleCounter() > total - cycle);
+
+    // The waits of the instructions finished since are undone.
+    QVERIFY(cpu.rewindToCycle(cycle));
+    QCOMPARE(cpu.getCycleCounter(), cycle);
+    QCOMPARE(cpu.getCycleCount(), total);
+
+    // Waits are counted as instructions finish, so those of a partly executed instruction are dropped.
+    cpu.onMCStep();
+    cpu.onMCStep();
+    QVERIFY(!cpu.atMicroprogramStart());
+    QVERIFY(cpu.rewindToCycle(cycle + 1));
+    QCOMPARE(cpu.getCycleCount(), total + 1);
+    QCOMPARE(cache->takeWaitCycles(), quint64{0});
+
+    // Finishing the instruction resumes counting waits from the restored total.
+    QVERIFY2(runMicroUntil(cpu, [](){ return true; }), qPrintable(cpu.getErrorMessage()));
+    QVERIFY(cpu.getCycleCount() - cpu.getCycleCounter() > total - cycle);
+}
+
+void CacheMemoryTest::case_hybridWaitCycles()
+{
+    // Both levels share the cache, as when pep10term fast forwards a program with a cache.
+    auto memory = createMemory();
+    loadOperatingSystemAndProgram(*memory, *program);
+    auto cache = QSharedPointer<CacheMemory>::create(memory, smallConfig(2));
+    auto isaCPU = QSharedPointer<IsaCpu>::create(AsmProgramManager::getInstance(), cache);
+    auto microCPU = QSharedPointer<FullMicrocodedCPU>::create(AsmProgramManager::getInstance(), cache);
+    microCPU->setMicrocodeProgram(microprogram);
+    isaCPU->onResetCPU();
+    microCPU->onResetCPU();
+    HybridCPUController hybrid(isaCPU, microCPU);
+    hybrid.onSimulationStarted();
+    startIsaCpu(*isaCPU, program->getBurnAddress());
+
+    QVERIFY(hybrid.fastForward(30));
+    const quint64 isaWaitCycles = cache->getStats().waitCycles;
+    QVERIFY(isaWaitCycles > 0);
+    hybrid.switchToMicrocode();
+    QVERIFY2(runMicroUntil(*microCPU, [&microCPU, this](){
+        return microCPU->getCPURegWordCurrent(Enu::CPURegisters::PC) == done;
+    }), qPrintable(microCPU->getErrorMessage()));
+
+    const quint64 microWaitCycles = cache->getStats().waitCycles - isaWaitCycles;
+    QVERIFY(microWaitCycles > 0);
+    QCOMPARE(microCPU->getCycleCount() - microCPU->getCycleCounter(), microWaitCycles);
+}
@@ -0,0 +1,47 @@
+#ifndef TST_CACHEMEMORY_H
+#define TST_CACHEMEMORY_H
+
+#include <QtTest>
+
+class AsmProgram;
+class MicrocodeProgram;
+
+/*
+ * Test that a cache in front of main memory counts hits, misses, and evictions
+ * under each of its policies, without changing the values read from memory.
+ */
+class CacheMemoryTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    CacheMemoryTest();
+    ~CacheMemoryTest() override;
+
+private slots:
+    void initTestCase();
+
+    // Check the validation and parsing of cache configurations.
+    void case_config();
+    // Check hits, misses, and wait cycles of a direct mapped cache.
+    void case_directMapped();
+    // Check which line LRU and FIFO replacement evict.
+    void case_replacement();
+    // Check the traffic caused by write back, write through, and no write allocate.
+    void case_writePolicies();
+    // Check that IO is not cached, and that clearing statistics starts a cold cache.
+    void case_uncachedAndClear();
+    // Check that the microcoded CPU adds the cache's wait cycles to its cycle count and profile.
+    void case_microcodedCPU();
+    // Check that rewinding the microcoded CPU also rewinds the wait cycles it has counted.
+    void case_rewindWaitCycles();
+    // Check that the microcoded CPU does not count the waits of an ISA level CPU it takes over from.
+    void case_hybridWaitCycles();
+
+private:
+    QSharedPointer<MicrocodeProgram> microprogram;
+    QSharedPointer<AsmProgram> program;
+    quint16 done = 0;
+};
+
+#endif // TST_CACHEMEMORY_H
@@ -0,0 +1,127 @@
+#include "tst_compiledmicrostep.h"
+#include "testhelpers.h"
+#include "compiledmicrostep.h"
+#include "cpudata.h"
+#include "mainmemory.h"
+#include "microcode.h"
+#include "microcodeprogram.h"
+#include "pep.h"
+#include "registerfile.h"
+
+Q_DECLARE_METATYPE(Enu::CPUType);
+
+// Report the first piece of visible state in which the two data sections differ, if any.
+static QString compareDataSections(const CPUDataSection& expected, const CPUDataSection& actual)
+{
+    for(quint8 reg = 0; reg <= Enu::maxRegisterNumber; reg++) {
+        if(expected.getRegisterBankByte(reg) != actual.getRegisterBankByte(reg)) {
+            return QString("Register %1 differs.").arg(reg);
+        }
+    }
+    if(expected.getRegisterBank().readStatusBitsCurrent() != actual.getRegisterBank().readStatusBitsCurrent()) {
+        return "Status bits differ.";
+    }
+    for(auto reg : {Enu::MEM_MARA, Enu::MEM_MARB, Enu::MEM_MDR, Enu::MEM_MDRE, Enu::MEM_MDRO}) {
+        if(expected.getMemoryRegister(reg) != actual.getMemoryRegister(reg)) {
+            return QString("Memory register %1 differs.").arg(reg);
+        }
+    }
+    if(expected.getMainBusState() != actual.getMainBusState()) {
+        return "Main bus state differs.";
+    }
+    if(expected.hadErrorOnStep() != actual.hadErrorOnStep()
+            || expected.getErrorMessage() != actual.getErrorMessage()) {
+        return QString("Errors differ: \"%1\" versus \"%2\".")
+                .arg(expected.getErrorMessage(), actual.getErrorMessage());
+    }
+    return "";
+}
+
+CompiledMicroStepTest::CompiledMicroStepTest()
+{
+
+}
+
+CompiledMicroStepTest::~CompiledMicroStepTest() = default;
+
+void CompiledMicroStepTest::case_matchesInterpreter_data()
+{
+    QTest::addColumn<QString>("ProgramText");
+    QTest::addColumn<Enu::CPUType>("Type");
+    for(const auto& example : microcodeExamples()) {
+        QString str = "Execute file "+example.fileName;
+        QTest::newRow(str.toStdString().c_str()) << example.text << example.type;
+    }
+}
+
+void CompiledMicroStepTest::case_matchesInterpreter()
+{
+    QFETCH(QString, ProgramText);
+    QFETCH(Enu::CPUType, Type);
+
+    QString errorString;
+    auto program = assembleMicrocode(ProgramText, Type, false, errorString);
+    QVERIFY2(!program.isNull(), errorString.toStdString().c_str());
+
+    auto interpretedMemory = createMemory(), compiledMemory = createMemory();
+    CPUDataSection interpreted(Type, interpretedMemory), compiled(Type, compiledMemory);
+    interpreted.setEmitEvents(false);
+    compiled.setEmitEvents(false);
+    for(auto line : program->getObjectCode()) {
+        if(line->hasUnitPre()) {
+            static_cast<UnitPreCode*>(line)->setUnitPre(&interpreted, interpretedMemory.get());
+            static_cast<UnitPreCode*>(line)->setUnitPre(&compiled, compiledMemory.get());
+        }
+    }
+
+    // The examples are straight-line microcode, so execute every line once, in order.
+    int cycle = 0;
+    for(const auto& line : program->getLinkedCode()) {
+        interpreted.setSignalsFromMicrocode(line.line);
+        interpreted.onStep();
+        compiled.setSignals(line.controlSignals, line.clockSignals);
+        compiled.stepCompiled(CompiledMicroStep(Type, line.controlSignals, line.clockSignals));
+
+        QString difference = compareDataSections(interpreted, compiled);
+        QVERIFY2(difference.isEmpty(), QString("Cycle %1: %2").arg(cycle).arg(difference).toStdString().c_str());
+        // A CPU stops at its first error, so there is nothing further to compare.
+        if(interpreted.hadErrorOnStep()) break;
+        cycle++;
+    }
+
+    for(int address = 0; address < (1<<16); address++) {
+        quint8 expected = 0, actual = 0;
+        interpretedMemory->getByte(static_cast<quint16>(address), expected);
+        compiledMemory->getByte(static_cast<quint16>(address), actual);
+        QVERIFY2(expected == actual, QString("Memory differs at address %1.").arg(address).toStdString().c_str());
+    }
+}
+
+void CompiledMicroStepTest::case_operationCount()
+{
+    Enu::ControlSignals control;
+    control.fill(Enu::signalDisabled);
+    Enu::ClockSignals clock;
+
+    // A line without signals only updates the bus.
+    QCOMPARE(CompiledMicroStep().operationCount(), 1);
+    QCOMPARE(CompiledMicroStep(Enu::OneByteDataBus, control, clock).operationCount(), 1);
+
+    // A=6, B=7; MARCk updates the bus and MAR, but never needs the ALU.
+    control[Enu::A] = 6;
+    control[Enu::B] = 7;
+    clock[Enu::MARCk] = true;
+    QCOMPARE(CompiledMicroStep(Enu::OneByteDataBus, control, clock).operationCount(), 2);
+
+    // A=7, B=23, AMux=1, ALU=1, CMux=1, C=7; SCk, LoadCk additionally computes the ALU output
+    // and C bus, clocks C & S, and checks for status bit errors.
+    clock.reset();
+    control[Enu::B] = 23;
+    control[Enu::AMux] = 1;
+    control[Enu::ALU] = 1;
+    control[Enu::CMux] = 1;
+    control[Enu::C] = 7;
+    clock[Enu::SCk] = true;
+    clock[Enu::LoadCk] = true;
+    QCOMPARE(CompiledMicroStep(Enu::OneByteDataBus, control, clock).operationCount(), 6);
+}
@@ -0,0 +1,27 @@
+#ifndef TST_COMPILEDMICROSTEP_H
+#define TST_COMPILEDMICROSTEP_H
+
+#include <QtTest>
+
+/*
+ * Test that executing precompiled lines of microcode is indistinguishable
+ * from interpreting their signals, one cycle at a time.
+ */
+class CompiledMicroStepTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    CompiledMicroStepTest();
+    ~CompiledMicroStepTest() override;
+
+private slots:
+    // Run every microcode example on two data sections, one interpreting and one
+    // executing compiled steps, and compare their state after every cycle.
+    void case_matchesInterpreter_data();
+    void case_matchesInterpreter();
+    // Check that a step only performs the operations its line enables.
+    void case_operationCount();
+};
+
+#endif // TST_COMPILEDMICROSTEP_H
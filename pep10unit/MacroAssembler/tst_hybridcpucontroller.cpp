@@ -0,0 +1,179 @@
+#include "tst_hybridcpucontroller.h"
+#include "testhelpers.h"
+
+#include "acpumodel.h"
+#include "asmprogram.h"
+#include "asmprogrammanager.h"
+#include "fullmicrocodedcpu.h"
+#include "hybridcpucontroller.h"
+#include "isacpu.h"
+#include "mainmemory.h"
+#include "microcodeprogram.h"
+#include "symbolentry.h"
+#include "symboltable.h"
+
+// Far more cycles than the test program needs, so that a runaway CPU fails instead of hanging.
+static const quint64 maxCycles = 1000000;
+
+// Run the microcoded CPU until the next instruction to execute is at pc.
+static bool runMicroToPC(FullMicrocodedCPU& cpu, quint16 pc)
+{
+    const quint64 limit = cpu.getCycleCounter() + maxCycles;
+    auto atPC = [&cpu, pc](){
+        return cpu.atMicroprogramStart() && cpu.getCPURegWordCurrent(Enu::CPURegisters::PC) == pc;
+    };
+    cpu.doMCStepWhile([&cpu, &atPC, limit](){
+        return !cpu.hadErrorOnStep() && !cpu.getExecutionFinished()
+                && cpu.getCycleCounter() < limit && !atPC();
+    });
+    return !cpu.hadErrorOnStep() && atPC();
+}
+
+// Report the first register, status bit, or byte of memory in which two machines differ, if any.
+static QString compareMachines(const ACPUModel& expected, const MainMemory& expectedMemory,
+                               const ACPUModel& actual, const MainMemory& actualMemory)
+{
+    static const QVector<QPair<Enu::CPURegisters, QString>> registers = {
+        {Enu::CPURegisters::A, "A"}, {Enu::CPURegisters::X, "X"},
+        {Enu::CPURegisters::SP, "SP"}, {Enu::CPURegisters::PC, "PC"},
+    };
+    for(const auto& reg : registers) {
+        if(expected.getCPURegWordCurrent(reg.first) != actual.getCPURegWordCurrent(reg.first)) {
+            return QString("%1 differs.").arg(reg.second);
+        }
+    }
+    static const QVector<QPair<Enu::EStatusBit, QString>> statusBits = {
+        {Enu::STATUS_N, "N"}, {Enu::STATUS_Z, "Z"}, {Enu::STATUS_V, "V"}, {Enu::STATUS_C, "C"},
+    };
+    for(const auto& bit : statusBits) {
+        if(expected.getStatusBitCurrent(bit.first) != actual.getStatusBitCurrent(bit.first)) {
+            return QString("%1 differs.").arg(bit.second);
+        }
+    }
+    for(int address = 0; address < (1<<16); address++) {
+        quint8 expectedValue = 0, actualValue = 0;
+        expectedMemory.getByte(static_cast<quint16>(address), expectedValue);
+        actualMemory.getByte(static_cast<quint16>(address), actualValue);
+        if(expectedValue != actualValue) return QString("Memory differs at address %1.").arg(address);
+    }
+    return "";
+}
+
+HybridCPUControllerTest::HybridCPUControllerTest()
+{
+
+}
+
+HybridCPUControllerTest::~HybridCPUControllerTest() = default;
+
+void HybridCPUControllerTest::initTestCase()
+{
+    QVERIFY2(installOperatingSystem(), "Assembly of operating system did not succede");
+    QString error;
+    microprogram = assembleStockMicroprogram(error);
+    QVERIFY2(!microprogram.isNull(), qPrintable(error));
+    program = assembleUserProgram(branchingProgramText(), error);
+    QVERIFY2(!program.isNull(), qPrintable(error));
+    done = static_cast<quint16>(program->getSymbolTable()->getValue("done")->getValue());
+}
+
+void HybridCPUControllerTest::case_matchesMicrocode_data()
+{
+    QTest::addColumn<quint64>("Instructions");
+    QTest::addColumn<QString>("Symbol");
+    QTest::newRow("Switch before the first instruction.") << quint64{0} << QString();
+    QTest::newRow("Switch after a few instructions.") << quint64{5} << QString();
+    // The first DECO is well underway by then.
+    QTest::newRow("Switch inside a trap handler.") << quint64{60} << QString();
+    QTest::newRow("Switch on reaching a branch target.") << quint64{0} << QString("negative");
+    QTest::newRow("Switch on reaching a function.") << quint64{0} << QString("times3");
+}
+
+void HybridCPUControllerTest::case_matchesMicrocode()
+{
+    QFETCH(quint64, Instructions);
+    QFETCH(QString, Symbol);
+
+    // Execute the whole program in microcode.
+    auto referenceMemory = createMemory();
+    loadOperatingSystemAndProgram(*referenceMemory, *program);
+    FullMicrocodedCPU reference(AsmProgramManager::getInstance(), referenceMemory);
+    reference.setMicrocodeProgram(microprogram);
+    reference.onResetCPU();
+    startMicroCpu(reference, program->getBurnAddress());
+    QVERIFY2(runMicroToPC(reference, done), qPrintable(reference.getErrorMessage()));
+
+    // Only the ISA level memory holds the program, so the switch must copy memory.
+    auto isaMemory = createMemory(), microMemory = createMemory();
+    loadOperatingSystemAndProgram(*isaMemory, *program);
+    auto isaCPU = QSharedPointer<IsaCpu>::create(AsmProgramManager::getInstance(), isaMemory);
+    auto microCPU = QSharedPointer<FullMicrocodedCPU>::create(AsmProgramManager::getInstance(), microMemory);
+    microCPU->setMicrocodeProgram(microprogram);
+    isaCPU->onResetCPU();
+    microCPU->onResetCPU();
+    HybridCPUController hybrid(isaCPU, microCPU);
+    hybrid.onSimulationStarted();
+    startIsaCpu(*isaCPU, program->getBurnAddress());
+
+    if(Symbol.isEmpty()) {
+        QVERIFY(hybrid.fastForward(Instructions));
+        QCOMPARE(isaCPU->getInstructionCount(), Instructions);
+    }
+    else {
+        auto pc = static_cast<quint16>(program->getSymbolTable()->getValue(Symbol)->getValue());
+        QVERIFY(hybrid.fastForwardToPC(pc, 10000));
+        QCOMPARE(isaCPU->getCPURegWordCurrent(Enu::CPURegisters::PC), pc);
+    }
+    QVERIFY(hybrid.getLevel() == HybridCPUController::Level::ISA);
+    hybrid.switchToMicrocode();
+    QVERIFY(hybrid.getLevel() == HybridCPUController::Level::Microcode);
+    // Fast forwarding is only possible at the ISA level.
+    QVERIFY(!hybrid.fastForward(1));
+    QVERIFY2(runMicroToPC(*microCPU, done), qPrintable(microCPU->getErrorMessage()));
+
+    QString difference = compareMachines(reference, *referenceMemory, *microCPU, *microMemory);
+    QVERIFY2(difference.isEmpty(), qPrintable(difference));
+    // The microcoded CPU only counts what it executed itself.
+    QCOMPARE(microCPU->getInstructionCount() + isaCPU->getInstructionCount(), reference.getInstructionCount());
+}
+
+void HybridCPUControllerTest::case_switchBackToISA()
+{
+    auto referenceMemory = createMemory();
+    loadOperatingSystemAndProgram(*referenceMemory, *program);
+    FullMicrocodedCPU reference(AsmProgramManager::getInstance(), referenceMemory);
+    reference.setMicrocodeProgram(microprogram);
+    reference.onResetCPU();
+    startMicroCpu(reference, program->getBurnAddress());
+    QVERIFY2(runMicroToPC(reference, done), qPrintable(reference.getErrorMessage()));
+
+    // Share memory between the levels, so that nothing needs to be copied.
+    auto memory = createMemory();
+    loadOperatingSystemAndProgram(*memory, *program);
+    auto isaCPU = QSharedPointer<IsaCpu>::create(AsmProgramManager::getInstance(), memory);
+    auto microCPU = QSharedPointer<FullMicrocodedCPU>::create(AsmProgramManager::getInstance(), memory);
+    microCPU->setMicrocodeProgram(microprogram);
+    isaCPU->onResetCPU();
+    microCPU->onResetCPU();
+    HybridCPUController hybrid(isaCPU, microCPU);
+    hybrid.onSimulationStarted();
+    startIsaCpu(*isaCPU, program->getBurnAddress());
+
+    QVERIFY(hybrid.fastForward(3));
+    hybrid.switchToMicrocode();
+    // Partially executed microcode has no ISA level equivalent.
+    microCPU->onMCStep();
+    QVERIFY(!microCPU->atMicroprogramStart());
+    QVERIFY(!hybrid.switchToISA());
+    QVERIFY(hybrid.getLevel() == HybridCPUController::Level::Microcode);
+    microCPU->doMCStepWhile([&microCPU](){
+        return !microCPU->hadErrorOnStep() && !microCPU->atMicroprogramStart();
+    });
+    QVERIFY(hybrid.switchToISA());
+    QVERIFY(hybrid.getLevel() == HybridCPUController::Level::ISA);
+
+    // Finish at the ISA level, which must agree with the microcode.
+    QVERIFY(hybrid.fastForwardToPC(done, 10000));
+    QString difference = compareMachines(reference, *referenceMemory, *isaCPU, *memory);
+    QVERIFY2(difference.isEmpty(), qPrintable(difference));
+}
@@ -0,0 +1,36 @@
+#ifndef TST_HYBRIDCPUCONTROLLER_H
+#define TST_HYBRIDCPUCONTROLLER_H
+
+#include <QtTest>
+
+class AsmProgram;
+class MicrocodeProgram;
+
+/*
+ * Test that fast forwarding a program at the ISA level and finishing it in microcode
+ * leaves the machine in the same state as executing the whole program in microcode.
+ */
+class HybridCPUControllerTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    HybridCPUControllerTest();
+    ~HybridCPUControllerTest() override;
+
+private slots:
+    void initTestCase();
+
+    // Check switching to microcode after an instruction count or on reaching an address.
+    void case_matchesMicrocode_data();
+    void case_matchesMicrocode();
+    // Check that control only returns to the ISA level between instructions.
+    void case_switchBackToISA();
+
+private:
+    QSharedPointer<MicrocodeProgram> microprogram;
+    QSharedPointer<AsmProgram> program;
+    quint16 done = 0;
+};
+
+#endif // TST_HYBRIDCPUCONTROLLER_H
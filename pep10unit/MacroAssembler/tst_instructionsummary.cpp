@@ -0,0 +1,157 @@
+#include "tst_instructionsummary.h"
+#include "testhelpers.h"
+
+#include "asmprogram.h"
+#include "asmprogrammanager.h"
+#include "cpudata.h"
+#include "fullmicrocodedcpu.h"
+#include "mainmemory.h"
+#include "microcodeprogram.h"
+#include "symbolentry.h"
+#include "symboltable.h"
+
+// Far more instructions than the test program needs, so that a runaway CPU fails instead of hanging.
+static const int maxInstructions = 100000;
+
+// Execute microcode until the CPU is between instructions again.
+static void stepInstruction(FullMicrocodedCPU& cpu)
+{
+    cpu.doMCStepWhile([&cpu](){
+        return !cpu.hadErrorOnStep() && !cpu.getExecutionFinished() && !cpu.atMicroprogramStart();
+    });
+}
+
+// Report the first register, status bit, or count in which the two CPUs differ, if any.
+static QString compareCPUs(FullMicrocodedCPU& expected, FullMicrocodedCPU& actual)
+{
+    auto expectedData = expected.getDataSection(), actualData = actual.getDataSection();
+    for(quint8 reg = 0; reg <= Enu::maxRegisterNumber; reg++) {
+        if(expectedData->getRegisterBankByte(reg) != actualData->getRegisterBankByte(reg)) {
+            return QString("Register %1 differs.").arg(reg);
+        }
+    }
+    if(expectedData->getRegisterBank().readStatusBitsCurrent() != actualData->getRegisterBank().readStatusBitsCurrent()) {
+        return "Status bits differ.";
+    }
+    else if(expected.getPrefetchValid() != actual.getPrefetchValid()) {
+        return "Prefetch differs.";
+    }
+    else if(expected.getCycleCount() != actual.getCycleCount()) {
+        return QString("Cycle count should be %1, but was %2.").arg(expected.getCycleCount()).arg(actual.getCycleCount());
+    }
+    else if(expected.getInstructionCount() != actual.getInstructionCount()) {
+        return "Instruction count differs.";
+    }
+    else if(expected.hadErrorOnStep() != actual.hadErrorOnStep()) {
+        return "Errors differ.";
+    }
+    return "";
+}
+
+InstructionSummaryTest::InstructionSummaryTest()
+{
+
+}
+
+InstructionSummaryTest::~InstructionSummaryTest() = default;
+
+void InstructionSummaryTest::initTestCase()
+{
+    QVERIFY2(installOperatingSystem(), "Assembly of operating system did not succede");
+    QString error;
+    microprogram = assembleStockMicroprogram(error);
+    QVERIFY2(!microprogram.isNull(), qPrintable(error));
+    program = assembleUserProgram(branchingProgramText(), error);
+    QVERIFY2(!program.isNull(), qPrintable(error));
+    done = static_cast<quint16>(program->getSymbolTable()->getValue("done")->getValue());
+}
+
+void InstructionSummaryTest::case_matchesStepping()
+{
+    auto steppedMemory = createMemory(), replayedMemory = createMemory();
+    loadOperatingSystemAndProgram(*steppedMemory, *program);
+    loadOperatingSystemAndProgram(*replayedMemory, *program);
+    FullMicrocodedCPU stepped(AsmProgramManager::getInstance(), steppedMemory);
+    FullMicrocodedCPU replayed(AsmProgramManager::getInstance(), replayedMemory);
+    stepped.setUseInstructionSummaries(false);
+    QVERIFY(replayed.getUseInstructionSummaries());
+    for(auto cpu : {&stepped, &replayed}) {
+        cpu->setMicrocodeProgram(microprogram);
+        cpu->onResetCPU();
+        startMicroCpu(*cpu, program->getBurnAddress());
+    }
+
+    // Summaries are keyed by instruction specifier, prefetch, and PC parity. Count how often
+    // each key starts an instruction, so that the test can tell which variants were replayed.
+    QMap<int, int> keys;
+    int instructions = 0;
+    while(replayed.getCPURegWordCurrent(Enu::CPURegisters::PC) != done) {
+        QVERIFY2(instructions++ < maxInstructions, "Program did not reach done.");
+        quint16 pc = replayed.getCPURegWordCurrent(Enu::CPURegisters::PC);
+        quint8 instructionSpecifier = 0;
+        replayedMemory->getByte(pc, instructionSpecifier);
+        keys[instructionSpecifier | (replayed.getPrefetchValid() ? 1 << 8 : 0) | (pc & 1) << 9]++;
+
+        stepInstruction(stepped);
+        stepInstruction(replayed);
+        QString difference = compareCPUs(stepped, replayed);
+        QVERIFY2(difference.isEmpty(), qPrintable(QString("After the instruction at %1: %2").arg(pc).arg(difference)));
+
+        QSet<quint16> written = steppedMemory->getBytesWritten();
+        written.unite(replayedMemory->getBytesWritten());
+        for(auto address : written) {
+            quint8 expected = 0, actual = 0;
+            steppedMemory->getByte(address, expected);
+            replayedMemory->getByte(address, actual);
+            QVERIFY2(expected == actual, qPrintable(QString("After the instruction at %1: Memory differs at address %2.")
+                                                   .arg(pc).arg(address)));
+        }
+        steppedMemory->clearBytesWritten();
+        replayedMemory->clearBytesWritten();
+    }
+    QVERIFY(!replayed.hadErrorOnStep());
+
+    // The program must have exercised every part of the key, and replayed instructions under them.
+    bool bothParities = false, bothPrefetches = false;
+    for(auto it = keys.constBegin(); it != keys.constEnd(); ++it) {
+        if(it.value() < 2) continue;
+        bothParities |= keys.value(it.key() ^ (1 << 9)) >= 2;
+        bothPrefetches |= keys.value(it.key() ^ (1 << 8)) >= 2;
+    }
+    QVERIFY2(bothParities, "No instruction was replayed from both even and odd addresses.");
+    QVERIFY2(bothPrefetches, "No instruction was replayed both with and without a valid prefetch.");
+
+    for(int address = 0; address < (1<<16); address++) {
+        quint8 expected = 0, actual = 0;
+        steppedMemory->getByte(static_cast<quint16>(address), expected);
+        replayedMemory->getByte(static_cast<quint16>(address), actual);
+        QVERIFY2(expected == actual, qPrintable(QString("Memory differs at address %1.").arg(address)));
+    }
+}
+
+void InstructionSummaryTest::benchmark_runProgram_data()
+{
+    QTest::addColumn<bool>("UseSummaries");
+    QTest::newRow("Step every line of microcode.") << false;
+    QTest::newRow("Replay instruction summaries.") << true;
+}
+
+void InstructionSummaryTest::benchmark_runProgram()
+{
+    QFETCH(bool, UseSummaries);
+    auto memory = createMemory();
+    FullMicrocodedCPU cpu(AsmProgramManager::getInstance(), memory);
+    cpu.setMicrocodeProgram(microprogram);
+    cpu.setUseInstructionSummaries(UseSummaries);
+    const quint16 end = done;
+    QBENCHMARK {
+        loadOperatingSystemAndProgram(*memory, *program);
+        cpu.onResetCPU();
+        startMicroCpu(cpu, program->getBurnAddress());
+        cpu.doMCStepWhile([&cpu, end](){
+            return !cpu.hadErrorOnStep() && !(cpu.atMicroprogramStart()
+                                               && cpu.getCPURegWordCurrent(Enu::CPURegisters::PC) == end);
+        });
+    }
+    QVERIFY(!cpu.hadErrorOnStep());
+}
@@ -0,0 +1,37 @@
+#ifndef TST_INSTRUCTIONSUMMARY_H
+#define TST_INSTRUCTIONSUMMARY_H
+
+#include <QtTest>
+
+class AsmProgram;
+class MicrocodeProgram;
+
+/*
+ * Test that replaying instructions from their recorded summaries in the microcoded CPU
+ * is indistinguishable from stepping every line of microcode, and measure the difference.
+ */
+class InstructionSummaryTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    InstructionSummaryTest();
+    ~InstructionSummaryTest() override;
+
+private slots:
+    void initTestCase();
+
+    // Check registers, status bits, cycle counts, and memory after every instruction.
+    void case_matchesStepping();
+
+    // Benchmark running a program with and without summaries.
+    void benchmark_runProgram_data();
+    void benchmark_runProgram();
+
+private:
+    QSharedPointer<MicrocodeProgram> microprogram;
+    QSharedPointer<AsmProgram> program;
+    quint16 done = 0;
+};
+
+#endif // TST_INSTRUCTIONSUMMARY_H
@@ -0,0 +1,144 @@
+#include "tst_isaprofiler.h"
+#include "testhelpers.h"
+#include "asmprogrammanager.h"
+#include "isacpu.h"
+#include "isaprofiler.h"
+#include "mainmemory.h"
+#include "pep.h"
+
+/*
+ * Record a program starting at 0x0000 which calls f at 0x0100. f calls itself once,
+ * and the inner call of f calls g at 0x0200. Calls take 3 cycles, and everything else takes 1.
+ */
+static void recordProgram(IsaProfiler& profiler)
+{
+    const quint8 ldwa = Pep::encodeInstruction(Enu::EMnemonic::LDWA, Enu::EAddrMode::I);
+    const quint8 call = Pep::encodeInstruction(Enu::EMnemonic::CALL, Enu::EAddrMode::I);
+    const quint8 ret = Pep::encodeInstruction(Enu::EMnemonic::RET, Enu::EAddrMode::NONE);
+    profiler.recordInstruction(0x0000, ldwa, 0x0003, 1);
+    profiler.recordInstruction(0x0003, call, 0x0100, 3);
+    profiler.recordInstruction(0x0100, ldwa, 0x0103, 1);
+    profiler.recordInstruction(0x0103, call, 0x0100, 3);
+    profiler.recordInstruction(0x0100, ldwa, 0x0103, 1);
+    profiler.recordInstruction(0x0103, call, 0x0200, 3);
+    profiler.recordInstruction(0x0200, ret, 0x0106, 1);
+    profiler.recordInstruction(0x0106, ret, 0x0106, 1);
+    profiler.recordInstruction(0x0106, ret, 0x0006, 1);
+    profiler.recordInstruction(0x0006, ldwa, 0x0009, 1);
+}
+
+static QString testNamer(quint16 address)
+{
+    if(address == 0x0100) return "f";
+    else if(address == 0x0200) return "g";
+    return "main";
+}
+
+IsaProfilerTest::IsaProfilerTest()
+{
+
+}
+
+IsaProfilerTest::~IsaProfilerTest() = default;
+
+void IsaProfilerTest::case_counters()
+{
+    IsaProfiler profiler;
+    recordProgram(profiler);
+    QCOMPARE(profiler.getInstructionCount(), quint64{10});
+    QCOMPARE(profiler.getCycleCount(), quint64{16});
+    QCOMPARE(profiler.getExecutionCount(0x0100), quint64{2});
+    QCOMPARE(profiler.getExecutionCount(0x0103), quint64{2});
+    QCOMPARE(profiler.getCycleCount(0x0103), quint64{6});
+    QCOMPARE(profiler.getExecutionCount(0x0009), quint64{0});
+    QCOMPARE(profiler.getCallCount(0x0003, 0x0100), quint64{1});
+    QCOMPARE(profiler.getCallCount(0x0103, 0x0100), quint64{1});
+    QCOMPARE(profiler.getCallCount(0x0103, 0x0200), quint64{1});
+    QCOMPARE(profiler.getCallCount(0x0003, 0x0200), quint64{0});
+
+    profiler.clear();
+    QCOMPARE(profiler.getInstructionCount(), quint64{0});
+    QCOMPARE(profiler.getExecutionCount(0x0100), quint64{0});
+    QCOMPARE(profiler.getCallCount(0x0003, 0x0100), quint64{0});
+    QVERIFY(profiler.getFunctionStats().isEmpty());
+}
+
+void IsaProfilerTest::case_functionStats()
+{
+    IsaProfiler profiler;
+    recordProgram(profiler);
+    auto stats = profiler.getFunctionStats(testNamer);
+    QCOMPARE(stats.size(), 3);
+    // Hottest first.
+    QCOMPARE(stats[0].name, QString("f"));
+    QCOMPARE(stats[0].calls, quint64{2});
+    QCOMPARE(stats[0].exclusiveInstructions, quint64{6});
+    QCOMPARE(stats[0].exclusiveCycles, quint64{10});
+    // The recursive call is already included in the outer call.
+    QCOMPARE(stats[0].inclusiveInstructions, quint64{7});
+    QCOMPARE(stats[0].inclusiveCycles, quint64{11});
+
+    QCOMPARE(stats[1].name, QString("main"));
+    QCOMPARE(stats[1].address, quint16{0x0000});
+    QCOMPARE(stats[1].calls, quint64{0});
+    QCOMPARE(stats[1].exclusiveInstructions, quint64{3});
+    QCOMPARE(stats[1].inclusiveInstructions, quint64{10});
+    QCOMPARE(stats[1].inclusiveCycles, quint64{16});
+
+    QCOMPARE(stats[2].name, QString("g"));
+    QCOMPARE(stats[2].calls, quint64{1});
+    QCOMPARE(stats[2].exclusiveCycles, quint64{1});
+    QCOMPARE(stats[2].inclusiveCycles, quint64{1});
+
+    // Returning from the root must not leave it.
+    profiler.recordInstruction(0x0009, Pep::encodeInstruction(Enu::EMnemonic::RET, Enu::EAddrMode::NONE), 0x1234, 1);
+    profiler.recordInstruction(0x1234, Pep::encodeInstruction(Enu::EMnemonic::LDWA, Enu::EAddrMode::I), 0x1237, 1);
+    stats = profiler.getFunctionStats(testNamer);
+    QCOMPARE(stats.size(), 3);
+    QCOMPARE(stats[1].name, QString("main"));
+    QCOMPARE(stats[1].exclusiveInstructions, quint64{5});
+}
+
+void IsaProfilerTest::case_foldedStacks()
+{
+    IsaProfiler profiler;
+    QCOMPARE(profiler.getFoldedStacks(), QString());
+    recordProgram(profiler);
+    QCOMPARE(profiler.getFoldedStacks(testNamer), QString("main 5\n"
+                                                          "main;f 5\n"
+                                                          "main;f;f 5\n"
+                                                          "main;f;f;g 1\n"));
+    QCOMPARE(profiler.getFoldedStacks().section('\n', 1, 1), QString("0x0000;0x0100 5"));
+}
+
+void IsaProfilerTest::case_cpu()
+{
+    auto memory = createMemory();
+    IsaCpu cpu(AsmProgramManager::getInstance(), memory);
+
+    // 0x7000: CALL 0x7010,i; LDWA 1,i
+    // 0x7010: LDWA 2,i; RET
+    const quint8 call = Pep::encodeInstruction(Enu::EMnemonic::CALL, Enu::EAddrMode::I);
+    const quint8 ldwa = Pep::encodeInstruction(Enu::EMnemonic::LDWA, Enu::EAddrMode::I);
+    const quint8 ret = Pep::encodeInstruction(Enu::EMnemonic::RET, Enu::EAddrMode::NONE);
+    memory->loadValues(0x7000, {call, 0x70, 0x10, ldwa, 0x00, 0x01});
+    memory->loadValues(0x7010, {ldwa, 0x00, 0x02, ret});
+    startIsaCpu(cpu, 0x7000);
+
+    auto profiler = QSharedPointer<IsaProfiler>::create();
+    cpu.setProfiler(profiler);
+    for(int it = 0; it < 4; it++) {
+        cpu.stepInto();
+        QVERIFY(!cpu.hadErrorOnStep());
+    }
+    QCOMPARE(profiler->getInstructionCount(), quint64{4});
+    // The ISA level has no clock, so every instruction is one cycle.
+    QCOMPARE(profiler->getCycleCount(), quint64{4});
+    QCOMPARE(profiler->getCallCount(0x7000, 0x7010), quint64{1});
+    QCOMPARE(profiler->getExecutionCount(0x7013), quint64{1});
+    QCOMPARE(profiler->getFoldedStacks(), QString("0x7000 2\n0x7000;0x7010 2\n"));
+
+    // Resetting the CPU starts a new profile.
+    cpu.onResetCPU();
+    QCOMPARE(profiler->getInstructionCount(), quint64{0});
+}
@@ -0,0 +1,29 @@
+#ifndef TST_ISAPROFILER_H
+#define TST_ISAPROFILER_H
+
+#include <QtTest>
+
+/*
+ * Test that the profiler attributes instructions and cycles to
+ * the right program counters, call sites, and functions.
+ */
+class IsaProfilerTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    IsaProfilerTest();
+    ~IsaProfilerTest() override;
+
+private slots:
+    // Check the per program counter and per call site counters.
+    void case_counters();
+    // Check inclusive and exclusive totals, including for a recursive function.
+    void case_functionStats();
+    // Check the folded stacks exported for flame graphs.
+    void case_foldedStacks();
+    // Profile a program executed by an IsaCpu.
+    void case_cpu();
+};
+
+#endif // TST_ISAPROFILER_H
@@ -0,0 +1,144 @@
+#include "tst_isaundolog.h"
+#include "testhelpers.h"
+#include "asmprogrammanager.h"
+#include "isacpu.h"
+#include "isaundolog.h"
+#include "mainmemory.h"
+#include "pep.h"
+
+// Address of the test program, which is clear of the OS and any user program.
+static const quint16 programStart = 0x7000;
+static const quint16 dataStart = 0x7100;
+
+// LDWA 0x1234,i; STWA dataStart,d; ADDA 0x7FFF,i; STBA dataStart+1,d; STWA dataStart,d; ASLA
+static QVector<quint8> createProgram()
+{
+    QVector<quint8> program;
+    auto nonunary = [&program](Enu::EMnemonic mnemon, Enu::EAddrMode addrMode, quint16 operand) {
+        program << Pep::encodeInstruction(mnemon, addrMode) << static_cast<quint8>(operand >> 8) << static_cast<quint8>(operand);
+    };
+    nonunary(Enu::EMnemonic::LDWA, Enu::EAddrMode::I, 0x1234);
+    nonunary(Enu::EMnemonic::STWA, Enu::EAddrMode::D, dataStart);
+    nonunary(Enu::EMnemonic::ADDA, Enu::EAddrMode::I, 0x7FFF);
+    nonunary(Enu::EMnemonic::STBA, Enu::EAddrMode::D, dataStart + 1);
+    nonunary(Enu::EMnemonic::STWA, Enu::EAddrMode::D, dataStart);
+    program << Pep::encodeInstruction(Enu::EMnemonic::ASLA, Enu::EAddrMode::NONE);
+    return program;
+}
+
+// Everything the test program may change.
+struct Snapshot
+{
+    quint16 A, X, SP, PC;
+    quint8 NZVC, data0, data1;
+    quint64 instructions;
+    bool operator==(const Snapshot& other) const
+    {
+        return A == other.A && X == other.X && SP == other.SP && PC == other.PC && NZVC == other.NZVC
+                && data0 == other.data0 && data1 == other.data1 && instructions == other.instructions;
+    }
+};
+
+static Snapshot takeSnapshot(IsaCpu& cpu, AMemoryDevice& memory)
+{
+    Snapshot snapshot;
+    snapshot.A = cpu.getCPURegWordCurrent(Enu::CPURegisters::A);
+    snapshot.X = cpu.getCPURegWordCurrent(Enu::CPURegisters::X);
+    snapshot.SP = cpu.getCPURegWordCurrent(Enu::CPURegisters::SP);
+    snapshot.PC = cpu.getCPURegWordCurrent(Enu::CPURegisters::PC);
+    snapshot.NZVC = cpu.getRegisterBank().readStatusBitsCurrent() & 0x0F;
+    memory.getByte(dataStart, snapshot.data0);
+    memory.getByte(dataStart + 1, snapshot.data1);
+    snapshot.instructions = cpu.getInstructionCount();
+    return snapshot;
+}
+
+static void loadProgram(IsaCpu& cpu, MainMemory& memory)
+{
+    memory.loadValues(programStart, createProgram());
+    memory.setByte(dataStart, 0xAA);
+    memory.setByte(dataStart + 1, 0xBB);
+    startIsaCpu(cpu, programStart);
+}
+
+IsaUndoLogTest::IsaUndoLogTest()
+{
+
+}
+
+IsaUndoLogTest::~IsaUndoLogTest() = default;
+
+void IsaUndoLogTest::case_stepBack()
+{
+    auto memory = createMemory();
+    IsaCpu cpu(AsmProgramManager::getInstance(), memory);
+    cpu.setUndoBudget(1 << 20);
+    loadProgram(cpu, *memory);
+
+    QVector<Snapshot> history;
+    const int instructions = 6;
+    for(int it = 0; it < instructions; it++) {
+        history.append(takeSnapshot(cpu, *memory));
+        cpu.stepInto();
+        QVERIFY(!cpu.hadErrorOnStep());
+    }
+    QCOMPARE(cpu.getUndoDepth(), quint64{instructions});
+    Snapshot end = takeSnapshot(cpu, *memory);
+
+    for(int it = instructions - 1; it >= 0; it--) {
+        QCOMPARE(cpu.stepBack(), quint64{1});
+        QVERIFY2(takeSnapshot(cpu, *memory) == history[it], QString("Instruction %1 was not undone.").arg(it).toStdString().c_str());
+    }
+    QCOMPARE(cpu.stepBack(), quint64{0});
+    QCOMPARE(cpu.getInstructionHistogram()[Pep::encodeInstruction(Enu::EMnemonic::STWA, Enu::EAddrMode::D)], quint32{0});
+
+    // Execution after stepping back must match the original execution.
+    for(int it = 0; it < instructions; it++) cpu.stepInto();
+    QVERIFY(takeSnapshot(cpu, *memory) == end);
+    QCOMPARE(cpu.stepBack(instructions + 1), quint64{instructions});
+    QVERIFY(takeSnapshot(cpu, *memory) == history[0]);
+}
+
+void IsaUndoLogTest::case_runBackToBreakpoint()
+{
+    auto memory = createMemory();
+    IsaCpu cpu(AsmProgramManager::getInstance(), memory);
+    cpu.setUndoBudget(1 << 20);
+    loadProgram(cpu, *memory);
+
+    // Break on the ADDA, which is the third instruction.
+    const quint16 breakpoint = programStart + 6;
+    cpu.breakpointsSet({breakpoint});
+    for(int it = 0; it < 6; it++) cpu.stepInto();
+    QVERIFY(cpu.runBackToBreakpoint());
+    QCOMPARE(cpu.getCPURegWordCurrent(Enu::CPURegisters::PC), breakpoint);
+    QCOMPARE(cpu.getUndoDepth(), quint64{2});
+    // Continuing backwards stops at the start of the journal without finding another breakpoint.
+    QVERIFY(!cpu.runBackToBreakpoint());
+    QCOMPARE(cpu.getCPURegWordCurrent(Enu::CPURegisters::PC), programStart);
+}
+
+void IsaUndoLogTest::case_budget()
+{
+    IsaUndoLog log(1, 4);
+    IsaUndoLog::Frame frame;
+    // The segment being recorded may exceed the budget, but older segments are evicted.
+    for(int it = 0; it < 10; it++) {
+        frame.callDepth = it;
+        log.beginInstruction(frame)->append({static_cast<quint16>(it), 0});
+    }
+    QCOMPARE(log.getDepth(), quint64{2});
+
+    auto memory = createMemory();
+    IsaUndoLog::Frame undone;
+    QVERIFY(log.undoInstruction(memory.get(), undone));
+    QCOMPARE(undone.callDepth, 9);
+    QVERIFY(log.undoInstruction(memory.get(), undone));
+    QCOMPARE(undone.callDepth, 8);
+    QVERIFY(!log.undoInstruction(memory.get(), undone));
+    QCOMPARE(log.getBytesUsed(), quint64{0});
+
+    // A budget of 0 disables the journal.
+    log.setBudget(0);
+    QVERIFY(!log.isEnabled());
+}
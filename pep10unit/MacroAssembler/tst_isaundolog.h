@@ -0,0 +1,27 @@
+#ifndef TST_ISAUNDOLOG_H
+#define TST_ISAUNDOLOG_H
+
+#include <QtTest>
+
+/*
+ * Test that an IsaCpu stepping backwards through its undo journal
+ * returns to exactly the state it held before each instruction.
+ */
+class IsaUndoLogTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    IsaUndoLogTest();
+    ~IsaUndoLogTest() override;
+
+private slots:
+    // Execute a short program, and then undo it one instruction at a time.
+    void case_stepBack();
+    // Undo instructions until the program counter reaches a breakpoint.
+    void case_runBackToBreakpoint();
+    // Check that old history is evicted a segment at a time to respect the budget.
+    void case_budget();
+};
+
+#endif // TST_ISAUNDOLOG_H
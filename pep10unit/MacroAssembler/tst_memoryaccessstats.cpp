@@ -0,0 +1,117 @@
+#include "tst_memoryaccessstats.h"
+#include "testhelpers.h"
+#include "asmprogrammanager.h"
+#include "isacpu.h"
+#include "mainmemory.h"
+#include "memoryaccessstats.h"
+#include "pep.h"
+
+using Access = MemoryAccessStats::Access;
+
+MemoryAccessStatsTest::MemoryAccessStatsTest()
+{
+
+}
+
+MemoryAccessStatsTest::~MemoryAccessStatsTest() = default;
+
+void MemoryAccessStatsTest::case_counters()
+{
+    MemoryAccessStats stats;
+    stats.recordRead(0x0010);
+    stats.recordRead(0x0010);
+    stats.recordWrite(0x01FF);
+    // An instruction at the end of memory wraps around to its start.
+    stats.recordExecute(0xFFFF, 3);
+    QCOMPARE(stats.getCount(Access::Read, 0x0010), quint32{2});
+    QCOMPARE(stats.getCount(Access::Write, 0x0010), quint32{0});
+    QCOMPARE(stats.getCount(Access::Write, 0x01FF), quint32{1});
+    QCOMPARE(stats.getCount(Access::Execute, 0xFFFF), quint32{1});
+    QCOMPARE(stats.getCount(Access::Execute, 0x0001), quint32{1});
+    QCOMPARE(stats.getCount(Access::Execute, 0x0002), quint32{0});
+    QCOMPARE(stats.getPageCount(Access::Read, 0x00), quint64{2});
+    QCOMPARE(stats.getPageCount(Access::Execute, 0x00), quint64{2});
+    QCOMPARE(stats.getPageCount(Access::Write, 0x01), quint64{1});
+    QCOMPARE(stats.getMaxCount(Access::Read), quint32{2});
+    QCOMPARE(stats.getInstructionCount(), quint64{1});
+
+    stats.clear();
+    QCOMPARE(stats.getCount(Access::Read, 0x0010), quint32{0});
+    QCOMPARE(stats.getMaxCount(Access::Execute), quint32{0});
+    QCOMPARE(stats.getInstructionCount(), quint64{0});
+}
+
+void MemoryAccessStatsTest::case_workingSet()
+{
+    MemoryAccessStats stats(2);
+    QCOMPARE(stats.getWorkingSetReport(), QString());
+    stats.recordWrite(0x0100);
+    stats.recordExecute(0x0000, 1);
+    stats.recordExecute(0x0000, 1);
+    stats.recordRead(0x8000);
+    stats.recordExecute(0x0000, 1);
+
+    // The last interval is incomplete, but it is still reported.
+    auto samples = stats.getWorkingSet();
+    QCOMPARE(samples.size(), 2);
+    QCOMPARE(samples[0].firstInstruction, quint64{0});
+    QCOMPARE(samples[0].instructions, quint32{2});
+    QCOMPARE(samples[0].pages.count(), std::size_t{2});
+    QVERIFY(samples[0].writtenPages.test(0x01));
+    QCOMPARE(samples[1].firstInstruction, quint64{2});
+    QCOMPARE(samples[1].instructions, quint32{1});
+    QVERIFY(samples[1].pages.test(0x80));
+    QVERIFY(samples[1].pages.test(0x00));
+    QVERIFY(samples[1].writtenPages.none());
+    QCOMPARE(stats.getWorkingSetReport(), QString("0,2,2,1,01,01\n"
+                                                  "2,1,2,0,,\n"));
+
+    // Changing the interval starts sampling over, but keeps the counts.
+    stats.setSampleInterval(5);
+    QVERIFY(stats.getWorkingSet().isEmpty());
+    QCOMPARE(stats.getCount(Access::Write, 0x0100), quint32{1});
+}
+
+void MemoryAccessStatsTest::case_cpu()
+{
+    auto memory = createMemory();
+    IsaCpu cpu(AsmProgramManager::getInstance(), memory);
+
+    // 0x7000: LDWA 0x7100,d; STWA 0x7180,d
+    const quint8 ldwa = Pep::encodeInstruction(Enu::EMnemonic::LDWA, Enu::EAddrMode::D);
+    const quint8 stwa = Pep::encodeInstruction(Enu::EMnemonic::STWA, Enu::EAddrMode::D);
+    memory->loadValues(0x7000, {ldwa, 0x71, 0x00, stwa, 0x71, 0x80});
+    startIsaCpu(cpu, 0x7000);
+
+    MemoryAccessStats stats(1);
+    memory->setAccessStats(&stats);
+    for(int it = 0; it < 2; it++) {
+        cpu.stepInto();
+        QVERIFY(!cpu.hadErrorOnStep());
+    }
+    QCOMPARE(stats.getInstructionCount(), quint64{2});
+    // Instructions are fetched through memory, so their bytes are also read.
+    QCOMPARE(stats.getCount(Access::Execute, 0x7003), quint32{1});
+    QCOMPARE(stats.getCount(Access::Read, 0x7003), quint32{1});
+    QCOMPARE(stats.getCount(Access::Execute, 0x7006), quint32{0});
+    QCOMPARE(stats.getCount(Access::Read, 0x7101), quint32{1});
+    QCOMPARE(stats.getCount(Access::Write, 0x7180), quint32{1});
+    QCOMPARE(stats.getCount(Access::Write, 0x7181), quint32{1});
+    QCOMPARE(stats.getCount(Access::Write, 0x7100), quint32{0});
+    QCOMPARE(stats.getWorkingSetReport(), QString("0,1,2,0,,\n"
+                                                  "1,1,2,1,71,71\n"));
+
+    // Getting and setting memory, as the UI does, is not counted.
+    quint8 value;
+    memory->getByte(0x7100, value);
+    memory->setByte(0x7100, value);
+    QCOMPARE(stats.getCount(Access::Read, 0x7100), quint32{1});
+    QCOMPARE(stats.getCount(Access::Write, 0x7100), quint32{0});
+
+    // Resetting the CPU clears the counts, and detached stats no longer count.
+    cpu.onResetCPU();
+    QCOMPARE(stats.getInstructionCount(), quint64{0});
+    memory->setAccessStats(nullptr);
+    memory->readByte(0x7100, value);
+    QCOMPARE(stats.getCount(Access::Read, 0x7100), quint32{0});
+}
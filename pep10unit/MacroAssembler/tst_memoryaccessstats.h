@@ -0,0 +1,27 @@
+#ifndef TST_MEMORYACCESSSTATS_H
+#define TST_MEMORYACCESSSTATS_H
+
+#include <QtTest>
+
+/*
+ * Test that memory accesses are counted per address,
+ * and that the working set is sampled per interval of instructions.
+ */
+class MemoryAccessStatsTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    MemoryAccessStatsTest();
+    ~MemoryAccessStatsTest() override;
+
+private slots:
+    // Check the per address and per page counters.
+    void case_counters();
+    // Check the samples of the working set, and their report.
+    void case_workingSet();
+    // Count the accesses of a program executed by an IsaCpu.
+    void case_cpu();
+};
+
+#endif // TST_MEMORYACCESSSTATS_H
@@ -0,0 +1,112 @@
+#include "tst_microdecodertable.h"
+#include "testhelpers.h"
+
+#include "asmprogrammanager.h"
+#include "fullmicrocodedcpu.h"
+#include "mainmemory.h"
+#include "microcodeprogram.h"
+#include "pep.h"
+#include "registerfile.h"
+#include "symboltable.h"
+#include "symbolentry.h"
+
+// Address of the line labeled by symbol, or -1 if it is not defined.
+static int lineOf(const SymbolTable& symbolTable, const QString& symbol)
+{
+    auto value = symbolTable.getValue(symbol);
+    if(value == nullptr || !value->isDefined()) return -1;
+    return static_cast<int>(value->getValue());
+}
+
+// Execute ADDA 3,i with A=5 on the microcoded CPU, starting a new simulation, and return A.
+static quint16 executeAddImmediate(QSharedPointer<MicrocodeProgram> program)
+{
+    auto memory = createMemory();
+    memory->setByte(0x0000, Pep::encodeInstruction(Enu::EMnemonic::ADDA, Enu::EAddrMode::I));
+    memory->setByte(0x0001, 0x00);
+    memory->setByte(0x0002, 0x03);
+    FullMicrocodedCPU cpu(AsmProgramManager::getInstance(), memory);
+    cpu.setMicrocodeProgram(program);
+    cpu.onResetCPU();
+    cpu.onSimulationStarted();
+
+    RegisterFile registers;
+    registers.writeRegisterWord(Enu::CPURegisters::A, 5);
+    registers.writeRegisterWord(Enu::CPURegisters::SP, 0x6000);
+    registers.flattenFile();
+    cpu.loadArchitecturalState(registers, 0);
+    cpu.doMCStepWhile([&cpu](){
+        return !cpu.hadErrorOnStep() && !cpu.atMicroprogramStart();
+    });
+    return cpu.getCPURegWordCurrent(Enu::CPURegisters::A);
+}
+
+MicroDecoderTableTest::MicroDecoderTableTest()
+{
+
+}
+
+MicroDecoderTableTest::~MicroDecoderTableTest() = default;
+
+void MicroDecoderTableTest::cleanup()
+{
+    Pep::initMicroDecoderTables();
+}
+
+void MicroDecoderTableTest::case_matchesSymbolLookup()
+{
+    QString error;
+    auto program = assembleStockMicroprogram(error);
+    QVERIFY2(!program.isNull(), qPrintable(error));
+    QVERIFY(program->isDecoderTableCurrent());
+
+    const auto& symbolTable = *program->getSymTable();
+    const auto& table = program->getDecoderTable();
+    for(int it = 0; it <= 255; it++) {
+        const auto& entry = table[static_cast<quint8>(it)];
+        QString row = QString("Instruction specifier %1").arg(it);
+
+        int instrLine = lineOf(symbolTable, Pep::instSpecToMicrocodeInstrSymbol[it]);
+        QVERIFY2(bool(entry.flags & MicroDecoderEntry::InstrValid) == (instrLine != -1), qPrintable(row));
+        if(instrLine != -1) QCOMPARE(static_cast<int>(entry.instrAddr), instrLine);
+
+        int addrLine = lineOf(symbolTable, Pep::instSpecToMicrocodeAddrSymbol[it]);
+        QVERIFY2(bool(entry.flags & MicroDecoderEntry::AddrModeValid) == (addrLine != -1), qPrintable(row));
+        if(addrLine != -1) QCOMPARE(static_cast<int>(entry.addrModeAddr), addrLine);
+
+        auto mnemon = Pep::decodeMnemonic[it];
+        bool unary = Pep::isUnaryMap[mnemon] || Pep::isTrapMap[mnemon];
+        QVERIFY2(bool(entry.flags & MicroDecoderEntry::Unary) == unary, qPrintable(row));
+    }
+
+    // The stock microprogram implements every instruction.
+    const auto& adda = table[Pep::encodeInstruction(Enu::EMnemonic::ADDA, Enu::EAddrMode::I)];
+    QCOMPARE(static_cast<int>(adda.instrAddr), lineOf(symbolTable, "adda"));
+    QCOMPARE(static_cast<int>(adda.addrModeAddr), lineOf(symbolTable, "iAddr"));
+    QVERIFY(!(adda.flags & MicroDecoderEntry::Unary));
+    QCOMPARE(executeAddImmediate(program), quint16{8});
+}
+
+void MicroDecoderTableTest::case_rebuiltAfterEdit()
+{
+    QString error;
+    auto program = assembleStockMicroprogram(error);
+    QVERIFY2(!program.isNull(), qPrintable(error));
+    const quint8 addImmediate = Pep::encodeInstruction(Enu::EMnemonic::ADDA, Enu::EAddrMode::I);
+
+    // Route ADDA to the microcode of SUBA, as the decoder table dialog would.
+    Pep::instSpecToMicrocodeInstrSymbol[addImmediate] = "suba";
+    Pep::microDecoderTablesRevision++;
+    QVERIFY(!program->isDecoderTableCurrent());
+    auto rebuilt = MicrocodeProgram::buildDecoderTable(*program->getSymTable());
+    QCOMPARE(static_cast<int>(rebuilt[addImmediate].instrAddr), lineOf(*program->getSymTable(), "suba"));
+    QCOMPARE(static_cast<int>(program->getDecoderTable()[addImmediate].instrAddr),
+             lineOf(*program->getSymTable(), "adda"));
+    // 5 - 3 rather than 5 + 3.
+    QCOMPARE(executeAddImmediate(program), quint16{2});
+
+    // Restoring the default symbols is also an edit, and the stale table must not be reused.
+    Pep::initMicroDecoderTables();
+    QVERIFY(!program->isDecoderTableCurrent());
+    QCOMPARE(executeAddImmediate(program), quint16{8});
+}
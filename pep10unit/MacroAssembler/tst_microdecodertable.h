@@ -0,0 +1,29 @@
+#ifndef TST_MICRODECODERTABLE_H
+#define TST_MICRODECODERTABLE_H
+
+#include <QtTest>
+
+/*
+ * Test that the decoder table precomputed for a microprogram resolves every instruction
+ * specifier to the same microcode as looking up its decoder symbols, and that editing
+ * the decoder symbols causes the table to be rebuilt rather than used while stale.
+ */
+class MicroDecoderTableTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    MicroDecoderTableTest();
+    ~MicroDecoderTableTest() override;
+
+private slots:
+    // Restore the default decoder symbols after each case.
+    void cleanup();
+
+    // Check every entry of the stock microprogram's table against its symbol table.
+    void case_matchesSymbolLookup();
+    // Check that an edit which bumps the revision is honored by the next simulation.
+    void case_rebuiltAfterEdit();
+};
+
+#endif // TST_MICRODECODERTABLE_H
@@ -0,0 +1,91 @@
+#include "tst_microprogramverifier.h"
+#include "testhelpers.h"
+
+#include "asmprogrammanager.h"
+#include "microcodeprogram.h"
+#include "microprogramverifier.h"
+#include "pep.h"
+
+// A sample of unary, non-unary, memory writing, branching, and trap instructions.
+static QVector<quint8> sampleSpecifiers()
+{
+    using Enu::EMnemonic;
+    using Enu::EAddrMode;
+    return {
+        Pep::encodeInstruction(EMnemonic::ASLA, EAddrMode::NONE),
+        Pep::encodeInstruction(EMnemonic::NOTX, EAddrMode::NONE),
+        Pep::encodeInstruction(EMnemonic::LDWA, EAddrMode::N),
+        Pep::encodeInstruction(EMnemonic::ADDA, EAddrMode::I),
+        Pep::encodeInstruction(EMnemonic::ADDA, EAddrMode::SFX),
+        Pep::encodeInstruction(EMnemonic::STBX, EAddrMode::S),
+        Pep::encodeInstruction(EMnemonic::BRNE, EAddrMode::I),
+        Pep::encodeInstruction(EMnemonic::CALL, EAddrMode::X),
+        Pep::encodeInstruction(EMnemonic::RET, EAddrMode::NONE),
+        Pep::encodeInstruction(EMnemonic::SCALL, EAddrMode::I),
+    };
+}
+
+static QVector<MicroprogramVerifier::InstructionResult> verify(QSharedPointer<MicrocodeProgram> program)
+{
+    MicroprogramVerifier verifier(program, AsmProgramManager::getInstance());
+    verifier.setTrialsPerInstruction(50);
+    verifier.setSeed(0x5EED);
+    verifier.setThreadCount(2);
+    verifier.setInstructionSpecifiers(sampleSpecifiers());
+    return verifier.verify();
+}
+
+MicroprogramVerifierTest::MicroprogramVerifierTest()
+{
+
+}
+
+MicroprogramVerifierTest::~MicroprogramVerifierTest() = default;
+
+void MicroprogramVerifierTest::initTestCase()
+{
+    QVERIFY2(installOperatingSystem(), "Assembly of operating system did not succede");
+    stockText = Pep::resToString(":/help-micro/pep10micro.pepmicro", false);
+    QVERIFY2(!stockText.isEmpty(), "Stock microprogram was empty.");
+}
+
+void MicroprogramVerifierTest::case_stockPasses()
+{
+    QString error;
+    auto program = assembleStockMicroprogram(error);
+    QVERIFY2(!program.isNull(), qPrintable(error));
+
+    auto results = verify(program);
+    QCOMPARE(results.size(), sampleSpecifiers().size());
+    for(const auto& result : results) {
+        QVERIFY2(result.passed, qPrintable(MicroprogramVerifier::formatResult(result)));
+        QCOMPARE(result.trials, quint64{50});
+    }
+}
+
+void MicroprogramVerifierTest::case_mutationDiverges()
+{
+    // Make the first cycle of ADDA subtract the low order bytes instead of adding them.
+    const QString original = "adda: A=1, B=21, AMux=1, ALU=1,";
+    QVERIFY(stockText.contains(original));
+    QString mutated = stockText;
+    mutated.replace(original, "adda: A=1, B=21, AMux=1, ALU=3,");
+
+    QString error;
+    auto program = assembleMicrocode(mutated, Enu::CPUType::TwoByteDataBus, true, error);
+    QVERIFY2(!program.isNull(), qPrintable(error));
+
+    auto results = verify(program);
+    for(const auto& result : results) {
+        auto mnemonic = Pep::decodeMnemonic[result.instructionSpecifier];
+        if(mnemonic == Enu::EMnemonic::ADDA) {
+            QVERIFY2(!result.passed, qPrintable(MicroprogramVerifier::formatResult(result)));
+            QVERIFY(!result.divergence.isEmpty());
+            // Random operands expose the wrong sum long before the trials run out.
+            QVERIFY(result.trials < 50);
+        }
+        else {
+            QVERIFY2(result.passed, qPrintable(MicroprogramVerifier::formatResult(result)));
+        }
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef TST_MICROPROGRAMVERIFIER_H
+#define TST_MICROPROGRAMVERIFIER_H
+
+#include <QtTest>
+
+/*
+ * Test that the microprogram verifier accepts the stock Pep/10 microprogram,
+ * and that it catches a microprogram whose semantics were changed.
+ */
+class MicroprogramVerifierTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    MicroprogramVerifierTest();
+    ~MicroprogramVerifierTest() override;
+
+private slots:
+    void initTestCase();
+
+    // Check that the stock microprogram matches the ISA level for a sample of instructions.
+    void case_stockPasses();
+    // Check that ADDA computing a difference is reported, and that other instructions are not.
+    void case_mutationDiverges();
+
+private:
+    QString stockText;
+};
+
+#endif // TST_MICROPROGRAMVERIFIER_H
@@ -0,0 +1,164 @@
+#include "tst_microtracerecorder.h"
+#include "testhelpers.h"
+#include "cpudata.h"
+#include "mainmemory.h"
+#include "microcode.h"
+#include "microcodeprogram.h"
+#include "microtracerecorder.h"
+#include "pep.h"
+#include "registerfile.h"
+
+Q_DECLARE_METATYPE(Enu::CPUType);
+
+// Capture the state of a data section the same way the recorder does.
+static MicroTraceRecorder::CycleState captureState(quint16 microPC, const CPUDataSection& data)
+{
+    MicroTraceRecorder::CycleState state;
+    state.microPC = microPC;
+    state.busState = data.getMainBusState();
+    state.statusBits = data.getRegisterBank().readStatusBitsCurrent();
+    for(auto reg : {Enu::MEM_MARA, Enu::MEM_MARB, Enu::MEM_MDR, Enu::MEM_MDRO, Enu::MEM_MDRE}) {
+        state.memoryRegisters[static_cast<std::size_t>(reg)] = data.getMemoryRegister(reg);
+    }
+    for(quint8 reg = 0; reg <= Enu::maxRegisterNumber; reg++) {
+        state.registers[reg] = data.getRegisterBankByte(reg);
+    }
+    return state;
+}
+
+// Report the first field in which two states differ, if any.
+static QString compareStates(const MicroTraceRecorder::CycleState& expected, const MicroTraceRecorder::CycleState& actual)
+{
+    if(expected.microPC != actual.microPC) return "Microprogram counter differs.";
+    if(expected.prefetchValid != actual.prefetchValid) return "Prefetch valid differs.";
+    if(expected.busState != actual.busState) return "Main bus state differs.";
+    if(expected.statusBits != actual.statusBits) return "Status bits differ.";
+    if(expected.memoryRegisters != actual.memoryRegisters) return "Memory registers differ.";
+    for(std::size_t reg = 0; reg < expected.registers.size(); reg++) {
+        if(expected.registers[reg] != actual.registers[reg]) return QString("Register %1 differs.").arg(reg);
+    }
+    return "";
+}
+
+MicroTraceRecorderTest::MicroTraceRecorderTest()
+{
+
+}
+
+MicroTraceRecorderTest::~MicroTraceRecorderTest() = default;
+
+void MicroTraceRecorderTest::case_replay_data()
+{
+    QTest::addColumn<QString>("ProgramText");
+    QTest::addColumn<Enu::CPUType>("Type");
+    QTest::addColumn<bool>("Compress");
+    for(const auto& example : microcodeExamples()) {
+        for(bool compress : {false, true}) {
+            QString str = QString("Replay file %1%2").arg(example.fileName, compress ? " compressed" : "");
+            QTest::newRow(str.toStdString().c_str()) << example.text << example.type << compress;
+        }
+    }
+}
+
+void MicroTraceRecorderTest::case_replay()
+{
+    QFETCH(QString, ProgramText);
+    QFETCH(Enu::CPUType, Type);
+    QFETCH(bool, Compress);
+
+    QString errorString;
+    auto program = assembleMicrocode(ProgramText, Type, false, errorString);
+    QVERIFY2(!program.isNull(), errorString.toStdString().c_str());
+
+    auto memory = createMemory();
+    CPUDataSection data(Type, memory);
+    data.setEmitEvents(false);
+    for(auto line : program->getObjectCode()) {
+        if(line->hasUnitPre()) static_cast<UnitPreCode*>(line)->setUnitPre(&data, memory.get());
+    }
+
+    // A short keyframe interval, so that most cycles are rebuilt from deltas after a keyframe.
+    MicroTraceRecorder recorder(1 << 16, 3);
+    recorder.setUseRunLengthCompression(Compress);
+    // The examples are straight-line microcode, so execute every line once, in order.
+    QVector<MicroTraceRecorder::CycleState> expected;
+    quint16 microPC = 0;
+    for(const auto& line : program->getLinkedCode()) {
+        data.setSignalsFromMicrocode(line.line);
+        data.onStep();
+        if(data.hadErrorOnStep()) break;
+        microPC++;
+        QVERIFY(recorder.record(static_cast<quint64>(expected.size()), microPC, false, data));
+        expected.append(captureState(microPC, data));
+    }
+    QCOMPARE(recorder.getCycleCount(), static_cast<quint64>(expected.size()));
+
+    for(int cycle = 0; cycle < expected.size(); cycle++) {
+        MicroTraceRecorder::CycleState actual;
+        QVERIFY(recorder.stateAt(static_cast<quint64>(cycle), actual));
+        QString difference = compareStates(expected[cycle], actual);
+        QVERIFY2(difference.isEmpty(), QString("Cycle %1: %2").arg(cycle).arg(difference).toStdString().c_str());
+
+        // Restoring into a fresh data section must reproduce the same state.
+        CPUDataSection restored(Type, createMemory());
+        restored.setEmitEvents(false);
+        QVERIFY(recorder.restore(static_cast<quint64>(cycle), restored));
+        difference = compareStates(expected[cycle], captureState(expected[cycle].microPC, restored));
+        QVERIFY2(difference.isEmpty(), QString("Restore %1: %2").arg(cycle).arg(difference).toStdString().c_str());
+    }
+    MicroTraceRecorder::CycleState unused;
+    QVERIFY(!recorder.stateAt(static_cast<quint64>(expected.size()), unused));
+}
+
+void MicroTraceRecorderTest::case_runLength()
+{
+    CPUDataSection data(Enu::TwoByteDataBus, createMemory());
+    data.setEmitEvents(false);
+    MicroTraceRecorder compressed, uncompressed;
+    uncompressed.setUseRunLengthCompression(false);
+
+    // Cycles that only advance the microprogram counter, starting from cycle 10.
+    for(quint16 cycle = 0; cycle < 1000; cycle++) {
+        QVERIFY(compressed.record(10 + cycle, cycle, false, data));
+        QVERIFY(uncompressed.record(10 + cycle, cycle, false, data));
+    }
+    QCOMPARE(compressed.getFirstCycle(), quint64{10});
+    QVERIFY(compressed.getBytesUsed() < uncompressed.getBytesUsed() / 10);
+
+    // Rewind into the middle of a run, and diverge from it.
+    QVERIFY(compressed.truncateAfter(500));
+    QCOMPARE(compressed.getCycleCount(), quint64{491});
+    QVERIFY(!compressed.record(600, 600, false, data));
+    data.onSetRegisterByte(0, 0x42);
+    QVERIFY(compressed.record(501, 7, true, data));
+
+    MicroTraceRecorder::CycleState state;
+    QVERIFY(compressed.stateAt(500, state));
+    QCOMPARE(state.microPC, quint16{490});
+    QCOMPARE(state.registers[0], quint8{0});
+    QVERIFY(compressed.stateAt(501, state));
+    QCOMPARE(state.microPC, quint16{7});
+    QCOMPARE(state.prefetchValid, true);
+    QCOMPARE(state.registers[0], quint8{0x42});
+    QVERIFY(!compressed.stateAt(502, state));
+}
+
+void MicroTraceRecorderTest::case_full()
+{
+    CPUDataSection data(Enu::TwoByteDataBus, createMemory());
+    data.setEmitEvents(false);
+    // Enough room for the first keyframe, and little else.
+    MicroTraceRecorder recorder(64);
+    recorder.setUseRunLengthCompression(false);
+    quint64 cycle = 0;
+    while(recorder.record(cycle, static_cast<quint16>(cycle * 2), false, data)) cycle++;
+    QVERIFY(recorder.isFull());
+    QVERIFY(cycle > 1);
+    QCOMPARE(recorder.getCycleCount(), cycle);
+    // Once full, recording does not resume even if a later record would be smaller.
+    QVERIFY(!recorder.record(cycle, static_cast<quint16>(cycle * 2), false, data));
+
+    MicroTraceRecorder::CycleState state;
+    QVERIFY(recorder.stateAt(cycle - 1, state));
+    QCOMPARE(state.microPC, static_cast<quint16>((cycle - 1) * 2));
+}
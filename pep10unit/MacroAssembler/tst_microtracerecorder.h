@@ -0,0 +1,29 @@
+#ifndef TST_MICROTRACERECORDER_H
+#define TST_MICROTRACERECORDER_H
+
+#include <QtTest>
+
+/*
+ * Test that a recorded micro-step trace rebuilds the exact state
+ * of the data section after every recorded cycle.
+ */
+class MicroTraceRecorderTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    MicroTraceRecorderTest();
+    ~MicroTraceRecorderTest() override;
+
+private slots:
+    // Record every microcode example, and then rebuild each cycle from the trace,
+    // with and without run length compression.
+    void case_replay_data();
+    void case_replay();
+    // Check that idle cycles are compressed, and that recording resumes after truncating a run.
+    void case_runLength();
+    // Check that recording stops once the arena is full, rather than losing history.
+    void case_full();
+};
+
+#endif // TST_MICROTRACERECORDER_H
@@ -19,6 +19,20 @@ void PreprocessorFailure::cleanupTestCase()
     preprocessor->setTarget(nullptr);
 }
 
+void PreprocessorFailure::case_coreMacroIndex()
+{
+    auto coreMacros = registry->getCoreMacros();
+    QVERIFY2(!coreMacros.isEmpty(), "Expected builtin macros to be indexed.");
+    for(const auto& macro : coreMacros) {
+        // The text of the macro must be loaded on request, and its declaration line
+        // must agree with the name and argument count recorded in the index.
+        auto [success, name, argCount] = MacroRegistry::macroDefinition(macro->macroText);
+        QVERIFY2(success, qPrintable(QString("Malformed core macro @%1.").arg(macro->macroName)));
+        QCOMPARE(name.toUpper(), macro->macroName.toUpper());
+        QCOMPARE(argCount, static_cast<quint16>(macro->argCount));
+    }
+}
+
 void PreprocessorFailure::case_noSuchMacro_data()
 {
     QTest::addColumn<QString>("ProgramText");
@@ -21,6 +21,9 @@ private slots:
     void initTestCase();
     void cleanupTestCase();
 
+    // Test that lazily loaded core macros agree with the build time macro index.
+    void case_coreMacroIndex();
+
     // Test cases for macros that do not exist.
     void case_noSuchMacro_data();
     void case_noSuchMacro();
@@ -0,0 +1,153 @@
+#include "tst_snapshotpublisher.h"
+
+#include <algorithm>
+#include <thread>
+#include "amemorydevice.h"
+#include "simulationsnapshot.h"
+
+// Every byte of a dirty page holds the low byte of instructionCount, so tests can tell which snapshot a page came from.
+static SimulationSnapshot makeSnapshot(quint64 instructionCount, QVector<quint8> dirtyPages = {})
+{
+    SimulationSnapshot snapshot;
+    snapshot.instructionCount = instructionCount;
+    snapshot.cycleCount = instructionCount * 10;
+    snapshot.dirtyPages = std::move(dirtyPages);
+    snapshot.pageBytes.fill(static_cast<quint8>(instructionCount), snapshot.dirtyPages.size() * AMemoryDevice::pageSize);
+    return snapshot;
+}
+
+SnapshotPublisherTest::SnapshotPublisherTest()
+{
+
+}
+
+SnapshotPublisherTest::~SnapshotPublisherTest()
+{
+
+}
+
+void SnapshotPublisherTest::case_coalesce()
+{
+    SnapshotPublisher publisher(60);
+    QSignalSpy spy(&publisher, &SnapshotPublisher::frameReady);
+    QVERIFY(publisher.takeLatest().isNull());
+
+    publisher.publish(makeSnapshot(1));
+    publisher.publish(makeSnapshot(2));
+    publisher.publish(makeSnapshot(3));
+    QCOMPARE(spy.count(), 1);
+
+    auto snapshot = publisher.takeLatest();
+    QVERIFY(!snapshot.isNull());
+    QCOMPARE(snapshot->instructionCount, quint64(3));
+    QCOMPARE(snapshot->cycleCount, quint64(30));
+    QVERIFY(publisher.takeLatest().isNull());
+
+    // Once the views have caught up, the next snapshot must be signalled again.
+    publisher.publish(makeSnapshot(4));
+    QCOMPARE(spy.count(), 2);
+
+    publisher.clear();
+    QVERIFY(publisher.takeLatest().isNull());
+    publisher.publish(makeSnapshot(5));
+    QCOMPARE(spy.count(), 3);
+}
+
+void SnapshotPublisherTest::case_mergeDirtyPages_data()
+{
+    QTest::addColumn<QVector<quint8>>("first");
+    QTest::addColumn<QVector<quint8>>("second");
+    QTest::addColumn<QVector<quint8>>("third");
+    QTest::addColumn<QVector<quint8>>("expected");
+
+    QTest::newRow("None") << QVector<quint8>() << QVector<quint8>() << QVector<quint8>()
+                          << QVector<quint8>();
+    QTest::newRow("Only first") << QVector<quint8>{1, 2} << QVector<quint8>() << QVector<quint8>()
+                                << QVector<quint8>{1, 2};
+    QTest::newRow("Only last") << QVector<quint8>() << QVector<quint8>() << QVector<quint8>{7}
+                               << QVector<quint8>{7};
+    QTest::newRow("Disjoint") << QVector<quint8>{0, 4} << QVector<quint8>{2} << QVector<quint8>{255}
+                              << QVector<quint8>{0, 2, 4, 255};
+    QTest::newRow("Overlapping") << QVector<quint8>{1, 3, 5} << QVector<quint8>{3, 4, 5} << QVector<quint8>{1, 5, 6}
+                                 << QVector<quint8>{1, 3, 4, 5, 6};
+}
+
+void SnapshotPublisherTest::case_mergeDirtyPages()
+{
+    QFETCH(QVector<quint8>, first);
+    QFETCH(QVector<quint8>, second);
+    QFETCH(QVector<quint8>, third);
+    QFETCH(QVector<quint8>, expected);
+
+    SnapshotPublisher publisher(60);
+    publisher.publish(makeSnapshot(1, first));
+    publisher.publish(makeSnapshot(2, second));
+    publisher.publish(makeSnapshot(3, third));
+    auto snapshot = publisher.takeLatest();
+    QVERIFY(!snapshot.isNull());
+    QCOMPARE(snapshot->dirtyPages, expected);
+    QCOMPARE(snapshot->pageBytes.size(), expected.size() * AMemoryDevice::pageSize);
+    for(int it = 0; it < expected.size(); it++) {
+        quint8 latest = third.contains(expected[it]) ? 3 : second.contains(expected[it]) ? 2 : 1;
+        auto page = snapshot->pageBytes.mid(it * AMemoryDevice::pageSize, AMemoryDevice::pageSize);
+        QVERIFY2(std::all_of(page.cbegin(), page.cend(), [latest](quint8 byte) { return byte == latest; }),
+                 qPrintable(QString("Page %1 does not hold the bytes of snapshot %2.").arg(expected[it]).arg(latest)));
+    }
+
+    // Taken pages must not carry over into the next snapshot.
+    publisher.publish(makeSnapshot(4, {9}));
+    QCOMPARE(publisher.takeLatest()->dirtyPages, QVector<quint8>{9});
+}
+
+void SnapshotPublisherTest::case_frameDue()
+{
+    // At one frame per second, a frame cannot come due again during the test.
+    SnapshotPublisher publisher(1);
+    QVERIFY(publisher.isFrameDue());
+    publisher.publish(makeSnapshot(1));
+    QVERIFY(!publisher.isFrameDue());
+    publisher.clear();
+    QVERIFY(publisher.isFrameDue());
+    QVERIFY(publisher.takeLatest().isNull());
+
+    // Raising the frame rate applies to the frame already in progress.
+    publisher.publish(makeSnapshot(2));
+    publisher.setFramesPerSecond(1000);
+    QCOMPARE(publisher.getFramesPerSecond(), 1000);
+    QTest::qWait(10);
+    QVERIFY(publisher.isFrameDue());
+}
+
+void SnapshotPublisherTest::case_concurrentPublish()
+{
+    static const quint64 snapshotCount = 100000;
+    SnapshotPublisher publisher(1000);
+    std::thread simulation([&publisher](){
+        for(quint64 it = 1; it <= snapshotCount; it++) {
+            publisher.isFrameDue();
+            publisher.publish(makeSnapshot(it, {static_cast<quint8>(it)}));
+        }
+    });
+
+    // Failures are reported after joining, since the simulation thread must not outlive the publisher.
+    QString failure;
+    quint64 lastCount = 0;
+    int taken = 0;
+    while(failure.isEmpty() && lastCount < snapshotCount) {
+        if(taken++ % 16 == 0) publisher.clear();
+        publisher.isFrameDue();
+        auto snapshot = publisher.takeLatest();
+        if(snapshot.isNull()) {
+            continue;
+        }
+        else if(snapshot->instructionCount <= lastCount) {
+            failure = QString("Took snapshot %1 after snapshot %2.").arg(snapshot->instructionCount).arg(lastCount);
+        }
+        else if(!std::is_sorted(snapshot->dirtyPages.cbegin(), snapshot->dirtyPages.cend())) {
+            failure = QString("Dirty pages of snapshot %1 are out of order.").arg(snapshot->instructionCount);
+        }
+        lastCount = snapshot->instructionCount;
+    }
+    simulation.join();
+    QVERIFY2(failure.isEmpty(), qPrintable(failure));
+}
@@ -0,0 +1,34 @@
+#ifndef TST_SNAPSHOTPUBLISHER_H
+#define TST_SNAPSHOTPUBLISHER_H
+
+#include <QtTest>
+
+/*
+ * Test that the snapshot publisher coalesces untaken snapshots without losing dirty pages,
+ * and that it may be used from the simulation and the views at once.
+ */
+class SnapshotPublisherTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    SnapshotPublisherTest();
+    ~SnapshotPublisherTest() override;
+
+private slots:
+    // Check that untaken snapshots are replaced by the latest one, with a single frameReady().
+    void case_coalesce();
+
+    // Check that the dirty pages of replaced snapshots are merged in order, without duplicates,
+    // and that each page keeps the contents of the latest snapshot which dirtied it.
+    void case_mergeDirtyPages_data();
+    void case_mergeDirtyPages();
+
+    // Check that a frame is due before the first publish and after clear(), but not right after a publish.
+    void case_frameDue();
+
+    // Check that snapshots taken while another thread publishes and clears arrive in order.
+    void case_concurrentPublish();
+};
+
+#endif // TST_SNAPSHOTPUBLISHER_H
@@ -0,0 +1,269 @@
+#include "tst_stacktrace.h"
+
+#include <algorithm>
+#include <limits>
+#include "asmprogram.h"
+#include "stacktrace.h"
+
+// Types must outlive the traces whose tags refer to them.
+static const TraceType types[] = {
+    {Enu::ESymbolFormat::F_2D, "a"},
+    {Enu::ESymbolFormat::F_1C, "b"},
+    {Enu::ESymbolFormat::F_2H, "c"},
+};
+static const TraceType* const a = &types[0];
+static const TraceType* const b = &types[1];
+static const TraceType* const c = &types[2];
+
+// The types in [begin, end), which must be contiguous.
+static TraceTypeRange range(const TraceType* begin, const TraceType* end)
+{
+    TraceTypeRange items;
+    items.begin = begin;
+    items.end = end;
+    for(auto type = begin; type != end; ++type) {
+        items.size += Enu::tagNumBytes(type->format);
+    }
+    return items;
+}
+
+// What a view drew of a stack trace, when it last took the trace's changes.
+struct DrawnStack
+{
+    QVector<MemTag> tags;
+    // Text, size, and orphaned state of each frame.
+    QStringList frames;
+};
+
+static QString describeFrame(const StackFrame& frame)
+{
+    return QString("%1 %2 %3").arg(QString(frame)).arg(frame.size())
+            .arg(frame.isOrphaned ? "orphaned" : "called");
+}
+
+// Take the changes from stack, and report any way in which they differ from the expected changes,
+// or in which the stack changed below them. Then redraw drawn from the stack.
+static QString takeAndCheckChanges(StackTrace& stack, DrawnStack& drawn, int firstTag, int firstFrame)
+{
+    StackTrace::Changes changes = stack.takeChanges();
+    if(changes.firstTag != firstTag || changes.firstFrame != firstFrame) {
+        return QString("Expected first changed tag %1 and frame %2, but was %3 and %4.")
+                .arg(firstTag).arg(firstFrame).arg(changes.firstTag).arg(changes.firstFrame);
+    }
+
+    const QVector<MemTag>& tags = stack.getMemTags();
+    int keptTags = std::min(tags.size(), drawn.tags.size());
+    if(tags.size() != drawn.tags.size() && changes.firstTag > keptTags) {
+        return QString("The number of tags changed, but the first changed tag was %1.").arg(changes.firstTag);
+    }
+    for(int it = 0; it < std::min(keptTags, changes.firstTag); it++) {
+        if(tags[it].addr != drawn.tags[it].addr || tags[it].type != drawn.tags[it].type) {
+            return QString("Tag %1 changed, but the first changed tag was %2.").arg(it).arg(changes.firstTag);
+        }
+    }
+
+    QStringList frames;
+    for(int it = 0; it < stack.numFrames(); it++) frames << describeFrame(stack.getFrame(it));
+    int keptFrames = std::min(frames.size(), drawn.frames.size());
+    if(frames.size() != drawn.frames.size() && changes.firstFrame > keptFrames) {
+        return QString("The number of frames changed, but the first changed frame was %1.").arg(changes.firstFrame);
+    }
+    for(int it = 0; it < std::min(keptFrames, changes.firstFrame); it++) {
+        if(frames[it] != drawn.frames[it]) {
+            return QString("Frame %1 changed, but the first changed frame was %2.").arg(it).arg(changes.firstFrame);
+        }
+    }
+
+    drawn.tags = tags;
+    drawn.frames = frames;
+    return "";
+}
+
+StackTraceTest::StackTraceTest()
+{
+
+}
+
+StackTraceTest::~StackTraceTest() = default;
+
+void StackTraceTest::case_callRet()
+{
+    StackTrace stack;
+    QCOMPARE(stack.callDepth(), quint16{1});
+    QCOMPARE(QString(stack), QString("{}||"));
+
+    // Parameters stay in the next frame until the call.
+    stack.pushParams(0xFB00, range(a, a + 1));
+    QCOMPARE(QString(stack), QString("(a:[fafe])||"));
+    QCOMPARE(stack.getTOS().size(), quint16{2});
+    QVERIFY(stack.getTOS().isOrphaned);
+
+    stack.call(0xFAFC);
+    QCOMPARE(stack.callDepth(), quint16{2});
+    QCOMPARE(QString(stack), QString("{}||{(retAddr:[fafc]), (a:[fafe])}"));
+
+    // Locals are pushed downward from the given address.
+    stack.pushLocals(0xFAFC, range(b, c + 1));
+    QCOMPARE(QString(stack), QString("{}||{(c:[faf9]), (b:[fafb]), (retAddr:[fafc]), (a:[fafe])}"));
+    StackFrame tos = stack.getTOS();
+    QVERIFY(!tos.isOrphaned);
+    QCOMPARE(tos.numItems(), quint16{4});
+    QCOMPARE(tos.size(), quint16{7});
+    QCOMPARE(tos.crbegin()->type, c);
+    QCOMPARE(tos.cbegin()->type, a);
+
+    QVERIFY(stack.popLocals(3));
+    QVERIFY(stack.ret());
+    QCOMPARE(stack.callDepth(), quint16{1});
+    QCOMPARE(QString(stack), QString("(a:[fafe])||"));
+    QVERIFY(stack.getTOS().isOrphaned);
+    QVERIFY(stack.popParams(2));
+    QCOMPARE(stack.getMemTags().size(), 0);
+    QCOMPARE(QString(stack), QString("{}||"));
+
+    // Frames are iterated from the bottom of the stack.
+    stack.pushLocals(0xFB00, range(a, a + 1));
+    stack.pushParams(0xFAFE, range(b, b + 1));
+    QStringList frames;
+    for(const auto& frame : stack) frames << QString(frame);
+    QCOMPARE(frames, QStringList() << "(a:[fafe])" << "(b:[fafd])");
+
+    stack.clear();
+    QCOMPARE(stack.callDepth(), quint16{0});
+    QVERIFY(!stack.ret());
+    QVERIFY(!stack.popLocals(1));
+}
+
+void StackTraceTest::case_popParams()
+{
+    // After returning from a call, its parameters are below the next frame.
+    StackTrace stack;
+    stack.pushParams(0xFB00, range(a, a + 1));
+    stack.call(0xFAFC);
+    QVERIFY(stack.popParams(4));
+    QCOMPARE(stack.getMemTags().size(), 0);
+    QCOMPARE(stack.callDepth(), quint16{1});
+
+    // Popping more than the next frame holds continues into the frame below.
+    // Only the bytes actually popped from the next frame may count toward the size.
+    stack.pushParams(0xFB00, range(a, a + 1));
+    stack.call(0xFAFC);
+    stack.pushParams(0xFAFC, range(a, a + 1));
+    QCOMPARE(stack.getTOS().size(), quint16{2});
+    QVERIFY(stack.popParams(6));
+    QCOMPARE(stack.getMemTags().size(), 0);
+    QCOMPARE(stack.callDepth(), quint16{1});
+
+    // Popping part of a tag pops all of it, but is reported as a failure.
+    stack.pushParams(0xFB00, range(a, a + 1));
+    QVERIFY(!stack.popParams(1));
+    QCOMPARE(stack.getMemTags().size(), 0);
+
+    // Popping more than the whole stack fails.
+    stack.pushParams(0xFB00, range(a, a + 1));
+    QVERIFY(!stack.popParams(4));
+    QCOMPARE(stack.getMemTags().size(), 0);
+}
+
+void StackTraceTest::case_popAndOrphan()
+{
+    StackTrace stack;
+    stack.pushParams(0xFB00, range(a, a + 1));
+    stack.pushParams(0xFAFE, range(a, a + 1));
+    // The whole frame can't be orphaned.
+    QVERIFY(!stack.popAndOrphan(4));
+    QCOMPARE(stack.callDepth(), quint16{1});
+
+    QVERIFY(stack.popAndOrphan(2));
+    QCOMPARE(stack.callDepth(), quint16{2});
+    QCOMPARE(QString(stack), QString("{}||{(a:[fafe])}"));
+    StackFrame tos = stack.getTOS();
+    QVERIFY(tos.isOrphaned);
+    QCOMPARE(tos.numItems(), quint16{1});
+    QCOMPARE(tos.cbegin()->addr, quint16{0xFAFE});
+}
+
+void StackTraceTest::case_heap()
+{
+    HeapTrace heap;
+    heap.pushHeap(0x1000, range(a, b + 1));
+    heap.pushHeap(0x1003, range(c, c + 1));
+    QCOMPARE(heap.numFrames(), 2);
+
+    StackFrame first = heap.getFrame(0), second = heap.getFrame(1);
+    QCOMPARE(first.size(), quint16{3});
+    QCOMPARE(first.numItems(), quint16{2});
+    QCOMPARE(first.cbegin()->addr, quint16{0x1000});
+    QCOMPARE((first.cbegin() + 1)->addr, quint16{0x1002});
+    QVERIFY(!first.isOrphaned);
+    QCOMPARE(second.size(), quint16{2});
+    QCOMPARE(second.numItems(), quint16{1});
+
+    // Frames are listed in the order they were allocated, and tags from the last.
+    QCOMPARE(QString(heap), QString("(b:[1002]), (a:[1000]), (c:[1003])"));
+    QStringList frames;
+    for(auto frame = heap.crbegin(); frame != heap.crend(); ++frame) frames << QString(*frame);
+    QCOMPARE(frames, QStringList() << "(c:[1003])" << "(b:[1002]), (a:[1000])");
+
+    heap.clear();
+    QCOMPARE(heap.numFrames(), 0);
+    QCOMPARE(QString(heap), QString());
+}
+
+void StackTraceTest::case_changes()
+{
+    static const int none = std::numeric_limits<int>::max();
+    StackTrace stack;
+    DrawnStack drawn;
+    QString error;
+    // A new stack has never been drawn.
+    error = takeAndCheckChanges(stack, drawn, 0, 0);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+    error = takeAndCheckChanges(stack, drawn, none, none);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+
+    stack.pushParams(0xFB00, range(a, a + 1));
+    error = takeAndCheckChanges(stack, drawn, 0, 1);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+
+    stack.call(0xFAFC);
+    error = takeAndCheckChanges(stack, drawn, 1, 1);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+
+    stack.pushLocals(0xFAFC, range(b, c + 1));
+    error = takeAndCheckChanges(stack, drawn, 2, 1);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+
+    QVERIFY(stack.popLocals(3));
+    error = takeAndCheckChanges(stack, drawn, 2, 1);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+
+    stack.pushParams(0xFAFC, range(a, a + 1));
+    error = takeAndCheckChanges(stack, drawn, 2, 2);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+
+    // Returning discards the parameters of the call that did not happen, and pops the return address.
+    QVERIFY(stack.ret());
+    error = takeAndCheckChanges(stack, drawn, 1, 1);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+
+    stack.pushParams(0xFAFE, range(a, a + 1));
+    error = takeAndCheckChanges(stack, drawn, 1, 1);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+
+    QVERIFY(stack.popAndOrphan(2));
+    error = takeAndCheckChanges(stack, drawn, 1, 1);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+
+    // Popping parameters across frames changes the frame below the next frame.
+    stack.call(0xFAFC);
+    error = takeAndCheckChanges(stack, drawn, 1, 2);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+    QVERIFY(stack.popParams(4));
+    error = takeAndCheckChanges(stack, drawn, 0, 1);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+
+    stack.clear();
+    error = takeAndCheckChanges(stack, drawn, 0, 0);
+    QVERIFY2(error.isEmpty(), qPrintable(error));
+}
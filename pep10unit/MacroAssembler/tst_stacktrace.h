@@ -0,0 +1,32 @@
+#ifndef TST_STACKTRACE_H
+#define TST_STACKTRACE_H
+
+#include <QtTest>
+
+/*
+ * Test that the stack and heap traces behind the memory trace pane
+ * keep their frames and tags as the program calls, returns, pushes, and pops.
+ */
+class StackTraceTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    StackTraceTest();
+    ~StackTraceTest() override;
+
+private slots:
+    // Check that calling and returning moves the next frame on to and off of the call stack.
+    void case_callRet();
+    // Check that popping parameters continues into the frames below an empty or exhausted next frame.
+    void case_popParams();
+    // Check that a partly popped next frame is left orphaned on the call stack.
+    void case_popAndOrphan();
+    // Check the addresses, byte counts, and text of heap frames.
+    void case_heap();
+    // Check that every push, pop, call, and return reports the first tag and frame it changed,
+    // and that nothing below them changed.
+    void case_changes();
+};
+
+#endif // TST_STACKTRACE_H
@@ -0,0 +1,173 @@
+#include "tst_symboltable.h"
+#include "macroassemblerdriver.h"
+#include "macroregistry.h"
+#include "pep.h"
+#include "symbolentry.h"
+#include "symboltable.h"
+#include "symbolvalue.h"
+
+// Generate a unique symbol name of at most eight characters.
+static QString symbolName(int index)
+{
+    return QString("s%1").arg(index, 5, 10, QLatin1Char('0'));
+}
+
+SymbolTableTest::SymbolTableTest(): registry(new MacroRegistry())
+{
+
+}
+
+SymbolTableTest::~SymbolTableTest() = default;
+
+void SymbolTableTest::initTestCase()
+{
+    QString osText = Pep::resToString(":/help-asm/figures/pep10os.pep", false);
+    QVERIFY2(!osText.isEmpty(), "Default operating system was empty.");
+
+    MacroAssemblerDriver assembler(registry);
+    auto asmResult = assembler.assembleOperatingSystem(osText);
+    QVERIFY2(asmResult.success, "Assembly of operating system did not succede");
+    operatingSystem = asmResult.program;
+}
+
+void SymbolTableTest::case_lookup()
+{
+    SymbolTable table;
+    // Insert enough symbols to force the hash table to grow several times.
+    const int count = 5000;
+    for(int it = 0; it < count; it++) {
+        auto entry = table.insertSymbol(symbolName(it));
+        QCOMPARE(entry->getSymbolID(), static_cast<SymbolTable::SymbolID>(it));
+    }
+    QCOMPARE(table.size(), count);
+    for(int it = 0; it < count; it++) {
+        auto byName = table.getValue(symbolName(it));
+        QVERIFY(!byName.isNull());
+        QCOMPARE(byName->getName(), symbolName(it));
+        QCOMPARE(table.getValue(byName->getSymbolID()), byName);
+    }
+    // Inserting an existing symbol returns the same entry.
+    QCOMPARE(table.insertSymbol(symbolName(42)), table.getValue(symbolName(42)));
+    QCOMPARE(table.size(), count);
+    // Missing symbols are not created by lookups.
+    QVERIFY(!table.exists("missing"));
+    QVERIFY(table.getValue("missing").isNull());
+    QVERIFY(!table.exists(static_cast<SymbolTable::SymbolID>(count)));
+    QVERIFY(table.getValue(static_cast<SymbolTable::SymbolID>(count)).isNull());
+    QCOMPARE(table.size(), count);
+}
+
+void SymbolTableTest::case_defineReference()
+{
+    SymbolTable table;
+    auto referenced = table.reference("ref");
+    QVERIFY(referenced->isUndefined());
+    QCOMPARE(table.define("ref"), referenced);
+    QVERIFY(referenced->isDefined());
+
+    auto multiple = table.define("multi");
+    table.define("multi");
+    QVERIFY(multiple->isMultiplyDefined());
+
+    table.reference("undef");
+    QCOMPARE(table.numUndefinedSymbols(), static_cast<quint32>(1));
+    QCOMPARE(table.numMultiplyDefinedSymbols(), static_cast<quint32>(1));
+}
+
+void SymbolTableTest::case_setOffset()
+{
+    SymbolTable table;
+    auto low = table.setValue("low", QSharedPointer<SymbolValueLocation>::create(0x10));
+    auto high = table.setValue("high", QSharedPointer<SymbolValueLocation>::create(0x100));
+    auto constant = table.setValue("const", QSharedPointer<SymbolValueNumeric>::create(0x200));
+    table.setOffset(0x1000, 0x20);
+    QCOMPARE(low->getValue(), 0x10);
+    QCOMPARE(high->getValue(), 0x1100);
+    QCOMPARE(constant->getValue(), 0x200);
+    table.clearOffset();
+    QCOMPARE(high->getValue(), 0x100);
+}
+
+void SymbolTableTest::case_importTable()
+{
+    auto osTable = QSharedPointer<SymbolTable>::create();
+    auto exported = osTable->setValue("exported", QSharedPointer<SymbolValueNumeric>::create(10));
+    osTable->setValue("private", QSharedPointer<SymbolValueNumeric>::create(20));
+    osTable->declareExternal("exported");
+
+    SymbolTable userTable;
+    userTable.setImportTable(osTable);
+    // References to exported symbols resolve to the imported entry, without creating a local one.
+    QCOMPARE(userTable.reference("exported"), exported);
+    QVERIFY(userTable.exists("exported"));
+    QVERIFY(!userTable.existsLocally("exported"));
+    QCOMPARE(userTable.size(), 0);
+    QCOMPARE(userTable.getImportedSymbols().size(), 1);
+    // Symbols that were not exported remain invisible.
+    QVERIFY(!userTable.exists("private"));
+    QVERIFY(userTable.reference("private")->isUndefined());
+    QVERIFY(userTable.existsLocally("private"));
+    // Local definitions are kept separate from the imported table.
+    auto local = userTable.define("exported");
+    QVERIFY(local != exported);
+    QCOMPARE(userTable.getValue("exported"), local);
+    QCOMPARE(exported->getValue(), 10);
+    QVERIFY(exported->isDefined());
+}
+
+void SymbolTableTest::benchmark_tableOperations_data()
+{
+    QTest::addColumn<int>("SymbolCount");
+    QTest::newRow("1000 symbols") << 1000;
+    QTest::newRow("10000 symbols") << 10000;
+}
+
+void SymbolTableTest::benchmark_tableOperations()
+{
+    QFETCH(int, SymbolCount);
+    QStringList names;
+    for(int it = 0; it < SymbolCount; it++) {
+        names.append(symbolName(it));
+    }
+
+    QBENCHMARK {
+        SymbolTable table;
+        // Reference each symbol before it is defined, as an assembler would for forward branches.
+        for(const auto& name : names) {
+            table.reference(name);
+        }
+        for(const auto& name : names) {
+            table.define(name);
+        }
+        for(const auto& name : names) {
+            table.getValue(name);
+        }
+    }
+}
+
+void SymbolTableTest::benchmark_symbolHeavyProgram_data()
+{
+    QTest::addColumn<QString>("ProgramText");
+    for(int count : {500, 2000}) {
+        // Each line defines one symbol and references the following one.
+        QStringList lines;
+        for(int it = 0; it < count; it++) {
+            lines.append(QString("%1: .ADDRSS %2").arg(symbolName(it), symbolName((it + 1) % count)));
+        }
+        lines.append(".END");
+        QString name = QString("%1 symbols").arg(count);
+        QTest::newRow(name.toStdString().c_str()) << lines.join("\n");
+    }
+}
+
+void SymbolTableTest::benchmark_symbolHeavyProgram()
+{
+    QFETCH(QString, ProgramText);
+    QVERIFY(!operatingSystem.isNull());
+
+    QBENCHMARK {
+        MacroAssemblerDriver assembler(registry);
+        auto asmResult = assembler.assembleUserProgram(ProgramText, operatingSystem->getSymbolTable());
+        QVERIFY2(asmResult.success, "Assembly of symbol heavy program did not succede.");
+    }
+}
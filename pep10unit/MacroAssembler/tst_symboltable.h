@@ -0,0 +1,44 @@
+#ifndef TST_SYMBOLTABLE_H
+#define TST_SYMBOLTABLE_H
+
+#include <QtTest>
+class AsmProgram;
+class MacroRegistry;
+
+/*
+ * Test that the symbol table behaves correctly as it grows,
+ * and benchmark programs that define and reference many symbols.
+ */
+class SymbolTableTest : public QObject
+{
+    Q_OBJECT
+
+public:
+    SymbolTableTest();
+    ~SymbolTableTest() override;
+
+private slots:
+    void initTestCase();
+
+    // Test that symbols may be looked up by name and ID after many insertions.
+    void case_lookup();
+    // Test that defining and referencing symbols tracks definition state.
+    void case_defineReference();
+    // Test that relocation only affects address symbols above the threshhold.
+    void case_setOffset();
+    // Test that exported symbols of an imported table are shared rather than copied.
+    void case_importTable();
+
+    // Benchmark defining, referencing, and looking up symbols directly.
+    void benchmark_tableOperations_data();
+    void benchmark_tableOperations();
+    // Benchmark assembling user programs that contain many symbols.
+    void benchmark_symbolHeavyProgram_data();
+    void benchmark_symbolHeavyProgram();
+
+private:
+    QSharedPointer<MacroRegistry> registry;
+    QSharedPointer<const AsmProgram> operatingSystem;
+};
+
+#endif // TST_SYMBOLTABLE_H
@@ -267,6 +267,19 @@ void TokenBufferTest::case_malformedIdentifier()
     execute();
 }
 
+void TokenBufferTest::case_errorStopsTokenizing()
+{
+    using MacroTokenizerHelper::ELexicalToken;
+    // The second error's message is shorter than the first's.
+    buffer->setTokenizerInput(QStringList() << "LDWA x,d .ASCII \"abc" << "6:7");
+    buffer->tokenizeInput();
+    QVERIFY(buffer->match(ELexicalToken::LTE_ERROR));
+    QCOMPARE(buffer->getMatches().first().second.toString(), MacroTokenizer::malformedStringConst);
+    // The tokens preceding the error on its line follow it.
+    QVERIFY(buffer->match(ELexicalToken::LT_IDENTIFIER));
+    buffer->clearMatchBuffer();
+}
+
 void TokenBufferTest::execute()
 {
     QFETCH(QString, ProgramText);
@@ -36,6 +36,10 @@ private slots:
     // Catch malformed dot commands that the tokenizer could not find on it own.
     void case_malformedIdentifier_data();
     void case_malformedIdentifier();
+
+    // Check that eager tokenizing stops at an error in the middle of a line,
+    // so that an error on a later line cannot replace its message.
+    void case_errorStopsTokenizing();
 private:
     void execute();
     QSharedPointer<MacroRegistry> registry;
@@ -54,7 +54,7 @@ void UserOSIntegrationTest::case_testExport()
     auto userGraph = ModuleAssemblyGraph();
     execute(osGraph, userGraph);
     auto addressCode = userGraph.getRootInstance()->codeList[0];
-    auto addressLine = dynamic_cast<DotAddrss*>(addressCode.get());
+    auto addressLine = dynamic_cast<DotAddrss*>(addressCode);
     QVERIFY2(addressLine->getArgument()->getArgumentValue()==10,
              "Expected exported value to be equal to 10");
 }